@@ -132,6 +132,7 @@ public:
     MAP_PERSISTENT_READ_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_READ_BIT,
     MAP_PERSISTENT_WRITE_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_WRITE_BIT,
     MAP_PERSISTENT_READ_WRITE_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT,
+    MAP_PERSISTENT_COHERENT_WRITE_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_MAP_WRITE_BIT,
     MAP_DYNAMIC_PERSISTENT_READ_WRITE_BIT
     = GL_DYNAMIC_STORAGE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT,
     MAP_DYNAMIC_PERSISTENT_READ_BIT = GL_DYNAMIC_STORAGE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_READ_BIT,
@@ -155,6 +156,7 @@ public:
     MAP_PERSISTENT_READ_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_READ_BIT,
     MAP_PERSISTENT_WRITE_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_WRITE_BIT,
     MAP_PERSISTENT_READ_WRITE_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT,
+    MAP_PERSISTENT_COHERENT_WRITE_BIT = GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_MAP_WRITE_BIT,
     MAP_COHERENT_BIT = GL_MAP_COHERENT_BIT,
     MAP_INVALIDATE_RANGE_BIT = GL_MAP_INVALIDATE_RANGE_BIT,
     MAP_INVALIDATE_BUFFER_BIT = GL_MAP_INVALIDATE_BUFFER_BIT,
@@ -206,6 +208,7 @@ public:
     UNSIGNED_SHORT = GL_UNSIGNED_SHORT,
     INT = GL_INT,
     UNSIGNED_INT = GL_UNSIGNED_INT,
+    HALF_FLOAT = GL_HALF_FLOAT,
     FLOAT = GL_FLOAT,
     DOUBLE = GL_DOUBLE,
 
@@ -261,6 +264,28 @@ public:
     CURRENT_PROGRAM = GL_CURRENT_PROGRAM
   };
 
+  enum class EProgramInterface
+  {
+    UNIFORM = GL_UNIFORM,
+    UNIFORM_BLOCK = GL_UNIFORM_BLOCK,
+  };
+
+  enum class EProgramInterfaceParameter
+  {
+    ACTIVE_RESOURCES = GL_ACTIVE_RESOURCES,
+    MAX_NAME_LENGTH = GL_MAX_NAME_LENGTH,
+  };
+
+  enum class EProgramResourceProperty
+  {
+    NAME_LENGTH = GL_NAME_LENGTH,
+    TYPE = GL_TYPE,
+    ARRAY_SIZE = GL_ARRAY_SIZE,
+    LOCATION = GL_LOCATION,
+    BLOCK_INDEX = GL_BLOCK_INDEX,
+    BUFFER_BINDING = GL_BUFFER_BINDING,
+  };
+
   enum class EBlendFactor
   {
     ZERO = GL_ZERO,
@@ -755,6 +780,7 @@ public:
     POINT_SIZE = GL_POINT_SIZE,
     POINT_SIZE_GRANULARITY = GL_POINT_SIZE_GRANULARITY,
     POINT_SIZE_RANGE = GL_POINT_SIZE_RANGE,
+    POLYGON_MODE = GL_POLYGON_MODE,
     POLYGON_OFFSET_FACTOR = GL_POLYGON_OFFSET_FACTOR,
     POLYGON_OFFSET_UNITS = GL_POLYGON_OFFSET_UNITS,
     POLYGON_OFFSET_FILL = GL_POLYGON_OFFSET_FILL,
@@ -850,6 +876,8 @@ public:
     GL::EBlendFactor mDestBlendFactorRGB = GL::EBlendFactor::ZERO;
     GL::EBlendFactor mSourceBlendFactorAlpha = GL::EBlendFactor::ONE;
     GL::EBlendFactor mDestBlendFactorAlpha = GL::EBlendFactor::ZERO;
+
+    bool operator==(const BlendFactors& inRHS) const = default;
   };
 
   static void Enable(const GL::EEnablable inEnablable);
@@ -1097,6 +1125,11 @@ public:
       const GL::Size inNumberOfPrimitives,
       const GL::EDataType inIndicesDataType,
       const GL::Size inBeginPrimiviteIndex = 0);
+  // One draw of several ranges of the bound EBO, at the given byte offsets
+  static void MultiDrawElements(const GL::EPrimitivesType inPrimitivesType,
+      const Span<GL::Size>& inNumbersOfElements,
+      const GL::EDataType inIndicesDataType,
+      const Span<const void*>& inIndicesOffsets);
   static void DrawArrays(const GL::EPrimitivesType inPrimitivesType,
       const GL::Size inNumberOfPrimitives,
       const GL::Size inBeginPrimiviteIndex = 0);
@@ -1116,6 +1149,16 @@ public:
   static GL::Id GetAttribLocation(const GL::Id inShaderProgramId, const std::string_view inAttribName);
   static GL::Id GetUniformLocation(const GL::Id inShaderProgramId, const std::string_view inUniformName);
   static GL::Id GetUniformBlockIndex(const GL::Id inShaderProgramId, const std::string_view inUniformBlockName);
+  static GL::Int GetProgramInterface(const GL::Id inShaderProgramId,
+      const GL::EProgramInterface inProgramInterface,
+      const GL::EProgramInterfaceParameter inProgramInterfaceParameter);
+  static GL::Int GetProgramResource(const GL::Id inShaderProgramId,
+      const GL::EProgramInterface inProgramInterface,
+      const GL::Uint inResourceIndex,
+      const GL::EProgramResourceProperty inProgramResourceProperty);
+  static std::string GetProgramResourceName(const GL::Id inShaderProgramId,
+      const GL::EProgramInterface inProgramInterface,
+      const GL::Uint inResourceIndex);
   static void Uniform(const GL::Id inUniformLocation, bool inValue);
   static void Uniform(const GL::Id inUniformLocation, int8_t inValue);
   static void Uniform(const GL::Id inUniformLocation, int16_t inValue);
@@ -1191,10 +1234,16 @@ public:
   static void Bind(const GL::Id inId);
   template <GL::EBindingType TBindingType>
   static void UnBind();
-  static GL::Id GetBoundGLId(const GL::EBindingType inBindingType)
-  {
-    return GL::GetInteger(static_cast<GL::EGetEnum>(inBindingType));
-  }
+  static GL::Id GetBoundGLId(const GL::EBindingType inBindingType);
+
+  // State cache. Bindings, enables, depth/blend state, point size, line width and viewport set through this class are
+  // mirrored in a cache of the current context, so getters do not hit glGet* and redundant sets are skipped. The cache
+  // starts over when the thread finds another context current. Call InvalidateStateCache after touching that state
+  // with raw gl* calls, or after using the current context from another thread.
+  // When the check is enabled (default in debug builds), every cached value is cross-checked against glGet*.
+  static void InvalidateStateCache();
+  static void SetStateCacheCheckEnabled(const bool inStateCacheCheckEnabled);
+  static bool IsStateCacheCheckEnabled();
 
   // To ObjectType conversions
   template <GL::EBindingType TBindingType>
@@ -3,7 +3,9 @@
 #include <ez/GL.h>
 #include <ez/Mat.h>
 #include <ez/Vec.h>
+#include <ez/VertexAttribEncoding.h>
 #include <GL/glew.h>
+#include <array>
 
 namespace ez
 {
@@ -110,6 +112,23 @@ struct GLTypeTraits<double> final : public _GLTypeTraitsBase<double>
   static constexpr auto GLTextureComponentFormat = GL::ETextureInputComponentFormat::DOUBLE;
 };
 
+template <>
+struct GLTypeTraits<Half> final : public _GLTypeTraitsBase<Half>
+{
+  static constexpr auto GLType = GL::EDataType::HALF_FLOAT;
+  static constexpr auto GLComponentType = GLType;
+  static constexpr auto GLTextureInputFormat = GL::ETextureInputFormat::RED;
+  static constexpr auto GLTextureFormat = GL::ETextureFormat::RED;
+  static constexpr auto GLTextureComponentFormat = GL::ETextureInputComponentFormat::HALF_FLOAT;
+};
+
+// Packed vertex attributes of any component type (e.g. std::array<int16_t, 2> for octahedral normals)
+template <typename T, std::size_t N>
+struct GLTypeTraits<std::array<T, N>> final : public _GLTypeTraitsBase<T, N>
+{
+  static constexpr auto GLComponentType = GLTypeTraits<T>::GLComponentType;
+};
+
 template <typename, std::size_t>
 class Vec;
 
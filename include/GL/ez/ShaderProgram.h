@@ -6,18 +6,63 @@
 #include <ez/Mat.h>
 #include <ez/Shader.h>
 #include <ez/Vec.h>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace ez
 {
+class ShaderProgram;
+
+// Name of a uniform (or uniform block) with its hash precomputed. It also remembers the index it resolved to in the
+// last ShaderProgram it was used with, so that it can be created once (e.g. a static) and reused for every draw.
+template <GL::EProgramInterface TProgramInterface>
+class ShaderProgramResourceHandle final
+{
+public:
+  explicit ShaderProgramResourceHandle(const std::string_view inName);
+
+  const std::string& GetName() const { return mName; }
+  std::size_t GetHash() const { return mHash; }
+
+private:
+  friend class ShaderProgram;
+
+  std::string mName;
+  std::size_t mHash = 0;
+  mutable uint64_t mResolvedShaderProgramSerial = 0;
+  mutable uint32_t mResolvedIndex = 0;
+};
+
+using UniformHandle = ShaderProgramResourceHandle<GL::EProgramInterface::UNIFORM>;
+using UniformBlockHandle = ShaderProgramResourceHandle<GL::EProgramInterface::UNIFORM_BLOCK>;
+
 class ShaderProgram final : public GLBindableObject<GL::EBindingType::SHADER_PROGRAM>
 {
 public:
   using GLGuardType = GLBindGuard<GL::EBindingType::SHADER_PROGRAM>;
   using GLBindableObject<GL::EBindingType::SHADER_PROGRAM>::GetGLId;
 
+  struct UniformInfo
+  {
+    std::string mName;
+    GL::Id mLocation = GL::InvalidId;
+    GL::EDataType mType = GL::EDataType::FLOAT;
+    GL::Int mArraySize = 1;
+  };
+
+  struct UniformBlockInfo
+  {
+    std::string mName;
+    GL::Id mIndex = GL::InvalidId;
+    GL::Id mBindingPoint = GL::InvalidId;
+  };
+
   ShaderProgram(const VertexShader& inVertexShader, const FragmentShader& inFragmentShader);
   ShaderProgram(const ComputeShader& inComputeShader);
   ShaderProgram(ShaderProgram&& ioRHS) = default;
@@ -25,19 +70,66 @@ public:
 
   std::optional<GL::Id> GetAttribLocation(const std::string_view inAttribName) const;
   std::optional<GL::Id> GetUniformLocation(const std::string_view inUniformName) const;
+  std::optional<GL::Id> GetUniformLocation(const UniformHandle& inUniformHandle) const;
   std::optional<GL::Id> GetUniformBlockIndex(const std::string_view inUniformBlockName) const;
+  std::optional<GL::Id> GetUniformBlockIndex(const UniformBlockHandle& inUniformBlockHandle) const;
+
+  const std::vector<UniformInfo>& GetUniforms() const { return mUniforms.mResources; }
+  const std::vector<UniformBlockInfo>& GetUniformBlocks() const { return mUniformBlocks.mResources; }
 
   template <typename T>
   void SetUniform(const GL::Id inUniformLocation, const T& inValue);
   template <typename T>
   void SetUniform(const std::string_view inUniformName, const T& inValue);
   template <typename T>
+  void SetUniform(const UniformHandle& inUniformHandle, const T& inValue);
+  template <typename T>
   void SetUniformSafe(const std::string_view inUniformName, const T& inValue);
+  template <typename T>
+  void SetUniformSafe(const UniformHandle& inUniformHandle, const T& inValue);
   void SetUniformBlockBinding(const std::string_view inUniformBlockName, const GL::Id inBindingPoint);
+  void SetUniformBlockBinding(const UniformBlockHandle& inUniformBlockHandle, const GL::Id inBindingPoint);
   void SetUniformBlockBinding(const GL::Id inUniformBlockIndex, const GL::Id inBindingPoint);
   void SetUniformBlockBindingSafe(const std::string_view inUniformBlockName, const GL::Id inBindingPoint);
+  void SetUniformBlockBindingSafe(const UniformBlockHandle& inUniformBlockHandle, const GL::Id inBindingPoint);
 
 private:
+  static constexpr auto InvalidIndex = static_cast<uint32_t>(-1);
+
+  // Open addressing hash table (linear probing) over the introspected resources, indexed by name
+  template <typename TResourceInfo>
+  struct ResourceTable
+  {
+    std::vector<TResourceInfo> mResources;
+    std::vector<std::pair<std::string, uint32_t>> mKeys; // Name (or alias) and its resource index
+    std::vector<std::size_t> mKeysHashes;
+    std::vector<uint32_t> mSlots; // Key index + 1, 0 means empty
+
+    void Add(TResourceInfo&& ioResourceInfo, const std::string_view inName);
+    void AddAlias(const std::string_view inAlias); // Alias for the last added resource
+    void Build();
+    uint32_t Find(const std::string_view inName, const std::size_t inHash) const;
+  };
+
+  // Last value set for each uniform, to skip redundant glUniform* calls
+  struct UniformValue
+  {
+    std::array<std::byte, sizeof(Mat4d)> mBytes;
+    uint8_t mSize = 0;
+  };
+
+  uint64_t mSerial = 0;
+  ResourceTable<UniformInfo> mUniforms;
+  ResourceTable<UniformBlockInfo> mUniformBlocks;
+  std::vector<UniformValue> mUniformValues;
+  std::vector<uint32_t> mLocationToUniformIndex;
+
+  void IntrospectResources();
+  uint32_t GetUniformIndex(const GL::Id inUniformLocation) const;
+  template <GL::EProgramInterface TProgramInterface>
+  uint32_t ResolveHandle(const ShaderProgramResourceHandle<TProgramInterface>& inHandle) const;
+  template <typename T>
+  void SetUniformByIndex(const uint32_t inUniformIndex, const T& inValue);
   GL::Id GetUniformLocationWithException(const ShaderProgram& inShaderProgram, const std::string_view inUniformName);
 };
 }
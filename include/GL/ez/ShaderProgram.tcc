@@ -1,14 +1,114 @@
 #include <ez/GL.h>
 #include <ez/ShaderProgram.h>
+#include <cstring>
+#include <functional>
+#include <type_traits>
 
 namespace ez
 {
+template <GL::EProgramInterface TProgramInterface>
+ShaderProgramResourceHandle<TProgramInterface>::ShaderProgramResourceHandle(const std::string_view inName)
+    : mName(inName), mHash(std::hash<std::string_view> {}(inName))
+{
+}
+
+template <typename TResourceInfo>
+void ShaderProgram::ResourceTable<TResourceInfo>::Add(TResourceInfo&& ioResourceInfo, const std::string_view inName)
+{
+  mResources.push_back(std::move(ioResourceInfo));
+  mKeys.emplace_back(std::string(inName), static_cast<uint32_t>(mResources.size() - 1));
+}
+
+template <typename TResourceInfo>
+void ShaderProgram::ResourceTable<TResourceInfo>::AddAlias(const std::string_view inAlias)
+{
+  EXPECTS(!mResources.empty());
+  mKeys.emplace_back(std::string(inAlias), static_cast<uint32_t>(mResources.size() - 1));
+}
+
+template <typename TResourceInfo>
+void ShaderProgram::ResourceTable<TResourceInfo>::Build()
+{
+  std::size_t num_slots = 1;
+  while (num_slots < mKeys.size() * 2)
+    num_slots *= 2;
+
+  mKeysHashes.resize(mKeys.size());
+  mSlots.assign(num_slots, 0u);
+  for (std::size_t key_index = 0; key_index < mKeys.size(); ++key_index)
+  {
+    mKeysHashes[key_index] = std::hash<std::string_view> {}(mKeys[key_index].first);
+
+    auto slot = (mKeysHashes[key_index] & (num_slots - 1));
+    while (mSlots[slot] != 0)
+      slot = ((slot + 1) & (num_slots - 1));
+    mSlots[slot] = static_cast<uint32_t>(key_index + 1);
+  }
+}
+
+template <typename TResourceInfo>
+uint32_t ShaderProgram::ResourceTable<TResourceInfo>::Find(const std::string_view inName,
+    const std::size_t inHash) const
+{
+  const auto num_slots = mSlots.size();
+  if (num_slots == 0)
+    return InvalidIndex;
+
+  auto slot = (inHash & (num_slots - 1));
+  while (mSlots[slot] != 0)
+  {
+    const auto key_index = (mSlots[slot] - 1);
+    if (mKeysHashes[key_index] == inHash && mKeys[key_index].first == inName)
+      return mKeys[key_index].second;
+    slot = ((slot + 1) & (num_slots - 1));
+  }
+  return InvalidIndex;
+}
+
+template <GL::EProgramInterface TProgramInterface>
+uint32_t ShaderProgram::ResolveHandle(const ShaderProgramResourceHandle<TProgramInterface>& inHandle) const
+{
+  if (inHandle.mResolvedShaderProgramSerial != mSerial)
+  {
+    if constexpr (TProgramInterface == GL::EProgramInterface::UNIFORM)
+      inHandle.mResolvedIndex = mUniforms.Find(inHandle.mName, inHandle.mHash);
+    else
+      inHandle.mResolvedIndex = mUniformBlocks.Find(inHandle.mName, inHandle.mHash);
+    inHandle.mResolvedShaderProgramSerial = mSerial;
+  }
+  return inHandle.mResolvedIndex;
+}
+
+template <typename T>
+void ShaderProgram::SetUniformByIndex(const uint32_t inUniformIndex, const T& inValue)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(sizeof(T) <= sizeof(UniformValue::mBytes));
+
+  EXPECTS(IsBound());
+  EXPECTS(inUniformIndex < mUniformValues.size());
+
+  auto& uniform_value = mUniformValues[inUniformIndex];
+  if (uniform_value.mSize == sizeof(T) && std::memcmp(uniform_value.mBytes.data(), &inValue, sizeof(T)) == 0)
+    return;
+
+  std::memcpy(uniform_value.mBytes.data(), &inValue, sizeof(T));
+  uniform_value.mSize = sizeof(T);
+
+  GL::Uniform(mUniforms.mResources[inUniformIndex].mLocation, inValue);
+}
+
 template <typename T>
 void ShaderProgram::SetUniform(const GL::Id inUniformLocation, const T& inValue)
 {
   EXPECTS(IsBound());
   EXPECTS(inUniformLocation != GL::InvalidId);
-  GL::Uniform(inUniformLocation, inValue);
+
+  const auto uniform_index = GetUniformIndex(inUniformLocation);
+  if (uniform_index != InvalidIndex)
+    SetUniformByIndex(uniform_index, inValue);
+  else
+    GL::Uniform(inUniformLocation, inValue);
 }
 
 template <typename T>
@@ -17,6 +117,16 @@ void ShaderProgram::SetUniform(const std::string_view inName, const T& inValue)
   SetUniform<T>(GetUniformLocationWithException(*this, inName), inValue);
 }
 
+template <typename T>
+void ShaderProgram::SetUniform(const UniformHandle& inUniformHandle, const T& inValue)
+{
+  const auto uniform_index = ResolveHandle(inUniformHandle);
+  if (uniform_index == InvalidIndex)
+    THROW_EXCEPTION("Uniform \"" << inUniformHandle.GetName() << "\" not found in shader program with id "
+                                 << GetGLId());
+  SetUniformByIndex(uniform_index, inValue);
+}
+
 template <typename T>
 void ShaderProgram::SetUniformSafe(const std::string_view inName, const T& inValue)
 {
@@ -24,4 +134,12 @@ void ShaderProgram::SetUniformSafe(const std::string_view inName, const T& inVal
   if (uniform_location.has_value())
     SetUniform<T>(*uniform_location, inValue);
 }
-}
\ No newline at end of file
+
+template <typename T>
+void ShaderProgram::SetUniformSafe(const UniformHandle& inUniformHandle, const T& inValue)
+{
+  const auto uniform_index = ResolveHandle(inUniformHandle);
+  if (uniform_index != InvalidIndex)
+    SetUniformByIndex(uniform_index, inValue);
+}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ez/GL.h>
+#include <ez/Sync.h>
+#include <ez/VAO.h>
+#include <ez/VAOVertexAttrib.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ez
+{
+class VBO;
+
+// Persistently mapped vertex ring buffer for transient (immediate-mode) geometry.
+// The ring is split in regions. Each allocation lives inside a single region, and a fence is set on a region when the
+// ring moves past it, so that it is only overwritten once the GPU has finished drawing from it.
+class StreamingVBO final
+{
+public:
+  // Interleaved vertex format: attrib location and attrib description for each vertex attribute
+  using VertexFormat = std::vector<std::pair<GL::Id, VAOVertexAttrib>>;
+
+  struct Allocation
+  {
+    void* mData = nullptr;     // Mapped pointer to write the vertices to
+    std::size_t mOffset = 0;   // Offset in bytes inside the buffer
+    GL::Size mBeginVertex = 0; // First vertex index, to be used with DrawArrays
+  };
+
+  struct Stats
+  {
+    uint64_t mNumberOfAllocations = 0;
+    uint64_t mNumberOfAllocatedBytes = 0;
+    uint64_t mNumberOfWraps = 0;         // Times the ring went back to its beginning
+    uint64_t mNumberOfStalls = 0;        // Times we had to wait for the GPU to release a region
+    uint64_t mNumberOfReallocations = 0; // Times the ring had to grow to fit an allocation
+  };
+
+  static constexpr std::size_t NumberOfRegions = 4;
+  static constexpr std::size_t DefaultSizeInBytes = (4u << 20u);
+
+  explicit StreamingVBO(const std::size_t inSizeInBytes = DefaultSizeInBytes);
+  StreamingVBO(const StreamingVBO&) = delete;
+  StreamingVBO& operator=(const StreamingVBO&) = delete;
+  StreamingVBO(StreamingVBO&&) = default;
+  StreamingVBO& operator=(StreamingVBO&&) = default;
+  ~StreamingVBO() = default;
+
+  Allocation Allocate(const std::size_t inSizeInBytes, const std::size_t inVertexStride);
+  const VAO& GetVAO(const VertexFormat& inVertexFormat);
+
+  std::size_t GetSizeInBytes() const { return mRegionSizeInBytes * NumberOfRegions; }
+  const Stats& GetStats() const { return mStats; }
+  void ResetStats() { mStats = Stats {}; }
+
+private:
+  std::shared_ptr<VBO> mVBO;
+  uint8_t* mMappedData = nullptr;
+  std::size_t mRegionSizeInBytes = 0;
+  std::size_t mCurrentRegion = 0;
+  std::size_t mHead = 0;
+  std::array<Sync, NumberOfRegions> mRegionsFences;
+  std::vector<std::pair<VertexFormat, std::unique_ptr<VAO>>> mVAOs;
+  Stats mStats;
+
+  void Reallocate(const std::size_t inSizeInBytes);
+  void WaitForRegion(const std::size_t inRegion);
+};
+}
@@ -15,6 +15,7 @@ public:
   ~Sync();
 
   void Set();
+  bool IsSet() const { return mSync != 0; }
   GL::EClientWaitSyncResult ClientWait(const bool inFlush = true, const uint64_t inTimeout = Max<uint64_t>()) const;
   GL::EClientWaitSyncResult SetAndClientWait(const bool inFlush = true, const uint64_t inTimeout = Max<uint64_t>());
   static GL::EClientWaitSyncResult StaticClientWait(const bool inFlush = true,
@@ -25,6 +25,7 @@ public:
 
   void AddVBO(const std::shared_ptr<VBO>& inVBO, const GL::Id inAttribLocation, const VAOVertexAttrib& inVertexAttrib);
   void SetEBO(const std::shared_ptr<EBO>& inEBO);
+  void ClearVBOs(); // Drops every VBO and disables their vertex attribs, keeping the EBO
 
   void AddVertexAttrib(const GL::Id inAttributeLocation, const VAOVertexAttrib& inVertexAttrib);
   void RemoveVertexAttrib(const GL::Id inAttributeLocation);
@@ -8,7 +8,7 @@ namespace ez
 struct VAOVertexAttrib
 {
   VAOVertexAttrib() = default;
-  explicit VAOVertexAttrib(uint32_t inNumComponents,
+  constexpr explicit VAOVertexAttrib(uint32_t inNumComponents,
       GL::EDataType inType,
       uint32_t inStride,
       bool inNormalized = false,
@@ -17,6 +17,8 @@ struct VAOVertexAttrib
   {
   }
 
+  bool operator==(const VAOVertexAttrib& inRHS) const = default;
+
   uint32_t mNumComponents = 1;
   GL::EDataType mType = GL::EDataType::BOOL;
   bool mNormalized = false;
@@ -27,7 +29,7 @@ struct VAOVertexAttrib
 template <typename T>
 struct VAOVertexAttribT final : public VAOVertexAttrib
 {
-  explicit VAOVertexAttribT(uint32_t inStride = GLTypeTraits<T>::NumBytes,
+  constexpr explicit VAOVertexAttribT(uint32_t inStride = GLTypeTraits<T>::NumBytes,
       bool inNormalized = false,
       uint32_t inOffset = 0)
       : VAOVertexAttrib(GLTypeTraits<T>::NumComponents,
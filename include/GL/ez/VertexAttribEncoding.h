@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ez/Vec.h>
+#include <array>
+#include <cstdint>
+
+namespace ez
+{
+// Packed encodings of vertex attributes, to be read by the GPU as floats (HALF_FLOAT or normalized integers)
+
+// IEEE 754 binary16
+struct Half
+{
+  uint16_t mBits = 0;
+
+  bool operator==(const Half& inRHS) const = default;
+};
+
+Half EncodeHalf(const float inValue); // Rounds to nearest even. Overflows to infinity.
+float DecodeHalf(const Half inValue);
+
+uint16_t EncodeUnorm16(const float inValue); // [0, 1] to [0, 65535], clamped
+int16_t EncodeSnorm16(const float inValue);  // [-1, 1] to [-32767, 32767], clamped
+
+// Octahedral mapping of a unit vector to 2 snorm16 (Cigolle et al., "A Survey of Efficient Representations for
+// Independent Unit Vectors", 2014). The zero vector is encoded as (0, 0), which decodes to (0, 0, 1).
+std::array<int16_t, 2> EncodeOctahedralSnorm16(const Vec3f& inUnitVector);
+Vec3f DecodeOctahedralSnorm16(const std::array<int16_t, 2>& inEncodedUnitVector);
+}
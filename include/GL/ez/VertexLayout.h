@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ez/GL.h>
+#include <ez/GLTypeTraits.h>
+#include <ez/VAO.h>
+#include <ez/VAOVertexAttrib.h>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ez
+{
+class VBO;
+
+// One attribute of an interleaved vertex struct: its type, its offset in the struct (use offsetof), the attrib
+// location it is bound to, and whether integer components are normalized to [0, 1] / [-1, 1] when read.
+template <typename TAttrib, std::size_t TOffset, GL::Id TAttribLocation, bool TNormalized = false>
+struct VertexLayoutAttrib final
+{
+  using AttribType = TAttrib;
+  static constexpr auto Offset = TOffset;
+  static constexpr auto AttribLocation = TAttribLocation;
+  static constexpr auto Normalized = TNormalized;
+};
+
+// Compile-time description of an interleaved vertex struct, from which the VAO attributes are generated. E.g.:
+//   struct Vertex { Vec3f mPosition; std::array<int16_t, 2> mNormal; };
+//   using Layout = VertexLayout<Vertex,
+//       VertexLayoutAttrib<Vec3f, offsetof(Vertex, mPosition), 0>,
+//       VertexLayoutAttrib<std::array<int16_t, 2>, offsetof(Vertex, mNormal), 1, true>>;
+template <typename TVertex, typename... TVertexLayoutAttribs>
+class VertexLayout final
+{
+public:
+  using VertexType = TVertex;
+  static constexpr std::size_t VertexSize = sizeof(TVertex);
+  static constexpr std::size_t NumberOfAttribs = sizeof...(TVertexLayoutAttribs);
+
+  static_assert(std::is_standard_layout_v<TVertex> && std::is_trivially_copyable_v<TVertex>,
+      "Vertices are uploaded as raw bytes");
+  static_assert(((TVertexLayoutAttribs::Offset + sizeof(typename TVertexLayoutAttribs::AttribType) <= VertexSize)
+                    && ...),
+      "Vertex attribute out of the vertex struct");
+
+  static constexpr std::array<std::pair<GL::Id, VAOVertexAttrib>, NumberOfAttribs> VertexAttribs = {
+    std::pair<GL::Id, VAOVertexAttrib> { TVertexLayoutAttribs::AttribLocation,
+        VAOVertexAttribT<typename TVertexLayoutAttribs::AttribType>(static_cast<uint32_t>(VertexSize),
+            TVertexLayoutAttribs::Normalized,
+            static_cast<uint32_t>(TVertexLayoutAttribs::Offset)) }...
+  };
+
+  VertexLayout() = delete;
+
+  // Binds all the attributes of the layout to inVBO, which holds TVertex's
+  static void AddVBO(VAO& ioVAO, const std::shared_ptr<VBO>& inVBO)
+  {
+    for (const auto& [attrib_location, vertex_attrib] : VertexAttribs)
+      ioVAO.AddVBO(inVBO, attrib_location, vertex_attrib);
+  }
+};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace ez
+{
+// Read-only memory mapping of a whole file. Its pages are loaded on first access, and shared with the page cache.
+class MappedFile final
+{
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::filesystem::path& inFilePath);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& ioRHS) noexcept;
+  MappedFile& operator=(MappedFile&& ioRHS) noexcept;
+  ~MappedFile();
+
+  const std::byte* GetData() const { return mData; } // Page aligned. Null if not mapped, or if the file is empty.
+  std::size_t GetSize() const { return mSize; }
+
+private:
+  const std::byte* mData = nullptr;
+  std::size_t mSize = 0;
+
+  void Unmap();
+};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace ez
+{
+constexpr std::size_t DefaultParallelMinChunkSize = 4096;
+
+// Number of threads the parallel algorithms below run on (the hardware concurrency, at least 1, or 1 inside a
+// ParallelSerialGuard)
+std::size_t GetNumberOfParallelThreads();
+
+// While alive, the parallel algorithms below run on the calling thread only. For work done inside the chunks of an
+// outer ParallelFor that already keeps all the threads busy, so that it does not spawn threads of its own.
+class ParallelSerialGuard final
+{
+public:
+  ParallelSerialGuard();
+  ~ParallelSerialGuard();
+  ParallelSerialGuard(const ParallelSerialGuard&) = delete;
+  ParallelSerialGuard& operator=(const ParallelSerialGuard&) = delete;
+};
+
+// Number of chunks ParallelFor splits inNumberOfElements into: at least 1, at most one per thread, and none smaller
+// than inMinChunkSize (except when there are less elements than that).
+std::size_t GetNumberOfParallelChunks(const std::size_t inNumberOfElements,
+    const std::size_t inMinChunkSize = DefaultParallelMinChunkSize);
+
+// Calls inFunction(chunk_id, begin, end) for every chunk of [0, inNumberOfElements), each chunk in its own thread.
+// Blocks until all chunks are done. If any call throws, the first exception (by chunk id) is rethrown.
+template <typename TFunction>
+void ParallelFor(const std::size_t inNumberOfElements,
+    const TFunction& inFunction,
+    const std::size_t inMinChunkSize = DefaultParallelMinChunkSize);
+
+// Sorts chunks in parallel and then merges them pairwise, also in parallel
+template <typename TRandomIt, typename TCompare = std::less<>>
+void ParallelSort(const TRandomIt inBegin, const TRandomIt inEnd, const TCompare& inCompare = TCompare {});
+}
+
+#include "ez/Parallel.tcc"
@@ -0,0 +1,90 @@
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace ez
+{
+template <typename TFunction>
+void ParallelFor(const std::size_t inNumberOfElements, const TFunction& inFunction, const std::size_t inMinChunkSize)
+{
+  const auto number_of_chunks = GetNumberOfParallelChunks(inNumberOfElements, inMinChunkSize);
+  const auto chunk_begin = [&](const std::size_t inChunkId)
+  { return (inNumberOfElements * inChunkId) / number_of_chunks; };
+
+  if (number_of_chunks == 1)
+  {
+    inFunction(std::size_t(0), std::size_t(0), inNumberOfElements);
+    return;
+  }
+
+  std::vector<std::exception_ptr> chunks_exceptions(number_of_chunks);
+  const auto run_chunk = [&](const std::size_t inChunkId)
+  {
+    try
+    {
+      inFunction(inChunkId, chunk_begin(inChunkId), chunk_begin(inChunkId + 1));
+    }
+    catch (...)
+    {
+      chunks_exceptions[inChunkId] = std::current_exception();
+    }
+  };
+
+  // The calling thread runs the first chunk itself
+  std::vector<std::thread> threads;
+  threads.reserve(number_of_chunks - 1);
+  for (std::size_t chunk_id = 1; chunk_id < number_of_chunks; ++chunk_id) { threads.emplace_back(run_chunk, chunk_id); }
+  run_chunk(0);
+  for (auto& thread : threads) { thread.join(); }
+
+  for (const auto& chunk_exception : chunks_exceptions)
+  {
+    if (chunk_exception)
+      std::rethrow_exception(chunk_exception);
+  }
+}
+
+template <typename TRandomIt, typename TCompare>
+void ParallelSort(const TRandomIt inBegin, const TRandomIt inEnd, const TCompare& inCompare)
+{
+  const auto number_of_elements = static_cast<std::size_t>(std::distance(inBegin, inEnd));
+  const auto number_of_chunks = GetNumberOfParallelChunks(number_of_elements);
+  const auto chunk_begin = [&](const std::size_t inChunkId)
+  { return inBegin + static_cast<std::ptrdiff_t>((number_of_elements * inChunkId) / number_of_chunks); };
+
+  ParallelFor(
+      number_of_chunks,
+      [&](const std::size_t, const std::size_t inBeginChunkId, const std::size_t inEndChunkId)
+      {
+        for (auto chunk_id = inBeginChunkId; chunk_id < inEndChunkId; ++chunk_id)
+          std::sort(chunk_begin(chunk_id), chunk_begin(chunk_id + 1), inCompare);
+      },
+      1);
+
+  // Merge sorted runs of 1, 2, 4... chunks, each merge of a level independent from the others
+  for (std::size_t run_chunks = 1; run_chunks < number_of_chunks; run_chunks *= 2)
+  {
+    const auto number_of_merges = (number_of_chunks + (2 * run_chunks) - 1) / (2 * run_chunks);
+    ParallelFor(
+        number_of_merges,
+        [&](const std::size_t, const std::size_t inBeginMergeId, const std::size_t inEndMergeId)
+        {
+          for (auto merge_id = inBeginMergeId; merge_id < inEndMergeId; ++merge_id)
+          {
+            const auto first_chunk_id = (merge_id * 2 * run_chunks);
+            const auto middle_chunk_id = std::min(first_chunk_id + run_chunks, number_of_chunks);
+            const auto last_chunk_id = std::min(first_chunk_id + 2 * run_chunks, number_of_chunks);
+            if (middle_chunk_id < last_chunk_id)
+              std::inplace_merge(chunk_begin(first_chunk_id),
+                  chunk_begin(middle_chunk_id),
+                  chunk_begin(last_chunk_id),
+                  inCompare);
+          }
+        },
+        1);
+  }
+}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <ez/AAHyperBox.h>
+#include <ez/MathInitializers.h>
+#include <ez/Ray.h>
+#include <ez/Span.h>
+#include <ez/Triangle.h>
+#include <ez/Vec.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace ez
+{
+template <typename TPrimitive>
+class Bvh;
+
+// Bounding volume hierarchy over triangles, for ray queries on big meshes (picking, visibility...). Built top-down in
+// parallel, splitting every node where the surface area heuristic (evaluated on binned centroids) says. Nodes are
+// laid out depth first, with the left child right after its parent. Leaves store their triangles in packets of 4,
+// tested against the ray at once (with SSE when available).
+template <>
+class Bvh<Triangle3f> final
+{
+public:
+  struct Parameters
+  {
+    std::size_t mMaxLeafSize = 8; // Triangles. Leaves can be smaller, if splitting them is cheaper for the SAH.
+    float mTraversalCost = 1.0f;  // SAH cost of visiting a node, relative to testing a packet of triangles
+
+    // 16 bytes nodes instead of 32, with their bounds quantized to 16 bits inside the BVH bounds (rounded outwards,
+    // so queries just visit a few more nodes). Needs mMaxLeafSize <= 60.
+    bool mQuantize = false;
+  };
+
+  struct Intersection
+  {
+    float mDistance = 0.0f;
+    std::size_t mPrimitiveIndex = 0; // Index of the triangle in the span the BVH was built from
+  };
+
+  static constexpr float Infinity = std::numeric_limits<float>::infinity();
+
+  Bvh() = default;
+  explicit Bvh(const Span<Triangle3f>& inTriangles);
+  Bvh(const Span<Triangle3f>& inTriangles, const Bvh::Parameters& inParameters);
+  Bvh(const Bvh& inRHS) = default;
+  Bvh& operator=(const Bvh& inRHS) = default;
+  Bvh(Bvh&& inRHS) = default;
+  Bvh& operator=(Bvh&& inRHS) = default;
+  ~Bvh() = default;
+
+  // Intersections in [0, inMaxDistance] along the ray. Triangles are hit from both sides.
+  std::optional<Bvh::Intersection> IntersectClosest(const Ray3f& inRay, const float inMaxDistance = Infinity) const;
+  bool IntersectCheck(const Ray3f& inRay, const float inMaxDistance = Infinity) const; // Stops at any hit
+  std::vector<Bvh::Intersection> IntersectAll(const Ray3f& inRay, const float inMaxDistance = Infinity) const;
+
+  // One result per ray (IntersectCheck ones are 0 or 1), with the rays split across threads
+  std::vector<std::optional<Bvh::Intersection>> IntersectClosest(const Span<Ray3f>& inRays,
+      const float inMaxDistance = Infinity) const;
+  std::vector<uint8_t> IntersectCheck(const Span<Ray3f>& inRays, const float inMaxDistance = Infinity) const;
+
+  AABoxf GetAABox() const;
+  std::size_t GetNumberOfTriangles() const { return mNumberOfTriangles; }
+  std::size_t GetNumberOfNodes() const { return IsQuantized() ? mQuantizedNodes.size() : mNodes.size(); }
+  bool IsQuantized() const { return !mQuantizedNodes.empty(); }
+
+private:
+  struct Node
+  {
+    float mMin[3];
+    uint32_t mIndex; // Right child for inner nodes (the left one is the next node), first packet for leaves
+    float mMax[3];
+    uint32_t mNumberOfPackets; // 0 for inner nodes
+
+    bool IsLeaf() const { return (mNumberOfPackets != 0); }
+    uint32_t GetIndex() const { return mIndex; }
+    uint32_t GetNumberOfPackets() const { return mNumberOfPackets; }
+  };
+  static_assert(sizeof(Node) == 32);
+
+  struct QuantizedNode
+  {
+    static constexpr uint32_t NumberOfPacketsBits = 4;
+
+    uint16_t mMin[3]; // Steps of mQuantizationScale from mQuantizationOrigin
+    uint16_t mMax[3];
+    uint32_t mIndexAndNumberOfPackets; // As Node, (mIndex << NumberOfPacketsBits) | mNumberOfPackets
+
+    bool IsLeaf() const { return (GetNumberOfPackets() != 0); }
+    uint32_t GetIndex() const { return (mIndexAndNumberOfPackets >> NumberOfPacketsBits); }
+    uint32_t GetNumberOfPackets() const { return (mIndexAndNumberOfPackets & ((1u << NumberOfPacketsBits) - 1u)); }
+  };
+  static_assert(sizeof(QuantizedNode) == 16);
+
+  // Structure of arrays of 4 triangles, as Moller-Trumbore uses them. Unused slots are degenerate, never hit.
+  struct alignas(16) TrianglesPacket
+  {
+    float mVertex0[3][4] = {}; // [axis][triangle]
+    float mEdge1[3][4] = {};   // Vertex 1 - vertex 0
+    float mEdge2[3][4] = {};   // Vertex 2 - vertex 0
+    uint32_t mTrianglesIds[4] = {};
+  };
+
+  std::vector<Bvh::Node> mNodes; // Empty if quantized
+  std::vector<Bvh::QuantizedNode> mQuantizedNodes;
+  std::vector<Bvh::TrianglesPacket> mPackets;
+  Vec3f mMin = Zero<Vec3f>();
+  Vec3f mMax = Zero<Vec3f>();
+  Vec3f mQuantizationOrigin = Zero<Vec3f>();
+  Vec3f mQuantizationScale = Zero<Vec3f>();
+  std::size_t mNumberOfTriangles = 0;
+};
+}
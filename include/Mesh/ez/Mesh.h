@@ -1,15 +1,21 @@
 #pragma once
 
+#include <ez/AAHyperBox.h>
+#include <ez/HyperSphere.h>
 #include <ez/Macros.h>
 #include <ez/Mat.h>
 #include <ez/MathInitializers.h>
 #include <ez/MeshIterators.h>
 #include <ez/Range.h>
+#include <ez/Span.h>
 #include <ez/Triangle.h>
 #include <ez/Vec.h>
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
+#include <mutex>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -23,16 +29,36 @@ public:
   using CornerId = Mesh::Id;
   using FaceId = Mesh::Id;
   using VertexId = Mesh::Id;
+  using EdgeId = Mesh::Id;
+  using Generation = uint64_t;
   using InternalCornerId = uint8_t; // [0, 2];
-  using FaceVerticesIds = Vec3<Mesh::FaceId>;
+  using FaceVerticesIds = std::array<Mesh::VertexId, 3>;
   static constexpr VertexId InvalidId = static_cast<VertexId>(-1);
 
+  // How much each face around a vertex contributes to its corner normals
+  enum class ENormalWeighting
+  {
+    UNIFORM,
+    AREA,
+    ANGLE
+  };
+
+  using CirculatorVertexCornerIds = MeshCirculatorVertexCornerIds<Mesh>;
   using CirculatorVertexNeighborFaceIds = MeshCirculatorVertexNeighborFaceIds<Mesh>;
+  using CirculatorVertexNeighborVertexIds = MeshCirculatorVertexNeighborVertexIds<Mesh>;
 
+  // Unordered pair of vertices, stored sorted
   struct Edge
   {
+    using Key = uint64_t;
+
+    Edge() = default;
     Edge(const Mesh::VertexId& inVertexId0, const Mesh::VertexId& inVertexId1)
-        : mVerticesIds(std::minmax(inVertexId0, inVertexId1))
+        : mVerticesIds { std::min(inVertexId0, inVertexId1), std::max(inVertexId0, inVertexId1) }
+    {
+    }
+    explicit Edge(const Mesh::Edge::Key inKey)
+        : Edge(static_cast<Mesh::VertexId>(inKey >> 32u), static_cast<Mesh::VertexId>(inKey & 0xFFFFFFFFull))
     {
     }
 
@@ -45,38 +71,54 @@ public:
     const Mesh::VertexId& operator[](std::size_t inVertexInternalIdFrom0To1) const
     {
       EXPECTS(inVertexInternalIdFrom0To1 == 0 || inVertexInternalIdFrom0To1 == 1);
-      return inVertexInternalIdFrom0To1 == 0 ? mVerticesIds.first : mVerticesIds.second;
+      return mVerticesIds[inVertexInternalIdFrom0To1];
+    }
+
+    // Both vertices ids packed, the lower one in the high bits: keys sort as edges do
+    Mesh::Edge::Key GetKey() const { return (static_cast<Mesh::Edge::Key>(mVerticesIds[0]) << 32u) | mVerticesIds[1]; }
+
+    // The 64-bit finalizer of MurmurHash3 on the key, so that every bit of both ids reaches every bit of the hash
+    static uint64_t GetKeyHash(const Mesh::Edge::Key inKey)
+    {
+      auto hash = inKey;
+      hash ^= (hash >> 33u);
+      hash *= 0xFF51AFD7ED558CCDull;
+      hash ^= (hash >> 33u);
+      hash *= 0xC4CEB9FE1A85EC53ull;
+      hash ^= (hash >> 33u);
+      return hash;
     }
 
     struct Hash
     {
       std::size_t operator()(const Edge& inEdge) const
       {
-        return std::hash<Mesh::VertexId>()(inEdge[0]) ^ std::hash<Mesh::VertexId>()(inEdge[1]);
+        return static_cast<std::size_t>(Mesh::Edge::GetKeyHash(inEdge.GetKey()));
       }
     };
 
   private:
-    const std::pair<Mesh::VertexId, Mesh::VertexId> mVerticesIds = std::make_pair(Mesh::InvalidId, Mesh::InvalidId);
+    std::array<Mesh::VertexId, 2> mVerticesIds = { Mesh::InvalidId, Mesh::InvalidId };
   };
 
-  struct VertexData
+  // Bounding range [mBegin, mEnd) of the modified element ids
+  struct DirtyRange
   {
-    Mesh::FaceId mFaceId = Mesh::InvalidId;
-    Vec3f mPosition = Zero<Vec3f>();
-  };
+    std::size_t mBegin = 0;
+    std::size_t mEnd = 0;
 
-  struct CornerData
-  {
-    Mesh::CornerId mOppositeCornerId = Mesh::InvalidId;
-    Vec3f mNormal = Zero<Vec3f>();
-    Vec2f mTextureCoordinates = Zero<Vec2f>();
+    bool IsEmpty() const { return (mBegin >= mEnd); }
+    void Add(const std::size_t inBegin, const std::size_t inEnd);
   };
 
-  struct FaceData
+  // Attributes modified since mBeginGeneration: derived data synced at a generation >= mBeginGeneration only needs to
+  // update these ranges (see MeshDrawData::Update). Topology changes, copies and moves start them over.
+  struct DirtyRanges
   {
-    std::array<Mesh::VertexId, 3> mVerticesIds;
-    Vec3f mNormal = Zero<Vec3f>();
+    DirtyRange mVertices; // Positions
+    DirtyRange mCorners;  // Normals and texture coordinates
+    DirtyRange mFaces;    // Normals
+    Mesh::Generation mBeginGeneration = 0;
   };
 
   Mesh() = default;
@@ -90,16 +132,47 @@ public:
   Mesh::FaceId AddFace(const Mesh::VertexId& inFaceVertexId0,
       const Mesh::VertexId& inFaceVertexId1,
       const Mesh::VertexId& inFaceVertexId2);
+
+  // Bulk versions of AddVertex and AddFace, growing every stream once. They return the id of the first new element.
+  Mesh::VertexId AddVertices(const Span<Vec3f>& inPositions);
+  Mesh::FaceId AddFaces(const Span<Mesh::FaceVerticesIds>& inFacesVerticesIds);
+
+  // Replaces the whole mesh with the given streams, moved in without copies. The faces and corners attributes
+  // streams may be empty, meaning all zeros.
+  void SetStreams(std::vector<Vec3f>&& ioVerticesPositions,
+      std::vector<Mesh::FaceVerticesIds>&& ioFacesVerticesIds,
+      std::vector<Vec3f>&& ioFacesNormals = {},
+      std::vector<Vec3f>&& ioCornersNormals = {},
+      std::vector<Vec2f>&& ioCornersTextureCoordinates = {});
+
+  // Capacity for the given total number of vertices and faces, so that adding them one by one does not reallocate
+  void Reserve(const std::size_t inNumberOfVertices, const std::size_t inNumberOfFaces);
+
+  // Normals computed right away and kept as regular attributes (turning the auto normals off)
   void ComputeFaceNormals();
-  void ComputeCornerNormals(const float inMinEdgeAngleToSmooth);
-  void ComputeNormals(const float inMinEdgeAngleToSmooth);
-  void ComputeCornerTable();
+  void ComputeCornerNormals(const float inMinEdgeAngleToSmooth,
+      const Mesh::ENormalWeighting inWeighting = Mesh::ENormalWeighting::UNIFORM);
+  void ComputeNormals(const float inMinEdgeAngleToSmooth,
+      const Mesh::ENormalWeighting inWeighting = Mesh::ENormalWeighting::UNIFORM);
+
+  // Face and corner normals derived from the positions (as ComputeNormals), computed by the first normals read after
+  // every change instead of right away, so that meshes whose normals are never read do not pay for them. Writing or
+  // computing normals explicitly turns them off, and so does replacing the whole mesh (Clear, SetStreams, Read).
+  void SetAutoNormals(const float inMinEdgeAngleToSmooth,
+      const Mesh::ENormalWeighting inWeighting = Mesh::ENormalWeighting::UNIFORM);
+  bool HasAutoNormals() const { return mAutoNormals.has_value(); }
+
+  // The corner table is computed on demand by the queries that need it. This computes it ahead of time.
+  void ComputeCornerTable(const bool inComputeVertexCornersIndex = true);
   void Clear();
 
   void SetVertexPosition(const Mesh::VertexId inVertexId, const Vec3f& inPosition);
   void SetFaceNormal(const Mesh::FaceId inFaceId, const Vec3f& inFaceNormal);
   void SetCornerNormal(const Mesh::CornerId inCornerId, const Vec3f& inCornerNormal);
   void SetCornerTextureCoordinates(const Mesh::CornerId& inCornerId, const Vec2f& inTextureCoordinates);
+  void SetFacesNormals(const Span<Vec3f>& inFacesNormals); // One per face
+  void SetCornersNormals(const Span<Vec3f>& inCornersNormals); // One per corner
+  void SetCornersTextureCoordinates(const Span<Vec2f>& inCornersTextureCoordinates);
   const Vec3f& GetVertexPosition(const Mesh::VertexId& inVertexId) const;
   const Vec3f& GetFaceNormal(const Mesh::CornerId& inCornerId) const;
   Triangle3f GetFaceTriangle(const Mesh::FaceId& inFaceId) const;
@@ -133,41 +206,199 @@ public:
   Mesh::CornerId GetPreviousAdjacentCornerId(const Mesh::CornerId inCornerId) const;
   Mesh::CornerId GetNextAdjacentFaceId(const Mesh::CornerId inCornerId) const;
   Mesh::CornerId GetPreviousAdjacentFaceId(const Mesh::CornerId inCornerId) const;
-  std::vector<Triangle3f> GetTriangles() const;
+
+  // Cached until the positions or the topology change, which invalidates the returned references
+  const std::vector<Triangle3f>& GetTriangles() const;
+  const AABoxf& GetBoundingAABox() const;
+  const Spheref& GetBoundingSphere() const; // Centered on the bounding box
+
+  // Edges shared by more than two faces, found by the corner table. Their corners have no opposite corner.
+  std::vector<Mesh::Edge> GetNonManifoldEdges() const;
+
+  // Edge table, built on demand along with the corner table: one id per distinct edge of the faces, in the order of
+  // their keys. Lookups go through an open addressing hash table on the keys.
+  std::size_t GetNumberOfEdges() const;
+  Span<Mesh::Edge> GetEdges() const;
+  const Mesh::Edge& GetEdge(const Mesh::EdgeId inEdgeId) const;
+  Mesh::EdgeId GetEdgeId(const Mesh::Edge& inEdge) const; // InvalidId if no face has the edge
+  Mesh::EdgeId GetCornerEdgeId(const Mesh::CornerId inCornerId) const; // The edge the corner faces
+
+  // A corner facing the edge, and its opposite corner (InvalidId for boundary and non-manifold edges)
+  std::array<Mesh::CornerId, 2> GetEdgeCornersIds(const Mesh::EdgeId inEdgeId) const;
+  Span<Mesh::EdgeId> GetVertexEdgesIdsSpan(const Mesh::VertexId inVertexId) const;
 
   void Transform(const Mat4f& inTransform);
 
   static bool IsValid(const Mesh::Id inId);
   static bool IsValid(const std::optional<Mesh::Id> inOptionalId);
-  const std::vector<Mesh::VertexData>& GetVerticesData() const;
-  const std::vector<Mesh::CornerData>& GetCornersData() const;
-  const std::vector<Mesh::FaceData>& GetFacesData() const;
+
+  // Attributes are stored as structure of arrays, one contiguous stream per attribute
+  Span<Vec3f> GetVerticesPositions() const;
+  Span<Mesh::FaceId> GetVerticesFaceIds() const;
+  Span<Mesh::CornerId> GetCornersOppositeCornersIds() const;
+  Span<Vec3f> GetCornersNormals() const;
+  Span<Vec2f> GetCornersTextureCoordinates() const;
+  Span<Mesh::FaceVerticesIds> GetFacesVerticesIds() const;
+  Span<Vec3f> GetFacesNormals() const;
+
+  // Write access to whole attribute streams. They bump the generation, so write before the mesh is drawn again.
+  MutableSpan<Vec3f> GetMutableVerticesPositions();
+  MutableSpan<Vec3f> GetMutableCornersNormals();
+  MutableSpan<Vec2f> GetMutableCornersTextureCoordinates();
+  MutableSpan<Vec3f> GetMutableFacesNormals();
+
   std::size_t GetNumberOfFaces() const;
   std::size_t GetNumberOfVertices() const;
   std::size_t GetNumberOfCorners() const;
 
-  // Circulators
-  // CirculatorVertexNeighborFaceIds GetVertexNeighborFaceIdsCirculatorBegin(const Mesh::VertexId inVertexId) const;
-  // CirculatorVertexNeighborFaceIds GetVertexNeighborFaceIdsCirculatorEnd() const;
-  // Range<CirculatorVertexNeighborFaceIds> AllVertexNeighborFaceIds(const Mesh::VertexId inVertexId) const;
+  // Changes every time the streams or the topology are modified (not when derived data is computed). Unique among all
+  // meshes, so (mesh address, generation) identifies a state.
+  Mesh::Generation GetGeneration() const { return mGeneration.mValue; }
+
+  const Mesh::DirtyRanges& GetDirtyRanges() const { return mDirtyRanges.mValue; }
+  void ClearDirtyRanges(); // Once all the derived data has been updated, e.g. at the end of every frame
+
+  // Vertex->corners index (compressed sparse row), built on demand with the corner table. The queries below do not
+  // allocate. HasVertexCornersIndex tells whether it is built already.
+  bool HasVertexCornersIndex() const;
+  Span<Mesh::CornerId> GetVertexCornersIdsSpan(const Mesh::VertexId inVertexId) const;
+
+  // Circulators (on the vertex->corners index)
+  Range<CirculatorVertexCornerIds> AllVertexCornerIds(const Mesh::VertexId inVertexId) const;
+  Range<CirculatorVertexNeighborFaceIds> AllVertexNeighborFaceIds(const Mesh::VertexId inVertexId) const;
+  Range<CirculatorVertexNeighborVertexIds> AllVertexNeighborVertexIds(const Mesh::VertexId inVertexId) const;
 
   std::vector<Mesh::CornerId> GetNeighborCornersIds(const Mesh::VertexId inVertexId) const;
   std::vector<Mesh::VertexId> GetNeighborVerticesIds(const Mesh::VertexId inVertexId) const;
   std::vector<Mesh::FaceId> GetNeighborFacesIds(const Mesh::VertexId inVertexId) const;
   std::vector<Mesh::CornerId> GetVertexCornersIds(const Mesh::VertexId inVertexId) const;
 
-#ifdef MESH_IO
+  // .ezmesh files go through MeshBinaryIO (always available, keeps the vertices ids). Other files are read with
+  // MeshNativeIO if it supports them (OBJ, PLY, binary STL), and otherwise with MeshIO.
   void Read(const std::filesystem::path& inMeshPath);
   void Write(const std::filesystem::path& inMeshPath, const bool inPreserveVerticesIds = false) const;
-#endif
 
 private:
-  bool mCornerTableComputed = false;
-  std::vector<Mesh::VertexData> mVerticesData;
-  std::vector<Mesh::CornerData> mCornersData;
-  std::vector<Mesh::FaceData> mFacesData;
+  friend class MeshBinaryIO; // Read and write the streams as a whole
+
+  // Gets a new value on construction, on every modification and when moved from
+  struct GenerationCounter
+  {
+    GenerationCounter() : mValue(Next()) {}
+    GenerationCounter(const GenerationCounter&) : mValue(Next()) {}
+    GenerationCounter(GenerationCounter&& ioRHS) noexcept : mValue(ioRHS.mValue) { ioRHS.Bump(); }
+    GenerationCounter& operator=(const GenerationCounter&);
+    GenerationCounter& operator=(GenerationCounter&& ioRHS) noexcept;
+
+    void Bump() { mValue = Next(); }
+    static Mesh::Generation Next();
+
+    Mesh::Generation mValue = 0;
+  };
+
+  // Starts over on construction, copy and move. Its begin generation is taken before the mesh one changes.
+  struct DirtyRangesTracker
+  {
+    DirtyRangesTracker() { Reset(); }
+    DirtyRangesTracker(const DirtyRangesTracker&) { Reset(); }
+    DirtyRangesTracker(DirtyRangesTracker&&) noexcept { Reset(); }
+    DirtyRangesTracker& operator=(const DirtyRangesTracker&);
+    DirtyRangesTracker& operator=(DirtyRangesTracker&&) noexcept;
+
+    void Reset();
+
+    Mesh::DirtyRanges mValue;
+  };
+
+  // Data derived from the streams, computed by const queries when missing
+  using DerivedDataFlags = uint32_t;
+  static constexpr DerivedDataFlags CornerTableFlag = (1u << 0); // Opposite corners and non-manifold corners
+  static constexpr DerivedDataFlags VertexCornersIndexFlag = (1u << 1);
+  static constexpr DerivedDataFlags NormalsFlag = (1u << 2); // Only ever missing with auto normals
+  static constexpr DerivedDataFlags TrianglesFlag = (1u << 3);
+  static constexpr DerivedDataFlags BoundsFlag = (1u << 4);
+  static constexpr DerivedDataFlags EdgesFlag = (1u << 5); // Edge table, vertex->edges index and edges hash table
+  static constexpr DerivedDataFlags PositionsDerivedDataFlags = (NormalsFlag | TrianglesFlag | BoundsFlag);
+  static constexpr DerivedDataFlags AllDerivedDataFlags
+      = (CornerTableFlag | VertexCornersIndexFlag | EdgesFlag | PositionsDerivedDataFlags);
+
+  // Which derived data is up to date. Concurrent readers compute what is missing once: the first one computes it under
+  // the mutex while the others wait, and the flags are published after the data. Mutators must not run concurrently
+  // with readers, and just clear the flags of what they invalidate. Copies copy the flags along with the data.
+  struct DerivedDataGuard
+  {
+    DerivedDataGuard() = default;
+    DerivedDataGuard(const DerivedDataGuard& inRHS) : mComputedFlags(inRHS.GetComputedFlags()) {}
+    DerivedDataGuard(DerivedDataGuard&& ioRHS) noexcept;
+    DerivedDataGuard& operator=(const DerivedDataGuard& inRHS);
+    DerivedDataGuard& operator=(DerivedDataGuard&& ioRHS) noexcept;
+
+    Mesh::DerivedDataFlags GetComputedFlags() const { return mComputedFlags.load(std::memory_order_acquire); }
+    bool IsComputed(const Mesh::DerivedDataFlags inFlags) const { return (GetComputedFlags() & inFlags) == inFlags; }
+    void SetComputed(const Mesh::DerivedDataFlags inFlags)
+    {
+      mComputedFlags.fetch_or(inFlags, std::memory_order_release);
+    }
+    void Invalidate(const Mesh::DerivedDataFlags inFlags) { mComputedFlags.fetch_and(~inFlags); }
+
+    std::atomic<Mesh::DerivedDataFlags> mComputedFlags = AllDerivedDataFlags; // All trivially computed when empty
+    std::mutex mMutex;
+  };
+
+  // Every corner with the key of the edge it faces (the one between the other two vertices of its face)
+  using CornersEdgesKeys = std::vector<std::pair<Mesh::Edge::Key, Mesh::CornerId>>;
+
+  struct AutoNormals
+  {
+    float mMinEdgeAngleToSmooth = 0.0f;
+    Mesh::ENormalWeighting mWeighting = Mesh::ENormalWeighting::UNIFORM;
+  };
+
+  DirtyRangesTracker mDirtyRanges; // Before mGeneration, see DirtyRangesTracker
+  GenerationCounter mGeneration;
+  mutable DerivedDataGuard mDerivedData;
+  std::optional<Mesh::AutoNormals> mAutoNormals;
+  std::vector<Vec3f> mVerticesPositions;
+  std::vector<Mesh::FaceId> mVerticesFaceIds;
+  mutable std::vector<Mesh::CornerId> mCornersOppositeCornersIds;
+  mutable std::vector<Vec3f> mCornersNormals;
+  std::vector<Vec2f> mCornersTextureCoordinates;
+  std::vector<Mesh::FaceVerticesIds> mFacesVerticesIds;
+  mutable std::vector<Vec3f> mFacesNormals;
+  mutable std::vector<Mesh::CornerId> mNonManifoldCornersIds; // One corner facing each non-manifold edge
+  mutable std::vector<Mesh::Id> mVertexCornersOffsets;         // Vertex v corners: [offsets[v], offsets[v + 1])
+  mutable std::vector<Mesh::CornerId> mVertexCornersIds;
+  mutable std::vector<Mesh::Edge> mEdges;
+  mutable std::vector<std::array<Mesh::CornerId, 2>> mEdgesCornersIds;
+  mutable std::vector<Mesh::EdgeId> mCornersEdgesIds;
+  mutable std::vector<Mesh::Id> mVertexEdgesOffsets; // Vertex v edges: [offsets[v], offsets[v + 1])
+  mutable std::vector<Mesh::EdgeId> mVertexEdgesIds;
+  mutable std::vector<Mesh::EdgeId> mEdgesHashTable; // Power of two size, linear probing, InvalidId in empty slots
+  mutable std::vector<Triangle3f> mTriangles;
+  mutable AABoxf mBoundingAABox = AABoxf { Zero<Vec3f>(), Zero<Vec3f>() };
+  mutable Spheref mBoundingSphere = Spheref { Zero<Vec3f>(), 0.0f };
+
+  void EnsureDerivedData(const Mesh::DerivedDataFlags inFlags) const
+  {
+    if (!mDerivedData.IsComputed(inFlags))
+      ComputeDerivedData(inFlags);
+  }
+  void ComputeDerivedData(const Mesh::DerivedDataFlags inFlags) const;
+  void InvalidateDerivedData(const Mesh::DerivedDataFlags inFlags);
+  void DisableAutoNormals();
+  Mesh::CornersEdgesKeys GetSortedCornersEdgesKeys() const;
+  void UpdateOppositeCorners(const Mesh::CornersEdgesKeys& inSortedCornersEdgesKeys) const;
+  void UpdateEdges(const Mesh::CornersEdgesKeys& inSortedCornersEdgesKeys) const;
+  void UpdateVertexCornersIndex() const;
+  void UpdateFacesNormals() const;
+  void UpdateCornersNormals(const float inMinEdgeAngleToSmooth, const Mesh::ENormalWeighting inWeighting) const;
+  void UpdateTriangles() const;
+  void UpdateBounds() const;
+  void OnTopologyChanged();
+  float GetCornerNormalWeight(const Mesh::CornerId inCornerId, const Mesh::ENormalWeighting inWeighting) const;
+  const Mesh::CornerId* GetVertexCornersIdsBegin(const Mesh::VertexId inVertexId) const;
+  const Mesh::CornerId* GetVertexCornersIdsEnd(const Mesh::VertexId inVertexId) const;
 };
 
 std::ostream& operator<<(std::ostream& ioLHS, const Mesh::Edge& inRHS);
-std::ostream& operator<<(std::ostream& ioLHS, const Mesh::VertexData& inRHS);
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <ez/MappedFile.h>
+#include <ez/Mesh.h>
+#include <ez/Span.h>
+#include <ez/Vec.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace ez
+{
+// Binary .ezmesh format: the Mesh attribute streams (and its corner table, if computed) stored as they are in memory,
+// so that loading is a memory mapping plus, at most, one copy per stream. Versioned, native little-endian, and with
+// a checksum of the streams. The ids in the streams are not validated element by element (the checksum catches
+// corrupted files, not malformed ones).
+class MeshBinaryIO final
+{
+public:
+  static constexpr std::string_view Extension = ".ezmesh";
+  static constexpr uint32_t Version = 1;
+
+  // Read-only view of the streams of a mapped .ezmesh file, without copies. The spans are valid while it lives.
+  class MappedMesh final
+  {
+  public:
+    MappedMesh() = default;
+
+    Span<Vec3f> GetVerticesPositions() const { return MakeSpan(mVerticesPositions, mNumberOfVertices); }
+    Span<Mesh::FaceId> GetVerticesFaceIds() const { return MakeSpan(mVerticesFaceIds, mNumberOfVertices); }
+    Span<Mesh::CornerId> GetCornersOppositeCornersIds() const
+    {
+      return MakeSpan(mCornersOppositeCornersIds, GetNumberOfCorners());
+    }
+    Span<Vec3f> GetCornersNormals() const { return MakeSpan(mCornersNormals, GetNumberOfCorners()); }
+    Span<Vec2f> GetCornersTextureCoordinates() const
+    {
+      return MakeSpan(mCornersTextureCoordinates, GetNumberOfCorners());
+    }
+    Span<Mesh::FaceVerticesIds> GetFacesVerticesIds() const { return MakeSpan(mFacesVerticesIds, mNumberOfFaces); }
+    Span<Vec3f> GetFacesNormals() const { return MakeSpan(mFacesNormals, mNumberOfFaces); }
+    Span<Mesh::CornerId> GetNonManifoldCornersIds() const
+    {
+      return MakeSpan(mNonManifoldCornersIds, mNumberOfNonManifoldCorners);
+    }
+
+    // Vertex->corners index (see Mesh::GetVertexCornersIdsSpan). Empty if it was not computed.
+    Span<Mesh::Id> GetVertexCornersOffsets() const
+    {
+      return MakeSpan(mVertexCornersOffsets, HasVertexCornersIndex() ? (mNumberOfVertices + 1) : 0);
+    }
+    Span<Mesh::CornerId> GetVertexCornersIds() const
+    {
+      return MakeSpan(mVertexCornersIds, HasVertexCornersIndex() ? GetNumberOfCorners() : 0);
+    }
+
+    std::size_t GetNumberOfVertices() const { return mNumberOfVertices; }
+    std::size_t GetNumberOfFaces() const { return mNumberOfFaces; }
+    std::size_t GetNumberOfCorners() const { return mNumberOfFaces * 3; }
+    bool IsCornerTableComputed() const { return mCornerTableComputed; }
+    bool HasVertexCornersIndex() const { return (mVertexCornersOffsets != nullptr); }
+
+  private:
+    friend class MeshBinaryIO;
+
+    MappedFile mMappedFile;
+    std::size_t mNumberOfVertices = 0;
+    std::size_t mNumberOfFaces = 0;
+    std::size_t mNumberOfNonManifoldCorners = 0;
+    bool mCornerTableComputed = false;
+
+    // Pointers into the mapping
+    const Vec3f* mVerticesPositions = nullptr;
+    const Mesh::FaceId* mVerticesFaceIds = nullptr;
+    const Mesh::CornerId* mCornersOppositeCornersIds = nullptr;
+    const Vec3f* mCornersNormals = nullptr;
+    const Vec2f* mCornersTextureCoordinates = nullptr;
+    const Mesh::FaceVerticesIds* mFacesVerticesIds = nullptr;
+    const Vec3f* mFacesNormals = nullptr;
+    const Mesh::CornerId* mNonManifoldCornersIds = nullptr;
+    const Mesh::Id* mVertexCornersOffsets = nullptr;
+    const Mesh::CornerId* mVertexCornersIds = nullptr;
+  };
+
+  MeshBinaryIO() = delete;
+
+  static void Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath);
+
+  // Copies the mapped streams into ioMesh storage (one copy per stream, no parsing)
+  static void Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh, const bool inVerifyChecksum = true);
+
+  // Maps the file without copying it. Verifying the checksum reads the whole file once.
+  static MeshBinaryIO::MappedMesh Map(const std::filesystem::path& inMeshPath, const bool inVerifyChecksum = true);
+
+  // 64-bit hash of the bytes, chained through inSeed
+  static uint64_t ComputeChecksum(const std::byte* inData, const std::size_t inSize, const uint64_t inSeed = 0);
+};
+}
@@ -4,9 +4,13 @@
 #include <ez/GLGuard.h>
 #include <ez/GLTypeTraits.h>
 #include <ez/Mesh.h>
+#include <ez/MeshletBuilder.h>
 #include <ez/VAO.h>
 #include <ez/VBO.h>
+#include <ez/VertexCacheOptimizer.h>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace ez
 {
@@ -14,15 +18,33 @@ class MeshDrawData final
 {
 public:
   using GLGuardType = GLMultiGuard<VAO>;
-  using EBOIndexType = Mesh::VertexId;
-  static constexpr auto EBOGLIndexType = GLTypeTraits<Mesh::VertexId>::GLType;
 
   static constexpr GL::Id PositionAttribLocation() { return 0; }
   static constexpr GL::Id NormalAttribLocation() { return 1; }
   static constexpr GL::Id TextureCoordinateAttribLocation() { return 2; }
 
+  // How the vertex attributes are laid out in the VBOs. The packed layouts halve the memory and bandwidth per vertex;
+  // a shader drawing them has to decode the octahedral normals (see Mesh.vert), and to transform the positions by
+  // GetPositionsDequantizationMatrix() (Renderer3D does both).
+  enum class EVertexLayout
+  {
+    SEPARATE,    // One VBO per attribute: Vec3f position, Vec3f normal and Vec2f texture coordinates (32 bytes)
+    INTERLEAVED, // The same attributes, interleaved in a single VBO (32 bytes)
+    PACKED,      // Interleaved Vec3f position, octahedral snorm16 normal and half texture coordinates (20 bytes)
+    QUANTIZED    // As PACKED, but with unorm16 positions inside the mesh bounding box (16 bytes)
+  };
+
+  struct OptimizationStatistics
+  {
+    VertexCacheOptimizer::Statistics mBefore;
+    VertexCacheOptimizer::Statistics mAfter;
+  };
+
   MeshDrawData() = default;
-  explicit MeshDrawData(const Mesh& inMesh);
+  explicit MeshDrawData(const Mesh& inMesh,
+      const bool inOptimize = false,
+      const EVertexLayout inVertexLayout = EVertexLayout::SEPARATE,
+      const bool inBuildMeshlets = false);
   MeshDrawData(const MeshDrawData&) = delete;
   MeshDrawData& operator=(const MeshDrawData&) = delete;
   MeshDrawData(MeshDrawData&&) noexcept = default;
@@ -31,8 +53,34 @@ public:
 
   void Bind() const;
   [[nodiscard]] GLGuardType BindGuarded() const;
-  void ComputeFromMesh(const Mesh& inMesh);
+  // inOptimize reorders the triangles and vertices for the vertex cache, overdraw and vertex fetch (slower to build,
+  // faster to draw). Worth it for draw data that is built once and drawn many times.
+  // inBuildMeshlets orders the elements by meshlets (see MeshletBuilder), so that Renderer3D draws only the visible
+  // ones. Worth it for large meshes that are often only partly visible.
+  void ComputeFromMesh(const Mesh& inMesh,
+      const bool inOptimize = false,
+      const EVertexLayout inVertexLayout = EVertexLayout::SEPARATE,
+      const bool inBuildMeshlets = false);
+  // Syncs with inMesh, uploading only the vertices of its dirty ranges (see Mesh::GetDirtyRanges) into the existing
+  // buffers (and refitting the meshlets bounds, if any). Falls back to ComputeFromMesh (with the same options) if
+  // inMesh is not the mesh computed from, if its topology changed, or if the dirty ranges do not cover all the changes
+  // since the last sync.
+  void Update(const Mesh& inMesh);
   std::size_t GetNumberOfElements() const { return mNumberOfElements; }
+  std::size_t GetNumberOfVertices() const { return mNumberOfVertices; } // After welding equal corners
+  GL::EDataType GetIndicesDataType() const { return mIndicesDataType; }  // UNSIGNED_SHORT or UNSIGNED_INT
+  EVertexLayout GetVertexLayout() const { return mVertexLayout; }
+  bool HasOctahedralNormals() const
+  {
+    return (mVertexLayout == EVertexLayout::PACKED || mVertexLayout == EVertexLayout::QUANTIZED);
+  }
+  // Maps the stored positions to model space. Identity but for QUANTIZED.
+  const Mat4f& GetPositionsDequantizationMatrix() const { return mPositionsDequantizationMatrix; }
+  std::size_t GetSizeInBytes() const { return mSizeInBytes; } // GPU memory used by the buffers
+  std::size_t GetLastUploadSizeInBytes() const { return mLastUploadSizeInBytes; } // By the last ComputeFromMesh/Update
+  const std::optional<OptimizationStatistics>& GetOptimizationStatistics() const { return mOptimizationStatistics; }
+  // Ranges of the elements, in model space. Empty if not built.
+  const std::vector<MeshletBuilder::Meshlet>& GetMeshlets() const { return mMeshlets; }
 
   const VAO& GetVAO() const
   {
@@ -43,6 +91,34 @@ public:
 private:
   std::unique_ptr<VAO> mVAO = std::make_unique<VAO>();
   std::size_t mNumberOfElements = 0;
+  std::size_t mNumberOfVertices = 0;
+  GL::EDataType mIndicesDataType = GL::EDataType::UNSIGNED_INT;
+  EVertexLayout mVertexLayout = EVertexLayout::SEPARATE;
+  Mat4f mPositionsDequantizationMatrix = Identity<Mat4f>();
+  Vec3f mPositionsQuantizationMin = Zero<Vec3f>();
+  Vec3f mPositionsQuantizationExtent = Zero<Vec3f>();
+  std::size_t mSizeInBytes = 0;
+  std::size_t mLastUploadSizeInBytes = 0;
+  std::optional<OptimizationStatistics> mOptimizationStatistics;
+  bool mOptimize = false;
+  bool mBuildMeshlets = false;
+  std::vector<MeshletBuilder::Meshlet> mMeshlets;
+  std::vector<uint32_t> mMeshletsIndices; // Copy of the EBO, to refit the meshlets bounds on Update
+
+  // Mesh synced with, and the mapping between its corners and the welded vertices, for Update
+  const Mesh* mMesh = nullptr;
+  Mesh::Generation mMeshGeneration = 0;
+  std::vector<uint32_t> mCornersVerticesIds;
+  std::vector<uint32_t> mVerticesCornersOffsets; // Vertex v corners: [offsets[v], offsets[v + 1])
+  std::vector<Mesh::CornerId> mVerticesCornersIds;
+
+  bool UpdateDirtyVertices(const Mesh& inMesh);
+  void RefitMeshlets(const Mesh& inMesh);
+  void CreateVertexBuffers(const std::size_t inNumberOfVertices);
+  void UploadVertices(const std::size_t inBeginVertexId,
+      const Span<Vec3f>& inVerticesPositions,
+      const Span<Vec3f>& inVerticesNormals,
+      const Span<Vec2f>& inVerticesTextureCoordinates);
 };
 
 }
\ No newline at end of file
@@ -1,19 +1,45 @@
 #pragma once
 
 #ifdef MESH_IO
+#include <ez/Mat.h>
+#include <ez/MathInitializers.h>
+#include <ez/Mesh.h>
+#include <cstddef>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 namespace ez
 {
-class Mesh;
-
 class MeshIO final
 {
 public:
+  // A node of the scene drawing one of its meshes
+  struct SceneInstance
+  {
+    std::size_t mMeshId = 0;              // Index into Scene::mMeshes
+    Mat4f mTransform = Identity<Mat4f>(); // Mesh to scene, composed through all the node ancestors
+    std::string mNodeName;
+  };
+
+  // All the meshes of a file, each stored once no matter how many nodes draw it (meshes with the same contents are
+  // also merged), and the instances placing them in the scene
+  struct Scene
+  {
+    std::vector<Mesh> mMeshes;
+    std::vector<MeshIO::SceneInstance> mInstances;
+  };
+
+  // Reads only the first mesh of the file (see ReadScene)
   static void Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh);
   static void Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath, const bool inPreserveVerticesIds);
 
+  // Converts the meshes in parallel, each one in a single thread (see ParallelSerialGuard), with its face normals and
+  // corner table computed, and with its corner normals computed (with inMinEdgeAngleToSmooth) if the file has none.
+  // Meshes with no triangles are skipped.
+  static MeshIO::Scene ReadScene(const std::filesystem::path& inScenePath, const float inMinEdgeAngleToSmooth);
+
   MeshIO() = delete;
 };
 }
-#endif
\ No newline at end of file
+#endif
@@ -1,53 +1,83 @@
 #pragma once
 
-#include <optional>
+#include <cstddef>
+#include <iterator>
 
 namespace ez
 {
-template <typename TMesh>
-class MeshCirculatorVertexNeighborFaceIds final
+enum class EMeshVertexAdjacency
+{
+  CORNERS,
+  NEIGHBOR_FACES,
+  NEIGHBOR_VERTICES
+};
+
+// Walks the corners of a vertex in the vertex->corners index of the mesh (see Mesh::ComputeCornerTable), yielding the
+// ids of the requested adjacent elements. Never allocates, it is just a pointer into the index.
+template <typename TMesh, EMeshVertexAdjacency TAdjacency>
+class MeshCirculatorVertexAdjacency final
 {
 public:
   using MeshId = typename TMesh::Id;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = MeshId;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const MeshId*;
+  using reference = MeshId;
 
-  MeshCirculatorVertexNeighborFaceIds(const TMesh& inMesh, const MeshId inVertexId)
-      : mMesh(inMesh), mVertexId(inVertexId)
+  MeshCirculatorVertexAdjacency() = default;
+  MeshCirculatorVertexAdjacency(const TMesh& inMesh, const MeshId* inCornerIdIt)
+      : mMesh(&inMesh), mCornerIdIt(inCornerIdIt)
   {
   }
+
   MeshId operator*() const
   {
-    EXPECTS(IsValid());
-    return *Get();
+    const auto corner_id = *mCornerIdIt;
+    if constexpr (TAdjacency == EMeshVertexAdjacency::CORNERS)
+      return corner_id;
+    else if constexpr (TAdjacency == EMeshVertexAdjacency::NEIGHBOR_FACES)
+      return mMesh->GetFaceIdFromCornerId(corner_id);
+    else
+      return mMesh->GetVertexIdFromCornerId(mMesh->GetNextCornerId(corner_id));
+  }
+  MeshCirculatorVertexAdjacency& operator++()
+  {
+    ++mCornerIdIt;
+    return *this;
+  }
+  MeshCirculatorVertexAdjacency operator++(int)
+  {
+    auto previous = *this;
+    ++mCornerIdIt;
+    return previous;
   }
-  void operator++()
+  MeshCirculatorVertexAdjacency& operator--()
   {
-    EXPECTS(IsValid());
-    ++mCurrentNeighborFaceId;
+    --mCornerIdIt;
+    return *this;
   }
-  void operator--()
+  MeshCirculatorVertexAdjacency operator--(int)
   {
-    EXPECTS(IsValid());
-    --mCurrentNeighborFaceId;
+    auto previous = *this;
+    --mCornerIdIt;
+    return previous;
   }
-  bool operator==(const MeshCirculatorVertexNeighborFaceIds& inRHS) const { return (Get() == inRHS.Get()); }
-  bool operator!=(const MeshCirculatorVertexNeighborFaceIds& inRHS) const { return !(*this == inRHS); }
-  bool IsValid() const { return TMesh::IsValid(Get()); }
+  bool operator==(const MeshCirculatorVertexAdjacency& inRHS) const { return (mCornerIdIt == inRHS.mCornerIdIt); }
+  bool operator!=(const MeshCirculatorVertexAdjacency& inRHS) const { return !(*this == inRHS); }
 
 private:
-  const TMesh& mMesh;
-  const MeshId mVertexId = TMesh::InvalidId;
-  MeshId mCurrentNeighborFaceId = 0;
+  const TMesh* mMesh = nullptr;
+  const MeshId* mCornerIdIt = nullptr;
+};
 
-  std::optional<MeshId> Get() const
-  {
-    if (!TMesh::IsValid(mVertexId))
-      return std::nullopt;
+template <typename TMesh>
+using MeshCirculatorVertexCornerIds = MeshCirculatorVertexAdjacency<TMesh, EMeshVertexAdjacency::CORNERS>;
 
-    const auto& vertex_neighbor_faces_ids = mMesh.GetVerticesData().at(mVertexId).mNeighborFacesId;
-    if (mCurrentNeighborFaceId >= vertex_neighbor_faces_ids.size())
-      return std::nullopt;
-    return vertex_neighbor_faces_ids.at(mCurrentNeighborFaceId);
-  }
-};
+template <typename TMesh>
+using MeshCirculatorVertexNeighborFaceIds = MeshCirculatorVertexAdjacency<TMesh, EMeshVertexAdjacency::NEIGHBOR_FACES>;
 
-}
\ No newline at end of file
+template <typename TMesh>
+using MeshCirculatorVertexNeighborVertexIds
+    = MeshCirculatorVertexAdjacency<TMesh, EMeshVertexAdjacency::NEIGHBOR_VERTICES>;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <ez/HyperSphere.h>
+#include <ez/Mesh.h>
+#include <ez/MeshDrawData.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ez
+{
+// Levels of detail of a mesh, drawn as a single mesh (see Renderer3D::DrawMesh). Levels go from the finest to the
+// coarsest, each with its error in model units (as MeshSimplifier::Result::mError: a typical deviation from the
+// original surface, not a bound on it). The level drawn is the coarsest one whose error projects to less than a pixel.
+// The chain remembers the last level selected, for the hysteresis: drawing the same levels with several transforms in
+// the same frame needs a chain per instance (the levels MeshDrawData can be shared).
+class MeshLODChain final
+{
+public:
+  // A level only becomes coarser once its projected error is this fraction below the max, to avoid popping back and
+  // forth between two levels
+  static constexpr float Hysteresis = 0.25f;
+
+  struct Level
+  {
+    std::shared_ptr<const MeshDrawData> mMeshDrawData;
+    float mError = 0.0f;
+  };
+
+  MeshLODChain() = default;
+  // Simplifies inMesh (see MeshSimplifier) into up to inNumberOfLevels levels, each with about inFacesRatio of the
+  // faces of the previous one. The first level is inMesh itself.
+  explicit MeshLODChain(const Mesh& inMesh,
+      const std::size_t inNumberOfLevels = 4,
+      const float inFacesRatio = 0.5f,
+      const bool inOptimize = true,
+      const MeshDrawData::EVertexLayout inVertexLayout = MeshDrawData::EVertexLayout::SEPARATE);
+
+  // Expects the levels added from the finest to the coarsest, with non-decreasing errors
+  void AddLevel(const std::shared_ptr<const MeshDrawData>& inMeshDrawData, const float inError);
+  std::size_t GetNumberOfLevels() const { return mLevels.size(); }
+  const MeshLODChain::Level& GetLevel(const std::size_t inLevelId) const;
+
+  // In model space. Computed by the constructor from a Mesh, to be set if the levels are added by hand.
+  void SetBoundingSphere(const Spheref& inBoundingSphere) { mBoundingSphere = inBoundingSphere; }
+  const Spheref& GetBoundingSphere() const { return mBoundingSphere; }
+
+  // Coarsest level whose error, scaled by inPixelsPerUnit, stays below inMaxScreenError pixels, moving from the last
+  // level selected (with hysteresis). Expects at least one level.
+  std::size_t SelectLevel(const float inPixelsPerUnit, const float inMaxScreenError) const;
+  std::size_t GetLastSelectedLevelId() const { return mLastSelectedLevelId; }
+
+private:
+  std::vector<MeshLODChain::Level> mLevels;
+  Spheref mBoundingSphere;
+  mutable std::size_t mLastSelectedLevelId = 0;
+};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ez/Mesh.h>
+#include <filesystem>
+
+namespace ez
+{
+// Native readers for OBJ, PLY (ASCII and binary) and binary STL, without Assimp. The file is memory-mapped, split
+// into chunks parsed in parallel (see ParallelFor), and the merged streams are moved into the Mesh at once.
+// OBJ polygons and PLY faces are triangulated as fans. The vertices are the OBJ positions, the PLY vertices, or the
+// STL corners welded by equal positions, with the normals and texture coordinates set per corner (as MeshIO does).
+class MeshNativeIO final
+{
+public:
+  MeshNativeIO() = delete;
+
+  // Whether the extension (case insensitive) is one of the formats above
+  static bool IsSupported(const std::filesystem::path& inMeshPath);
+
+  // Returns false, without modifying ioMesh, if the file is not supported natively (unsupported extension, ASCII STL,
+  // or PLY vertices with list properties), so that the caller can fall back to MeshIO. Throws if it is malformed.
+  static bool Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh);
+};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ez/Mesh.h>
+#include <cstddef>
+#include <limits>
+
+namespace ez
+{
+// Quadric error metric edge collapse (Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics",
+// 1997), with half edge collapses so that no new vertices are created. Boundaries and attribute seams (corners with
+// different normals or texture coordinates) are preserved: their vertices only collapse along them, and their ends
+// never move. Collapses that would flip faces or make the mesh non-manifold are skipped.
+class MeshSimplifier final
+{
+public:
+  static constexpr double BoundaryQuadricWeight = 10.0; // Of the planes that keep boundaries and seams in place
+
+  struct Parameters
+  {
+    std::size_t mTargetNumberOfFaces = 0;
+    // Max collapse error, in mesh units: the root of the area weighted mean squared distance from the collapsed
+    // vertex to the planes of the original faces around it. Not a bound on the distance to the original surface.
+    float mMaxError = std::numeric_limits<float>::max();
+    bool mLockBoundaries = false; // Do not collapse boundary vertices at all
+
+    // Independent regions simplified in parallel before the final global pass. 0 picks it from the number of threads
+    // and faces. 1 disables the parallel pass.
+    std::size_t mNumberOfRegions = 0;
+  };
+
+  struct Result
+  {
+    Mesh mMesh; // Compacted, with face normals and corner table computed
+    float mError = 0.0f; // Largest collapse error done, measured as Parameters::mMaxError
+    std::size_t mNumberOfCollapses = 0;
+  };
+
+  MeshSimplifier() = delete;
+
+  // Stops when the target number of faces is reached or the next collapse would exceed the max error.
+  // Computes the corner table of the mesh if missing.
+  static MeshSimplifier::Result Simplify(const Mesh& inMesh, const MeshSimplifier::Parameters& inParameters);
+};
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ez/Mesh.h>
+#include <cstddef>
+
+namespace ez
+{
+// Merges the vertices closer than an epsilon, remaps the faces, and removes the faces left with repeated vertices.
+// Vertices are hashed into a grid of epsilon sized cells, so that only the 27 cells around each vertex are searched,
+// and merged with a concurrent union-find: each group of vertices chained within epsilon becomes its lowest id
+// vertex, keeping its position. Corner attributes and face normals are kept, and vertices without faces too.
+class MeshWelder final
+{
+public:
+  struct Parameters
+  {
+    float mEpsilon = 0.0f; // Max distance between merged vertices. 0 merges only equal positions.
+
+    // Do not merge vertices whose corners have different normals or texture coordinates (more than mSeamEpsilon
+    // apart), so that the split vertices of attribute seams stay split. One corner of each vertex is compared (as
+    // importers set the attributes per vertex).
+    bool mPreserveSeams = false;
+    float mSeamEpsilon = 1.0e-4f;
+  };
+
+  struct Result
+  {
+    std::size_t mNumberOfMergedVertices = 0; // Removed, merged into others
+    std::size_t mNumberOfRemovedFaces = 0;
+  };
+
+  MeshWelder() = delete;
+
+  // Ids change: the corner table and the other derived data are computed again when needed
+  static MeshWelder::Result Weld(Mesh& ioMesh, const MeshWelder::Parameters& inParameters);
+};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <ez/HyperSphere.h>
+#include <ez/Macros.h>
+#include <ez/Mat.h>
+#include <ez/MathInitializers.h>
+#include <ez/Span.h>
+#include <ez/Vec.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ez
+{
+// Meshlets (clusters) of an indexed triangle list: ranges of triangles with few vertices, spatially close, with
+// bounds to cull them (bounding sphere against the view frustum, normal cone against the camera position).
+class MeshletBuilder final
+{
+public:
+  static constexpr std::size_t DefaultMaxNumberOfVertices = 64;
+  static constexpr std::size_t DefaultMaxNumberOfTriangles = 124;
+
+  struct Meshlet
+  {
+    uint32_t mBeginElement = 0; // Range of the meshlet in the indices
+    uint32_t mNumberOfElements = 0;
+    uint32_t mNumberOfVertices = 0;
+    Spheref mBoundingSphere;
+
+    // All the triangles face away from any point p with Dot(Normalized(mConeApex - p), mConeAxis) >= mConeCutoff.
+    // A cutoff of 1 (or more) never culls.
+    Vec3f mConeApex = Zero<Vec3f>();
+    Vec3f mConeAxis = Zero<Vec3f>();
+    float mConeCutoff = 1.0f;
+  };
+
+  // What to cull the meshlets against, in world space
+  struct CullingView
+  {
+    // (normal, distance) of the frustum planes, with normals pointing inwards: p is inside if all
+    // Dot(normal, p) + distance >= 0
+    std::array<Vec4f, 6> mFrustumPlanes;
+    Vec3f mCameraPosition = Zero<Vec3f>();
+  };
+
+  MeshletBuilder() = delete;
+
+  // Reorders the triangles of ioIndices so that the ones of every meshlet are contiguous, and returns the meshlets.
+  // Meshlets grow across adjacent triangles, adding the ones with fewer new vertices first.
+  static std::vector<MeshletBuilder::Meshlet> Build(std::vector<uint32_t>& ioIndices,
+      const Span<Vec3f>& inVerticesPositions,
+      const std::size_t inMaxNumberOfVertices = DefaultMaxNumberOfVertices,
+      const std::size_t inMaxNumberOfTriangles = DefaultMaxNumberOfTriangles);
+
+  // Recomputes the bounding sphere and normal cone of the meshlet, e.g. after its vertices moved
+  static void ComputeBounds(MeshletBuilder::Meshlet& ioMeshlet,
+      const Span<uint32_t>& inIndices,
+      const Span<Vec3f>& inVerticesPositions);
+
+  // Ids of the meshlets, transformed by inTransformMatrix, not outside the frustum nor, if inCullBackFacing, facing
+  // away from the camera. The normal cones are only used if inTransformMatrix has a uniform scale.
+  static void Cull(const Span<MeshletBuilder::Meshlet>& inMeshlets,
+      const MeshletBuilder::CullingView& inCullingView,
+      const Mat4f& inTransformMatrix,
+      const bool inCullBackFacing,
+      std::vector<uint32_t>& outVisibleMeshletsIds);
+};
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ez/Mat.h>
+#include <ez/Span.h>
+#include <ez/Vec.h>
+
+namespace ez
+{
+// Batch transforms of whole Vec3f streams, in place. They use AVX2 when the CPU supports it (scalar otherwise), and
+// are split across threads for big streams.
+
+// Affine transform of points (the last row of the matrix is assumed to be [0, 0, 0, 1])
+void TransformPoints(const MutableSpan<Vec3f>& ioPoints, const Mat4f& inTransform);
+
+// Projective transform of points, dividing by w
+void TransformPointsProjective(const MutableSpan<Vec3f>& ioPoints, const Mat4f& inTransform);
+
+// Transform of normals by a normal matrix (see NormalMat), renormalizing them. Zero normals stay zero.
+void TransformNormals(const MutableSpan<Vec3f>& ioNormals, const Mat4f& inNormalMatrix);
+}
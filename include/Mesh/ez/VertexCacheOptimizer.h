@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ez/Macros.h>
+#include <ez/Span.h>
+#include <ez/Vec.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ez
+{
+// Reorders indexed triangle lists for the GPU: post-transform vertex cache locality (Tipsify), overdraw (clusters
+// sorted front-facing first) and vertex fetch locality (vertices renumbered by first use).
+class VertexCacheOptimizer final
+{
+public:
+  static constexpr std::size_t DefaultCacheSize = 16;
+  static constexpr float DefaultOverdrawThreshold = 1.05f; // Max ACMR increase allowed when splitting clusters
+
+  struct Statistics
+  {
+    std::size_t mNumberOfCacheMisses = 0;
+    float mACMR = 0.0f; // Average cache miss ratio: misses per triangle, in [0.5, 3]
+    float mATVR = 0.0f; // Average transformed vertex ratio: misses per referenced vertex, 1 is optimal
+  };
+
+  VertexCacheOptimizer() = delete;
+
+  // Simulates a FIFO post-transform cache of inCacheSize vertices
+  static Statistics Analyze(const Span<uint32_t>& inIndices,
+      const std::size_t inNumberOfVertices,
+      const std::size_t inCacheSize = DefaultCacheSize);
+
+  static void OptimizeVertexCache(std::vector<uint32_t>& ioIndices,
+      const std::size_t inNumberOfVertices,
+      const std::size_t inCacheSize = DefaultCacheSize);
+
+  // Expects vertex cache optimized indices: splits them into clusters and sorts the clusters so that the ones facing
+  // outwards are drawn first, keeping the ACMR within inThreshold of the input one.
+  static void OptimizeOverdraw(std::vector<uint32_t>& ioIndices,
+      const Span<Vec3f>& inVerticesPositions,
+      const float inThreshold = DefaultOverdrawThreshold,
+      const std::size_t inCacheSize = DefaultCacheSize);
+
+  // Returns the remap from old to new vertex ids (InvalidVertexId for unused vertices), and updates the indices
+  static std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& ioIndices,
+      const std::size_t inNumberOfVertices);
+
+  template <typename T>
+  static void RemapVertices(std::vector<T>& ioVerticesAttribute, const std::vector<uint32_t>& inRemap);
+
+  static constexpr uint32_t InvalidVertexId = static_cast<uint32_t>(-1);
+};
+}
+
+#include "ez/VertexCacheOptimizer.tcc"
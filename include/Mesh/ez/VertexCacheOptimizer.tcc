@@ -0,0 +1,22 @@
+#include <ez/VertexCacheOptimizer.h>
+#include <algorithm>
+
+namespace ez
+{
+template <typename T>
+void VertexCacheOptimizer::RemapVertices(std::vector<T>& ioVerticesAttribute, const std::vector<uint32_t>& inRemap)
+{
+  EXPECTS(ioVerticesAttribute.size() == inRemap.size());
+
+  const auto number_of_used_vertices = static_cast<std::size_t>(
+      std::count_if(inRemap.cbegin(), inRemap.cend(), [](const uint32_t inId) { return inId != InvalidVertexId; }));
+
+  std::vector<T> remapped_vertices_attribute(number_of_used_vertices);
+  for (std::size_t vertex_id = 0; vertex_id < inRemap.size(); ++vertex_id)
+  {
+    if (inRemap[vertex_id] != InvalidVertexId)
+      remapped_vertices_attribute[inRemap[vertex_id]] = std::move(ioVerticesAttribute[vertex_id]);
+  }
+  ioVerticesAttribute = std::move(remapped_vertices_attribute);
+}
+}
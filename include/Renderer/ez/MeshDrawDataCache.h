@@ -0,0 +1,69 @@
+#pragma once
+
+#include <ez/Mesh.h>
+#include <ez/MeshDrawData.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace ez
+{
+// Keeps the MeshDrawData uploaded for the Meshes drawn directly (DrawMesh(const Mesh&)), keyed by Mesh address.
+// A Mesh is only re-uploaded when its generation changed, and then only its dirty ranges when possible (see
+// MeshDrawData::Update). Least recently used entries are evicted past the limits.
+class MeshDrawDataCache final
+{
+public:
+  struct Stats
+  {
+    uint64_t mNumberOfHits = 0;
+    uint64_t mNumberOfUploads = 0;
+    uint64_t mNumberOfEvictions = 0;
+    uint64_t mUploadedSizeInBytes = 0;
+  };
+
+  static constexpr std::size_t DefaultMaxNumberOfEntries = 256;
+  static constexpr std::size_t DefaultMaxSizeInBytes = (256u << 20u);
+
+  explicit MeshDrawDataCache(const std::size_t inMaxNumberOfEntries = DefaultMaxNumberOfEntries,
+      const std::size_t inMaxSizeInBytes = DefaultMaxSizeInBytes);
+  MeshDrawDataCache(const MeshDrawDataCache&) = delete;
+  MeshDrawDataCache& operator=(const MeshDrawDataCache&) = delete;
+
+  std::shared_ptr<const MeshDrawData> Get(const Mesh& inMesh);
+
+  // Eviction hooks, e.g. to release the GPU memory of a Mesh that is not going to be drawn anymore
+  void Evict(const Mesh& inMesh);
+  void Clear();
+
+  void SetMaxNumberOfEntries(const std::size_t inMaxNumberOfEntries);
+  void SetMaxSizeInBytes(const std::size_t inMaxSizeInBytes);
+  std::size_t GetMaxNumberOfEntries() const { return mMaxNumberOfEntries; }
+  std::size_t GetMaxSizeInBytes() const { return mMaxSizeInBytes; }
+  std::size_t GetNumberOfEntries() const { return mEntries.size(); }
+  std::size_t GetSizeInBytes() const { return mSizeInBytes; }
+  const Stats& GetStats() const { return mStats; }
+  void ResetStats() { mStats = Stats {}; }
+
+private:
+  struct Entry
+  {
+    const Mesh* mMesh = nullptr;
+    Mesh::Generation mGeneration = 0;
+    std::shared_ptr<MeshDrawData> mMeshDrawData;
+  };
+  using EntriesList = std::list<Entry>; // Most recently used first
+
+  EntriesList mEntries;
+  std::unordered_map<const Mesh*, EntriesList::iterator> mEntriesMap;
+  std::size_t mSizeInBytes = 0;
+  std::size_t mMaxNumberOfEntries = DefaultMaxNumberOfEntries;
+  std::size_t mMaxSizeInBytes = DefaultMaxSizeInBytes;
+  Stats mStats;
+
+  void EvictIfNeeded();
+  void Evict(const EntriesList::iterator inEntryIt);
+};
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <ez/Mesh.h>
+#include <ez/MeshDrawData.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace ez
+{
+// Cache of the MeshDrawData of the parametric primitives (MeshFactory meshes), so that they are built and uploaded
+// only once per set of tessellation parameters. Least recently used entries are evicted past a memory budget.
+class PrimitiveDrawDataCache final
+{
+public:
+  enum class EPrimitive
+  {
+    BOX,
+    SPHERE,
+    HEMISPHERE,
+    CONE,
+    CYLINDER,
+    CAPSULE,
+    TORUS,
+    PLANE,
+    CIRCLE
+  };
+
+  struct Key
+  {
+    EPrimitive mPrimitive = EPrimitive::BOX;
+    std::size_t mNumLatitudes = 0;
+    std::size_t mNumLongitudes = 0;
+    float mParameter = 0.0f; // Torus hole size, capsule length/radius ratio
+
+    bool operator==(const Key& inRHS) const = default;
+
+    struct Hash
+    {
+      std::size_t operator()(const Key& inKey) const;
+    };
+  };
+
+  struct Stats
+  {
+    uint64_t mNumberOfHits = 0;
+    uint64_t mNumberOfMisses = 0;
+    uint64_t mNumberOfEvictions = 0;
+  };
+
+  static constexpr std::size_t DefaultMaxSizeInBytes = (64u << 20u);
+
+  explicit PrimitiveDrawDataCache(const std::size_t inMaxSizeInBytes = DefaultMaxSizeInBytes);
+  PrimitiveDrawDataCache(const PrimitiveDrawDataCache&) = delete;
+  PrimitiveDrawDataCache& operator=(const PrimitiveDrawDataCache&) = delete;
+
+  std::shared_ptr<const MeshDrawData> Get(const Key& inKey);
+  void Clear();
+
+  void SetMaxSizeInBytes(const std::size_t inMaxSizeInBytes);
+  std::size_t GetMaxSizeInBytes() const { return mMaxSizeInBytes; }
+  std::size_t GetSizeInBytes() const { return mSizeInBytes; }
+  std::size_t GetNumberOfEntries() const { return mEntries.size(); }
+  const Stats& GetStats() const { return mStats; }
+  void ResetStats() { mStats = Stats {}; }
+
+  static Mesh CreateMesh(const Key& inKey);
+
+private:
+  struct Entry
+  {
+    Key mKey;
+    std::shared_ptr<const MeshDrawData> mMeshDrawData;
+  };
+  using EntriesList = std::list<Entry>; // Most recently used first
+
+  EntriesList mEntries;
+  std::unordered_map<Key, EntriesList::iterator, Key::Hash> mEntriesMap;
+  std::size_t mSizeInBytes = 0;
+  std::size_t mMaxSizeInBytes = DefaultMaxSizeInBytes;
+  Stats mStats;
+
+  void EvictIfNeeded();
+};
+}
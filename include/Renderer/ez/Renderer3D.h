@@ -13,6 +13,8 @@
 #include "ez/Material3D.h"
 #include <ez/Math.h>
 #include <ez/MeshDrawData.h>
+#include <ez/MeshLODChain.h>
+#include <ez/MeshletBuilder.h>
 #include <ez/OrthographicCamera.h>
 #include <ez/PerspectiveCamera.h>
 #include <ez/Plane.h>
@@ -79,6 +81,8 @@ public:
   void PopCamera() { mState.Pop<Renderer3D::EStateId::CAMERA>(); }
   void ResetCamera() { mState.Reset<Renderer3D::EStateId::CAMERA>(); }
   void AdaptCameraToWindow(const Window& inWindow);
+  // Frustum and position of the current camera, to cull meshlets. Expects a PerspectiveCamera.
+  MeshletBuilder::CullingView GetMeshletsCullingView() const;
 
   // Transformation
   void SetTransformMatrix(const Mat4f& inTransformMatrix);
@@ -119,15 +123,26 @@ public:
   void PopPointLights() { mState.Pop<Renderer3D::EStateId::POINT_LIGHTS>(); }
   void ResetPointLights() { mState.Reset<Renderer3D::EStateId::POINT_LIGHTS>(); }
 
+  // Level of detail (see DrawMesh(const MeshLODChain&)). Positive biases pick coarser levels, negative ones finer.
+  void SetLODBias(const float inLODBias) { mLODBias = inLODBias; }
+  float GetLODBias() const { return mLODBias; }
+
   // Draw - 3D
   void AdaptToWindow(const Window& inWindow);
   void DrawCustom(const std::function<void()>& inCustomDrawFunction);
   void DrawMesh(const Mesh& inMesh, const RendererGPU::EDrawType inDrawType = RendererGPU::EDrawType::SOLID);
+  // Draw data with meshlets only draws the ones visible from the perspective camera. The ones facing away from it are
+  // only skipped for SOLID draws with cull face enabled.
   void DrawMesh(const MeshDrawData& inMeshDrawData,
       const RendererGPU::EDrawType inDrawType = RendererGPU::EDrawType::SOLID);
+  // Draws the level whose error projects to less than 2^GetLODBias() pixels, from the bounding sphere under the
+  // current transform matrix and the perspective camera. The finest one with other cameras.
+  void DrawMesh(const MeshLODChain& inMeshLODChain,
+      const RendererGPU::EDrawType inDrawType = RendererGPU::EDrawType::SOLID);
   void DrawVAOElements(const VAO& inVAO,
       const GL::Size inNumberOfElementsToDraw,
-      const GL::EPrimitivesType inPrimitivesType = GL::EPrimitivesType::TRIANGLES);
+      const GL::EPrimitivesType inPrimitivesType = GL::EPrimitivesType::TRIANGLES,
+      const GL::EDataType inIndicesDataType = GL::EDataType::UNSIGNED_INT);
   void DrawVAOArrays(const VAO& inVAO,
       const GL::Size inNumberOfPrimitivesToDraw,
       const GL::EPrimitivesType inPrimitivesType = GL::EPrimitivesType::TRIANGLES,
@@ -218,7 +233,6 @@ private:
   static std::shared_ptr<ShaderProgram> sOnlyColorShaderProgram;
   static std::shared_ptr<ShaderProgram> sMeshShaderProgram;
   static std::shared_ptr<ShaderProgram> sTextShaderProgram;
-  static std::shared_ptr<MeshDrawData> sCone;
 
   // State
   State mState { *this };
@@ -229,6 +243,12 @@ private:
   UBO mDirectionalLightsUBO;
   UBO mPointLightsUBO;
 
+  float mLODBias = 0.0f;
+  std::vector<uint32_t> mVisibleMeshletsIds; // Reused by DrawMesh
+
+  // MeshDrawData being drawn by DrawMesh, whose vertex layout has to be decoded (see MeshDrawData::EVertexLayout)
+  const MeshDrawData* mMeshDrawDataBeingDrawn = nullptr;
+
   // DrawSetup3D
   struct DrawSetup3D : public DrawSetup
   {
@@ -9,15 +9,18 @@
 #include "ez/Material3D.h"
 #include <ez/Math.h>
 #include <ez/MeshDrawData.h>
+#include <ez/MeshDrawDataCache.h>
 #include <ez/OrthographicCamera.h>
 #include <ez/PerspectiveCamera.h>
 #include <ez/Plane.h>
 #include <ez/PointLight.h>
+#include <ez/PrimitiveDrawDataCache.h>
 #include <ez/RenderTarget.h>
 #include <ez/Renderer.h>
 #include <ez/RendererStateStacks.h>
 #include <ez/Segment.h>
 #include <ez/ShaderProgram.h>
+#include <ez/StreamingVBO.h>
 #include "ez/Texture2D.h"
 #include <ez/Triangle.h>
 #include <ez/UBO.h>
@@ -201,6 +204,16 @@ public:
   State& GetState() { return mState; }
   const State& GetState() const { return mState; }
 
+  // Transient geometry streaming stats (DrawTriangles, DrawSegments, DrawPoints, ...)
+  static const StreamingVBO::Stats& GetStreamingVBOStats() { return sStreamingVBO->GetStats(); }
+  static void ResetStreamingVBOStats() { sStreamingVBO->ResetStats(); }
+
+  // Cached MeshDrawData of the parametric primitives (DrawSphere, DrawCylinder, DrawAABox, ...)
+  static PrimitiveDrawDataCache& GetPrimitiveDrawDataCache() { return *sPrimitiveDrawDataCache; }
+
+  // MeshDrawData uploaded for the Meshes passed to DrawMesh(const Mesh&), re-uploaded only when they change
+  static MeshDrawDataCache& GetMeshDrawDataCache() { return *sMeshDrawDataCache; }
+
 protected:
   // Shader
   void SetShaderProgram(const std::shared_ptr<ShaderProgram>& inShaderProgram) { mShaderProgram = inShaderProgram; }
@@ -216,9 +229,14 @@ protected:
   void DrawMesh(const Mesh& inMesh, const RendererGPU::EDrawType inDrawType = RendererGPU::EDrawType::SOLID);
   void DrawMesh(const MeshDrawData& inMeshDrawData,
       const RendererGPU::EDrawType inDrawType = RendererGPU::EDrawType::SOLID);
+  // Draws only the given meshlets of the draw data (see MeshDrawData::GetMeshlets), in a single draw call
+  void DrawMeshlets(const MeshDrawData& inMeshDrawData,
+      const Span<uint32_t>& inMeshletsIds,
+      const RendererGPU::EDrawType inDrawType = RendererGPU::EDrawType::SOLID);
   void DrawVAOElements(const VAO& inVAO,
       const GL::Size inNumberOfElementsToDraw,
-      const GL::EPrimitivesType inPrimitivesType = GL::EPrimitivesType::TRIANGLES);
+      const GL::EPrimitivesType inPrimitivesType = GL::EPrimitivesType::TRIANGLES,
+      const GL::EDataType inIndicesDataType = GL::EDataType::UNSIGNED_INT);
   void DrawVAOArrays(const VAO& inVAO,
       const GL::Size inNumberOfPrimitivesToDraw,
       const GL::EPrimitivesType inPrimitivesType = GL::EPrimitivesType::TRIANGLES,
@@ -227,7 +245,12 @@ protected:
       const GL::Size inNumberOfElementsToDraw,
       const GL::EPrimitivesType inPrimitivesType,
       const bool inDrawArrays,
-      const GL::Size inBeginArraysPrimitiveIndex);
+      const GL::Size inBeginArraysPrimitiveIndex,
+      const GL::EDataType inIndicesDataType = GL::EDataType::UNSIGNED_INT);
+  static std::shared_ptr<const MeshDrawData> GetPrimitiveDrawData(const PrimitiveDrawDataCache::EPrimitive inPrimitive,
+      const std::size_t inNumLatitudes = 0,
+      const std::size_t inNumLongitudes = 0,
+      const float inParameter = 0.0f);
   template <typename T, std::size_t N>
   void DrawCircleSectionGeneric(const AngleRads<T> inAngle, std::size_t inNumVertices);
   template <typename T, std::size_t N>
@@ -242,6 +265,10 @@ protected:
   void DrawPointsGeneric(const Span<Vec<T, N>>& inPoints);
   template <typename T, std::size_t N>
   void DrawLineStripGeneric(const Span<Vec<T, N>>& inLinePoints);
+  template <typename T, std::size_t N>
+  void DrawStreamedPositionsGeneric(const Span<Vec<T, N>>& inPositions, const GL::EPrimitivesType inPrimitivesType);
+  template <typename T, std::size_t N>
+  static const StreamingVBO::VertexFormat& GetStreamingPositionsVertexFormat();
 
   // DrawSetup
   class DrawSetup
@@ -273,6 +300,9 @@ protected:
 private:
   // Static resources
   static bool sStaticResourcesInited;
+  static std::unique_ptr<StreamingVBO> sStreamingVBO; // Shared by all the Draw*Generic, one VAO per vertex format
+  static std::unique_ptr<PrimitiveDrawDataCache> sPrimitiveDrawDataCache;
+  static std::unique_ptr<MeshDrawDataCache> sMeshDrawDataCache;
 
   // State
   State mState { *this };
@@ -1,6 +1,9 @@
 #include <ez/Renderer.h>
+#include <ez/StreamingVBO.h>
 #include <ez/VAO.h>
+#include <ez/VAOVertexAttrib.h>
 #include <ez/VBO.h>
+#include <cstring>
 
 namespace ez
 {
@@ -56,57 +59,113 @@ void RendererGPU::DrawCircleSectionBoundaryGeneric(const AngleRads<T> inAngle, s
 template <typename T, std::size_t N>
 void RendererGPU::DrawTrianglesGeneric(const Span<Triangle<T, N>>& inTriangles)
 {
-  VAO vao;
-  vao.AddVBO(std::make_shared<VBO>(inTriangles), MeshDrawData::PositionAttribLocation(), VAOVertexAttribT<Vec<T, N>>());
+  using VertexType = Vec<T, N>;
   constexpr auto add_normals = (N == 3);
-  if constexpr (add_normals)
+  constexpr auto vertex_stride = (add_normals ? 2 : 1) * sizeof(VertexType);
+
+  const auto number_of_vertices = inTriangles.GetNumberOfElements() * 3;
+  if (number_of_vertices == 0)
+    return;
+
+  // Positions and normals (if any) interleaved
+  static const auto TrianglesVertexFormat = []()
   {
-    std::vector<Vec<T, N>> normals;
-    normals.reserve(inTriangles.GetNumberOfElements());
-    for (const auto& triangle : inTriangles) { normals.push_back(Normal(triangle)); }
+    StreamingVBO::VertexFormat vertex_format;
+    vertex_format.emplace_back(MeshDrawData::PositionAttribLocation(), VAOVertexAttribT<VertexType>(vertex_stride));
+    if constexpr (add_normals)
+    {
+      vertex_format.emplace_back(MeshDrawData::NormalAttribLocation(),
+          VAOVertexAttribT<VertexType>(vertex_stride, false, sizeof(VertexType)));
+    }
+    return vertex_format;
+  }();
 
-    vao.AddVBO(std::make_shared<VBO>(MakeSpan(normals)),
-        MeshDrawData::NormalAttribLocation(),
-        VAOVertexAttribT<Vec<T, N>>());
+  const auto allocation = sStreamingVBO->Allocate(number_of_vertices * vertex_stride, vertex_stride);
+  auto vertices_data = static_cast<VertexType*>(allocation.mData);
+  for (const auto& triangle : inTriangles)
+  {
+    if constexpr (add_normals)
+    {
+      const auto normal = Normal(triangle);
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        *(vertices_data++) = triangle[i];
+        *(vertices_data++) = normal;
+      }
+    }
+    else
+    {
+      for (std::size_t i = 0; i < 3; ++i) { *(vertices_data++) = triangle[i]; }
+    }
   }
 
-  DrawVAOArrays(vao, inTriangles.GetNumberOfElements() * 3, GL::EPrimitivesType::TRIANGLES, 0);
+  DrawVAOArrays(sStreamingVBO->GetVAO(TrianglesVertexFormat),
+      number_of_vertices,
+      GL::EPrimitivesType::TRIANGLES,
+      allocation.mBeginVertex);
 }
 
 template <typename T, std::size_t N>
 void RendererGPU::DrawSegmentsGeneric(const Span<Segment<T, N>>& inSegments)
 {
-  std::vector<Vec<T, N>> segment_points;
-  segment_points.reserve(inSegments.GetNumberOfElements() * 2);
+  using VertexType = Vec<T, N>;
+  constexpr auto vertex_stride = sizeof(VertexType);
+
+  const auto number_of_vertices = inSegments.GetNumberOfElements() * 2;
+  if (number_of_vertices == 0)
+    return;
+
+  const auto allocation = sStreamingVBO->Allocate(number_of_vertices * vertex_stride, vertex_stride);
+  auto vertices_data = static_cast<VertexType*>(allocation.mData);
   for (const auto& segment : inSegments)
   {
-    segment_points.push_back(segment.GetOrigin());
-    segment_points.push_back(segment.GetDestiny());
+    *(vertices_data++) = segment.GetOrigin();
+    *(vertices_data++) = segment.GetDestiny();
   }
 
-  VAO vao;
-  vao.AddVBO(std::make_shared<VBO>(MakeSpan(segment_points)),
-      MeshDrawData::PositionAttribLocation(),
-      VAOVertexAttribT<Vec<T, N>>());
-  DrawVAOArrays(vao, segment_points.size(), GL::EPrimitivesType::LINES);
+  DrawVAOArrays(sStreamingVBO->GetVAO(GetStreamingPositionsVertexFormat<T, N>()),
+      number_of_vertices,
+      GL::EPrimitivesType::LINES,
+      allocation.mBeginVertex);
 }
 
 template <typename T, std::size_t N>
 void RendererGPU::DrawPointsGeneric(const Span<Vec<T, N>>& inPoints)
 {
-  VAO vao;
-  vao.AddVBO(std::make_shared<VBO>(inPoints), MeshDrawData::PositionAttribLocation(), VAOVertexAttribT<Vec<T, N>>());
-  DrawVAOArrays(vao, inPoints.GetNumberOfElements(), GL::EPrimitivesType::POINTS);
+  DrawStreamedPositionsGeneric(inPoints, GL::EPrimitivesType::POINTS);
 }
 
 template <typename T, std::size_t N>
 void RendererGPU::DrawLineStripGeneric(const Span<Vec<T, N>>& inLinePoints)
 {
-  VAO vao;
-  vao.AddVBO(std::make_shared<VBO>(inLinePoints),
-      MeshDrawData::PositionAttribLocation(),
-      VAOVertexAttribT<Vec<T, N>>());
-  DrawVAOArrays(vao, inLinePoints.GetNumberOfElements(), GL::EPrimitivesType::LINE_STRIP);
+  DrawStreamedPositionsGeneric(inLinePoints, GL::EPrimitivesType::LINE_STRIP);
+}
+
+template <typename T, std::size_t N>
+void RendererGPU::DrawStreamedPositionsGeneric(const Span<Vec<T, N>>& inPositions,
+    const GL::EPrimitivesType inPrimitivesType)
+{
+  constexpr auto vertex_stride = sizeof(Vec<T, N>);
+
+  const auto number_of_vertices = inPositions.GetNumberOfElements();
+  if (number_of_vertices == 0)
+    return;
+
+  const auto allocation = sStreamingVBO->Allocate(number_of_vertices * vertex_stride, vertex_stride);
+  std::memcpy(allocation.mData, inPositions.GetData(), number_of_vertices * vertex_stride);
+
+  DrawVAOArrays(sStreamingVBO->GetVAO(GetStreamingPositionsVertexFormat<T, N>()),
+      number_of_vertices,
+      inPrimitivesType,
+      allocation.mBeginVertex);
+}
+
+template <typename T, std::size_t N>
+const StreamingVBO::VertexFormat& RendererGPU::GetStreamingPositionsVertexFormat()
+{
+  static const auto PositionsVertexFormat
+      = StreamingVBO::VertexFormat { { MeshDrawData::PositionAttribLocation(), VAOVertexAttribT<Vec<T, N>>() } };
+  return PositionsVertexFormat;
 }
 
 template <RendererGPU::EStateId StateId>
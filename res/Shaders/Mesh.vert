@@ -7,6 +7,7 @@ uniform mat4 UNormal;
 uniform mat4 UView;
 uniform mat4 UProjection;
 uniform mat4 UProjectionViewModel;
+uniform bool UOctahedralNormals; // Normals packed in in_model_normal.xy (see MeshDrawData::EVertexLayout)
 
 layout(location = 0) in vec3 in_model_position;
 layout(location = 1) in vec3 in_model_normal;
@@ -16,10 +17,20 @@ layout(location = 0) out vec3 out_world_position;
 layout(location = 1) out vec3 out_world_normal;
 layout(location = 2) out vec2 out_texture_coordinate;
 
+vec3 DecodeOctahedral(vec2 inEncoded)
+{
+  vec3 decoded = vec3(inEncoded, 1.0 - abs(inEncoded.x) - abs(inEncoded.y));
+  const float t = max(-decoded.z, 0.0);
+  decoded.xy += mix(vec2(t), vec2(-t), greaterThanEqual(decoded.xy, vec2(0.0)));
+  return normalize(decoded);
+}
+
 void main()
 {
+  const vec3 model_normal = (UOctahedralNormals ? DecodeOctahedral(in_model_normal.xy) : in_model_normal);
+
   out_world_position = (UModel * vec4(in_model_position, 1)).xyz;
-  out_world_normal = normalize((UNormal * vec4(in_model_normal, 0)).xyz);
+  out_world_normal = normalize((UNormal * vec4(model_normal, 0)).xyz);
   out_texture_coordinate = in_model_texture_coordinate;
 
   gl_Position = UProjectionViewModel * vec4(in_model_position, 1.0);
@@ -7,6 +7,7 @@
 #include <ez/Mesh.h>
 #include <fstream>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 namespace ez
@@ -168,8 +169,14 @@ Mesh Font::GetTextMesh(const std::string_view inText,
     }
   }
 
-  // Build mesh
-  Mesh text_mesh;
+  // Build mesh, 4 vertices and 2 faces per character
+  std::vector<Vec3f> vertices_positions;
+  std::vector<Mesh::FaceVerticesIds> faces_vertices_ids;
+  std::vector<Vec2f> corners_texture_coordinates;
+  vertices_positions.reserve(inText.size() * 4);
+  faces_vertices_ids.reserve(inText.size() * 2);
+  corners_texture_coordinates.reserve(inText.size() * 6);
+
   const auto alignment_offset = GetAlignmentOffset(text_rect, num_text_lines, inHAlignment, inVAlignment);
   for (std::size_t i = 0; i < inText.size(); ++i)
   {
@@ -177,30 +184,31 @@ Mesh Font::GetTextMesh(const std::string_view inText,
     const auto& character_rect = Translated(character_rects[i], alignment_offset);
 
     for (const auto& character_rect_point : MakePointsRange(character_rect))
-    { text_mesh.AddVertex(XY0(character_rect_point)); }
+    { vertices_positions.push_back(XY0(character_rect_point)); }
 
-    const auto i4 = i * 4;
-    const auto face_id_0 = text_mesh.AddFace(i4, i4 + 2, i4 + 1);
-    const auto face_id_1 = text_mesh.AddFace(i4 + 1, i4 + 2, i4 + 3);
+    const auto i4 = static_cast<Mesh::VertexId>(i * 4);
+    faces_vertices_ids.push_back({ i4, i4 + 2, i4 + 1 });
+    faces_vertices_ids.push_back({ i4 + 1, i4 + 2, i4 + 3 });
 
     const auto character_texture_coordinates_rect = GetCharacterAtlasTextureCoordinatesRect(character);
     const auto& cr = character_texture_coordinates_rect;
-
-    text_mesh.SetCornerTextureCoordinates(text_mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_0, 0),
-        Vec2f(cr.GetMin()[0], cr.GetMax()[1]));
-    text_mesh.SetCornerTextureCoordinates(text_mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_0, 1),
-        Vec2f(cr.GetMax()[0], cr.GetMax()[1]));
-    text_mesh.SetCornerTextureCoordinates(text_mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_0, 2),
-        Vec2f(cr.GetMin()[0], cr.GetMin()[1]));
-
-    text_mesh.SetCornerTextureCoordinates(text_mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_1, 0),
-        Vec2f(cr.GetMin()[0], cr.GetMin()[1]));
-    text_mesh.SetCornerTextureCoordinates(text_mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_1, 1),
-        Vec2f(cr.GetMax()[0], cr.GetMax()[1]));
-    text_mesh.SetCornerTextureCoordinates(text_mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_1, 2),
-        Vec2f(cr.GetMax()[0], cr.GetMin()[1]));
+    corners_texture_coordinates.insert(corners_texture_coordinates.end(),
+        {
+            Vec2f(cr.GetMin()[0], cr.GetMax()[1]), // Face 0
+            Vec2f(cr.GetMax()[0], cr.GetMax()[1]),
+            Vec2f(cr.GetMin()[0], cr.GetMin()[1]),
+            Vec2f(cr.GetMin()[0], cr.GetMin()[1]), // Face 1
+            Vec2f(cr.GetMax()[0], cr.GetMax()[1]),
+            Vec2f(cr.GetMax()[0], cr.GetMin()[1]),
+        });
   }
 
+  Mesh text_mesh;
+  text_mesh.SetStreams(std::move(vertices_positions),
+      std::move(faces_vertices_ids),
+      {},
+      {},
+      std::move(corners_texture_coordinates));
   return text_mesh;
 }
 
@@ -1,39 +1,294 @@
 #include <ez/GL.h>
+#include <GLFW/glfw3.h>
+#include <array>
+#include <optional>
 
 namespace ez
 {
+namespace
+{
+struct GLStateCache
+{
+  static constexpr std::size_t NumberOfBindingTypes = 13;
+  static constexpr std::size_t NumberOfEnablables = 4;
+
+  std::array<std::optional<GL::Id>, NumberOfBindingTypes> mBoundIds;
+  std::array<std::optional<bool>, NumberOfEnablables> mEnabled;
+  std::optional<bool> mDepthMask;
+  std::optional<GL::EDepthFunc> mDepthFunc;
+  std::optional<GL::BlendFactors> mBlendFactors;
+  std::optional<float> mPointSize;
+  std::optional<float> mLineWidth;
+  std::optional<std::array<GL::Int, 4>> mViewport;
+};
+
+// GL state belongs to the context: the cache is started over whenever the thread finds another context current than
+// the one it was filled for (e.g. after glfwMakeContextCurrent with another window)
+struct ThreadGLStateCache
+{
+  GLFWwindow* mContext = nullptr;
+  GLStateCache mStateCache;
+#ifndef NDEBUG
+  bool mCheckEnabled = true;
+#else
+  bool mCheckEnabled = false;
+#endif
+};
+
+thread_local ThreadGLStateCache sThreadStateCache;
+
+GLStateCache& GetStateCache()
+{
+  const auto current_context = glfwGetCurrentContext();
+  if (current_context != sThreadStateCache.mContext)
+  {
+    sThreadStateCache.mContext = current_context;
+    sThreadStateCache.mStateCache = GLStateCache {};
+  }
+  return sThreadStateCache.mStateCache;
+}
+
+std::size_t GetStateCacheIndex(const GL::EBindingType inBindingType)
+{
+  switch (inBindingType)
+  {
+  case GL::EBindingType::ARRAY_BUFFER:
+    return 0;
+  case GL::EBindingType::CURRENT_PROGRAM:
+    return 1;
+  case GL::EBindingType::ELEMENT_ARRAY:
+    return 2;
+  case GL::EBindingType::FRAMEBUFFER:
+    return 3;
+  case GL::EBindingType::RENDERBUFFER:
+    return 4;
+  case GL::EBindingType::TEXTURE_1D:
+    return 5;
+  case GL::EBindingType::TEXTURE_1D_ARRAY:
+    return 6;
+  case GL::EBindingType::TEXTURE_2D:
+    return 7;
+  case GL::EBindingType::TEXTURE_2D_ARRAY:
+    return 8;
+  case GL::EBindingType::TEXTURE_3D:
+    return 9;
+  case GL::EBindingType::UNIFORM_BUFFER:
+    return 10;
+  case GL::EBindingType::SHADER_STORAGE_BUFFER:
+    return 11;
+  case GL::EBindingType::VERTEX_ARRAY:
+    return 12;
+  }
+  assert(false);
+  return 0;
+}
+
+std::size_t GetStateCacheIndex(const GL::EEnablable inEnablable)
+{
+  switch (inEnablable)
+  {
+  case GL::EEnablable::DEPTH_TEST:
+    return 0;
+  case GL::EEnablable::CULL_FACE:
+    return 1;
+  case GL::EEnablable::BLEND:
+    return 2;
+  case GL::EEnablable::LINE_SMOOTH:
+    return 3;
+  }
+  assert(false);
+  return 0;
+}
+
+std::optional<GL::EBindingType> GetTextureBindingType(const GL::ETextureTarget inTextureTarget)
+{
+  switch (inTextureTarget)
+  {
+  case GL::ETextureTarget::TEXTURE_1D:
+    return GL::EBindingType::TEXTURE_1D;
+  case GL::ETextureTarget::TEXTURE_1D_ARRAY:
+    return GL::EBindingType::TEXTURE_1D_ARRAY;
+  case GL::ETextureTarget::TEXTURE_2D:
+    return GL::EBindingType::TEXTURE_2D;
+  case GL::ETextureTarget::TEXTURE_2D_ARRAY:
+    return GL::EBindingType::TEXTURE_2D_ARRAY;
+  case GL::ETextureTarget::TEXTURE_3D:
+    return GL::EBindingType::TEXTURE_3D;
+  default:
+    break;
+  }
+  return std::nullopt;
+}
+
+template <typename T, typename TQueryFunction>
+void CheckCachedValue(const T& inCachedValue, const TQueryFunction& inQueryFunction)
+{
+  if (!sThreadStateCache.mCheckEnabled)
+    return;
+
+  if (!(inCachedValue == inQueryFunction()))
+    THROW_EXCEPTION("GL state cache is out of sync with the GL context. Was some state modified with raw gl* calls?");
+}
 
-void GL::Enable(const GL::EEnablable inEnablable) { glEnable(GL::EnumCast(inEnablable)); }
+// Returns the cached value, querying GL only if it is not known yet
+template <typename T, typename TQueryFunction>
+T GetCachedValue(std::optional<T>& ioCachedValue, const TQueryFunction& inQueryFunction)
+{
+  if (ioCachedValue.has_value())
+    CheckCachedValue(*ioCachedValue, inQueryFunction);
+  else
+    ioCachedValue = inQueryFunction();
+  return *ioCachedValue;
+}
+
+// Returns whether the value changed, that is, whether the actual GL call needs to be done
+template <typename T, typename TQueryFunction>
+bool UpdateCachedValue(std::optional<T>& ioCachedValue, const T& inNewValue, const TQueryFunction& inQueryFunction)
+{
+  if (ioCachedValue.has_value())
+  {
+    CheckCachedValue(*ioCachedValue, inQueryFunction);
+    if (*ioCachedValue == inNewValue)
+      return false;
+  }
+  ioCachedValue = inNewValue;
+  return true;
+}
+
+GL::Id QueryBoundGLId(const GL::EBindingType inBindingType)
+{
+  return GL::GetInteger(static_cast<GL::EGetEnum>(inBindingType));
+}
+
+bool UpdateCachedBoundGLId(const GL::EBindingType inBindingType, const GL::Id inId)
+{
+  return UpdateCachedValue(GetStateCache().mBoundIds[GetStateCacheIndex(inBindingType)],
+      inId,
+      [&]() { return QueryBoundGLId(inBindingType); });
+}
+
+void InvalidateCachedBoundGLId(const GL::EBindingType inBindingType)
+{
+  GetStateCache().mBoundIds[GetStateCacheIndex(inBindingType)] = std::nullopt;
+}
+
+void ResetCachedBoundGLIdIfEqual(const GL::EBindingType inBindingType, const GL::Id inDeletedId)
+{
+  auto& cached_bound_id = GetStateCache().mBoundIds[GetStateCacheIndex(inBindingType)];
+  if (cached_bound_id == inDeletedId)
+    cached_bound_id = 0; // Deleting a bound object reverts the binding to 0
+}
+
+void InvalidateCachedTextureBindings()
+{
+  InvalidateCachedBoundGLId(GL::EBindingType::TEXTURE_1D);
+  InvalidateCachedBoundGLId(GL::EBindingType::TEXTURE_1D_ARRAY);
+  InvalidateCachedBoundGLId(GL::EBindingType::TEXTURE_2D);
+  InvalidateCachedBoundGLId(GL::EBindingType::TEXTURE_2D_ARRAY);
+  InvalidateCachedBoundGLId(GL::EBindingType::TEXTURE_3D);
+}
+
+GL::EDepthFunc QueryDepthFunc() { return static_cast<GL::EDepthFunc>(GL::GetInteger(GL::EGetEnum::DEPTH_FUNC)); }
+
+bool QueryDepthMask() { return GL::GetBoolean(GL::EGetEnum::DEPTH_WRITEMASK); }
+
+GL::BlendFactors QueryBlendFactors()
+{
+  GL::BlendFactors blend_factors;
+  blend_factors.mSourceBlendFactorRGB = static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_SRC_RGB));
+  blend_factors.mDestBlendFactorRGB = static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_DST_RGB));
+  blend_factors.mSourceBlendFactorAlpha = static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_SRC_ALPHA));
+  blend_factors.mDestBlendFactorAlpha = static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_DST_ALPHA));
+  return blend_factors;
+}
+}
+
+void GL::InvalidateStateCache() { GetStateCache() = GLStateCache {}; }
+
+void GL::SetStateCacheCheckEnabled(const bool inStateCacheCheckEnabled)
+{
+  sThreadStateCache.mCheckEnabled = inStateCacheCheckEnabled;
+}
 
-void GL::Disable(const GL::EEnablable inEnablable) { glDisable(GL::EnumCast(inEnablable)); }
+bool GL::IsStateCacheCheckEnabled() { return sThreadStateCache.mCheckEnabled; }
+
+GL::Id GL::GetBoundGLId(const GL::EBindingType inBindingType)
+{
+  return GetCachedValue(GetStateCache().mBoundIds[GetStateCacheIndex(inBindingType)],
+      [&]() { return QueryBoundGLId(inBindingType); });
+}
+
+void GL::Enable(const GL::EEnablable inEnablable) { GL::SetEnabled(inEnablable, true); }
+
+void GL::Disable(const GL::EEnablable inEnablable) { GL::SetEnabled(inEnablable, false); }
 
 void GL::SetEnabled(const GL::EEnablable inEnablable, const bool inEnabled)
 {
+  if (!UpdateCachedValue(GetStateCache().mEnabled[GetStateCacheIndex(inEnablable)],
+          inEnabled,
+          [&]() { return (glIsEnabled(GL::EnumCast(inEnablable)) != 0); }))
+    return;
+
   if (inEnabled)
-    GL::Enable(inEnablable);
+    glEnable(GL::EnumCast(inEnablable));
   else
-    GL::Disable(inEnablable);
+    glDisable(GL::EnumCast(inEnablable));
 }
 
-bool GL::IsEnabled(const GL::EEnablable inEnablable) { return glIsEnabled(GL::EnumCast(inEnablable)); }
+bool GL::IsEnabled(const GL::EEnablable inEnablable)
+{
+  return GetCachedValue(GetStateCache().mEnabled[GetStateCacheIndex(inEnablable)],
+      [&]() { return (glIsEnabled(GL::EnumCast(inEnablable)) != 0); });
+}
 
-void GL::DepthMask(const bool inDepthMask) { glDepthMask(inDepthMask); }
-bool GL::GetDepthMask() { return (GL::GetInteger(GL::EGetEnum::DEPTH_WRITEMASK) == 1); }
+void GL::DepthMask(const bool inDepthMask)
+{
+  if (UpdateCachedValue(GetStateCache().mDepthMask, inDepthMask, &QueryDepthMask))
+    glDepthMask(inDepthMask);
+}
+bool GL::GetDepthMask() { return GetCachedValue(GetStateCache().mDepthMask, &QueryDepthMask); }
 
-void GL::DepthFunc(const GL::EDepthFunc inDepthFunc) { glDepthFunc(GL::EnumCast(inDepthFunc)); }
-GL::EDepthFunc GL::GetDepthFunc() { return static_cast<GL::EDepthFunc>(GL::GetInteger(GL::EGetEnum::DEPTH_FUNC)); }
+void GL::DepthFunc(const GL::EDepthFunc inDepthFunc)
+{
+  if (UpdateCachedValue(GetStateCache().mDepthFunc, inDepthFunc, &QueryDepthFunc))
+    glDepthFunc(GL::EnumCast(inDepthFunc));
+}
+GL::EDepthFunc GL::GetDepthFunc() { return GetCachedValue(GetStateCache().mDepthFunc, &QueryDepthFunc); }
 
-void GL::PointSize(const float inPointSize) { glPointSize(inPointSize); }
-float GL::GetPointSize() { return GL::GetFloat(GL::EGetEnum::POINT_SIZE); }
+void GL::PointSize(const float inPointSize)
+{
+  if (UpdateCachedValue(GetStateCache().mPointSize,
+          inPointSize,
+          [&]() { return GL::GetFloat(GL::EGetEnum::POINT_SIZE); }))
+    glPointSize(inPointSize);
+}
+float GL::GetPointSize()
+{
+  return GetCachedValue(GetStateCache().mPointSize, [&]() { return GL::GetFloat(GL::EGetEnum::POINT_SIZE); });
+}
 
-void GL::LineWidth(const float inLineWidth) { glLineWidth(inLineWidth); }
-float GL::GetLineWidth() { return GL::GetFloat(GL::EGetEnum::LINE_WIDTH); }
+void GL::LineWidth(const float inLineWidth)
+{
+  if (UpdateCachedValue(GetStateCache().mLineWidth,
+          inLineWidth,
+          [&]() { return GL::GetFloat(GL::EGetEnum::LINE_WIDTH); }))
+    glLineWidth(inLineWidth);
+}
+float GL::GetLineWidth()
+{
+  return GetCachedValue(GetStateCache().mLineWidth, [&]() { return GL::GetFloat(GL::EGetEnum::LINE_WIDTH); });
+}
 
 void GL::Viewport(const int inX, const int inY, const int inWidth, const int inHeight)
 {
   EXPECTS(inWidth >= 0);
   EXPECTS(inHeight >= 0);
-  glViewport(inX, inY, inWidth, inHeight);
+
+  const auto x_y_width_height_ints = std::array<GL::Int, 4> { inX, inY, inWidth, inHeight };
+  if (UpdateCachedValue(GetStateCache().mViewport,
+          x_y_width_height_ints,
+          [&]() { return GL::GetIntegers<4>(GL::EGetEnum::VIEWPORT); }))
+    glViewport(inX, inY, inWidth, inHeight);
 }
 
 void GL::Viewport(const Vec2i& inXY, const Vec2i& inSize) { GL::Viewport(inXY[0], inXY[1], inSize[0], inSize[1]); }
@@ -42,7 +297,8 @@ void GL::Viewport(const AARecti& inViewport) { GL::Viewport(inViewport.GetMin(),
 
 AARecti GL::GetViewport()
 {
-  const auto x_y_width_height_ints = GL::GetIntegers<4>(GL::EGetEnum::VIEWPORT);
+  const auto x_y_width_height_ints
+      = GetCachedValue(GetStateCache().mViewport, [&]() { return GL::GetIntegers<4>(GL::EGetEnum::VIEWPORT); });
   const auto x = x_y_width_height_ints[0];
   const auto y = x_y_width_height_ints[1];
   const auto width = x_y_width_height_ints[2];
@@ -53,7 +309,7 @@ AARecti GL::GetViewport()
 
 void GL::BlendFunc(const GL::EBlendFactor inSourceBlendFactor, const GL::EBlendFactor inDestBlendFactor)
 {
-  glBlendFunc(GL::EnumCast(inSourceBlendFactor), GL::EnumCast(inDestBlendFactor));
+  GL::BlendFuncSeparate(inSourceBlendFactor, inDestBlendFactor, inSourceBlendFactor, inDestBlendFactor);
 }
 
 void GL::BlendFuncSeparate(const GL::EBlendFactor inSourceBlendFactorRGB,
@@ -62,6 +318,13 @@ void GL::BlendFuncSeparate(const GL::EBlendFactor inSourceBlendFactorRGB,
     const GL::EBlendFactor inDestBlendFactorAlpha)
 
 {
+  const auto blend_factors = GL::BlendFactors { inSourceBlendFactorRGB,
+    inDestBlendFactorRGB,
+    inSourceBlendFactorAlpha,
+    inDestBlendFactorAlpha };
+  if (!UpdateCachedValue(GetStateCache().mBlendFactors, blend_factors, &QueryBlendFactors))
+    return;
+
   glBlendFuncSeparate(GL::EnumCast(inSourceBlendFactorRGB),
       GL::EnumCast(inDestBlendFactorRGB),
       GL::EnumCast(inSourceBlendFactorAlpha),
@@ -83,19 +346,19 @@ void GL::BlendColor(const Color4f& inBlendColor)
 
 GL::EBlendFactor GL::GetSourceBlendFactorRGB()
 {
-  return static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_SRC_RGB));
+  return GetCachedValue(GetStateCache().mBlendFactors, &QueryBlendFactors).mSourceBlendFactorRGB;
 }
 GL::EBlendFactor GL::GetDestBlendFactorRGB()
 {
-  return static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_DST_RGB));
+  return GetCachedValue(GetStateCache().mBlendFactors, &QueryBlendFactors).mDestBlendFactorRGB;
 }
 GL::EBlendFactor GL::GetSourceBlendFactorAlpha()
 {
-  return static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_SRC_ALPHA));
+  return GetCachedValue(GetStateCache().mBlendFactors, &QueryBlendFactors).mSourceBlendFactorAlpha;
 }
 GL::EBlendFactor GL::GetDestBlendFactorAlpha()
 {
-  return static_cast<GL::EBlendFactor>(GL::GetInteger(GL::EGetEnum::BLEND_DST_ALPHA));
+  return GetCachedValue(GetStateCache().mBlendFactors, &QueryBlendFactors).mDestBlendFactorAlpha;
 }
 Color4f GL::GetBlendColor()
 {
@@ -119,12 +382,14 @@ GL::Id GL::CreateBuffer()
 
 void GL::BindBuffer(const GL::EBufferType inBufferType, const GL::Id inBufferId)
 {
-  glBindBuffer(GL::EnumCast(inBufferType), inBufferId);
+  if (UpdateCachedBoundGLId(GL::GetBufferBindingType(inBufferType), inBufferId))
+    glBindBuffer(GL::EnumCast(inBufferType), inBufferId);
 }
 
 void GL::BindBufferBase(const GL::EBufferType inBufferType, const GL::Id inBindingPoint, const GL::Id inBufferId)
 {
   glBindBufferBase(GL::EnumCast(inBufferType), inBindingPoint, inBufferId);
+  UpdateCachedBoundGLId(GL::GetBufferBindingType(inBufferType), inBufferId); // Also binds to the generic binding point
 }
 
 GL::EBindingType GL::GetBufferBindingType(const GL::EBufferType inBufferType)
@@ -171,7 +436,14 @@ void* GL::MapBufferRange(const GL::Id inBufferId,
 void GL::UnmapBuffer(const GL::EBufferType inBufferType) { glUnmapBuffer(GL::EnumCast(inBufferType)); }
 void GL::UnmapBuffer(const GL::Id inBufferId) { glUnmapNamedBuffer(inBufferId); }
 
-void GL::DeleteBuffer(const GL::Id inBufferId) { glDeleteBuffers(1, &inBufferId); }
+void GL::DeleteBuffer(const GL::Id inBufferId)
+{
+  glDeleteBuffers(1, &inBufferId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::ARRAY_BUFFER, inBufferId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::ELEMENT_ARRAY, inBufferId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::UNIFORM_BUFFER, inBufferId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::SHADER_STORAGE_BUFFER, inBufferId);
+}
 
 GL::Id GL::GenVertexArray()
 {
@@ -187,7 +459,14 @@ GL::Id GL::CreateVertexArray()
   return new_vertex_array_id;
 }
 
-void GL::BindVertexArray(const GL::Id inVAOId) { glBindVertexArray(inVAOId); }
+void GL::BindVertexArray(const GL::Id inVAOId)
+{
+  if (!UpdateCachedBoundGLId(GL::EBindingType::VERTEX_ARRAY, inVAOId))
+    return;
+
+  glBindVertexArray(inVAOId);
+  InvalidateCachedBoundGLId(GL::EBindingType::ELEMENT_ARRAY); // The EBO binding is part of the VAO state
+}
 
 void GL::EnableVertexAttribArray(const GL::Id inAttribLocation) { glEnableVertexAttribArray(inAttribLocation); }
 
@@ -221,18 +500,28 @@ void GL::VertexAttribIPointer(const GL::Id inAttribLocation,
 
 bool GL::IsFloatingType(const GL::EDataType inDataType)
 {
-  return (inDataType == GL::EDataType::FLOAT || inDataType == GL::EDataType::DOUBLE
-      || inDataType == GL::EDataType::FLOAT_VEC2 || inDataType == GL::EDataType::FLOAT_VEC3
-      || inDataType == GL::EDataType::FLOAT_VEC4 || inDataType == GL::EDataType::DOUBLE_VEC2
-      || inDataType == GL::EDataType::DOUBLE_VEC3 || inDataType == GL::EDataType::DOUBLE_VEC4
-      || inDataType == GL::EDataType::FLOAT_MAT2 || inDataType == GL::EDataType::DOUBLE_MAT2
-      || inDataType == GL::EDataType::FLOAT_MAT3 || inDataType == GL::EDataType::DOUBLE_MAT3
-      || inDataType == GL::EDataType::FLOAT_MAT4 || inDataType == GL::EDataType::DOUBLE_MAT4);
+  return (inDataType == GL::EDataType::HALF_FLOAT || inDataType == GL::EDataType::FLOAT
+      || inDataType == GL::EDataType::DOUBLE || inDataType == GL::EDataType::FLOAT_VEC2
+      || inDataType == GL::EDataType::FLOAT_VEC3 || inDataType == GL::EDataType::FLOAT_VEC4
+      || inDataType == GL::EDataType::DOUBLE_VEC2 || inDataType == GL::EDataType::DOUBLE_VEC3
+      || inDataType == GL::EDataType::DOUBLE_VEC4 || inDataType == GL::EDataType::FLOAT_MAT2
+      || inDataType == GL::EDataType::DOUBLE_MAT2 || inDataType == GL::EDataType::FLOAT_MAT3
+      || inDataType == GL::EDataType::DOUBLE_MAT3 || inDataType == GL::EDataType::FLOAT_MAT4
+      || inDataType == GL::EDataType::DOUBLE_MAT4);
 }
 
 void GL::DisableVertexAttribArray(const GL::Id inAttribLocation) { glDisableVertexAttribArray(inAttribLocation); }
 
-void GL::DeleteVertexArray(const GL::Id inVAOId) { glDeleteVertexArrays(1, &inVAOId); }
+void GL::DeleteVertexArray(const GL::Id inVAOId)
+{
+  glDeleteVertexArrays(1, &inVAOId);
+  auto& cached_bound_vao_id = GetStateCache().mBoundIds[GetStateCacheIndex(GL::EBindingType::VERTEX_ARRAY)];
+  if (cached_bound_vao_id == inVAOId)
+  {
+    cached_bound_vao_id = 0;
+    InvalidateCachedBoundGLId(GL::EBindingType::ELEMENT_ARRAY);
+  }
+}
 
 GL::Id GL::GenTexture()
 {
@@ -250,6 +539,10 @@ GL::Id GL::CreateTexture(const GL::ETextureTarget& inTextureTarget)
 
 void GL::BindTexture(const GL::ETextureTarget& inTextureTarget, const GL::Id& inTextureId)
 {
+  const auto texture_binding_type = GetTextureBindingType(inTextureTarget);
+  if (texture_binding_type.has_value() && !UpdateCachedBoundGLId(*texture_binding_type, inTextureId))
+    return;
+
   glBindTexture(GL::EnumCast(inTextureTarget), inTextureId);
 }
 
@@ -277,10 +570,15 @@ void GL::UnBindImageTexture(const GL::Uint inImageUnit)
 
 void GL::GenerateTextureMipMap(const GL::Id& inTextureId) { glGenerateTextureMipmap(inTextureId); }
 
-void GL::ActiveTexture(const GL::Id& inTextureUnit) { glActiveTexture(inTextureUnit); }
+void GL::ActiveTexture(const GL::Id& inTextureUnit)
+{
+  glActiveTexture(inTextureUnit);
+  InvalidateCachedTextureBindings();
+}
 void GL::BindTextureUnit(const GL::Size& inTextureUnit, const GL::Id& inTextureId)
 {
   glBindTextureUnit(inTextureUnit, inTextureId);
+  InvalidateCachedTextureBindings(); // The texture unit might be the active one
 }
 
 bool GL::IsColorFormat(const GL::ETextureFormat inTextureFormat)
@@ -320,7 +618,15 @@ bool GL::IsIntegerFormat(const GL::ETextureFormat inTextureFormat)
       || inTextureFormat == GL::ETextureFormat::RGB10_A2UI);
 }
 
-void GL::DeleteTexture(const GL::Id& inTextureId) { glDeleteTextures(1, &inTextureId); }
+void GL::DeleteTexture(const GL::Id& inTextureId)
+{
+  glDeleteTextures(1, &inTextureId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::TEXTURE_1D, inTextureId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::TEXTURE_1D_ARRAY, inTextureId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::TEXTURE_2D, inTextureId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::TEXTURE_2D_ARRAY, inTextureId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::TEXTURE_3D, inTextureId);
+}
 
 GL::Id GL::GenFramebuffer()
 {
@@ -336,7 +642,11 @@ GL::Id GL::CreateFramebuffer()
   return new_framebuffer_id;
 }
 
-void GL::BindFramebuffer(const GL::Id inFramebufferId) { glBindFramebuffer(GL_FRAMEBUFFER, inFramebufferId); }
+void GL::BindFramebuffer(const GL::Id inFramebufferId)
+{
+  if (UpdateCachedBoundGLId(GL::EBindingType::FRAMEBUFFER, inFramebufferId))
+    glBindFramebuffer(GL_FRAMEBUFFER, inFramebufferId);
+}
 
 void GL::FramebufferRenderbuffer(const GL::EFramebufferAttachment inAttachment, const GL::Id inRenderbufferId)
 {
@@ -378,7 +688,11 @@ void GL::BlitFramebuffer(const GL::Id inReadFramebufferId,
       GL::EnumCast(inFilterType));
 }
 
-void GL::DeleteFramebuffer(const GL::Id inFramebufferId) { glDeleteFramebuffers(1, &inFramebufferId); }
+void GL::DeleteFramebuffer(const GL::Id inFramebufferId)
+{
+  glDeleteFramebuffers(1, &inFramebufferId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::FRAMEBUFFER, inFramebufferId);
+}
 
 GL::Id GL::GenRenderbuffer()
 {
@@ -399,9 +713,17 @@ void GL::RenderbufferStorage(const GL::ETextureFormat inFormat, const GL::Size i
   glRenderbufferStorage(GL_RENDERBUFFER, GL::EnumCast(inFormat), inWidth, inHeight);
 }
 
-void GL::BindRenderbuffer(const GL::Id inRenderbufferId) { glBindRenderbuffer(GL_RENDERBUFFER, inRenderbufferId); }
+void GL::BindRenderbuffer(const GL::Id inRenderbufferId)
+{
+  if (UpdateCachedBoundGLId(GL::EBindingType::RENDERBUFFER, inRenderbufferId))
+    glBindRenderbuffer(GL_RENDERBUFFER, inRenderbufferId);
+}
 
-void GL::DeleteRenderbuffer(const GL::Id inRenderbufferId) { glDeleteRenderbuffers(1, &inRenderbufferId); }
+void GL::DeleteRenderbuffer(const GL::Id inRenderbufferId)
+{
+  glDeleteRenderbuffers(1, &inRenderbufferId);
+  ResetCachedBoundGLIdIfEqual(GL::EBindingType::RENDERBUFFER, inRenderbufferId);
+}
 
 void GL::ClearColor(const Color4f& inColor)
 {
@@ -428,6 +750,19 @@ void GL::DrawElements(const GL::EPrimitivesType inPrimitivesType,
       reinterpret_cast<const void*>(inBeginPrimiviteIndex));
 }
 
+void GL::MultiDrawElements(const GL::EPrimitivesType inPrimitivesType,
+    const Span<GL::Size>& inNumbersOfElements,
+    const GL::EDataType inIndicesDataType,
+    const Span<const void*>& inIndicesOffsets)
+{
+  EXPECTS(inNumbersOfElements.GetNumberOfElements() == inIndicesOffsets.GetNumberOfElements());
+  glMultiDrawElements(GL::EnumCast(inPrimitivesType),
+      inNumbersOfElements.GetData(),
+      GL::EnumCast(inIndicesDataType),
+      inIndicesOffsets.GetData(),
+      static_cast<GL::Size>(inNumbersOfElements.GetNumberOfElements()));
+}
+
 void GL::DrawArrays(const GL::EPrimitivesType inPrimitivesType,
     const GL::Size inNumberOfPrimitives,
     const GL::Size inBeginPrimiviteIndex)
@@ -477,6 +812,9 @@ GL::Id GL::CreateProgram() { return glCreateProgram(); }
 
 void GL::UseProgram(const GL::Id inShaderProgramId)
 {
+  if (!UpdateCachedBoundGLId(GL::EBindingType::CURRENT_PROGRAM, inShaderProgramId))
+    return;
+
   glUseProgram(inShaderProgramId);
 
 #ifndef NDEBUG
@@ -524,6 +862,60 @@ GL::Id GL::GetUniformBlockIndex(const GL::Id inShaderProgramId, const std::strin
   return glGetUniformBlockIndex(inShaderProgramId, inUniformBlockName.data());
 }
 
+GL::Int GL::GetProgramInterface(const GL::Id inShaderProgramId,
+    const GL::EProgramInterface inProgramInterface,
+    const GL::EProgramInterfaceParameter inProgramInterfaceParameter)
+{
+  GL::Int result = 0;
+  glGetProgramInterfaceiv(inShaderProgramId,
+      GL::EnumCast(inProgramInterface),
+      GL::EnumCast(inProgramInterfaceParameter),
+      &result);
+  return result;
+}
+
+GL::Int GL::GetProgramResource(const GL::Id inShaderProgramId,
+    const GL::EProgramInterface inProgramInterface,
+    const GL::Uint inResourceIndex,
+    const GL::EProgramResourceProperty inProgramResourceProperty)
+{
+  const auto property = GL::EnumCast(inProgramResourceProperty);
+  GL::Int result = 0;
+  glGetProgramResourceiv(inShaderProgramId,
+      GL::EnumCast(inProgramInterface),
+      inResourceIndex,
+      1,
+      &property,
+      1,
+      nullptr,
+      &result);
+  return result;
+}
+
+std::string GL::GetProgramResourceName(const GL::Id inShaderProgramId,
+    const GL::EProgramInterface inProgramInterface,
+    const GL::Uint inResourceIndex)
+{
+  const auto name_length = GL::GetProgramResource(inShaderProgramId,
+      inProgramInterface,
+      inResourceIndex,
+      GL::EProgramResourceProperty::NAME_LENGTH);
+
+  std::string name;
+  name.resize(name_length);
+
+  GL::Size written_length = 0;
+  glGetProgramResourceName(inShaderProgramId,
+      GL::EnumCast(inProgramInterface),
+      inResourceIndex,
+      name_length,
+      &written_length,
+      name.data());
+  name.resize(written_length);
+
+  return name;
+}
+
 void GL::DeleteProgram(const GL::Id inShaderProgramId) { glDeleteProgram(inShaderProgramId); }
 
 void GL::Uniform(const GL::Id inUniformLocation, bool inValue)
@@ -3,6 +3,8 @@
 #include <ez/Macros.h>
 #include <ez/Shader.h>
 #include <GL/glew.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <stdexcept>
 
@@ -13,12 +15,84 @@ ShaderProgram::ShaderProgram(const VertexShader& inVertexShader, const FragmentS
   GL::AttachShader(GetGLId(), inVertexShader.GetGLId());
   GL::AttachShader(GetGLId(), inFragmentShader.GetGLId());
   GL::LinkProgram(GetGLId());
+  IntrospectResources();
 }
 
 ShaderProgram::ShaderProgram(const ComputeShader& inComputeShader)
 {
   GL::AttachShader(GetGLId(), inComputeShader.GetGLId());
   GL::LinkProgram(GetGLId());
+  IntrospectResources();
+}
+
+void ShaderProgram::IntrospectResources()
+{
+  static std::atomic<uint64_t> sNextSerial = 1;
+  mSerial = sNextSerial++;
+
+  // Uniforms (only the ones in the default block, the ones inside uniform blocks do not have a location)
+  const auto num_uniforms = GL::GetProgramInterface(GetGLId(),
+      GL::EProgramInterface::UNIFORM,
+      GL::EProgramInterfaceParameter::ACTIVE_RESOURCES);
+  for (GL::Int uniform_resource_index = 0; uniform_resource_index < num_uniforms; ++uniform_resource_index)
+  {
+    const auto get_property = [&](const GL::EProgramResourceProperty inProperty)
+    { return GL::GetProgramResource(GetGLId(), GL::EProgramInterface::UNIFORM, uniform_resource_index, inProperty); };
+
+    const auto location = get_property(GL::EProgramResourceProperty::LOCATION);
+    if (location < 0)
+      continue;
+
+    UniformInfo uniform_info;
+    uniform_info.mName = GL::GetProgramResourceName(GetGLId(), GL::EProgramInterface::UNIFORM, uniform_resource_index);
+    uniform_info.mLocation = static_cast<GL::Id>(location);
+    uniform_info.mType = static_cast<GL::EDataType>(get_property(GL::EProgramResourceProperty::TYPE));
+    uniform_info.mArraySize = get_property(GL::EProgramResourceProperty::ARRAY_SIZE);
+
+    const auto uniform_name = uniform_info.mName;
+    mUniforms.Add(std::move(uniform_info), uniform_name);
+
+    // Arrays are reported as "UName[0]", but they can also be referred to as "UName"
+    constexpr auto ArraySuffix = std::string_view { "[0]" };
+    if (uniform_name.size() > ArraySuffix.size() && uniform_name.ends_with(ArraySuffix))
+      mUniforms.AddAlias(std::string_view(uniform_name).substr(0, uniform_name.size() - ArraySuffix.size()));
+  }
+  mUniforms.Build();
+
+  mUniformValues.resize(mUniforms.mResources.size());
+  for (uint32_t uniform_index = 0; uniform_index < mUniforms.mResources.size(); ++uniform_index)
+  {
+    const auto location = mUniforms.mResources[uniform_index].mLocation;
+    if (location >= mLocationToUniformIndex.size())
+      mLocationToUniformIndex.resize(location + 1, InvalidIndex);
+    mLocationToUniformIndex[location] = uniform_index;
+  }
+
+  // Uniform blocks
+  const auto num_uniform_blocks = GL::GetProgramInterface(GetGLId(),
+      GL::EProgramInterface::UNIFORM_BLOCK,
+      GL::EProgramInterfaceParameter::ACTIVE_RESOURCES);
+  for (GL::Int uniform_block_index = 0; uniform_block_index < num_uniform_blocks; ++uniform_block_index)
+  {
+    UniformBlockInfo uniform_block_info;
+    uniform_block_info.mName
+        = GL::GetProgramResourceName(GetGLId(), GL::EProgramInterface::UNIFORM_BLOCK, uniform_block_index);
+    uniform_block_info.mIndex = static_cast<GL::Id>(uniform_block_index);
+    uniform_block_info.mBindingPoint = static_cast<GL::Id>(GL::GetProgramResource(GetGLId(),
+        GL::EProgramInterface::UNIFORM_BLOCK,
+        uniform_block_index,
+        GL::EProgramResourceProperty::BUFFER_BINDING));
+
+    const auto uniform_block_name = uniform_block_info.mName;
+    mUniformBlocks.Add(std::move(uniform_block_info), uniform_block_name);
+  }
+  mUniformBlocks.Build();
+}
+
+uint32_t ShaderProgram::GetUniformIndex(const GL::Id inUniformLocation) const
+{
+  return (inUniformLocation < mLocationToUniformIndex.size()) ? mLocationToUniformIndex[inUniformLocation]
+                                                              : InvalidIndex;
 }
 
 std::optional<GL::Id> ShaderProgram::GetAttribLocation(const std::string_view inAttribName) const
@@ -29,14 +103,41 @@ std::optional<GL::Id> ShaderProgram::GetAttribLocation(const std::string_view in
 
 std::optional<GL::Id> ShaderProgram::GetUniformLocation(const std::string_view inUniformName) const
 {
-  const auto uniform_location = GL::GetUniformLocation(GetGLId(), inUniformName);
-  return (uniform_location != GL::InvalidId) ? std::make_optional(uniform_location) : std::nullopt;
+  const auto uniform_index = mUniforms.Find(inUniformName, std::hash<std::string_view> {}(inUniformName));
+  if (uniform_index != InvalidIndex)
+    return mUniforms.mResources[uniform_index].mLocation;
+
+  // Array elements other than the first one are not in the table, ask GL for those
+  if (inUniformName.find('[') != std::string_view::npos)
+  {
+    const auto uniform_location = GL::GetUniformLocation(GetGLId(), inUniformName);
+    return (uniform_location != GL::InvalidId) ? std::make_optional(uniform_location) : std::nullopt;
+  }
+  return std::nullopt;
+}
+
+std::optional<GL::Id> ShaderProgram::GetUniformLocation(const UniformHandle& inUniformHandle) const
+{
+  const auto uniform_index = ResolveHandle(inUniformHandle);
+  return (uniform_index != InvalidIndex) ? std::make_optional(mUniforms.mResources[uniform_index].mLocation)
+                                         : std::nullopt;
 }
 
 std::optional<GL::Id> ShaderProgram::GetUniformBlockIndex(const std::string_view inUniformBlockName) const
 {
-  const auto uniform_block_index = GL::GetUniformBlockIndex(GetGLId(), inUniformBlockName);
-  return (uniform_block_index != GL::InvalidId) ? std::make_optional(uniform_block_index) : std::nullopt;
+  const auto uniform_block_index
+      = mUniformBlocks.Find(inUniformBlockName, std::hash<std::string_view> {}(inUniformBlockName));
+  if (uniform_block_index == InvalidIndex)
+    return std::nullopt;
+  return mUniformBlocks.mResources[uniform_block_index].mIndex;
+}
+
+std::optional<GL::Id> ShaderProgram::GetUniformBlockIndex(const UniformBlockHandle& inUniformBlockHandle) const
+{
+  const auto uniform_block_index = ResolveHandle(inUniformBlockHandle);
+  if (uniform_block_index == InvalidIndex)
+    return std::nullopt;
+  return mUniformBlocks.mResources[uniform_block_index].mIndex;
 }
 
 void ShaderProgram::SetUniformBlockBinding(const std::string_view inUniformBlockName, const GL::Id inBindingPoint)
@@ -48,9 +149,28 @@ void ShaderProgram::SetUniformBlockBinding(const std::string_view inUniformBlock
   SetUniformBlockBinding(*uniform_block_index, inBindingPoint);
 }
 
+void ShaderProgram::SetUniformBlockBinding(const UniformBlockHandle& inUniformBlockHandle, const GL::Id inBindingPoint)
+{
+  const auto uniform_block_index = GetUniformBlockIndex(inUniformBlockHandle);
+  if (!uniform_block_index.has_value())
+    THROW_EXCEPTION("Uniform block with name '" << inUniformBlockHandle.GetName()
+                                                << "' does not exist in shader program with id " << GetGLId());
+  SetUniformBlockBinding(*uniform_block_index, inBindingPoint);
+}
+
 void ShaderProgram::SetUniformBlockBinding(const GL::Id inUniformBlockIndex, const GL::Id inBindingPoint)
 {
   EXPECTS(inUniformBlockIndex != GL::InvalidId);
+
+  // Uniform block indices are the same as the introspected resource indices, skip if already bound to that point
+  if (inUniformBlockIndex < mUniformBlocks.mResources.size())
+  {
+    auto& uniform_block_info = mUniformBlocks.mResources[inUniformBlockIndex];
+    if (uniform_block_info.mBindingPoint == inBindingPoint)
+      return;
+    uniform_block_info.mBindingPoint = inBindingPoint;
+  }
+
   GL::UniformBlockBinding(GetGLId(), inUniformBlockIndex, inBindingPoint);
 }
 
@@ -62,6 +182,15 @@ void ShaderProgram::SetUniformBlockBindingSafe(const std::string_view inUniformB
   SetUniformBlockBinding(*uniform_block_index, inBindingPoint);
 }
 
+void ShaderProgram::SetUniformBlockBindingSafe(const UniformBlockHandle& inUniformBlockHandle,
+    const GL::Id inBindingPoint)
+{
+  const auto uniform_block_index = GetUniformBlockIndex(inUniformBlockHandle);
+  if (!uniform_block_index.has_value())
+    return;
+  SetUniformBlockBinding(*uniform_block_index, inBindingPoint);
+}
+
 GL::Id ShaderProgram::GetUniformLocationWithException(const ShaderProgram& inShaderProgram,
     const std::string_view inUniformName)
 {
@@ -0,0 +1,101 @@
+#include <ez/StreamingVBO.h>
+#include <ez/Macros.h>
+#include <ez/VBO.h>
+#include <algorithm>
+#include <bit>
+
+namespace ez
+{
+StreamingVBO::StreamingVBO(const std::size_t inSizeInBytes) { Reallocate(inSizeInBytes); }
+
+StreamingVBO::Allocation StreamingVBO::Allocate(const std::size_t inSizeInBytes, const std::size_t inVertexStride)
+{
+  EXPECTS(inVertexStride > 0);
+
+  // Every allocation must fit in a single region, even after aligning it to the vertex stride
+  if (inSizeInBytes + inVertexStride > mRegionSizeInBytes)
+  {
+    const auto min_size_in_bytes = (inSizeInBytes + inVertexStride) * NumberOfRegions;
+    Reallocate(std::max(GetSizeInBytes() * 2, std::bit_ceil(min_size_in_bytes)));
+  }
+
+  // Offsets are multiple of the vertex stride, so that the allocation can be drawn with a begin vertex index
+  const auto align_to_stride = [inVertexStride](const std::size_t inOffset)
+  { return ((inOffset + inVertexStride - 1) / inVertexStride) * inVertexStride; };
+
+  auto offset = align_to_stride(mHead);
+  if (offset + inSizeInBytes > (mCurrentRegion + 1) * mRegionSizeInBytes)
+  {
+    // Everything using the current region has already been submitted, so fence it and move to the next one
+    mRegionsFences[mCurrentRegion].Set();
+    mCurrentRegion = ((mCurrentRegion + 1) % NumberOfRegions);
+    if (mCurrentRegion == 0)
+      ++mStats.mNumberOfWraps;
+
+    WaitForRegion(mCurrentRegion);
+    offset = align_to_stride(mCurrentRegion * mRegionSizeInBytes);
+  }
+  mHead = offset + inSizeInBytes;
+
+  ++mStats.mNumberOfAllocations;
+  mStats.mNumberOfAllocatedBytes += inSizeInBytes;
+
+  Allocation allocation;
+  allocation.mData = (mMappedData + offset);
+  allocation.mOffset = offset;
+  allocation.mBeginVertex = static_cast<GL::Size>(offset / inVertexStride);
+  return allocation;
+}
+
+const VAO& StreamingVBO::GetVAO(const VertexFormat& inVertexFormat)
+{
+  for (const auto& [vertex_format, vao] : mVAOs)
+  {
+    if (vertex_format == inVertexFormat)
+      return *vao;
+  }
+
+  auto new_vao = std::make_unique<VAO>();
+  for (const auto& [attrib_location, vertex_attrib] : inVertexFormat)
+    new_vao->AddVBO(mVBO, attrib_location, vertex_attrib);
+  mVAOs.emplace_back(inVertexFormat, std::move(new_vao));
+  return *mVAOs.back().second;
+}
+
+void StreamingVBO::Reallocate(const std::size_t inSizeInBytes)
+{
+  EXPECTS(inSizeInBytes > 0);
+
+  if (mVBO)
+    ++mStats.mNumberOfReallocations;
+
+  // GL defers the deletion of the old buffer until the GPU is done with it, so no need to wait here
+  mRegionSizeInBytes = ((inSizeInBytes + NumberOfRegions - 1) / NumberOfRegions);
+  const auto size_in_bytes = GetSizeInBytes();
+  mVBO = std::make_shared<VBO>();
+  mVBO->BufferStorageEmpty(size_in_bytes, GL::EBufferStorageAccessHintBitFlags::MAP_PERSISTENT_COHERENT_WRITE_BIT);
+  mMappedData = static_cast<uint8_t*>(
+      mVBO->MapBufferRange(0, size_in_bytes, GL::EMapBufferAccessBitFlags::MAP_PERSISTENT_COHERENT_WRITE_BIT));
+  ENSURES(mMappedData);
+
+  mCurrentRegion = 0;
+  mHead = 0;
+  for (auto& region_fence : mRegionsFences) { region_fence = Sync {}; }
+  mVAOs.clear(); // They point to the old buffer
+}
+
+void StreamingVBO::WaitForRegion(const std::size_t inRegion)
+{
+  auto& region_fence = mRegionsFences.at(inRegion);
+  if (!region_fence.IsSet())
+    return;
+
+  constexpr auto flush = true;
+  if (region_fence.ClientWait(flush, 0) == GL::EClientWaitSyncResult::TIMEOUT_EXPIRED)
+  {
+    ++mStats.mNumberOfStalls;
+    region_fence.ClientWait(flush);
+  }
+  region_fence = Sync {};
+}
+}
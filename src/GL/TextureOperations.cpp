@@ -16,7 +16,9 @@ void TextureOperations::DrawFullScreenQuad()
   TextureOperations::Init();
 
   const auto mesh_draw_data_bind_guard = sPlaneDrawData->BindGuarded();
-  GL::DrawElements(GL::EPrimitivesType::TRIANGLES, sPlaneDrawData->GetNumberOfElements(), MeshDrawData::EBOGLIndexType);
+  GL::DrawElements(GL::EPrimitivesType::TRIANGLES,
+      sPlaneDrawData->GetNumberOfElements(),
+      sPlaneDrawData->GetIndicesDataType());
 }
 
 void TextureOperations::DrawFullScreenTexture(const Texture2D& inTexture)
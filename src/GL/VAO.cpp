@@ -31,6 +31,18 @@ void VAO::SetEBO(const std::shared_ptr<EBO>& inEBO)
   inEBO->Bind();
 }
 
+void VAO::ClearVBOs()
+{
+  const auto vao_bind_guard = BindGuarded();
+
+  for (GL::Id attrib_location = 0; attrib_location < mVBOs.size(); ++attrib_location)
+  {
+    if (mVBOs[attrib_location])
+      GL::DisableVertexAttribArray(attrib_location);
+  }
+  mVBOs.clear();
+}
+
 void VAO::AddVertexAttrib(const GL::Id inAttribLocation, const VAOVertexAttrib& inVertexAttrib)
 {
   EXPECTS(inVertexAttrib.mNumComponents > 0);
@@ -38,7 +50,7 @@ void VAO::AddVertexAttrib(const GL::Id inAttribLocation, const VAOVertexAttrib&
   const auto vao_bind_guard = BindGuarded();
 
   GL::EnableVertexAttribArray(inAttribLocation);
-  if (GL::IsFloatingType(inVertexAttrib.mType))
+  if (GL::IsFloatingType(inVertexAttrib.mType) || inVertexAttrib.mNormalized) // Normalized integers are read as floats
   {
     GL::VertexAttribPointer(inAttribLocation,
         inVertexAttrib.mNumComponents,
@@ -49,9 +61,6 @@ void VAO::AddVertexAttrib(const GL::Id inAttribLocation, const VAOVertexAttrib&
   }
   else
   {
-    if (inVertexAttrib.mNormalized)
-      THROW_EXCEPTION("Integer vertex attributes can't be normalized");
-
     GL::VertexAttribIPointer(inAttribLocation,
         inVertexAttrib.mNumComponents,
         inVertexAttrib.mType,
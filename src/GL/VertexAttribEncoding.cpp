@@ -0,0 +1,101 @@
+#include <ez/VertexAttribEncoding.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace ez
+{
+Half EncodeHalf(const float inValue)
+{
+  const auto bits = std::bit_cast<uint32_t>(inValue);
+  const auto sign = static_cast<uint32_t>((bits >> 16u) & 0x8000u);
+  const auto float_exponent = static_cast<int32_t>((bits >> 23u) & 0xFFu);
+  auto mantissa = (bits & 0x7FFFFFu);
+
+  if (float_exponent == 0xFF) // Infinity or NaN (keeping it a quiet NaN)
+    return Half { static_cast<uint16_t>(sign | 0x7C00u | (mantissa != 0 ? 0x200u : 0u)) };
+
+  const auto exponent = (float_exponent - 127 + 15);
+  if (exponent >= 31) // Overflow
+    return Half { static_cast<uint16_t>(sign | 0x7C00u) };
+
+  if (exponent <= 0) // Subnormal or zero
+  {
+    if (exponent < -10)
+      return Half { static_cast<uint16_t>(sign) };
+
+    mantissa |= 0x800000u;
+    const auto shift = static_cast<uint32_t>(14 - exponent);
+    auto half_mantissa = (mantissa >> shift);
+    const auto remainder = (mantissa & ((1u << shift) - 1u));
+    const auto halfway = (1u << (shift - 1u));
+    if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u)))
+      ++half_mantissa;
+    return Half { static_cast<uint16_t>(sign | half_mantissa) };
+  }
+
+  // A rounding carry out of the mantissa correctly bumps the exponent (up to infinity)
+  auto half_bits = (sign | (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u));
+  const auto remainder = (mantissa & 0x1FFFu);
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half_bits & 1u)))
+    ++half_bits;
+  return Half { static_cast<uint16_t>(half_bits) };
+}
+
+float DecodeHalf(const Half inValue)
+{
+  const auto sign = (static_cast<uint32_t>(inValue.mBits & 0x8000u) << 16u);
+  const auto exponent = static_cast<uint32_t>((inValue.mBits >> 10u) & 0x1Fu);
+  const auto mantissa = static_cast<uint32_t>(inValue.mBits & 0x3FFu);
+
+  if (exponent == 0x1Fu) // Infinity or NaN
+    return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13u));
+
+  if (exponent == 0) // Subnormal or zero
+  {
+    const auto magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+    return (sign != 0 ? -magnitude : magnitude);
+  }
+
+  return std::bit_cast<float>(sign | ((exponent - 15u + 127u) << 23u) | (mantissa << 13u));
+}
+
+uint16_t EncodeUnorm16(const float inValue)
+{
+  return static_cast<uint16_t>(std::lround(std::clamp(inValue, 0.0f, 1.0f) * 65535.0f));
+}
+
+int16_t EncodeSnorm16(const float inValue)
+{
+  return static_cast<int16_t>(std::lround(std::clamp(inValue, -1.0f, 1.0f) * 32767.0f));
+}
+
+std::array<int16_t, 2> EncodeOctahedralSnorm16(const Vec3f& inUnitVector)
+{
+  const auto l1_norm = (std::abs(inUnitVector[0]) + std::abs(inUnitVector[1]) + std::abs(inUnitVector[2]));
+  if (l1_norm == 0.0f)
+    return { 0, 0 };
+
+  auto u = (inUnitVector[0] / l1_norm);
+  auto v = (inUnitVector[1] / l1_norm);
+  if (inUnitVector[2] < 0.0f) // Fold the lower hemisphere over the diagonals
+  {
+    const auto folded_u = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    const auto folded_v = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    u = folded_u;
+    v = folded_v;
+  }
+  return { EncodeSnorm16(u), EncodeSnorm16(v) };
+}
+
+Vec3f DecodeOctahedralSnorm16(const std::array<int16_t, 2>& inEncodedUnitVector)
+{
+  const auto u = std::max(inEncodedUnitVector[0] / 32767.0f, -1.0f);
+  const auto v = std::max(inEncodedUnitVector[1] / 32767.0f, -1.0f);
+  auto unit_vector = Vec3f { u, v, 1.0f - std::abs(u) - std::abs(v) };
+  const auto t = std::max(-unit_vector[2], 0.0f);
+  unit_vector[0] += (unit_vector[0] >= 0.0f ? -t : t);
+  unit_vector[1] += (unit_vector[1] >= 0.0f ? -t : t);
+  return NormalizedSafe(unit_vector);
+}
+}
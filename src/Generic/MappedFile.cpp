@@ -0,0 +1,67 @@
+#include <ez/MappedFile.h>
+#include <ez/Macros.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace ez
+{
+MappedFile::MappedFile(const std::filesystem::path& inFilePath)
+{
+  const auto file_descriptor = open(inFilePath.c_str(), O_RDONLY);
+  if (file_descriptor < 0)
+    THROW_EXCEPTION("Could not open file " << inFilePath << ": " << std::strerror(errno));
+
+  struct stat file_status;
+  if (fstat(file_descriptor, &file_status) != 0 || !S_ISREG(file_status.st_mode))
+  {
+    close(file_descriptor);
+    THROW_EXCEPTION("File " << inFilePath << " is not a regular file");
+  }
+
+  mSize = static_cast<std::size_t>(file_status.st_size);
+  if (mSize > 0)
+  {
+    auto* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    if (data == MAP_FAILED)
+    {
+      const auto mmap_errno = errno;
+      close(file_descriptor);
+      THROW_EXCEPTION("Could not map file " << inFilePath << ": " << std::strerror(mmap_errno));
+    }
+    mData = static_cast<const std::byte*>(data);
+  }
+
+  close(file_descriptor); // The mapping keeps the file referenced
+}
+
+MappedFile::MappedFile(MappedFile&& ioRHS) noexcept
+    : mData(std::exchange(ioRHS.mData, nullptr)), mSize(std::exchange(ioRHS.mSize, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& ioRHS) noexcept
+{
+  if (this != &ioRHS)
+  {
+    Unmap();
+    mData = std::exchange(ioRHS.mData, nullptr);
+    mSize = std::exchange(ioRHS.mSize, 0);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Unmap(); }
+
+void MappedFile::Unmap()
+{
+  if (mData)
+    munmap(const_cast<std::byte*>(mData), mSize);
+  mData = nullptr;
+  mSize = 0;
+}
+}
@@ -0,0 +1,28 @@
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <thread>
+
+namespace ez
+{
+namespace
+{
+thread_local std::size_t sNumberOfSerialGuards = 0;
+}
+
+std::size_t GetNumberOfParallelThreads()
+{
+  static const auto sNumberOfThreads = std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()),
+      static_cast<std::size_t>(1));
+  return (sNumberOfSerialGuards > 0) ? static_cast<std::size_t>(1) : sNumberOfThreads;
+}
+
+ParallelSerialGuard::ParallelSerialGuard() { ++sNumberOfSerialGuards; }
+
+ParallelSerialGuard::~ParallelSerialGuard() { --sNumberOfSerialGuards; }
+
+std::size_t GetNumberOfParallelChunks(const std::size_t inNumberOfElements, const std::size_t inMinChunkSize)
+{
+  const auto number_of_min_size_chunks = (inNumberOfElements / std::max(inMinChunkSize, static_cast<std::size_t>(1)));
+  return std::clamp(number_of_min_size_chunks, static_cast<std::size_t>(1), GetNumberOfParallelThreads());
+}
+}
@@ -0,0 +1,896 @@
+#include <ez/Bvh.h>
+#include <ez/Macros.h>
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define EZ_BVH_SSE
+#include <immintrin.h>
+#endif
+
+namespace ez
+{
+namespace
+{
+constexpr std::size_t NumberOfBins = 16;
+constexpr std::size_t PacketSize = 4;
+constexpr std::size_t MaxTraversalDepth = 128;
+constexpr std::size_t MaxSAHDepth = 64; // Deeper nodes are split in half, so that the depth stays below the above
+constexpr std::size_t ParallelBinningMinSize = (1u << 16u);
+constexpr std::size_t ParallelBinningMinChunkSize = (1u << 14u);
+constexpr std::size_t ParallelSubtreesMinSize = (1u << 12u);
+constexpr std::size_t ParallelQueriesMinChunkSize = 64;
+constexpr float QuantizationMaxStep = 65535.0f;
+
+struct Bounds
+{
+  Vec3f mMin = Vec3f(Bvh<Triangle3f>::Infinity, Bvh<Triangle3f>::Infinity, Bvh<Triangle3f>::Infinity);
+  Vec3f mMax = Vec3f(-Bvh<Triangle3f>::Infinity, -Bvh<Triangle3f>::Infinity, -Bvh<Triangle3f>::Infinity);
+
+  void Grow(const Vec3f& inPoint)
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      mMin[i] = std::min(mMin[i], inPoint[i]);
+      mMax[i] = std::max(mMax[i], inPoint[i]);
+    }
+  }
+
+  void Grow(const Bounds& inBounds)
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      mMin[i] = std::min(mMin[i], inBounds.mMin[i]);
+      mMax[i] = std::max(mMax[i], inBounds.mMax[i]);
+    }
+  }
+
+  Vec3f GetCenter() const { return (mMin + mMax) * 0.5f; }
+
+  float GetHalfArea() const
+  {
+    const auto extent = (mMax - mMin);
+    if (extent[0] < 0.0f || extent[1] < 0.0f || extent[2] < 0.0f)
+      return 0.0f; // Empty
+    return (extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0]);
+  }
+};
+
+// A node while building: right children indices are relative to the nodes of the subtree being built
+struct BuildNode
+{
+  Bounds mBounds;
+  uint32_t mIndex = 0;              // Right child for inner nodes, first primitive (in the primitives ids) for leaves
+  uint32_t mNumberOfPrimitives = 0; // 0 for inner nodes
+};
+
+struct Bin
+{
+  Bounds mBounds;
+  Bounds mCentroidBounds;
+  uint32_t mNumberOfPrimitives = 0;
+};
+using AxesBins = std::array<std::array<Bin, NumberOfBins>, 3>;
+
+struct Split
+{
+  std::size_t mAxis = 0;
+  std::size_t mLastLeftBinId = 0;
+  float mCost = Bvh<Triangle3f>::Infinity;
+  Bounds mLeftBounds;
+  Bounds mLeftCentroidBounds;
+  Bounds mRightBounds;
+  Bounds mRightCentroidBounds;
+};
+
+class BvhBuilder final
+{
+public:
+  BvhBuilder(const std::vector<Bounds>& inPrimitivesBounds,
+      std::vector<uint32_t>& ioPrimitivesIds,
+      const Bvh<Triangle3f>::Parameters& inParameters)
+      : mPrimitivesBounds(inPrimitivesBounds), mPrimitivesIds(ioPrimitivesIds), mParameters(inParameters)
+  {
+    // Forks down to a few subtrees per thread, so that unbalanced ones even out
+    if (GetNumberOfParallelThreads() > 1)
+    {
+      while ((static_cast<std::size_t>(1) << mMaxParallelDepth) < GetNumberOfParallelThreads() * 4)
+        ++mMaxParallelDepth;
+    }
+  }
+
+  // Appends the subtree of the primitives [inBegin, inEnd) to ioNodes, depth first, reordering their ids
+  void Build(const std::size_t inBegin,
+      const std::size_t inEnd,
+      const Bounds& inBounds,
+      const Bounds& inCentroidBounds,
+      const std::size_t inDepth,
+      std::vector<BuildNode>& ioNodes) const
+  {
+    const auto number_of_primitives = (inEnd - inBegin);
+    const auto node_id = ioNodes.size();
+    ioNodes.push_back(
+        BuildNode { inBounds, static_cast<uint32_t>(inBegin), static_cast<uint32_t>(number_of_primitives) });
+    if (number_of_primitives == 1)
+      return;
+
+    const auto fits_in_leaf = (number_of_primitives <= mParameters.mMaxLeafSize);
+    const auto split
+        = (inDepth < MaxSAHDepth ? FindSplit(inBegin, inEnd, inBounds, inCentroidBounds, inDepth) : Split {});
+    const auto is_split_found = (split.mCost < Bvh<Triangle3f>::Infinity);
+    if (fits_in_leaf && (!is_split_found || GetLeafCost(number_of_primitives) <= split.mCost))
+      return;
+
+    auto middle = inEnd;
+    Bounds left_bounds, left_centroid_bounds, right_bounds, right_centroid_bounds;
+    if (is_split_found)
+    {
+      const auto bin_scale = GetBinScale(inCentroidBounds, split.mAxis);
+      middle = static_cast<std::size_t>(
+          std::partition(mPrimitivesIds.begin() + inBegin,
+              mPrimitivesIds.begin() + inEnd,
+              [&](const uint32_t inPrimitiveId) {
+                return GetBinId(mPrimitivesBounds[inPrimitiveId], inCentroidBounds, split.mAxis, bin_scale)
+                    <= split.mLastLeftBinId;
+              })
+          - mPrimitivesIds.begin());
+      left_bounds = split.mLeftBounds;
+      left_centroid_bounds = split.mLeftCentroidBounds;
+      right_bounds = split.mRightBounds;
+      right_centroid_bounds = split.mRightCentroidBounds;
+    }
+
+    // No split (all centroids equal, or too deep): halves along the widest centroids axis
+    if (middle == inBegin || middle == inEnd)
+    {
+      middle = (inBegin + number_of_primitives / 2);
+      const auto centroid_extent = (inCentroidBounds.mMax - inCentroidBounds.mMin);
+      const auto axis = static_cast<std::size_t>(
+          std::max_element(&centroid_extent[0], &centroid_extent[0] + 3) - &centroid_extent[0]);
+      std::nth_element(mPrimitivesIds.begin() + inBegin,
+          mPrimitivesIds.begin() + middle,
+          mPrimitivesIds.begin() + inEnd,
+          [&](const uint32_t inPrimitiveId0, const uint32_t inPrimitiveId1) {
+            return mPrimitivesBounds[inPrimitiveId0].GetCenter()[axis]
+                < mPrimitivesBounds[inPrimitiveId1].GetCenter()[axis];
+          });
+      ComputeBounds(inBegin, middle, left_bounds, left_centroid_bounds);
+      ComputeBounds(middle, inEnd, right_bounds, right_centroid_bounds);
+    }
+
+    ioNodes[node_id].mNumberOfPrimitives = 0;
+    if (number_of_primitives >= ParallelSubtreesMinSize && inDepth < mMaxParallelDepth)
+    {
+      std::array<std::vector<BuildNode>, 2> children_nodes;
+      ParallelFor(
+          2,
+          [&](const std::size_t, const std::size_t inBeginChildId, const std::size_t inEndChildId)
+          {
+            for (auto child_id = inBeginChildId; child_id < inEndChildId; ++child_id)
+            {
+              if (child_id == 0)
+                Build(inBegin, middle, left_bounds, left_centroid_bounds, inDepth + 1, children_nodes[0]);
+              else
+                Build(middle, inEnd, right_bounds, right_centroid_bounds, inDepth + 1, children_nodes[1]);
+            }
+          },
+          1);
+      AppendSubtree(children_nodes[0], ioNodes);
+      ioNodes[node_id].mIndex = static_cast<uint32_t>(ioNodes.size());
+      AppendSubtree(children_nodes[1], ioNodes);
+    }
+    else
+    {
+      Build(inBegin, middle, left_bounds, left_centroid_bounds, inDepth + 1, ioNodes);
+      ioNodes[node_id].mIndex = static_cast<uint32_t>(ioNodes.size());
+      Build(middle, inEnd, right_bounds, right_centroid_bounds, inDepth + 1, ioNodes);
+    }
+  }
+
+  void ComputeBounds(const std::size_t inBegin,
+      const std::size_t inEnd,
+      Bounds& outBounds,
+      Bounds& outCentroidBounds) const
+  {
+    outBounds = Bounds {};
+    outCentroidBounds = Bounds {};
+    for (auto i = inBegin; i < inEnd; ++i)
+    {
+      const auto& primitive_bounds = mPrimitivesBounds[mPrimitivesIds[i]];
+      outBounds.Grow(primitive_bounds);
+      outCentroidBounds.Grow(primitive_bounds.GetCenter());
+    }
+  }
+
+private:
+  const std::vector<Bounds>& mPrimitivesBounds;
+  std::vector<uint32_t>& mPrimitivesIds;
+  const Bvh<Triangle3f>::Parameters& mParameters;
+  std::size_t mMaxParallelDepth = 0;
+
+  // Leaves test all their packets
+  static float GetLeafCost(const std::size_t inNumberOfPrimitives)
+  {
+    return static_cast<float>((inNumberOfPrimitives + PacketSize - 1) / PacketSize);
+  }
+
+  static float GetBinScale(const Bounds& inCentroidBounds, const std::size_t inAxis)
+  {
+    const auto extent = (inCentroidBounds.mMax[inAxis] - inCentroidBounds.mMin[inAxis]);
+    return (extent > 0.0f ? (NumberOfBins / extent) : 0.0f);
+  }
+
+  static std::size_t GetBinId(const Bounds& inPrimitiveBounds,
+      const Bounds& inCentroidBounds,
+      const std::size_t inAxis,
+      const float inBinScale)
+  {
+    const auto bin_id = static_cast<std::size_t>(
+        std::max((inPrimitiveBounds.GetCenter()[inAxis] - inCentroidBounds.mMin[inAxis]) * inBinScale, 0.0f));
+    return std::min(bin_id, NumberOfBins - 1);
+  }
+
+  static void AppendSubtree(const std::vector<BuildNode>& inSubtreeNodes, std::vector<BuildNode>& ioNodes)
+  {
+    const auto offset = static_cast<uint32_t>(ioNodes.size());
+    for (auto node : inSubtreeNodes)
+    {
+      if (node.mNumberOfPrimitives == 0)
+        node.mIndex += offset;
+      ioNodes.push_back(node);
+    }
+  }
+
+  AxesBins ComputeBins(const std::size_t inBegin,
+      const std::size_t inEnd,
+      const Bounds& inCentroidBounds,
+      const std::size_t inDepth) const
+  {
+    const std::array bins_scales
+        = { GetBinScale(inCentroidBounds, 0), GetBinScale(inCentroidBounds, 1), GetBinScale(inCentroidBounds, 2) };
+    const auto bin_primitives = [&](const std::size_t inBeginId, const std::size_t inEndId, AxesBins& ioBins)
+    {
+      for (auto i = inBeginId; i < inEndId; ++i)
+      {
+        const auto& primitive_bounds = mPrimitivesBounds[mPrimitivesIds[i]];
+        const auto centroid = primitive_bounds.GetCenter();
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+          auto& bin = ioBins[axis][GetBinId(primitive_bounds, inCentroidBounds, axis, bins_scales[axis])];
+          bin.mBounds.Grow(primitive_bounds);
+          bin.mCentroidBounds.Grow(centroid);
+          ++bin.mNumberOfPrimitives;
+        }
+      }
+    };
+
+    // Up to 2^depth subtrees forked by Build are binned at the same time, each on its share of the threads, so that
+    // they do not spawn more threads than there are. Below the fork depth, that share is less than one thread.
+    AxesBins bins;
+    const auto number_of_primitives = (inEnd - inBegin);
+    const auto number_of_subtree_threads = (GetNumberOfParallelThreads() >> inDepth);
+    if (number_of_primitives < ParallelBinningMinSize || number_of_subtree_threads <= 1)
+    {
+      bin_primitives(inBegin, inEnd, bins);
+      return bins;
+    }
+
+    const auto min_chunk_size = std::max(ParallelBinningMinChunkSize,
+        (number_of_primitives + number_of_subtree_threads - 1) / number_of_subtree_threads);
+    std::vector<AxesBins> chunks_bins(GetNumberOfParallelChunks(number_of_primitives, min_chunk_size));
+    ParallelFor(
+        number_of_primitives,
+        [&](const std::size_t inChunkId, const std::size_t inBeginId, const std::size_t inEndId)
+        { bin_primitives(inBegin + inBeginId, inBegin + inEndId, chunks_bins[inChunkId]); },
+        min_chunk_size);
+
+    for (const auto& chunk_bins : chunks_bins)
+    {
+      for (std::size_t axis = 0; axis < 3; ++axis)
+      {
+        for (std::size_t bin_id = 0; bin_id < NumberOfBins; ++bin_id)
+        {
+          auto& bin = bins[axis][bin_id];
+          const auto& chunk_bin = chunk_bins[axis][bin_id];
+          bin.mBounds.Grow(chunk_bin.mBounds);
+          bin.mCentroidBounds.Grow(chunk_bin.mCentroidBounds);
+          bin.mNumberOfPrimitives += chunk_bin.mNumberOfPrimitives;
+        }
+      }
+    }
+    return bins;
+  }
+
+  // Cheapest split between bins, on any axis. Its cost is infinite if the centroids can not be split.
+  Split FindSplit(const std::size_t inBegin,
+      const std::size_t inEnd,
+      const Bounds& inBounds,
+      const Bounds& inCentroidBounds,
+      const std::size_t inDepth) const
+  {
+    const auto bins = ComputeBins(inBegin, inEnd, inCentroidBounds, inDepth);
+    const auto half_area = std::max(inBounds.GetHalfArea(), std::numeric_limits<float>::min());
+
+    Split best_split;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+      if (!(inCentroidBounds.mMax[axis] > inCentroidBounds.mMin[axis]))
+        continue;
+
+      // Right side costs (area * leaf cost) of splitting after every bin, sweeping from the right
+      const auto& axis_bins = bins[axis];
+      std::array<float, NumberOfBins> right_costs {};
+      std::array<uint32_t, NumberOfBins> right_numbers_of_primitives {};
+      Bounds right_bounds;
+      uint32_t right_number_of_primitives = 0;
+      for (auto bin_id = NumberOfBins - 1; bin_id > 0; --bin_id)
+      {
+        right_bounds.Grow(axis_bins[bin_id].mBounds);
+        right_number_of_primitives += axis_bins[bin_id].mNumberOfPrimitives;
+        right_costs[bin_id - 1] = (right_bounds.GetHalfArea() * GetLeafCost(right_number_of_primitives));
+        right_numbers_of_primitives[bin_id - 1] = right_number_of_primitives;
+      }
+
+      Bounds left_bounds;
+      uint32_t left_number_of_primitives = 0;
+      for (std::size_t bin_id = 0; bin_id + 1 < NumberOfBins; ++bin_id)
+      {
+        left_bounds.Grow(axis_bins[bin_id].mBounds);
+        left_number_of_primitives += axis_bins[bin_id].mNumberOfPrimitives;
+        if (left_number_of_primitives == 0 || right_numbers_of_primitives[bin_id] == 0)
+          continue;
+
+        const auto cost = mParameters.mTraversalCost
+            + (left_bounds.GetHalfArea() * GetLeafCost(left_number_of_primitives) + right_costs[bin_id]) / half_area;
+        if (cost < best_split.mCost)
+        {
+          best_split.mAxis = axis;
+          best_split.mLastLeftBinId = bin_id;
+          best_split.mCost = cost;
+        }
+      }
+    }
+
+    if (best_split.mCost < Bvh<Triangle3f>::Infinity)
+    {
+      const auto& axis_bins = bins[best_split.mAxis];
+      for (std::size_t bin_id = 0; bin_id < NumberOfBins; ++bin_id)
+      {
+        const auto is_left = (bin_id <= best_split.mLastLeftBinId);
+        (is_left ? best_split.mLeftBounds : best_split.mRightBounds).Grow(axis_bins[bin_id].mBounds);
+        (is_left ? best_split.mLeftCentroidBounds : best_split.mRightCentroidBounds)
+            .Grow(axis_bins[bin_id].mCentroidBounds);
+      }
+    }
+    return best_split;
+  }
+};
+
+struct RayData
+{
+  std::array<float, 3> mOrigin;
+  std::array<float, 3> mDirection;
+  std::array<float, 3> mInverseDirection;
+};
+
+RayData GetRayData(const Ray3f& inRay)
+{
+  const auto& origin = inRay.GetOrigin();
+  const auto direction = Direction(inRay);
+
+  RayData ray_data;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    ray_data.mOrigin[i] = origin[i];
+    ray_data.mDirection[i] = direction[i];
+    ray_data.mInverseDirection[i] = (direction[i] != 0.0f ? (1.0f / direction[i]) : Bvh<Triangle3f>::Infinity);
+  }
+  return ray_data;
+}
+
+// Slab test. Sets the distance at which the ray enters the box (0 if it starts inside).
+bool IntersectBounds(const float* inMin,
+    const float* inMax,
+    const RayData& inRay,
+    const float inMaxDistance,
+    float& outEntryDistance)
+{
+  // Widened by a few ulps, so that rounding does not miss boxes hit right at their boundary
+  constexpr auto max_distance_widening = (1.0f + 4.0f * std::numeric_limits<float>::epsilon());
+
+  auto entry_distance = 0.0f;
+  auto exit_distance = inMaxDistance;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    auto distance_0 = (inMin[i] - inRay.mOrigin[i]) * inRay.mInverseDirection[i];
+    auto distance_1 = (inMax[i] - inRay.mOrigin[i]) * inRay.mInverseDirection[i];
+    if (distance_0 > distance_1)
+      std::swap(distance_0, distance_1);
+
+    // NaNs (the origin on a slab plane of a parallel ray) leave the distances as they are
+    entry_distance = std::max(entry_distance, distance_0);
+    exit_distance = std::min(exit_distance, distance_1 * max_distance_widening);
+  }
+
+  outEntryDistance = entry_distance;
+  return (entry_distance <= exit_distance);
+}
+
+// Moller-Trumbore against the 4 triangles of the packet. Returns the mask of the hits in [0, inMaxDistance], writing
+// their distances.
+template <typename TTrianglesPacket>
+uint32_t IntersectPacket(const TTrianglesPacket& inPacket,
+    const RayData& inRay,
+    const float inMaxDistance,
+    std::array<float, PacketSize>& outDistances)
+{
+#ifdef EZ_BVH_SSE
+  const auto direction_x = _mm_set1_ps(inRay.mDirection[0]);
+  const auto direction_y = _mm_set1_ps(inRay.mDirection[1]);
+  const auto direction_z = _mm_set1_ps(inRay.mDirection[2]);
+  const auto edge_1_x = _mm_load_ps(inPacket.mEdge1[0]);
+  const auto edge_1_y = _mm_load_ps(inPacket.mEdge1[1]);
+  const auto edge_1_z = _mm_load_ps(inPacket.mEdge1[2]);
+  const auto edge_2_x = _mm_load_ps(inPacket.mEdge2[0]);
+  const auto edge_2_y = _mm_load_ps(inPacket.mEdge2[1]);
+  const auto edge_2_z = _mm_load_ps(inPacket.mEdge2[2]);
+
+  // p = direction x edge 2
+  const auto p_x = _mm_sub_ps(_mm_mul_ps(direction_y, edge_2_z), _mm_mul_ps(direction_z, edge_2_y));
+  const auto p_y = _mm_sub_ps(_mm_mul_ps(direction_z, edge_2_x), _mm_mul_ps(direction_x, edge_2_z));
+  const auto p_z = _mm_sub_ps(_mm_mul_ps(direction_x, edge_2_y), _mm_mul_ps(direction_y, edge_2_x));
+  const auto determinant
+      = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge_1_x, p_x), _mm_mul_ps(edge_1_y, p_y)), _mm_mul_ps(edge_1_z, p_z));
+  const auto inverse_determinant = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+
+  // t = origin - vertex 0
+  const auto t_x = _mm_sub_ps(_mm_set1_ps(inRay.mOrigin[0]), _mm_load_ps(inPacket.mVertex0[0]));
+  const auto t_y = _mm_sub_ps(_mm_set1_ps(inRay.mOrigin[1]), _mm_load_ps(inPacket.mVertex0[1]));
+  const auto t_z = _mm_sub_ps(_mm_set1_ps(inRay.mOrigin[2]), _mm_load_ps(inPacket.mVertex0[2]));
+  const auto u = _mm_mul_ps(
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(t_x, p_x), _mm_mul_ps(t_y, p_y)), _mm_mul_ps(t_z, p_z)),
+      inverse_determinant);
+
+  // q = t x edge 1
+  const auto q_x = _mm_sub_ps(_mm_mul_ps(t_y, edge_1_z), _mm_mul_ps(t_z, edge_1_y));
+  const auto q_y = _mm_sub_ps(_mm_mul_ps(t_z, edge_1_x), _mm_mul_ps(t_x, edge_1_z));
+  const auto q_z = _mm_sub_ps(_mm_mul_ps(t_x, edge_1_y), _mm_mul_ps(t_y, edge_1_x));
+  const auto v = _mm_mul_ps(
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(direction_x, q_x), _mm_mul_ps(direction_y, q_y)), _mm_mul_ps(direction_z, q_z)),
+      inverse_determinant);
+  const auto distance = _mm_mul_ps(
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge_2_x, q_x), _mm_mul_ps(edge_2_y, q_y)), _mm_mul_ps(edge_2_z, q_z)),
+      inverse_determinant);
+
+  // NaNs (degenerate triangles) fail all the comparisons
+  const auto zero = _mm_setzero_ps();
+  auto hits = _mm_cmpneq_ps(determinant, zero);
+  hits = _mm_and_ps(hits, _mm_cmpge_ps(u, zero));
+  hits = _mm_and_ps(hits, _mm_cmpge_ps(v, zero));
+  hits = _mm_and_ps(hits, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+  hits = _mm_and_ps(hits, _mm_cmpge_ps(distance, zero));
+  hits = _mm_and_ps(hits, _mm_cmple_ps(distance, _mm_set1_ps(inMaxDistance)));
+  _mm_storeu_ps(outDistances.data(), distance);
+  return static_cast<uint32_t>(_mm_movemask_ps(hits));
+#else
+  uint32_t hits_mask = 0;
+  for (std::size_t i = 0; i < PacketSize; ++i)
+  {
+    const float edge_1[3] = { inPacket.mEdge1[0][i], inPacket.mEdge1[1][i], inPacket.mEdge1[2][i] };
+    const float edge_2[3] = { inPacket.mEdge2[0][i], inPacket.mEdge2[1][i], inPacket.mEdge2[2][i] };
+    const auto& direction = inRay.mDirection;
+    const float p[3] = { direction[1] * edge_2[2] - direction[2] * edge_2[1],
+      direction[2] * edge_2[0] - direction[0] * edge_2[2],
+      direction[0] * edge_2[1] - direction[1] * edge_2[0] };
+    const auto determinant = (edge_1[0] * p[0] + edge_1[1] * p[1] + edge_1[2] * p[2]);
+    if (determinant == 0.0f)
+      continue;
+
+    const auto inverse_determinant = (1.0f / determinant);
+    const float t[3] = { inRay.mOrigin[0] - inPacket.mVertex0[0][i],
+      inRay.mOrigin[1] - inPacket.mVertex0[1][i],
+      inRay.mOrigin[2] - inPacket.mVertex0[2][i] };
+    const auto u = (t[0] * p[0] + t[1] * p[1] + t[2] * p[2]) * inverse_determinant;
+    const float q[3] = { t[1] * edge_1[2] - t[2] * edge_1[1],
+      t[2] * edge_1[0] - t[0] * edge_1[2],
+      t[0] * edge_1[1] - t[1] * edge_1[0] };
+    const auto v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverse_determinant;
+    const auto distance = (edge_2[0] * q[0] + edge_2[1] * q[1] + edge_2[2] * q[2]) * inverse_determinant;
+    outDistances[i] = distance;
+    if (u >= 0.0f && v >= 0.0f && (u + v) <= 1.0f && distance >= 0.0f && distance <= inMaxDistance)
+      hits_mask |= (1u << i);
+  }
+  return hits_mask;
+#endif
+}
+
+struct NodeBoundsGetter
+{
+  template <typename TNode>
+  void operator()(const TNode& inNode, float* outMin, float* outMax) const
+  {
+    std::copy_n(inNode.mMin, 3, outMin);
+    std::copy_n(inNode.mMax, 3, outMax);
+  }
+};
+
+struct QuantizedNodeBoundsGetter
+{
+  Vec3f mOrigin;
+  Vec3f mScale;
+
+  template <typename TQuantizedNode>
+  void operator()(const TQuantizedNode& inNode, float* outMin, float* outMax) const
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      outMin[i] = mOrigin[i] + static_cast<float>(inNode.mMin[i]) * mScale[i];
+      outMax[i] = mOrigin[i] + static_cast<float>(inNode.mMax[i]) * mScale[i];
+    }
+  }
+};
+
+// Calls inLeafFunction(first packet id, number of packets) for the leaves whose bounds the ray hits closer than
+// ioMaxDistance (which the leaf function can shrink), visiting the nearest child first. Stops if it returns true.
+template <typename TNode, typename TNodeBoundsGetter, typename TLeafFunction>
+void TraverseNodes(const TNode* inNodes,
+    const TNodeBoundsGetter& inNodeBoundsGetter,
+    const RayData& inRay,
+    const float& ioMaxDistance,
+    const TLeafFunction& inLeafFunction)
+{
+  const auto intersect_node = [&](const uint32_t inNodeId, float& outEntryDistance)
+  {
+    float node_min[3], node_max[3];
+    inNodeBoundsGetter(inNodes[inNodeId], node_min, node_max);
+    return IntersectBounds(node_min, node_max, inRay, ioMaxDistance, outEntryDistance);
+  };
+
+  auto root_entry_distance = 0.0f;
+  if (!intersect_node(0, root_entry_distance))
+    return;
+
+  std::array<std::pair<uint32_t, float>, MaxTraversalDepth> stack; // Node id and entry distance
+  std::size_t stack_size = 0;
+  uint32_t node_id = 0;
+  while (true)
+  {
+    const auto& node = inNodes[node_id];
+    if (node.IsLeaf())
+    {
+      if (inLeafFunction(node.GetIndex(), node.GetNumberOfPackets()))
+        return;
+    }
+    else
+    {
+      auto near_child_id = (node_id + 1);
+      auto far_child_id = node.GetIndex();
+      auto near_entry_distance = 0.0f;
+      auto far_entry_distance = 0.0f;
+      const auto is_near_hit = intersect_node(near_child_id, near_entry_distance);
+      const auto is_far_hit = intersect_node(far_child_id, far_entry_distance);
+      if (is_near_hit && is_far_hit)
+      {
+        if (far_entry_distance < near_entry_distance)
+        {
+          std::swap(near_child_id, far_child_id);
+          std::swap(near_entry_distance, far_entry_distance);
+        }
+        stack[stack_size++] = std::make_pair(far_child_id, far_entry_distance);
+        node_id = near_child_id;
+        continue;
+      }
+
+      if (is_near_hit || is_far_hit)
+      {
+        node_id = (is_near_hit ? near_child_id : far_child_id);
+        continue;
+      }
+    }
+
+    // Next pending node not farther than the max distance (which may have shrunk since it was pushed)
+    do
+    {
+      if (stack_size == 0)
+        return;
+      --stack_size;
+    } while (stack[stack_size].second > ioMaxDistance);
+    node_id = stack[stack_size].first;
+  }
+}
+}
+
+Bvh<Triangle3f>::Bvh(const Span<Triangle3f>& inTriangles) : Bvh(inTriangles, Bvh::Parameters {}) {}
+
+Bvh<Triangle3f>::Bvh(const Span<Triangle3f>& inTriangles, const Bvh::Parameters& inParameters)
+{
+  EXPECTS(inParameters.mMaxLeafSize >= 1);
+  EXPECTS(!inParameters.mQuantize
+      || inParameters.mMaxLeafSize <= PacketSize * ((1u << QuantizedNode::NumberOfPacketsBits) - 1u));
+
+  const auto* triangles = inTriangles.GetData();
+  const auto number_of_triangles = inTriangles.GetNumberOfElements();
+  EXPECTS(number_of_triangles < std::numeric_limits<uint32_t>::max());
+  mNumberOfTriangles = number_of_triangles;
+  if (number_of_triangles == 0)
+    return;
+
+  // Triangles bounds, and the root ones reduced from the chunks ones
+  std::vector<Bounds> triangles_bounds(number_of_triangles);
+  std::vector<std::pair<Bounds, Bounds>> chunks_bounds(GetNumberOfParallelChunks(number_of_triangles));
+  ParallelFor(number_of_triangles,
+      [&](const std::size_t inChunkId, const std::size_t inBeginTriangleId, const std::size_t inEndTriangleId)
+      {
+        auto& [chunk_bounds, chunk_centroid_bounds] = chunks_bounds[inChunkId];
+        for (auto triangle_id = inBeginTriangleId; triangle_id < inEndTriangleId; ++triangle_id)
+        {
+          auto& triangle_bounds = triangles_bounds[triangle_id];
+          for (std::size_t i = 0; i < 3; ++i) { triangle_bounds.Grow(triangles[triangle_id][i]); }
+          chunk_bounds.Grow(triangle_bounds);
+          chunk_centroid_bounds.Grow(triangle_bounds.GetCenter());
+        }
+      });
+
+  Bounds bounds, centroid_bounds;
+  for (const auto& [chunk_bounds, chunk_centroid_bounds] : chunks_bounds)
+  {
+    bounds.Grow(chunk_bounds);
+    centroid_bounds.Grow(chunk_centroid_bounds);
+  }
+  mMin = bounds.mMin;
+  mMax = bounds.mMax;
+
+  std::vector<uint32_t> triangles_ids(number_of_triangles);
+  std::iota(triangles_ids.begin(), triangles_ids.end(), 0u);
+  std::vector<BuildNode> build_nodes;
+  build_nodes.reserve(2 * number_of_triangles / std::max(inParameters.mMaxLeafSize / 2, std::size_t(1)));
+  BvhBuilder(triangles_bounds, triangles_ids, inParameters).Build(0,
+      number_of_triangles,
+      bounds,
+      centroid_bounds,
+      0,
+      build_nodes);
+
+  // Final nodes, with the leaves packets consecutive in depth first order
+  mNodes.resize(build_nodes.size());
+  std::vector<uint32_t> leaves_nodes_ids;
+  std::size_t number_of_packets = 0;
+  for (std::size_t node_id = 0; node_id < build_nodes.size(); ++node_id)
+  {
+    const auto& build_node = build_nodes[node_id];
+    auto& node = mNodes[node_id];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      node.mMin[i] = build_node.mBounds.mMin[i];
+      node.mMax[i] = build_node.mBounds.mMax[i];
+    }
+
+    if (build_node.mNumberOfPrimitives == 0)
+    {
+      node.mIndex = build_node.mIndex;
+      node.mNumberOfPackets = 0;
+      continue;
+    }
+
+    node.mIndex = static_cast<uint32_t>(number_of_packets);
+    node.mNumberOfPackets = static_cast<uint32_t>((build_node.mNumberOfPrimitives + PacketSize - 1) / PacketSize);
+    number_of_packets += node.mNumberOfPackets;
+    leaves_nodes_ids.push_back(static_cast<uint32_t>(node_id));
+  }
+
+  mPackets.resize(number_of_packets);
+  ParallelFor(leaves_nodes_ids.size(),
+      [&](const std::size_t, const std::size_t inBeginLeafId, const std::size_t inEndLeafId)
+      {
+        for (auto leaf_id = inBeginLeafId; leaf_id < inEndLeafId; ++leaf_id)
+        {
+          const auto node_id = leaves_nodes_ids[leaf_id];
+          const auto& build_node = build_nodes[node_id];
+          for (std::size_t i = 0; i < build_node.mNumberOfPrimitives; ++i)
+          {
+            const auto triangle_id = triangles_ids[build_node.mIndex + i];
+            const auto& triangle = triangles[triangle_id];
+            auto& packet = mPackets[mNodes[node_id].mIndex + i / PacketSize];
+            const auto slot = (i % PacketSize);
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+              packet.mVertex0[axis][slot] = triangle[0][axis];
+              packet.mEdge1[axis][slot] = (triangle[1][axis] - triangle[0][axis]);
+              packet.mEdge2[axis][slot] = (triangle[2][axis] - triangle[0][axis]);
+            }
+            packet.mTrianglesIds[slot] = triangle_id;
+          }
+        }
+      },
+      DefaultParallelMinChunkSize / 4);
+
+  if (!inParameters.mQuantize)
+    return;
+
+  // Steps of 1/65535 of the BVH extent, rounded outwards, and a step more to be safe from rounding in the decoding
+  mQuantizationOrigin = mMin;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    const auto extent = (mMax[i] - mMin[i]);
+    mQuantizationScale[i] = (extent > 0.0f ? (extent / QuantizationMaxStep) : 1.0f);
+
+    // Steps clamped to the last one must still reach the max
+    while (mQuantizationOrigin[i] + QuantizationMaxStep * mQuantizationScale[i] < mMax[i])
+      mQuantizationScale[i] = std::nextafter(mQuantizationScale[i], Bvh::Infinity);
+  }
+
+  EXPECTS(mNodes.size() < (1u << (32u - QuantizedNode::NumberOfPacketsBits)));
+  EXPECTS(mPackets.size() < (1u << (32u - QuantizedNode::NumberOfPacketsBits)));
+  mQuantizedNodes.resize(mNodes.size());
+  ParallelFor(mNodes.size(),
+      [&](const std::size_t, const std::size_t inBeginNodeId, const std::size_t inEndNodeId)
+      {
+        for (auto node_id = inBeginNodeId; node_id < inEndNodeId; ++node_id)
+        {
+          const auto& node = mNodes[node_id];
+          auto& quantized_node = mQuantizedNodes[node_id];
+          for (std::size_t i = 0; i < 3; ++i)
+          {
+            const auto min_step = std::floor((node.mMin[i] - mQuantizationOrigin[i]) / mQuantizationScale[i]) - 1.0f;
+            const auto max_step = std::ceil((node.mMax[i] - mQuantizationOrigin[i]) / mQuantizationScale[i]) + 1.0f;
+            quantized_node.mMin[i] = static_cast<uint16_t>(std::clamp(min_step, 0.0f, QuantizationMaxStep));
+            quantized_node.mMax[i] = static_cast<uint16_t>(std::clamp(max_step, 0.0f, QuantizationMaxStep));
+          }
+          quantized_node.mIndexAndNumberOfPackets
+              = ((node.mIndex << QuantizedNode::NumberOfPacketsBits) | node.mNumberOfPackets);
+        }
+      });
+
+  mNodes.clear();
+  mNodes.shrink_to_fit();
+}
+
+std::optional<Bvh<Triangle3f>::Intersection> Bvh<Triangle3f>::IntersectClosest(const Ray3f& inRay,
+    const float inMaxDistance) const
+{
+  if (mPackets.empty())
+    return std::nullopt;
+
+  const auto ray_data = GetRayData(inRay);
+  auto max_distance = inMaxDistance;
+  std::optional<Bvh::Intersection> closest_intersection;
+  const auto intersect_leaf = [&](const uint32_t inFirstPacketId, const uint32_t inNumberOfPackets)
+  {
+    for (auto packet_id = inFirstPacketId; packet_id < inFirstPacketId + inNumberOfPackets; ++packet_id)
+    {
+      std::array<float, PacketSize> distances;
+      auto hits_mask = IntersectPacket(mPackets[packet_id], ray_data, max_distance, distances);
+      while (hits_mask != 0)
+      {
+        const auto slot = std::countr_zero(hits_mask);
+        hits_mask &= (hits_mask - 1u);
+        if (distances[slot] <= max_distance)
+        {
+          max_distance = distances[slot];
+          closest_intersection = Bvh::Intersection { distances[slot], mPackets[packet_id].mTrianglesIds[slot] };
+        }
+      }
+    }
+    return false;
+  };
+
+  if (IsQuantized())
+  {
+    const auto bounds_getter = QuantizedNodeBoundsGetter { mQuantizationOrigin, mQuantizationScale };
+    TraverseNodes(mQuantizedNodes.data(), bounds_getter, ray_data, max_distance, intersect_leaf);
+  }
+  else
+  {
+    TraverseNodes(mNodes.data(), NodeBoundsGetter {}, ray_data, max_distance, intersect_leaf);
+  }
+  return closest_intersection;
+}
+
+bool Bvh<Triangle3f>::IntersectCheck(const Ray3f& inRay, const float inMaxDistance) const
+{
+  if (mPackets.empty())
+    return false;
+
+  const auto ray_data = GetRayData(inRay);
+  auto is_hit = false;
+  const auto intersect_leaf = [&](const uint32_t inFirstPacketId, const uint32_t inNumberOfPackets)
+  {
+    std::array<float, PacketSize> distances;
+    for (auto packet_id = inFirstPacketId; packet_id < inFirstPacketId + inNumberOfPackets && !is_hit; ++packet_id)
+      is_hit = (IntersectPacket(mPackets[packet_id], ray_data, inMaxDistance, distances) != 0);
+    return is_hit;
+  };
+
+  if (IsQuantized())
+  {
+    const auto bounds_getter = QuantizedNodeBoundsGetter { mQuantizationOrigin, mQuantizationScale };
+    TraverseNodes(mQuantizedNodes.data(), bounds_getter, ray_data, inMaxDistance, intersect_leaf);
+  }
+  else
+  {
+    TraverseNodes(mNodes.data(), NodeBoundsGetter {}, ray_data, inMaxDistance, intersect_leaf);
+  }
+  return is_hit;
+}
+
+std::vector<Bvh<Triangle3f>::Intersection> Bvh<Triangle3f>::IntersectAll(const Ray3f& inRay,
+    const float inMaxDistance) const
+{
+  std::vector<Bvh::Intersection> intersections;
+  if (mPackets.empty())
+    return intersections;
+
+  const auto ray_data = GetRayData(inRay);
+  const auto intersect_leaf = [&](const uint32_t inFirstPacketId, const uint32_t inNumberOfPackets)
+  {
+    for (auto packet_id = inFirstPacketId; packet_id < inFirstPacketId + inNumberOfPackets; ++packet_id)
+    {
+      std::array<float, PacketSize> distances;
+      auto hits_mask = IntersectPacket(mPackets[packet_id], ray_data, inMaxDistance, distances);
+      while (hits_mask != 0)
+      {
+        const auto slot = std::countr_zero(hits_mask);
+        hits_mask &= (hits_mask - 1u);
+        intersections.push_back(Bvh::Intersection { distances[slot], mPackets[packet_id].mTrianglesIds[slot] });
+      }
+    }
+    return false;
+  };
+
+  if (IsQuantized())
+  {
+    const auto bounds_getter = QuantizedNodeBoundsGetter { mQuantizationOrigin, mQuantizationScale };
+    TraverseNodes(mQuantizedNodes.data(), bounds_getter, ray_data, inMaxDistance, intersect_leaf);
+  }
+  else
+  {
+    TraverseNodes(mNodes.data(), NodeBoundsGetter {}, ray_data, inMaxDistance, intersect_leaf);
+  }
+
+  std::sort(intersections.begin(),
+      intersections.end(),
+      [](const Bvh::Intersection& inLHS, const Bvh::Intersection& inRHS)
+      {
+        return std::make_pair(inLHS.mDistance, inLHS.mPrimitiveIndex)
+            < std::make_pair(inRHS.mDistance, inRHS.mPrimitiveIndex);
+      });
+  return intersections;
+}
+
+std::vector<std::optional<Bvh<Triangle3f>::Intersection>> Bvh<Triangle3f>::IntersectClosest(
+    const Span<Ray3f>& inRays,
+    const float inMaxDistance) const
+{
+  const auto* rays = inRays.GetData();
+  std::vector<std::optional<Bvh::Intersection>> intersections(inRays.GetNumberOfElements());
+  ParallelFor(intersections.size(),
+      [&](const std::size_t, const std::size_t inBeginRayId, const std::size_t inEndRayId)
+      {
+        for (auto ray_id = inBeginRayId; ray_id < inEndRayId; ++ray_id)
+          intersections[ray_id] = IntersectClosest(rays[ray_id], inMaxDistance);
+      },
+      ParallelQueriesMinChunkSize);
+  return intersections;
+}
+
+std::vector<uint8_t> Bvh<Triangle3f>::IntersectCheck(const Span<Ray3f>& inRays, const float inMaxDistance) const
+{
+  const auto* rays = inRays.GetData();
+  std::vector<uint8_t> are_hits(inRays.GetNumberOfElements());
+  ParallelFor(are_hits.size(),
+      [&](const std::size_t, const std::size_t inBeginRayId, const std::size_t inEndRayId)
+      {
+        for (auto ray_id = inBeginRayId; ray_id < inEndRayId; ++ray_id)
+          are_hits[ray_id] = (IntersectCheck(rays[ray_id], inMaxDistance) ? 1 : 0);
+      },
+      ParallelQueriesMinChunkSize);
+  return are_hits;
+}
+
+AABoxf Bvh<Triangle3f>::GetAABox() const { return AABoxf { mMin, mMax }; }
+}
@@ -1,25 +1,112 @@
 #include <ez/Mesh.h>
 #include <ez/Macros.h>
 #include <ez/Math.h>
+#include <ez/MeshBinaryIO.h>
 #include <ez/MeshIO.h>
 #include <ez/MeshIterators.h>
+#include <ez/MeshNativeIO.h>
+#include <ez/Parallel.h>
+#include <ez/PointsTransform.h>
 #include <ez/StreamOperators.h>
 #include <ez/Transformation.h>
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
-#include <unordered_map>
+#include <cmath>
+#include <mutex>
+#include <numeric>
 #include <utility>
 
 namespace ez
 {
+Mesh::GenerationCounter& Mesh::GenerationCounter::operator=(const GenerationCounter&)
+{
+  Bump();
+  return *this;
+}
+
+Mesh::GenerationCounter& Mesh::GenerationCounter::operator=(GenerationCounter&& ioRHS) noexcept
+{
+  if (this != &ioRHS)
+  {
+    mValue = ioRHS.mValue;
+    ioRHS.Bump();
+  }
+  return *this;
+}
+
+Mesh::Generation Mesh::GenerationCounter::Next()
+{
+  static std::atomic<Mesh::Generation> sNextGeneration = 1;
+  return sNextGeneration++;
+}
+
+void Mesh::DirtyRange::Add(const std::size_t inBegin, const std::size_t inEnd)
+{
+  EXPECTS(inBegin <= inEnd);
+  if (inBegin == inEnd)
+    return;
+
+  if (IsEmpty())
+  {
+    mBegin = inBegin;
+    mEnd = inEnd;
+  }
+  else
+  {
+    mBegin = std::min(mBegin, inBegin);
+    mEnd = std::max(mEnd, inEnd);
+  }
+}
+
+Mesh::DirtyRangesTracker& Mesh::DirtyRangesTracker::operator=(const DirtyRangesTracker&)
+{
+  Reset();
+  return *this;
+}
+
+Mesh::DirtyRangesTracker& Mesh::DirtyRangesTracker::operator=(DirtyRangesTracker&&) noexcept
+{
+  Reset();
+  return *this;
+}
+
+void Mesh::DirtyRangesTracker::Reset()
+{
+  mValue = Mesh::DirtyRanges {};
+  mValue.mBeginGeneration = GenerationCounter::Next();
+}
+
+Mesh::DerivedDataGuard::DerivedDataGuard(DerivedDataGuard&& ioRHS) noexcept
+    : mComputedFlags(ioRHS.GetComputedFlags())
+{
+  ioRHS.mComputedFlags = NormalsFlag; // Moved from streams are empty: recompute the rest to reset it
+}
+
+Mesh::DerivedDataGuard& Mesh::DerivedDataGuard::operator=(const DerivedDataGuard& inRHS)
+{
+  mComputedFlags = inRHS.GetComputedFlags();
+  return *this;
+}
+
+Mesh::DerivedDataGuard& Mesh::DerivedDataGuard::operator=(DerivedDataGuard&& ioRHS) noexcept
+{
+  if (this != &ioRHS)
+  {
+    mComputedFlags = ioRHS.GetComputedFlags();
+    ioRHS.mComputedFlags = NormalsFlag;
+  }
+  return *this;
+}
+
 Mesh::VertexId Mesh::AddVertex(const Vec3f& inPosition)
 {
-  Mesh::VertexData vertex_data;
-  vertex_data.mPosition = inPosition;
-  mVerticesData.push_back(std::move(vertex_data));
-  mCornerTableComputed = false;
+  mVerticesPositions.push_back(inPosition);
+  mVerticesFaceIds.push_back(Mesh::InvalidId);
+  OnTopologyChanged();
 
-  const auto new_vertex_id = mVerticesData.size() - 1;
+  const auto new_vertex_id = mVerticesPositions.size() - 1;
   return new_vertex_id;
 }
 
@@ -32,72 +119,210 @@ Mesh::FaceId Mesh::AddFace(const Mesh::VertexId& inFaceVertexId0,
   EXPECTS(inFaceVertexId2 < GetNumberOfVertices());
 
   // Add face
-  mFacesData.emplace_back();
-  const auto new_face_id = mFacesData.size() - 1;
   const std::array new_face_vertices_ids = { inFaceVertexId0, inFaceVertexId1, inFaceVertexId2 };
-  mFacesData.at(new_face_id).mVerticesIds = new_face_vertices_ids;
+  mFacesVerticesIds.push_back(new_face_vertices_ids);
+  mFacesNormals.push_back(Zero<Vec3f>());
+  const auto new_face_id = mFacesVerticesIds.size() - 1;
 
-  mVerticesData.at(inFaceVertexId0).mFaceId = new_face_id;
-  mVerticesData.at(inFaceVertexId1).mFaceId = new_face_id;
-  mVerticesData.at(inFaceVertexId2).mFaceId = new_face_id;
+  mVerticesFaceIds[inFaceVertexId0] = new_face_id;
+  mVerticesFaceIds[inFaceVertexId1] = new_face_id;
+  mVerticesFaceIds[inFaceVertexId2] = new_face_id;
 
   // For each vertex of the new face, create corners
-  for (Mesh::InternalCornerId internal_corner_id = 0; internal_corner_id < 3; ++internal_corner_id)
-  { mCornersData.emplace_back(); }
-  mCornerTableComputed = false;
+  const auto number_of_corners = (mFacesVerticesIds.size() * 3);
+  mCornersOppositeCornersIds.resize(number_of_corners, Mesh::InvalidId);
+  mCornersNormals.resize(number_of_corners, Zero<Vec3f>());
+  mCornersTextureCoordinates.resize(number_of_corners, Zero<Vec2f>());
+  OnTopologyChanged();
 
   return new_face_id;
 }
 
+Mesh::VertexId Mesh::AddVertices(const Span<Vec3f>& inPositions)
+{
+  const auto first_new_vertex_id = static_cast<Mesh::VertexId>(GetNumberOfVertices());
+  mVerticesPositions.insert(mVerticesPositions.end(),
+      inPositions.GetData(),
+      inPositions.GetData() + inPositions.GetNumberOfElements());
+  mVerticesFaceIds.resize(mVerticesPositions.size(), Mesh::InvalidId);
+  OnTopologyChanged();
+  return first_new_vertex_id;
+}
+
+Mesh::FaceId Mesh::AddFaces(const Span<Mesh::FaceVerticesIds>& inFacesVerticesIds)
+{
+  const auto first_new_face_id = static_cast<Mesh::FaceId>(GetNumberOfFaces());
+  const auto number_of_vertices = GetNumberOfVertices();
+  const auto* new_faces_vertices_ids = inFacesVerticesIds.GetData();
+  const auto number_of_new_faces = inFacesVerticesIds.GetNumberOfElements();
+
+  // Every id checked before anything is written, so that a bad one leaves the mesh as it was
+  for (std::size_t i = 0; i < number_of_new_faces; ++i)
+  {
+    const auto& face_vertices_ids = new_faces_vertices_ids[i];
+    EXPECTS(face_vertices_ids[0] < number_of_vertices);
+    EXPECTS(face_vertices_ids[1] < number_of_vertices);
+    EXPECTS(face_vertices_ids[2] < number_of_vertices);
+  }
+
+  for (std::size_t i = 0; i < number_of_new_faces; ++i)
+  {
+    const auto face_id = static_cast<Mesh::FaceId>(first_new_face_id + i);
+    for (const auto vertex_id : new_faces_vertices_ids[i]) { mVerticesFaceIds[vertex_id] = face_id; }
+  }
+
+  mFacesVerticesIds.insert(mFacesVerticesIds.end(),
+      new_faces_vertices_ids,
+      new_faces_vertices_ids + number_of_new_faces);
+  mFacesNormals.resize(mFacesVerticesIds.size(), Zero<Vec3f>());
+
+  const auto number_of_corners = (mFacesVerticesIds.size() * 3);
+  mCornersOppositeCornersIds.resize(number_of_corners, Mesh::InvalidId);
+  mCornersNormals.resize(number_of_corners, Zero<Vec3f>());
+  mCornersTextureCoordinates.resize(number_of_corners, Zero<Vec2f>());
+  OnTopologyChanged();
+
+  return first_new_face_id;
+}
+
+void Mesh::SetStreams(std::vector<Vec3f>&& ioVerticesPositions,
+    std::vector<Mesh::FaceVerticesIds>&& ioFacesVerticesIds,
+    std::vector<Vec3f>&& ioFacesNormals,
+    std::vector<Vec3f>&& ioCornersNormals,
+    std::vector<Vec2f>&& ioCornersTextureCoordinates)
+{
+  const auto number_of_vertices = ioVerticesPositions.size();
+  const auto number_of_faces = ioFacesVerticesIds.size();
+  const auto number_of_corners = (number_of_faces * 3);
+  EXPECTS(ioFacesNormals.empty() || ioFacesNormals.size() == number_of_faces);
+  EXPECTS(ioCornersNormals.empty() || ioCornersNormals.size() == number_of_corners);
+  EXPECTS(ioCornersTextureCoordinates.empty() || ioCornersTextureCoordinates.size() == number_of_corners);
+
+  Clear();
+
+  // As AddFace: the last face of every vertex
+  mVerticesFaceIds.assign(number_of_vertices, Mesh::InvalidId);
+  for (Mesh::FaceId face_id = 0; face_id < number_of_faces; ++face_id)
+  {
+    for (const auto vertex_id : ioFacesVerticesIds[face_id])
+    {
+      EXPECTS(vertex_id < number_of_vertices);
+      mVerticesFaceIds[vertex_id] = face_id;
+    }
+  }
+
+  mVerticesPositions = std::move(ioVerticesPositions);
+  mFacesVerticesIds = std::move(ioFacesVerticesIds);
+
+  if (ioFacesNormals.empty())
+    mFacesNormals.assign(number_of_faces, Zero<Vec3f>());
+  else
+    mFacesNormals = std::move(ioFacesNormals);
+
+  if (ioCornersNormals.empty())
+    mCornersNormals.assign(number_of_corners, Zero<Vec3f>());
+  else
+    mCornersNormals = std::move(ioCornersNormals);
+
+  if (ioCornersTextureCoordinates.empty())
+    mCornersTextureCoordinates.assign(number_of_corners, Zero<Vec2f>());
+  else
+    mCornersTextureCoordinates = std::move(ioCornersTextureCoordinates);
+
+  mCornersOppositeCornersIds.assign(number_of_corners, Mesh::InvalidId);
+  OnTopologyChanged();
+}
+
+void Mesh::Reserve(const std::size_t inNumberOfVertices, const std::size_t inNumberOfFaces)
+{
+  mVerticesPositions.reserve(inNumberOfVertices);
+  mVerticesFaceIds.reserve(inNumberOfVertices);
+  mFacesVerticesIds.reserve(inNumberOfFaces);
+  mFacesNormals.reserve(inNumberOfFaces);
+  mCornersOppositeCornersIds.reserve(inNumberOfFaces * 3);
+  mCornersNormals.reserve(inNumberOfFaces * 3);
+  mCornersTextureCoordinates.reserve(inNumberOfFaces * 3);
+}
+
 void Mesh::SetFaceNormal(const Mesh::FaceId inFaceId, const Vec3f& inFaceNormal)
 {
-  EXPECTS(inFaceId < mFacesData.size());
-  mFacesData.at(inFaceId).mNormal = inFaceNormal;
+  EXPECTS(inFaceId < mFacesNormals.size());
+  DisableAutoNormals();
+  mFacesNormals.at(inFaceId) = inFaceNormal;
+  mDirtyRanges.mValue.mFaces.Add(inFaceId, inFaceId + 1);
+  mGeneration.Bump();
 }
 
 void Mesh::SetCornerNormal(const Mesh::CornerId inCornerId, const Vec3f& inCornerNormal)
 {
-  EXPECTS(inCornerId < mCornersData.size());
-  mCornersData.at(inCornerId).mNormal = inCornerNormal;
+  EXPECTS(inCornerId < mCornersNormals.size());
+  DisableAutoNormals();
+  mCornersNormals.at(inCornerId) = inCornerNormal;
+  mDirtyRanges.mValue.mCorners.Add(inCornerId, inCornerId + 1);
+  mGeneration.Bump();
 }
 
 void Mesh::SetCornerTextureCoordinates(const Mesh::CornerId& inCornerId, const Vec2f& inTextureCoordinates)
 {
-  EXPECTS(inCornerId < mCornersData.size());
-  mCornersData.at(inCornerId).mTextureCoordinates = inTextureCoordinates;
+  EXPECTS(inCornerId < mCornersTextureCoordinates.size());
+  mCornersTextureCoordinates.at(inCornerId) = inTextureCoordinates;
+  mDirtyRanges.mValue.mCorners.Add(inCornerId, inCornerId + 1);
+  mGeneration.Bump();
+}
+
+void Mesh::SetFacesNormals(const Span<Vec3f>& inFacesNormals)
+{
+  EXPECTS(inFacesNormals.GetNumberOfElements() == GetNumberOfFaces());
+  std::copy_n(inFacesNormals.GetData(), GetNumberOfFaces(), GetMutableFacesNormals().GetData());
+}
+
+void Mesh::SetCornersNormals(const Span<Vec3f>& inCornersNormals)
+{
+  EXPECTS(inCornersNormals.GetNumberOfElements() == GetNumberOfCorners());
+  std::copy_n(inCornersNormals.GetData(), GetNumberOfCorners(), GetMutableCornersNormals().GetData());
+}
+
+void Mesh::SetCornersTextureCoordinates(const Span<Vec2f>& inCornersTextureCoordinates)
+{
+  EXPECTS(inCornersTextureCoordinates.GetNumberOfElements() == GetNumberOfCorners());
+  std::copy_n(inCornersTextureCoordinates.GetData(),
+      GetNumberOfCorners(),
+      GetMutableCornersTextureCoordinates().GetData());
 }
 
 const Vec3f& Mesh::GetVertexPosition(const Mesh::VertexId& inVertexId) const
 {
-  EXPECTS(inVertexId < mVerticesData.size());
-  return mVerticesData.at(inVertexId).mPosition;
+  EXPECTS(inVertexId < mVerticesPositions.size());
+  return mVerticesPositions.at(inVertexId);
 }
 
 const Vec3f& Mesh::GetFaceNormal(const Mesh::FaceId& inFaceId) const
 {
-  EXPECTS(inFaceId < mFacesData.size());
-  return mFacesData.at(inFaceId).mNormal;
+  EXPECTS(inFaceId < mFacesNormals.size());
+  EnsureDerivedData(NormalsFlag);
+  return mFacesNormals.at(inFaceId);
 }
 
 Triangle3f Mesh::GetFaceTriangle(const Mesh::FaceId& inFaceId) const
 {
-  EXPECTS(inFaceId < mFacesData.size());
-  const auto& face_data = mFacesData.at(inFaceId);
-  return Triangle3f(mVerticesData.at(face_data.mVerticesIds[0]).mPosition,
-      mVerticesData.at(face_data.mVerticesIds[1]).mPosition,
-      mVerticesData.at(face_data.mVerticesIds[2]).mPosition);
+  EXPECTS(inFaceId < mFacesVerticesIds.size());
+  const auto& face_vertices_ids = mFacesVerticesIds.at(inFaceId);
+  return Triangle3f(mVerticesPositions.at(face_vertices_ids[0]),
+      mVerticesPositions.at(face_vertices_ids[1]),
+      mVerticesPositions.at(face_vertices_ids[2]));
 }
 
 const Vec3f& Mesh::GetCornerNormal(const Mesh::CornerId& inCornerId) const
 {
-  EXPECTS(inCornerId < mCornersData.size());
-  return mCornersData.at(inCornerId).mNormal;
+  EXPECTS(inCornerId < mCornersNormals.size());
+  EnsureDerivedData(NormalsFlag);
+  return mCornersNormals.at(inCornerId);
 }
 
 const Vec2f& Mesh::GetCornerTextureCoordinates(const Mesh::CornerId& inCornerId) const
 {
-  EXPECTS(inCornerId < mCornersData.size());
-  return mCornersData.at(inCornerId).mTextureCoordinates;
+  EXPECTS(inCornerId < mCornersTextureCoordinates.size());
+  return mCornersTextureCoordinates.at(inCornerId);
 }
 
 Mesh::VertexId Mesh::GetVertexIdFromCornerId(const Mesh::CornerId inCornerId) const
@@ -111,7 +336,7 @@ Mesh::VertexId Mesh::GetVertexIdFromCornerId(const Mesh::CornerId inCornerId) co
 Mesh::VertexId Mesh::GetVertexIdFromFaceIdAndInternalCornerId(const Mesh::FaceId inFaceId,
     const Mesh::InternalCornerId inInternalCornerId) const
 {
-  return mFacesData.at(inFaceId).mVerticesIds.at(inInternalCornerId);
+  return mFacesVerticesIds.at(inFaceId).at(inInternalCornerId);
 }
 
 Mesh::FaceId Mesh::GetFaceIdFromCornerId(const Mesh::CornerId inCornerId) const
@@ -122,9 +347,9 @@ Mesh::FaceId Mesh::GetFaceIdFromCornerId(const Mesh::CornerId inCornerId) const
 
 Mesh::CornerId Mesh::GetOppositeCornerId(const Mesh::CornerId inCornerId) const
 {
-  EXPECTS(mCornerTableComputed);
-  EXPECTS(inCornerId < mCornersData.size());
-  return mCornersData.at(inCornerId).mOppositeCornerId;
+  EXPECTS(inCornerId < GetNumberOfCorners());
+  EnsureDerivedData(CornerTableFlag);
+  return mCornersOppositeCornersIds[inCornerId];
 }
 
 Mesh::FaceId Mesh::GetOppositeFaceId(const Mesh::CornerId inCornerId) const
@@ -137,8 +362,7 @@ Mesh::FaceId Mesh::GetOppositeFaceId(const Mesh::CornerId inCornerId) const
 
 std::array<Mesh::Edge, 3> Mesh::GetFaceEdges(const Mesh::FaceId inFaceId) const
 {
-  const auto& face_data = mFacesData.at(inFaceId);
-  const auto& face_vertices_ids = face_data.mVerticesIds;
+  const auto& face_vertices_ids = mFacesVerticesIds.at(inFaceId);
   const auto& face_vertex_id_0 = face_vertices_ids.at(0);
   const auto& face_vertex_id_1 = face_vertices_ids.at(1);
   const auto& face_vertex_id_2 = face_vertices_ids.at(2);
@@ -151,9 +375,26 @@ std::array<Mesh::Edge, 3> Mesh::GetFaceEdges(const Mesh::FaceId inFaceId) const
 
 void Mesh::Clear()
 {
-  mVerticesData.clear();
-  mCornersData.clear();
-  mFacesData.clear();
+  mVerticesPositions.clear();
+  mVerticesFaceIds.clear();
+  mCornersOppositeCornersIds.clear();
+  mCornersNormals.clear();
+  mCornersTextureCoordinates.clear();
+  mFacesVerticesIds.clear();
+  mFacesNormals.clear();
+  mNonManifoldCornersIds.clear();
+  mVertexCornersOffsets.clear();
+  mVertexCornersIds.clear();
+  mEdges.clear();
+  mEdgesCornersIds.clear();
+  mCornersEdgesIds.clear();
+  mVertexEdgesOffsets.clear();
+  mVertexEdgesIds.clear();
+  mEdgesHashTable.clear();
+  mTriangles.clear();
+  mAutoNormals.reset();
+  OnTopologyChanged();
+  mDerivedData.SetComputed(NormalsFlag); // Even if auto normals were pending
 }
 
 std::array<Mesh::CornerId, 3> Mesh::GetFaceCornersIds(const Mesh::FaceId inFaceId) const
@@ -234,11 +475,11 @@ Mesh::CornerId Mesh::GetCornerIdFromFaceIdAndVertexId(const Mesh::FaceId inFaceI
   EXPECTS(inFaceId < GetNumberOfFaces());
   EXPECTS(inVertexId < GetNumberOfVertices());
 
-  const auto& vertex_id_0 = mFacesData.at(inFaceId).mVerticesIds.at(0);
+  const auto& vertex_id_0 = mFacesVerticesIds.at(inFaceId).at(0);
   if (inVertexId == vertex_id_0)
     return (inFaceId * 3 + 0);
 
-  const auto& vertex_id_1 = mFacesData.at(inFaceId).mVerticesIds.at(1);
+  const auto& vertex_id_1 = mFacesVerticesIds.at(inFaceId).at(1);
   if (inVertexId == vertex_id_1)
     return (inFaceId * 3 + 1);
 
@@ -297,43 +538,92 @@ Mesh::CornerId Mesh::GetPreviousAdjacentFaceId(const Mesh::CornerId inCornerId)
   return GetFaceIdFromCornerId(previous_adjacent_corner_id);
 }
 
-std::vector<Triangle3f> Mesh::GetTriangles() const
+const std::vector<Triangle3f>& Mesh::GetTriangles() const
+{
+  EnsureDerivedData(TrianglesFlag);
+  return mTriangles;
+}
+
+const AABoxf& Mesh::GetBoundingAABox() const
+{
+  EnsureDerivedData(BoundsFlag);
+  return mBoundingAABox;
+}
+
+const Spheref& Mesh::GetBoundingSphere() const
 {
-  std::vector<Triangle3f> mesh_triangles;
-  mesh_triangles.reserve(GetNumberOfFaces());
-  for (std::size_t face_id = 0; face_id < GetNumberOfFaces(); ++face_id)
-  { mesh_triangles.push_back(GetFaceTriangle(face_id)); }
-  return mesh_triangles;
+  EnsureDerivedData(BoundsFlag);
+  return mBoundingSphere;
 }
 
 void Mesh::SetVertexPosition(const Mesh::VertexId inVertexId, const Vec3f& inPosition)
 {
   EXPECTS(inVertexId < GetNumberOfVertices());
-  mVerticesData.at(inVertexId).mPosition = inPosition;
+  mVerticesPositions.at(inVertexId) = inPosition;
+  mDirtyRanges.mValue.mVertices.Add(inVertexId, inVertexId + 1);
+  InvalidateDerivedData(PositionsDerivedDataFlags);
+  mGeneration.Bump();
 }
 
 void Mesh::Transform(const Mat4f& inTransform)
 {
-  for (auto& vertex_data : mVerticesData) { vertex_data.mPosition = Transformed(vertex_data.mPosition, inTransform); }
+  const auto* transform_data = inTransform.Data();
+  const auto is_affine = (transform_data[12] == 0.0f && transform_data[13] == 0.0f && transform_data[14] == 0.0f
+      && transform_data[15] == 1.0f);
+  if (is_affine)
+    TransformPoints(GetMutableVerticesPositions(), inTransform);
+  else
+    TransformPointsProjective(GetMutableVerticesPositions(), inTransform);
+
+  if (HasAutoNormals()) // Computed again from the new positions
+    return;
+
+  const auto normal_matrix = NormalMat(inTransform);
+  TransformNormals(GetMutableCornersNormals(), normal_matrix);
+  TransformNormals(GetMutableFacesNormals(), normal_matrix);
 }
 
-/*
-Mesh::CirculatorVertexNeighborFaceIds Mesh::GetVertexNeighborFaceIdsCirculatorBegin(
-    const Mesh::VertexId inVertexId) const
+bool Mesh::HasVertexCornersIndex() const { return mDerivedData.IsComputed(VertexCornersIndexFlag); }
+
+Span<Mesh::CornerId> Mesh::GetVertexCornersIdsSpan(const Mesh::VertexId inVertexId) const
 {
-  return Mesh::CirculatorVertexNeighborFaceIds(*this, inVertexId);
+  const auto vertex_corners_ids_begin = GetVertexCornersIdsBegin(inVertexId);
+  const auto vertex_corners_ids_end = GetVertexCornersIdsEnd(inVertexId);
+  const auto number_of_vertex_corners = static_cast<std::size_t>(vertex_corners_ids_end - vertex_corners_ids_begin);
+  return MakeSpan(vertex_corners_ids_begin, number_of_vertex_corners);
 }
 
-Mesh::CirculatorVertexNeighborFaceIds Mesh::GetVertexNeighborFaceIdsCirculatorEnd() const
+Range<Mesh::CirculatorVertexCornerIds> Mesh::AllVertexCornerIds(const Mesh::VertexId inVertexId) const
 {
-  return Mesh::CirculatorVertexNeighborFaceIds(*this, Mesh::InvalidId);
+  return { Mesh::CirculatorVertexCornerIds(*this, GetVertexCornersIdsBegin(inVertexId)),
+    Mesh::CirculatorVertexCornerIds(*this, GetVertexCornersIdsEnd(inVertexId)) };
 }
 
 Range<Mesh::CirculatorVertexNeighborFaceIds> Mesh::AllVertexNeighborFaceIds(const Mesh::VertexId inVertexId) const
 {
-  return { GetVertexNeighborFaceIdsCirculatorBegin(inVertexId), GetVertexNeighborFaceIdsCirculatorEnd() };
+  return { Mesh::CirculatorVertexNeighborFaceIds(*this, GetVertexCornersIdsBegin(inVertexId)),
+    Mesh::CirculatorVertexNeighborFaceIds(*this, GetVertexCornersIdsEnd(inVertexId)) };
+}
+
+Range<Mesh::CirculatorVertexNeighborVertexIds> Mesh::AllVertexNeighborVertexIds(const Mesh::VertexId inVertexId) const
+{
+  return { Mesh::CirculatorVertexNeighborVertexIds(*this, GetVertexCornersIdsBegin(inVertexId)),
+    Mesh::CirculatorVertexNeighborVertexIds(*this, GetVertexCornersIdsEnd(inVertexId)) };
+}
+
+const Mesh::CornerId* Mesh::GetVertexCornersIdsBegin(const Mesh::VertexId inVertexId) const
+{
+  EXPECTS(inVertexId < GetNumberOfVertices());
+  EnsureDerivedData(VertexCornersIndexFlag);
+  return mVertexCornersIds.data() + mVertexCornersOffsets[inVertexId];
+}
+
+const Mesh::CornerId* Mesh::GetVertexCornersIdsEnd(const Mesh::VertexId inVertexId) const
+{
+  EXPECTS(inVertexId < GetNumberOfVertices());
+  EnsureDerivedData(VertexCornersIndexFlag);
+  return mVertexCornersIds.data() + mVertexCornersOffsets[inVertexId + 1];
 }
-*/
 
 std::vector<Mesh::CornerId> Mesh::GetNeighborCornersIds(const Mesh::VertexId inVertexId) const
 {
@@ -400,11 +690,13 @@ std::vector<Mesh::CornerId> Mesh::GetVertexCornersIds(const Mesh::VertexId inVer
 {
   EXPECTS(inVertexId < GetNumberOfVertices());
 
+  if (HasVertexCornersIndex())
+    return std::vector<Mesh::CornerId>(GetVertexCornersIdsBegin(inVertexId), GetVertexCornersIdsEnd(inVertexId));
+
   std::vector<Mesh::CornerId> corner_ids;
   corner_ids.reserve(6);
 
-  const auto& vertex_data = mVerticesData.at(inVertexId);
-  const auto start_corner_id = GetCornerIdFromFaceIdAndVertexId(vertex_data.mFaceId, inVertexId);
+  const auto start_corner_id = GetCornerIdFromFaceIdAndVertexId(mVerticesFaceIds.at(inVertexId), inVertexId);
 
   auto corner_id = start_corner_id;
   do
@@ -423,142 +715,647 @@ bool Mesh::IsValid(const std::optional<Mesh::Id> inOptionalId)
   return inOptionalId.has_value() ? Mesh::IsValid(*inOptionalId) : false;
 }
 
-const std::vector<Mesh::VertexData>& Mesh::GetVerticesData() const { return mVerticesData; }
+Span<Vec3f> Mesh::GetVerticesPositions() const { return MakeSpan(mVerticesPositions); }
+
+Span<Mesh::FaceId> Mesh::GetVerticesFaceIds() const { return MakeSpan(mVerticesFaceIds); }
+
+Span<Mesh::CornerId> Mesh::GetCornersOppositeCornersIds() const
+{
+  EnsureDerivedData(CornerTableFlag);
+  return MakeSpan(mCornersOppositeCornersIds);
+}
+
+Span<Vec3f> Mesh::GetCornersNormals() const
+{
+  EnsureDerivedData(NormalsFlag);
+  return MakeSpan(mCornersNormals);
+}
+
+Span<Vec2f> Mesh::GetCornersTextureCoordinates() const { return MakeSpan(mCornersTextureCoordinates); }
+
+Span<Mesh::FaceVerticesIds> Mesh::GetFacesVerticesIds() const { return MakeSpan(mFacesVerticesIds); }
+
+Span<Vec3f> Mesh::GetFacesNormals() const
+{
+  EnsureDerivedData(NormalsFlag);
+  return MakeSpan(mFacesNormals);
+}
+
+MutableSpan<Vec3f> Mesh::GetMutableVerticesPositions()
+{
+  mDirtyRanges.mValue.mVertices.Add(0, GetNumberOfVertices());
+  InvalidateDerivedData(PositionsDerivedDataFlags);
+  mGeneration.Bump();
+  return MakeMutableSpan(mVerticesPositions.data(), mVerticesPositions.size());
+}
+
+MutableSpan<Vec3f> Mesh::GetMutableCornersNormals()
+{
+  DisableAutoNormals();
+  mDirtyRanges.mValue.mCorners.Add(0, GetNumberOfCorners());
+  mGeneration.Bump();
+  return MakeMutableSpan(mCornersNormals.data(), mCornersNormals.size());
+}
 
-const std::vector<Mesh::CornerData>& Mesh::GetCornersData() const { return mCornersData; }
+MutableSpan<Vec2f> Mesh::GetMutableCornersTextureCoordinates()
+{
+  mDirtyRanges.mValue.mCorners.Add(0, GetNumberOfCorners());
+  mGeneration.Bump();
+  return MakeMutableSpan(mCornersTextureCoordinates.data(), mCornersTextureCoordinates.size());
+}
 
-const std::vector<Mesh::FaceData>& Mesh::GetFacesData() const { return mFacesData; }
+MutableSpan<Vec3f> Mesh::GetMutableFacesNormals()
+{
+  DisableAutoNormals();
+  mDirtyRanges.mValue.mFaces.Add(0, GetNumberOfFaces());
+  mGeneration.Bump();
+  return MakeMutableSpan(mFacesNormals.data(), mFacesNormals.size());
+}
 
-std::size_t Mesh::GetNumberOfFaces() const { return mFacesData.size(); }
+std::size_t Mesh::GetNumberOfFaces() const { return mFacesVerticesIds.size(); }
 
-std::size_t Mesh::GetNumberOfVertices() const { return mVerticesData.size(); }
+std::size_t Mesh::GetNumberOfVertices() const { return mVerticesPositions.size(); }
 
-std::size_t Mesh::GetNumberOfCorners() const { return mCornersData.size(); }
+std::size_t Mesh::GetNumberOfCorners() const { return mCornersNormals.size(); }
 
 void Mesh::ComputeFaceNormals()
 {
-  for (auto& face_data : mFacesData)
+  DisableAutoNormals();
+  UpdateFacesNormals();
+  mDirtyRanges.mValue.mFaces.Add(0, GetNumberOfFaces());
+  mGeneration.Bump();
+}
+
+void Mesh::ComputeCornerNormals(const float inMinEdgeAngleToSmooth, const Mesh::ENormalWeighting inWeighting)
+{
+  DisableAutoNormals();
+  EnsureDerivedData(VertexCornersIndexFlag);
+  UpdateCornersNormals(inMinEdgeAngleToSmooth, inWeighting);
+  mDirtyRanges.mValue.mCorners.Add(0, GetNumberOfCorners());
+  mGeneration.Bump();
+}
+
+void Mesh::ComputeNormals(const float inMinEdgeAngleToSmooth, const Mesh::ENormalWeighting inWeighting)
+{
+  ComputeFaceNormals();
+  ComputeCornerNormals(inMinEdgeAngleToSmooth, inWeighting);
+}
+
+void Mesh::SetAutoNormals(const float inMinEdgeAngleToSmooth, const Mesh::ENormalWeighting inWeighting)
+{
+  mAutoNormals = Mesh::AutoNormals { inMinEdgeAngleToSmooth, inWeighting };
+  InvalidateDerivedData(NormalsFlag);
+  mGeneration.Bump();
+}
+
+void Mesh::DisableAutoNormals()
+{
+  if (!HasAutoNormals())
+    return;
+
+  // Pending normals are computed first, so that the ones not written afterwards are right
+  EnsureDerivedData(NormalsFlag);
+  mAutoNormals.reset();
+}
+
+void Mesh::UpdateFacesNormals() const
+{
+  ParallelFor(GetNumberOfFaces(),
+      [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          const auto& face_vertices_ids = mFacesVerticesIds[face_id];
+          const auto& vertex_position_0 = mVerticesPositions[face_vertices_ids[0]];
+          const auto& vertex_position_1 = mVerticesPositions[face_vertices_ids[1]];
+          const auto& vertex_position_2 = mVerticesPositions[face_vertices_ids[2]];
+          const auto v1_v0 = (vertex_position_0 - vertex_position_1);
+          const auto v1_v2 = (vertex_position_2 - vertex_position_1);
+          mFacesNormals[face_id] = NormalizedSafe(Cross(v1_v2, v1_v0));
+        }
+      });
+}
+
+void Mesh::UpdateCornersNormals(const float inMinEdgeAngleToSmooth, const Mesh::ENormalWeighting inWeighting) const
+{
+  EXPECTS(HasVertexCornersIndex());
+
+  // Every vertex fan is visited once: its faces normals and weights are gathered, and then each corner of the fan
+  // sums the weighted normals of the faces of the fan that are within the angle threshold of its own face.
+  const auto min_edge_dot_to_smooth = std::cos(inMinEdgeAngleToSmooth);
+  const auto smooth_all = (min_edge_dot_to_smooth <= -1.0f);
+  ParallelFor(GetNumberOfVertices(),
+      [&](const std::size_t, const std::size_t inBeginVertexId, const std::size_t inEndVertexId)
+      {
+        std::vector<Vec3f> fan_faces_normals; // Reused by all the vertices of the chunk
+        std::vector<Vec3f> fan_faces_weighted_normals;
+        for (auto vertex_id = inBeginVertexId; vertex_id < inEndVertexId; ++vertex_id)
+        {
+          const auto vertex_corners_ids_begin = GetVertexCornersIdsBegin(vertex_id);
+          const auto number_of_fan_corners
+              = static_cast<std::size_t>(GetVertexCornersIdsEnd(vertex_id) - vertex_corners_ids_begin);
+
+          fan_faces_normals.resize(number_of_fan_corners);
+          fan_faces_weighted_normals.resize(number_of_fan_corners);
+          auto fan_normal_sum = Zero<Vec3f>();
+          for (std::size_t i = 0; i < number_of_fan_corners; ++i)
+          {
+            const auto corner_id = vertex_corners_ids_begin[i];
+            fan_faces_normals[i] = mFacesNormals[corner_id / 3];
+            fan_faces_weighted_normals[i] = fan_faces_normals[i] * GetCornerNormalWeight(corner_id, inWeighting);
+            fan_normal_sum += fan_faces_weighted_normals[i];
+          }
+
+          if (smooth_all)
+          {
+            const auto corner_normal = NormalizedSafe(fan_normal_sum);
+            for (std::size_t i = 0; i < number_of_fan_corners; ++i)
+              mCornersNormals[vertex_corners_ids_begin[i]] = corner_normal;
+            continue;
+          }
+
+          for (std::size_t i = 0; i < number_of_fan_corners; ++i)
+          {
+            auto normal_sum = Zero<Vec3f>();
+            for (std::size_t j = 0; j < number_of_fan_corners; ++j)
+            {
+              const auto edge_dot = Dot(fan_faces_normals[i], fan_faces_normals[j]);
+              if (edge_dot >= min_edge_dot_to_smooth)
+                normal_sum += fan_faces_weighted_normals[j];
+            }
+            mCornersNormals[vertex_corners_ids_begin[i]] = NormalizedSafe(normal_sum);
+          }
+        }
+      },
+      DefaultParallelMinChunkSize / 4);
+}
+
+float Mesh::GetCornerNormalWeight(const Mesh::CornerId inCornerId, const Mesh::ENormalWeighting inWeighting) const
+{
+  if (inWeighting == Mesh::ENormalWeighting::UNIFORM)
+    return 1.0f;
+
+  const auto& face_vertices_ids = mFacesVerticesIds[inCornerId / 3];
+  const auto internal_corner_id = (inCornerId % 3);
+  const auto& corner_position = mVerticesPositions[face_vertices_ids[internal_corner_id]];
+  const auto to_next = (mVerticesPositions[face_vertices_ids[(internal_corner_id + 1) % 3]] - corner_position);
+  const auto to_previous = (mVerticesPositions[face_vertices_ids[(internal_corner_id + 2) % 3]] - corner_position);
+
+  if (inWeighting == Mesh::ENormalWeighting::AREA)
+    return Length(Cross(to_next, to_previous)) * 0.5f;
+
+  // Angle of the face at the corner
+  const auto corner_cos = Dot(NormalizedSafe(to_next), NormalizedSafe(to_previous));
+  return std::acos(std::clamp(corner_cos, -1.0f, 1.0f));
+}
+
+void Mesh::ComputeCornerTable(const bool inComputeVertexCornersIndex)
+{
+  const auto sorted_corners_edges_keys = GetSortedCornersEdgesKeys();
+  UpdateOppositeCorners(sorted_corners_edges_keys);
+  UpdateEdges(sorted_corners_edges_keys);
+  mDerivedData.SetComputed(CornerTableFlag | EdgesFlag);
+  if (inComputeVertexCornersIndex)
   {
-    const auto vertex_position_0 = mVerticesData.at(face_data.mVerticesIds[0]).mPosition;
-    const auto vertex_position_1 = mVerticesData.at(face_data.mVerticesIds[1]).mPosition;
-    const auto vertex_position_2 = mVerticesData.at(face_data.mVerticesIds[2]).mPosition;
-    const auto v1_v0 = (vertex_position_0 - vertex_position_1);
-    const auto v1_v2 = (vertex_position_2 - vertex_position_1);
-    const auto face_normal = NormalizedSafe(Cross(v1_v2, v1_v0));
-    face_data.mNormal = face_normal;
+    UpdateVertexCornersIndex();
+    mDerivedData.SetComputed(VertexCornersIndexFlag);
   }
+  // Derived topology only: no stream changes, so the generation stays and the uploaded draw data stays valid
 }
 
-void Mesh::ComputeCornerNormals(const float inMinEdgeAngleToSmooth)
+Mesh::CornersEdgesKeys Mesh::GetSortedCornersEdgesKeys() const
 {
-  const auto min_edge_dot_to_smooth = std::cos(inMinEdgeAngleToSmooth);
-  for (Mesh::CornerId corner_id = 0; corner_id < mCornersData.size(); ++corner_id)
+  // Once sorted, the corners facing the same edge are contiguous
+  Mesh::CornersEdgesKeys corners_edge_keys(GetNumberOfCorners());
+  ParallelFor(GetNumberOfFaces(),
+      [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          const auto& face_vertices_ids = mFacesVerticesIds[face_id];
+          for (Mesh::InternalCornerId internal_corner_id = 0; internal_corner_id < 3; ++internal_corner_id)
+          {
+            const auto edge = Mesh::Edge(face_vertices_ids[(internal_corner_id + 1) % 3],
+                face_vertices_ids[(internal_corner_id + 2) % 3]);
+            const auto corner_id = static_cast<Mesh::CornerId>(face_id * 3 + internal_corner_id);
+            corners_edge_keys[corner_id] = std::make_pair(edge.GetKey(), corner_id);
+          }
+        }
+      });
+
+  ParallelSort(corners_edge_keys.begin(), corners_edge_keys.end());
+  return corners_edge_keys;
+}
+
+void Mesh::UpdateOppositeCorners(const Mesh::CornersEdgesKeys& inSortedCornersEdgesKeys) const
+{
+  // Two corners facing the same edge are opposite each other. More than two means the edge is non-manifold, and those
+  // are left without opposite instead of being paired arbitrarily.
+  const auto& corners_edge_keys = inSortedCornersEdgesKeys;
+  const auto number_of_corners = GetNumberOfCorners();
+  std::fill(mCornersOppositeCornersIds.begin(), mCornersOppositeCornersIds.end(), Mesh::InvalidId);
+
+  // Each chunk handles the runs of equal keys that start inside it, even if they end in the next chunk
+  const auto number_of_chunks = GetNumberOfParallelChunks(number_of_corners);
+  std::vector<std::vector<Mesh::CornerId>> chunks_non_manifold_corners_ids(number_of_chunks);
+  ParallelFor(number_of_corners,
+      [&](const std::size_t inChunkId, const std::size_t inBegin, const std::size_t inEnd)
+      {
+        auto run_begin = inBegin;
+        while (run_begin > 0 && run_begin < inEnd
+            && corners_edge_keys[run_begin].first == corners_edge_keys[run_begin - 1].first)
+          ++run_begin;
+
+        while (run_begin < inEnd)
+        {
+          const auto edge_key = corners_edge_keys[run_begin].first;
+          auto run_end = run_begin + 1;
+          while (run_end < number_of_corners && corners_edge_keys[run_end].first == edge_key) ++run_end;
+
+          const auto run_size = (run_end - run_begin);
+          if (run_size == 2)
+          {
+            const auto corner_id = corners_edge_keys[run_begin].second;
+            const auto other_corner_id = corners_edge_keys[run_begin + 1].second;
+            if (GetFaceIdFromCornerId(corner_id) != GetFaceIdFromCornerId(other_corner_id)) // Not a degenerate face
+            {
+              mCornersOppositeCornersIds[corner_id] = other_corner_id;
+              mCornersOppositeCornersIds[other_corner_id] = corner_id;
+            }
+          }
+          else if (run_size > 2)
+          {
+            chunks_non_manifold_corners_ids[inChunkId].push_back(corners_edge_keys[run_begin].second);
+          }
+          run_begin = run_end;
+        }
+      });
+
+  mNonManifoldCornersIds.clear();
+  for (const auto& chunk_non_manifold_corners_ids : chunks_non_manifold_corners_ids)
+  {
+    mNonManifoldCornersIds.insert(mNonManifoldCornersIds.end(),
+        chunk_non_manifold_corners_ids.begin(),
+        chunk_non_manifold_corners_ids.end());
+  }
+}
+
+void Mesh::ComputeDerivedData(const Mesh::DerivedDataFlags inFlags) const
+{
+  // Readers getting here at the same time wait for the first one, and then find nothing missing. Every flag is set as
+  // soon as its data is ready, so that the computations needing it go through the regular queries without locking.
+  std::lock_guard lock(mDerivedData.mMutex);
+
+  auto missing_flags = (inFlags & ~mDerivedData.GetComputedFlags());
+  if ((missing_flags & NormalsFlag) != 0) // The corner normals go through the vertex->corners index
+    missing_flags |= (VertexCornersIndexFlag & ~mDerivedData.GetComputedFlags());
+
+  if ((missing_flags & (CornerTableFlag | EdgesFlag)) != 0) // Both from the same sorted edges keys
   {
-    auto& corner_data = mCornersData.at(corner_id);
-    const auto face_id = (corner_id / 3);
-    const auto internal_corner_id = (corner_id % 3);
-    const auto vertex_id = mFacesData.at(face_id).mVerticesIds.at(internal_corner_id);
-    const auto& face_normal = mFacesData.at(face_id).mNormal;
-
-    const auto neighbor_face_ids = GetNeighborFacesIds(vertex_id);
-    auto normal_sum = Zero<Vec3f>();
-    for (const auto& neighbor_face_id : neighbor_face_ids)
+    const auto sorted_corners_edges_keys = GetSortedCornersEdgesKeys();
+    if ((missing_flags & CornerTableFlag) != 0)
     {
-      const auto& neighbor_face_normal = mFacesData.at(neighbor_face_id).mNormal;
+      UpdateOppositeCorners(sorted_corners_edges_keys);
+      mDerivedData.SetComputed(CornerTableFlag);
+    }
 
-      const auto edge_dot = Dot(face_normal, neighbor_face_normal);
-      if (edge_dot >= min_edge_dot_to_smooth)
-        normal_sum += neighbor_face_normal;
+    if ((missing_flags & EdgesFlag) != 0)
+    {
+      UpdateEdges(sorted_corners_edges_keys);
+      mDerivedData.SetComputed(EdgesFlag);
     }
+  }
+
+  if ((missing_flags & VertexCornersIndexFlag) != 0)
+  {
+    UpdateVertexCornersIndex();
+    mDerivedData.SetComputed(VertexCornersIndexFlag);
+  }
+
+  if ((missing_flags & NormalsFlag) != 0)
+  {
+    EXPECTS(HasAutoNormals());
+    UpdateFacesNormals();
+    UpdateCornersNormals(mAutoNormals->mMinEdgeAngleToSmooth, mAutoNormals->mWeighting);
+    mDerivedData.SetComputed(NormalsFlag);
+  }
 
-    const auto corner_normal = NormalizedSafe(normal_sum);
-    corner_data.mNormal = corner_normal;
+  if ((missing_flags & TrianglesFlag) != 0)
+  {
+    UpdateTriangles();
+    mDerivedData.SetComputed(TrianglesFlag);
+  }
+
+  if ((missing_flags & BoundsFlag) != 0)
+  {
+    UpdateBounds();
+    mDerivedData.SetComputed(BoundsFlag);
   }
 }
 
-void Mesh::ComputeNormals(const float inMinEdgeAngleToSmooth)
+void Mesh::InvalidateDerivedData(const Mesh::DerivedDataFlags inFlags)
 {
-  ComputeFaceNormals();
-  ComputeCornerNormals(inMinEdgeAngleToSmooth);
+  auto flags = inFlags;
+  if (!HasAutoNormals())
+  {
+    flags &= ~NormalsFlag; // Regular attributes, never missing
+  }
+  else if ((flags & NormalsFlag) != 0)
+  {
+    // They change on the next read, derived data synced before has to update them
+    mDirtyRanges.mValue.mCorners.Add(0, GetNumberOfCorners());
+    mDirtyRanges.mValue.mFaces.Add(0, GetNumberOfFaces());
+  }
+  mDerivedData.Invalidate(flags);
 }
 
-void Mesh::ComputeCornerTable()
+void Mesh::UpdateTriangles() const
 {
-  std::vector<std::vector<FaceId>> vertex_to_neighbor_faces_ids(GetNumberOfVertices());
-  std::for_each(vertex_to_neighbor_faces_ids.begin(), vertex_to_neighbor_faces_ids.end(), [](auto& v) {
-    v.reserve(6);
-  });
+  mTriangles.clear();
+  mTriangles.reserve(GetNumberOfFaces());
+  for (const auto& face_vertices_ids : mFacesVerticesIds)
+  {
+    mTriangles.emplace_back(mVerticesPositions[face_vertices_ids[0]],
+        mVerticesPositions[face_vertices_ids[1]],
+        mVerticesPositions[face_vertices_ids[2]]);
+  }
+}
 
-  for (FaceId face_id = 0; face_id < GetNumberOfFaces(); ++face_id)
+void Mesh::UpdateBounds() const
+{
+  const auto number_of_vertices = GetNumberOfVertices();
+  if (number_of_vertices == 0)
   {
-    const auto face_vertices_ids = mFacesData.at(face_id).mVerticesIds;
-    for (const auto& face_vertex_id : face_vertices_ids)
-    { vertex_to_neighbor_faces_ids.at(face_vertex_id).push_back(face_id); }
+    mBoundingAABox = AABoxf { Zero<Vec3f>(), Zero<Vec3f>() };
+    mBoundingSphere = Spheref { Zero<Vec3f>(), 0.0f };
+    return;
   }
 
-  for (VertexId vertex_id = 0; vertex_id < GetNumberOfVertices(); ++vertex_id)
+  // Bounding box reduced from the chunks ones, and then the sphere around its center
+  const auto number_of_chunks = GetNumberOfParallelChunks(number_of_vertices);
+  std::vector<std::pair<Vec3f, Vec3f>> chunks_min_max_positions(number_of_chunks,
+      std::make_pair(mVerticesPositions.front(), mVerticesPositions.front()));
+  ParallelFor(number_of_vertices,
+      [&](const std::size_t inChunkId, const std::size_t inBeginVertexId, const std::size_t inEndVertexId)
+      {
+        auto& [min_position, max_position] = chunks_min_max_positions[inChunkId];
+        for (auto vertex_id = inBeginVertexId; vertex_id < inEndVertexId; ++vertex_id)
+        {
+          const auto& position = mVerticesPositions[vertex_id];
+          for (std::size_t i = 0; i < 3; ++i)
+          {
+            min_position[i] = std::min(min_position[i], position[i]);
+            max_position[i] = std::max(max_position[i], position[i]);
+          }
+        }
+      });
+
+  auto [min_position, max_position] = chunks_min_max_positions.front();
+  for (const auto& [chunk_min_position, chunk_max_position] : chunks_min_max_positions)
   {
-    const auto& vertex_neighbor_faces_ids = vertex_to_neighbor_faces_ids.at(vertex_id);
-    for (const auto& vertex_neighbor_face_id : vertex_neighbor_faces_ids)
+    for (std::size_t i = 0; i < 3; ++i)
     {
-      const auto face_other_vertices_id = GetFaceOtherVertexIds(vertex_neighbor_face_id, vertex_id);
-      for (std::size_t i = 0; i <= 1; ++i)
+      min_position[i] = std::min(min_position[i], chunk_min_position[i]);
+      max_position[i] = std::max(max_position[i], chunk_max_position[i]);
+    }
+  }
+  mBoundingAABox = AABoxf { min_position, max_position };
+
+  const auto center = (min_position + max_position) * 0.5f;
+  std::vector<float> chunks_max_squared_distances(number_of_chunks, 0.0f);
+  ParallelFor(number_of_vertices,
+      [&](const std::size_t inChunkId, const std::size_t inBeginVertexId, const std::size_t inEndVertexId)
       {
-        for (const auto& other_vertex_neighbor_face_id : vertex_neighbor_faces_ids)
+        auto& max_squared_distance = chunks_max_squared_distances[inChunkId];
+        for (auto vertex_id = inBeginVertexId; vertex_id < inEndVertexId; ++vertex_id)
         {
-          if (vertex_neighbor_face_id == other_vertex_neighbor_face_id)
-            continue;
+          const auto center_to_position = (mVerticesPositions[vertex_id] - center);
+          max_squared_distance = std::max(max_squared_distance, Dot(center_to_position, center_to_position));
+        }
+      });
+  const auto max_squared_distance
+      = *std::max_element(chunks_max_squared_distances.cbegin(), chunks_max_squared_distances.cend());
+  mBoundingSphere = Spheref { center, std::sqrt(max_squared_distance) };
+}
 
-          const auto other_face_other_vertices_id = GetFaceOtherVertexIds(other_vertex_neighbor_face_id, vertex_id);
-          auto matching_face_other_vertices_corner_i = Max<InternalCornerId>();
-          auto matching_other_face_other_vertices_corner_i = Max<InternalCornerId>();
-          for (std::size_t j = 0; j <= 1; ++j)
+void Mesh::ClearDirtyRanges()
+{
+  // Derived data synced now can keep updating partially
+  mDirtyRanges.mValue = Mesh::DirtyRanges {};
+  mDirtyRanges.mValue.mBeginGeneration = GetGeneration();
+}
+
+void Mesh::OnTopologyChanged()
+{
+  mDirtyRanges.Reset(); // Partial updates are not possible anymore
+  InvalidateDerivedData(AllDerivedDataFlags);
+  mGeneration.Bump();
+}
+
+void Mesh::UpdateVertexCornersIndex() const
+{
+  // Counting sort of the corners by vertex id: count, prefix sum to get the offsets, and scatter
+  const auto number_of_corners = GetNumberOfCorners();
+  mVertexCornersOffsets.assign(GetNumberOfVertices() + 1, 0);
+  for (const auto& face_vertices_ids : mFacesVerticesIds)
+  {
+    for (const auto& face_vertex_id : face_vertices_ids) { ++mVertexCornersOffsets[face_vertex_id + 1]; }
+  }
+  std::partial_sum(mVertexCornersOffsets.cbegin(), mVertexCornersOffsets.cend(), mVertexCornersOffsets.begin());
+
+  auto vertex_corners_heads = std::vector<Mesh::Id>(mVertexCornersOffsets.cbegin(), mVertexCornersOffsets.cend() - 1);
+  mVertexCornersIds.resize(number_of_corners);
+  for (Mesh::CornerId corner_id = 0; corner_id < number_of_corners; ++corner_id)
+  {
+    const auto vertex_id = mFacesVerticesIds[corner_id / 3][corner_id % 3];
+    mVertexCornersIds[vertex_corners_heads[vertex_id]++] = corner_id;
+  }
+}
+
+std::vector<Mesh::Edge> Mesh::GetNonManifoldEdges() const
+{
+  EnsureDerivedData(CornerTableFlag);
+
+  std::vector<Mesh::Edge> non_manifold_edges;
+  non_manifold_edges.reserve(mNonManifoldCornersIds.size());
+  for (const auto& non_manifold_corner_id : mNonManifoldCornersIds)
+  {
+    non_manifold_edges.emplace_back(GetVertexIdFromCornerId(GetNextCornerId(non_manifold_corner_id)),
+        GetVertexIdFromCornerId(GetPreviousCornerId(non_manifold_corner_id)));
+  }
+  return non_manifold_edges;
+}
+
+std::size_t Mesh::GetNumberOfEdges() const
+{
+  EnsureDerivedData(EdgesFlag);
+  return mEdges.size();
+}
+
+Span<Mesh::Edge> Mesh::GetEdges() const
+{
+  EnsureDerivedData(EdgesFlag);
+  return MakeSpan(mEdges);
+}
+
+const Mesh::Edge& Mesh::GetEdge(const Mesh::EdgeId inEdgeId) const
+{
+  EnsureDerivedData(EdgesFlag);
+  EXPECTS(inEdgeId < mEdges.size());
+  return mEdges[inEdgeId];
+}
+
+Mesh::EdgeId Mesh::GetEdgeId(const Mesh::Edge& inEdge) const
+{
+  EnsureDerivedData(EdgesFlag);
+  if (mEdgesHashTable.empty())
+    return Mesh::InvalidId;
+
+  const auto key = inEdge.GetKey();
+  const auto slots_mask = (mEdgesHashTable.size() - 1);
+  for (auto slot = (Mesh::Edge::GetKeyHash(key) & slots_mask); mEdgesHashTable[slot] != Mesh::InvalidId;
+       slot = ((slot + 1) & slots_mask))
+  {
+    if (mEdges[mEdgesHashTable[slot]].GetKey() == key)
+      return mEdgesHashTable[slot];
+  }
+  return Mesh::InvalidId;
+}
+
+Mesh::EdgeId Mesh::GetCornerEdgeId(const Mesh::CornerId inCornerId) const
+{
+  EXPECTS(inCornerId < GetNumberOfCorners());
+  EnsureDerivedData(EdgesFlag);
+  return mCornersEdgesIds[inCornerId];
+}
+
+std::array<Mesh::CornerId, 2> Mesh::GetEdgeCornersIds(const Mesh::EdgeId inEdgeId) const
+{
+  EnsureDerivedData(EdgesFlag);
+  EXPECTS(inEdgeId < mEdgesCornersIds.size());
+  return mEdgesCornersIds[inEdgeId];
+}
+
+Span<Mesh::EdgeId> Mesh::GetVertexEdgesIdsSpan(const Mesh::VertexId inVertexId) const
+{
+  EXPECTS(inVertexId < GetNumberOfVertices());
+  EnsureDerivedData(EdgesFlag);
+  const auto begin = mVertexEdgesOffsets[inVertexId];
+  return MakeSpan(mVertexEdgesIds.data() + begin, mVertexEdgesOffsets[inVertexId + 1] - begin);
+}
+
+void Mesh::UpdateEdges(const Mesh::CornersEdgesKeys& inSortedCornersEdgesKeys) const
+{
+  // Every run of equal keys is an edge. The chunks count the runs starting in them first, so that they can then number
+  // them in order (a chunk starting in the middle of a run continues the id of the previous chunk last run).
+  const auto& corners_edge_keys = inSortedCornersEdgesKeys;
+  const auto number_of_corners = GetNumberOfCorners();
+  const auto is_run_begin = [&](const std::size_t inIndex)
+  { return (inIndex == 0 || corners_edge_keys[inIndex].first != corners_edge_keys[inIndex - 1].first); };
+
+  std::vector<std::size_t> chunks_first_edges_ids(GetNumberOfParallelChunks(number_of_corners) + 1, 0);
+  ParallelFor(number_of_corners,
+      [&](const std::size_t inChunkId, const std::size_t inBegin, const std::size_t inEnd)
+      {
+        for (auto i = inBegin; i < inEnd; ++i) { chunks_first_edges_ids[inChunkId + 1] += (is_run_begin(i) ? 1 : 0); }
+      });
+  std::partial_sum(chunks_first_edges_ids.cbegin(), chunks_first_edges_ids.cend(), chunks_first_edges_ids.begin());
+
+  const auto number_of_edges = chunks_first_edges_ids.back();
+  mEdges.resize(number_of_edges);
+  mEdgesCornersIds.resize(number_of_edges);
+  mCornersEdgesIds.resize(number_of_corners);
+  ParallelFor(number_of_corners,
+      [&](const std::size_t inChunkId, const std::size_t inBegin, const std::size_t inEnd)
+      {
+        auto edge_id = static_cast<Mesh::EdgeId>(chunks_first_edges_ids[inChunkId] - 1);
+        for (auto i = inBegin; i < inEnd; ++i)
+        {
+          const auto& [edge_key, corner_id] = corners_edge_keys[i];
+          if (is_run_begin(i))
           {
-            if (face_other_vertices_id[i] == other_face_other_vertices_id[j])
-            {
-              matching_face_other_vertices_corner_i = i;
-              matching_other_face_other_vertices_corner_i = j;
-              break;
-            }
+            ++edge_id;
+            auto run_end = i + 1;
+            while (run_end < number_of_corners && corners_edge_keys[run_end].first == edge_key) ++run_end;
+
+            // As the opposite corners, only pairs of corners of different faces are opposite
+            const auto other_corner_id = corners_edge_keys[i + 1 < run_end ? i + 1 : i].second;
+            const auto is_manifold = ((run_end - i) == 2
+                && GetFaceIdFromCornerId(corner_id) != GetFaceIdFromCornerId(other_corner_id));
+            mEdges[edge_id] = Mesh::Edge(edge_key);
+            mEdgesCornersIds[edge_id] = { corner_id, (is_manifold ? other_corner_id : Mesh::InvalidId) };
           }
+          mCornersEdgesIds[corner_id] = edge_id;
+        }
+      });
 
-          const auto found_matching_other_vertex_id = (matching_face_other_vertices_corner_i <= 1);
-          if (!found_matching_other_vertex_id)
-            continue;
+  // Vertex->edges index, as the vertex->corners one. Edges of degenerate faces joining a vertex to itself once.
+  mVertexEdgesOffsets.assign(GetNumberOfVertices() + 1, 0);
+  for (const auto& edge : mEdges)
+  {
+    ++mVertexEdgesOffsets[edge[0] + 1];
+    if (edge[1] != edge[0])
+      ++mVertexEdgesOffsets[edge[1] + 1];
+  }
+  std::partial_sum(mVertexEdgesOffsets.cbegin(), mVertexEdgesOffsets.cend(), mVertexEdgesOffsets.begin());
 
-          const auto corner_id = GetCornerIdFromFaceIdAndVertexId(vertex_neighbor_face_id,
-              face_other_vertices_id[1 - matching_face_other_vertices_corner_i]);
-          const auto other_corner_id = GetCornerIdFromFaceIdAndVertexId(other_vertex_neighbor_face_id,
-              other_face_other_vertices_id[1 - matching_other_face_other_vertices_corner_i]);
-          mCornersData.at(corner_id).mOppositeCornerId = other_corner_id;
-          mCornersData.at(other_corner_id).mOppositeCornerId = corner_id;
-          break;
-        }
-      }
-    }
+  auto vertex_edges_heads = std::vector<Mesh::Id>(mVertexEdgesOffsets.cbegin(), mVertexEdgesOffsets.cend() - 1);
+  mVertexEdgesIds.resize(mVertexEdgesOffsets.back());
+  for (Mesh::EdgeId edge_id = 0; edge_id < number_of_edges; ++edge_id)
+  {
+    const auto& edge = mEdges[edge_id];
+    mVertexEdgesIds[vertex_edges_heads[edge[0]]++] = edge_id;
+    if (edge[1] != edge[0])
+      mVertexEdgesIds[vertex_edges_heads[edge[1]]++] = edge_id;
   }
 
-  mCornerTableComputed = true;
+  // At most half full, so that probe sequences stay short
+  mEdgesHashTable.assign(number_of_edges == 0 ? 0 : std::bit_ceil(number_of_edges * 2), Mesh::InvalidId);
+  const auto slots_mask = (mEdgesHashTable.size() - 1);
+  for (Mesh::EdgeId edge_id = 0; edge_id < number_of_edges; ++edge_id)
+  {
+    auto slot = (Mesh::Edge::GetKeyHash(mEdges[edge_id].GetKey()) & slots_mask);
+    while (mEdgesHashTable[slot] != Mesh::InvalidId) slot = ((slot + 1) & slots_mask);
+    mEdgesHashTable[slot] = edge_id;
+  }
 }
 
+void Mesh::Read(const std::filesystem::path& inMeshPath)
+{
+  if (inMeshPath.extension() == MeshBinaryIO::Extension)
+  {
+    MeshBinaryIO::Read(inMeshPath, *this);
+    return;
+  }
+
+  if (MeshNativeIO::Read(inMeshPath, *this))
+    return;
+
 #ifdef MESH_IO
-void Mesh::Read(const std::filesystem::path& inMeshPath) { MeshIO::Read(inMeshPath, *this); }
+  MeshIO::Read(inMeshPath, *this);
+#else
+  THROW_EXCEPTION("Can't read mesh from " << inMeshPath << ": not supported natively, and compiled without MESH_IO");
+#endif
+}
 
-void Mesh::Write(const std::filesystem::path& inMeshPath, const bool inPreserveVerticesIds) const
+void Mesh::Write(const std::filesystem::path& inMeshPath, [[maybe_unused]] const bool inPreserveVerticesIds) const
 {
+  if (inMeshPath.extension() == MeshBinaryIO::Extension)
+  {
+    MeshBinaryIO::Write(*this, inMeshPath);
+    return;
+  }
+
+#ifdef MESH_IO
   MeshIO::Write(*this, inMeshPath, inPreserveVerticesIds);
-}
+#else
+  THROW_EXCEPTION("Can't write mesh to " << inMeshPath << ": compiled without MESH_IO, only .ezmesh is supported");
 #endif
+}
 
 std::ostream& operator<<(std::ostream& ioLHS, const Mesh::Edge& inRHS)
 {
   ioLHS << "Edge<" << inRHS[0] << ", " << inRHS[1] << ">";
   return ioLHS;
 }
-
-std::ostream& operator<<(std::ostream& ioLHS, const Mesh::VertexData& inRHS)
-{
-  ioLHS << "VertexData<Position: " << inRHS.mPosition << ">";
-  return ioLHS;
-}
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include <ez/MeshBinaryIO.h>
+#include <ez/Macros.h>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace ez
+{
+namespace
+{
+static_assert(std::endian::native == std::endian::little, "The .ezmesh streams are stored little-endian");
+static_assert(sizeof(Vec3f) == 3 * sizeof(float) && std::is_trivially_copyable_v<Vec3f>);
+static_assert(sizeof(Vec2f) == 2 * sizeof(float) && std::is_trivially_copyable_v<Vec2f>);
+static_assert(sizeof(Mesh::FaceVerticesIds) == 3 * sizeof(Mesh::VertexId));
+
+// Streams in the order they are stored (and hashed)
+enum class EStream
+{
+  VERTICES_POSITIONS,
+  VERTICES_FACE_IDS,
+  CORNERS_OPPOSITE_CORNERS_IDS,
+  CORNERS_NORMALS,
+  CORNERS_TEXTURE_COORDINATES,
+  FACES_VERTICES_IDS,
+  FACES_NORMALS,
+  NON_MANIFOLD_CORNERS_IDS,
+  VERTEX_CORNERS_OFFSETS,
+  VERTEX_CORNERS_IDS
+};
+constexpr std::size_t NumberOfStreams = 10;
+
+constexpr std::array<char, 8> Magic = { 'E', 'Z', 'M', 'E', 'S', 'H', '\0', '\0' };
+constexpr std::size_t StreamsAlignment = 16;
+constexpr uint32_t CornerTableComputedFlag = 1;
+
+struct FileStream
+{
+  uint64_t mOffset = 0; // In bytes, from the beginning of the file
+  uint64_t mSize = 0;   // In bytes
+};
+
+struct FileHeader
+{
+  std::array<char, 8> mMagic = Magic;
+  uint32_t mVersion = MeshBinaryIO::Version;
+  uint32_t mFlags = 0;
+  uint64_t mChecksum = 0;
+  uint64_t mReserved = 0; // Pads the header to the streams alignment
+  std::array<FileStream, NumberOfStreams> mStreams;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader> && sizeof(FileHeader) % StreamsAlignment == 0);
+
+struct StreamBytes
+{
+  const std::byte* mData = nullptr;
+  std::size_t mSize = 0;
+};
+
+template <typename T>
+StreamBytes GetStreamBytes(const Span<T>& inSpan)
+{
+  return StreamBytes { reinterpret_cast<const std::byte*>(inSpan.GetData()), inSpan.GetNumberOfElements() * sizeof(T) };
+}
+
+uint64_t ComputeStreamsChecksum(const std::array<StreamBytes, NumberOfStreams>& inStreamsBytes)
+{
+  uint64_t checksum = 0;
+  for (const auto& stream_bytes : inStreamsBytes)
+    checksum = MeshBinaryIO::ComputeChecksum(stream_bytes.mData, stream_bytes.mSize, checksum);
+  return checksum;
+}
+
+constexpr uint64_t HashPrime0 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t HashPrime1 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t HashPrime2 = 0x165667B19E3779F9ull;
+constexpr uint64_t HashPrime3 = 0x85EBCA77C2B2AE63ull;
+
+uint64_t HashRound(const uint64_t inAccumulator, const uint64_t inWord)
+{
+  return std::rotl(inAccumulator + inWord * HashPrime1, 31) * HashPrime0;
+}
+
+uint64_t LoadWord(const std::byte* inData)
+{
+  uint64_t word;
+  std::memcpy(&word, inData, sizeof(word));
+  return word;
+}
+}
+
+uint64_t MeshBinaryIO::ComputeChecksum(const std::byte* inData, const std::size_t inSize, const uint64_t inSeed)
+{
+  // XXH64-like: four independent lanes over 32-byte blocks, so that it runs at memory bandwidth
+  const auto* data = inData;
+  const auto* data_end = inData + inSize;
+  std::array<uint64_t, 4> lanes
+      = { inSeed + HashPrime0 + HashPrime1, inSeed + HashPrime1, inSeed, inSeed - HashPrime0 };
+  for (; data + 32 <= data_end; data += 32)
+  {
+    for (std::size_t lane_id = 0; lane_id < lanes.size(); ++lane_id)
+      lanes[lane_id] = HashRound(lanes[lane_id], LoadWord(data + lane_id * 8));
+  }
+
+  auto hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+  hash += static_cast<uint64_t>(inSize);
+  for (; data + 8 <= data_end; data += 8) hash = std::rotl(hash ^ HashRound(0, LoadWord(data)), 27) * HashPrime0;
+  for (; data < data_end; ++data)
+    hash = std::rotl(hash ^ (static_cast<uint64_t>(*data) * HashPrime2), 11) * HashPrime0;
+
+  // Avalanche
+  hash ^= (hash >> 33);
+  hash *= HashPrime1;
+  hash ^= (hash >> 29);
+  hash *= HashPrime3;
+  hash ^= (hash >> 32);
+  return hash;
+}
+
+void MeshBinaryIO::Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath)
+{
+  std::ofstream file(inMeshPath, std::ios::binary | std::ios::trunc);
+  if (!file)
+    THROW_EXCEPTION("Could not open " << inMeshPath << " for writing");
+
+  // The corner table is stored only if computed (a stale one would be invalid), while pending auto normals are
+  // computed, as they are written as regular attributes
+  const auto has_vertex_corners_index = inMesh.HasVertexCornersIndex();
+  const std::array<StreamBytes, NumberOfStreams> streams_bytes = {
+    GetStreamBytes(MakeSpan(inMesh.mVerticesPositions)),
+    GetStreamBytes(MakeSpan(inMesh.mVerticesFaceIds)),
+    GetStreamBytes(MakeSpan(inMesh.mCornersOppositeCornersIds)),
+    GetStreamBytes(inMesh.GetCornersNormals()),
+    GetStreamBytes(MakeSpan(inMesh.mCornersTextureCoordinates)),
+    GetStreamBytes(MakeSpan(inMesh.mFacesVerticesIds)),
+    GetStreamBytes(inMesh.GetFacesNormals()),
+    GetStreamBytes(MakeSpan(inMesh.mNonManifoldCornersIds)),
+    has_vertex_corners_index ? GetStreamBytes(MakeSpan(inMesh.mVertexCornersOffsets)) : StreamBytes {},
+    has_vertex_corners_index ? GetStreamBytes(MakeSpan(inMesh.mVertexCornersIds)) : StreamBytes {},
+  };
+
+  FileHeader header;
+  header.mFlags = (inMesh.mDerivedData.IsComputed(Mesh::CornerTableFlag) ? CornerTableComputedFlag : 0);
+  header.mChecksum = ComputeStreamsChecksum(streams_bytes);
+
+  // Streams one after the other, aligned so that they can be used right from the mapping
+  auto offset = static_cast<uint64_t>(sizeof(FileHeader));
+  for (std::size_t stream_id = 0; stream_id < NumberOfStreams; ++stream_id)
+  {
+    header.mStreams[stream_id] = FileStream { offset, streams_bytes[stream_id].mSize };
+    offset += streams_bytes[stream_id].mSize;
+    offset = (offset + StreamsAlignment - 1) / StreamsAlignment * StreamsAlignment;
+  }
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  constexpr std::array<char, StreamsAlignment> padding {};
+  for (std::size_t stream_id = 0; stream_id < NumberOfStreams; ++stream_id)
+  {
+    const auto& stream_bytes = streams_bytes[stream_id];
+    file.write(reinterpret_cast<const char*>(stream_bytes.mData), stream_bytes.mSize);
+
+    const auto stream_end = header.mStreams[stream_id].mOffset + stream_bytes.mSize;
+    const auto next_stream_begin = (stream_id + 1 < NumberOfStreams) ? header.mStreams[stream_id + 1].mOffset : offset;
+    file.write(padding.data(), next_stream_begin - stream_end);
+  }
+
+  if (!file)
+    THROW_EXCEPTION("Error writing mesh to " << inMeshPath);
+}
+
+MeshBinaryIO::MappedMesh MeshBinaryIO::Map(const std::filesystem::path& inMeshPath, const bool inVerifyChecksum)
+{
+  MeshBinaryIO::MappedMesh mapped_mesh;
+  mapped_mesh.mMappedFile = MappedFile(inMeshPath);
+  const auto* file_data = mapped_mesh.mMappedFile.GetData();
+  const auto file_size = mapped_mesh.mMappedFile.GetSize();
+
+  FileHeader header;
+  if (file_size < sizeof(FileHeader))
+    THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": the file is too small to be an .ezmesh");
+  std::memcpy(&header, file_data, sizeof(FileHeader));
+  if (header.mMagic != Magic)
+    THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": the file is not an .ezmesh");
+  if (header.mVersion != MeshBinaryIO::Version)
+  {
+    THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": unsupported .ezmesh version " << header.mVersion
+                                               << " (expected " << MeshBinaryIO::Version << ")");
+  }
+
+  // Every stream has to be inside the file, aligned, and with the number of elements of its kind
+  std::array<StreamBytes, NumberOfStreams> streams_bytes;
+  for (std::size_t stream_id = 0; stream_id < NumberOfStreams; ++stream_id)
+  {
+    const auto& stream = header.mStreams[stream_id];
+    const auto is_inside_file = (stream.mOffset <= file_size && stream.mSize <= file_size - stream.mOffset);
+    if (!is_inside_file || stream.mOffset % StreamsAlignment != 0)
+      THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": the file is truncated or corrupted");
+    streams_bytes[stream_id] = StreamBytes { file_data + stream.mOffset, static_cast<std::size_t>(stream.mSize) };
+  }
+
+  const auto get_stream_size
+      = [&](const EStream inStream) { return streams_bytes[static_cast<std::size_t>(inStream)].mSize; };
+  const auto number_of_vertices = get_stream_size(EStream::VERTICES_POSITIONS) / sizeof(Vec3f);
+  const auto number_of_faces = get_stream_size(EStream::FACES_VERTICES_IDS) / sizeof(Mesh::FaceVerticesIds);
+  const auto number_of_corners = number_of_faces * 3;
+  const auto number_of_non_manifold_corners
+      = get_stream_size(EStream::NON_MANIFOLD_CORNERS_IDS) / sizeof(Mesh::CornerId);
+  const auto has_vertex_corners_index = (get_stream_size(EStream::VERTEX_CORNERS_OFFSETS) > 0);
+  const auto streams_sizes_match = (get_stream_size(EStream::VERTICES_POSITIONS) == number_of_vertices * sizeof(Vec3f))
+      && (get_stream_size(EStream::VERTICES_FACE_IDS) == number_of_vertices * sizeof(Mesh::FaceId))
+      && (get_stream_size(EStream::CORNERS_OPPOSITE_CORNERS_IDS) == number_of_corners * sizeof(Mesh::CornerId))
+      && (get_stream_size(EStream::CORNERS_NORMALS) == number_of_corners * sizeof(Vec3f))
+      && (get_stream_size(EStream::CORNERS_TEXTURE_COORDINATES) == number_of_corners * sizeof(Vec2f))
+      && (get_stream_size(EStream::FACES_VERTICES_IDS) == number_of_faces * sizeof(Mesh::FaceVerticesIds))
+      && (get_stream_size(EStream::FACES_NORMALS) == number_of_faces * sizeof(Vec3f))
+      && (get_stream_size(EStream::NON_MANIFOLD_CORNERS_IDS) == number_of_non_manifold_corners * sizeof(Mesh::CornerId))
+      && (get_stream_size(EStream::VERTEX_CORNERS_OFFSETS)
+          == (has_vertex_corners_index ? (number_of_vertices + 1) * sizeof(Mesh::Id) : 0))
+      && (get_stream_size(EStream::VERTEX_CORNERS_IDS)
+          == (has_vertex_corners_index ? number_of_corners * sizeof(Mesh::CornerId) : 0));
+  if (!streams_sizes_match)
+    THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": the streams sizes do not match");
+
+  if (inVerifyChecksum && ComputeStreamsChecksum(streams_bytes) != header.mChecksum)
+    THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": checksum mismatch, the file is corrupted");
+
+  const auto get_stream_data = [&]<typename T>(const EStream inStream, const T*& outData) {
+    const auto& stream_bytes = streams_bytes[static_cast<std::size_t>(inStream)];
+    outData = (stream_bytes.mSize > 0) ? reinterpret_cast<const T*>(stream_bytes.mData) : nullptr;
+  };
+  get_stream_data(EStream::VERTICES_POSITIONS, mapped_mesh.mVerticesPositions);
+  get_stream_data(EStream::VERTICES_FACE_IDS, mapped_mesh.mVerticesFaceIds);
+  get_stream_data(EStream::CORNERS_OPPOSITE_CORNERS_IDS, mapped_mesh.mCornersOppositeCornersIds);
+  get_stream_data(EStream::CORNERS_NORMALS, mapped_mesh.mCornersNormals);
+  get_stream_data(EStream::CORNERS_TEXTURE_COORDINATES, mapped_mesh.mCornersTextureCoordinates);
+  get_stream_data(EStream::FACES_VERTICES_IDS, mapped_mesh.mFacesVerticesIds);
+  get_stream_data(EStream::FACES_NORMALS, mapped_mesh.mFacesNormals);
+  get_stream_data(EStream::NON_MANIFOLD_CORNERS_IDS, mapped_mesh.mNonManifoldCornersIds);
+  get_stream_data(EStream::VERTEX_CORNERS_OFFSETS, mapped_mesh.mVertexCornersOffsets);
+  get_stream_data(EStream::VERTEX_CORNERS_IDS, mapped_mesh.mVertexCornersIds);
+  mapped_mesh.mNumberOfVertices = number_of_vertices;
+  mapped_mesh.mNumberOfFaces = number_of_faces;
+  mapped_mesh.mNumberOfNonManifoldCorners = number_of_non_manifold_corners;
+  mapped_mesh.mCornerTableComputed = ((header.mFlags & CornerTableComputedFlag) != 0);
+  return mapped_mesh;
+}
+
+void MeshBinaryIO::Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh, const bool inVerifyChecksum)
+{
+  const auto mapped_mesh = MeshBinaryIO::Map(inMeshPath, inVerifyChecksum);
+
+  const auto copy_stream = []<typename T>(const Span<T>& inSpan, std::vector<T>& outVector) {
+    outVector.assign(inSpan.GetData(), inSpan.GetData() + inSpan.GetNumberOfElements());
+  };
+  copy_stream(mapped_mesh.GetVerticesPositions(), ioMesh.mVerticesPositions);
+  copy_stream(mapped_mesh.GetVerticesFaceIds(), ioMesh.mVerticesFaceIds);
+  copy_stream(mapped_mesh.GetCornersOppositeCornersIds(), ioMesh.mCornersOppositeCornersIds);
+  copy_stream(mapped_mesh.GetCornersNormals(), ioMesh.mCornersNormals);
+  copy_stream(mapped_mesh.GetCornersTextureCoordinates(), ioMesh.mCornersTextureCoordinates);
+  copy_stream(mapped_mesh.GetFacesVerticesIds(), ioMesh.mFacesVerticesIds);
+  copy_stream(mapped_mesh.GetFacesNormals(), ioMesh.mFacesNormals);
+  copy_stream(mapped_mesh.GetNonManifoldCornersIds(), ioMesh.mNonManifoldCornersIds);
+  copy_stream(mapped_mesh.GetVertexCornersOffsets(), ioMesh.mVertexCornersOffsets);
+  copy_stream(mapped_mesh.GetVertexCornersIds(), ioMesh.mVertexCornersIds);
+  ioMesh.mAutoNormals.reset();
+  ioMesh.OnTopologyChanged();
+  ioMesh.mDerivedData.SetComputed(Mesh::NormalsFlag);
+  if (mapped_mesh.IsCornerTableComputed())
+    ioMesh.mDerivedData.SetComputed(Mesh::CornerTableFlag);
+  if (mapped_mesh.HasVertexCornersIndex())
+    ioMesh.mDerivedData.SetComputed(Mesh::VertexCornersIndexFlag);
+}
+}
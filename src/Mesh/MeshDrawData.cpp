@@ -1,14 +1,159 @@
 #include <ez/MeshDrawData.h>
+#include <ez/MeshletBuilder.h>
 #include <ez/EBO.h>
 #include <ez/StreamOperators.h>
 #include <ez/VAO.h>
 #include <ez/VBO.h>
+#include <ez/VertexAttribEncoding.h>
+#include <ez/VertexCacheOptimizer.h>
+#include <ez/VertexLayout.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <vector>
 
 namespace ez
 {
+namespace
+{
+struct InterleavedVertex
+{
+  Vec3f mPosition;
+  Vec3f mNormal;
+  Vec2f mTextureCoordinates;
+};
+using InterleavedVertexLayout = VertexLayout<InterleavedVertex,
+    VertexLayoutAttrib<Vec3f, offsetof(InterleavedVertex, mPosition), MeshDrawData::PositionAttribLocation()>,
+    VertexLayoutAttrib<Vec3f, offsetof(InterleavedVertex, mNormal), MeshDrawData::NormalAttribLocation()>,
+    VertexLayoutAttrib<Vec2f,
+        offsetof(InterleavedVertex, mTextureCoordinates),
+        MeshDrawData::TextureCoordinateAttribLocation()>>;
+static_assert(InterleavedVertexLayout::VertexSize == 32);
+
+struct PackedVertex
+{
+  Vec3f mPosition;
+  std::array<int16_t, 2> mNormal;
+  std::array<Half, 2> mTextureCoordinates;
+};
+using PackedVertexLayout = VertexLayout<PackedVertex,
+    VertexLayoutAttrib<Vec3f, offsetof(PackedVertex, mPosition), MeshDrawData::PositionAttribLocation()>,
+    VertexLayoutAttrib<std::array<int16_t, 2>,
+        offsetof(PackedVertex, mNormal),
+        MeshDrawData::NormalAttribLocation(),
+        true>,
+    VertexLayoutAttrib<std::array<Half, 2>,
+        offsetof(PackedVertex, mTextureCoordinates),
+        MeshDrawData::TextureCoordinateAttribLocation()>>;
+static_assert(PackedVertexLayout::VertexSize == 20);
+
+struct QuantizedVertex
+{
+  std::array<uint16_t, 3> mPosition;
+  uint16_t mPadding = 0; // Keeps the normal 4 byte aligned
+  std::array<int16_t, 2> mNormal;
+  std::array<Half, 2> mTextureCoordinates;
+};
+using QuantizedVertexLayout = VertexLayout<QuantizedVertex,
+    VertexLayoutAttrib<std::array<uint16_t, 3>,
+        offsetof(QuantizedVertex, mPosition),
+        MeshDrawData::PositionAttribLocation(),
+        true>,
+    VertexLayoutAttrib<std::array<int16_t, 2>,
+        offsetof(QuantizedVertex, mNormal),
+        MeshDrawData::NormalAttribLocation(),
+        true>,
+    VertexLayoutAttrib<std::array<Half, 2>,
+        offsetof(QuantizedVertex, mTextureCoordinates),
+        MeshDrawData::TextureCoordinateAttribLocation()>>;
+static_assert(QuantizedVertexLayout::VertexSize == 16);
+
+// Attributes of a mesh corner as drawn. Corners without normal get the normal of their face.
+struct CornerDrawAttributes
+{
+  Vec3f mPosition;
+  Vec3f mNormal;
+  Vec2f mTextureCoordinates;
 
-MeshDrawData::MeshDrawData(const Mesh& inMesh) { ComputeFromMesh(inMesh); }
+  bool operator==(const CornerDrawAttributes& inRHS) const
+  {
+    return (mPosition == inRHS.mPosition && mNormal == inRHS.mNormal
+        && mTextureCoordinates == inRHS.mTextureCoordinates);
+  }
+};
+
+class MeshCornersDrawAttributes final
+{
+public:
+  explicit MeshCornersDrawAttributes(const Mesh& inMesh)
+      : mVerticesPositions(inMesh.GetVerticesPositions().GetData()),
+        mFacesVerticesIds(inMesh.GetFacesVerticesIds().GetData()),
+        mCornersNormals(inMesh.GetCornersNormals().GetData()),
+        mCornersTextureCoordinates(inMesh.GetCornersTextureCoordinates().GetData()),
+        mFacesNormals(inMesh.GetFacesNormals().GetData())
+  {
+  }
+
+  CornerDrawAttributes Get(const Mesh::CornerId inCornerId) const
+  {
+    const auto& normal = mCornersNormals[inCornerId];
+    return CornerDrawAttributes { mVerticesPositions[mFacesVerticesIds[inCornerId / 3][inCornerId % 3]],
+      (normal == Zero<Vec3f>() ? mFacesNormals[inCornerId / 3] : normal),
+      mCornersTextureCoordinates[inCornerId] };
+  }
+
+private:
+  const Vec3f* mVerticesPositions = nullptr;
+  const Mesh::FaceVerticesIds* mFacesVerticesIds = nullptr;
+  const Vec3f* mCornersNormals = nullptr;
+  const Vec2f* mCornersTextureCoordinates = nullptr;
+  const Vec3f* mFacesNormals = nullptr;
+};
+
+std::array<Half, 2> EncodeHalf2(const Vec2f& inValue) { return { EncodeHalf(inValue[0]), EncodeHalf(inValue[1]) }; }
+
+template <typename TVertexLayout, typename TMakeVertexFunction>
+void UploadInterleavedVertices(VBO& ioVBO,
+    const std::size_t inBeginVertexId,
+    const std::size_t inNumberOfVertices,
+    const TMakeVertexFunction& inMakeVertex)
+{
+  std::vector<typename TVertexLayout::VertexType> vertices(inNumberOfVertices);
+  for (std::size_t i = 0; i < inNumberOfVertices; ++i) { vertices[i] = inMakeVertex(i); }
+  ioVBO.BufferSubData(MakeSpan(vertices), inBeginVertexId * TVertexLayout::VertexSize);
+}
+
+std::size_t GetVertexSizeInBytes(const MeshDrawData::EVertexLayout inVertexLayout)
+{
+  switch (inVertexLayout)
+  {
+  case MeshDrawData::EVertexLayout::SEPARATE:
+    return (sizeof(Vec3f) * 2 + sizeof(Vec2f));
+  case MeshDrawData::EVertexLayout::INTERLEAVED:
+    return InterleavedVertexLayout::VertexSize;
+  case MeshDrawData::EVertexLayout::PACKED:
+    return PackedVertexLayout::VertexSize;
+  case MeshDrawData::EVertexLayout::QUANTIZED:
+    return QuantizedVertexLayout::VertexSize;
+  }
+  return 0;
+}
+
+// Runs of dirty vertices closer than this are uploaded together, gap included, to save buffer updates
+constexpr std::size_t MaxDirtyVerticesGap = 32;
+}
+
+MeshDrawData::MeshDrawData(const Mesh& inMesh,
+    const bool inOptimize,
+    const EVertexLayout inVertexLayout,
+    const bool inBuildMeshlets)
+{
+  ComputeFromMesh(inMesh, inOptimize, inVertexLayout, inBuildMeshlets);
+}
 
 void MeshDrawData::Bind() const
 {
@@ -23,81 +168,420 @@ void MeshDrawData::Bind() const
   return guard;
 }
 
-void MeshDrawData::ComputeFromMesh(const Mesh& inMesh)
+void MeshDrawData::ComputeFromMesh(const Mesh& inMesh,
+    const bool inOptimize,
+    const EVertexLayout inVertexLayout,
+    const bool inBuildMeshlets)
 {
-  // Create vertices ids EBO
-  std::shared_ptr<EBO> vertices_ids_ebo;
+  // Weld the corners with the same position, normal and texture coordinates into a single vertex, so that the EBO
+  // indexes shared vertices and the post-transform vertex cache gets hits
+  const auto number_of_corners = inMesh.GetNumberOfCorners();
+  std::vector<Vec3f> vertices_positions;
+  std::vector<Vec3f> vertices_normals;
+  std::vector<Vec2f> vertices_texture_coordinates;
+  std::vector<uint32_t> corners_vertices_ids(number_of_corners);
   {
-    std::vector<Mesh::VertexId> face_vertices_ids;
+    const MeshCornersDrawAttributes mesh_corners_draw_attributes(inMesh);
+
+    // Open addressing hash table of welded vertex ids, at most half full
+    constexpr auto EmptySlot = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> slots(std::bit_ceil(number_of_corners * 2 + 1), EmptySlot);
+    const auto slots_mask = (slots.size() - 1);
+
+    vertices_positions.reserve(number_of_corners);
+    vertices_normals.reserve(number_of_corners);
+    vertices_texture_coordinates.reserve(number_of_corners);
+    for (Mesh::CornerId corner_id = 0; corner_id < number_of_corners; ++corner_id)
+    {
+      const auto corner_draw_attributes = mesh_corners_draw_attributes.Get(corner_id);
+      const auto& position = corner_draw_attributes.mPosition;
+      const auto& normal = corner_draw_attributes.mNormal;
+      const auto& texture_coordinates = corner_draw_attributes.mTextureCoordinates;
+
+      const std::array<float, 8> attributes = { position[0],
+        position[1],
+        position[2],
+        normal[0],
+        normal[1],
+        normal[2],
+        texture_coordinates[0],
+        texture_coordinates[1] };
+      uint64_t hash = 0xcbf29ce484222325ull; // FNV-1a over the attributes bits
+      for (const auto attribute : attributes) { hash = (hash ^ std::bit_cast<uint32_t>(attribute)) * 0x100000001b3ull; }
+
+      for (auto slot = ((hash ^ (hash >> 32u)) & slots_mask);; slot = ((slot + 1) & slots_mask))
+      {
+        const auto vertex_id = slots[slot];
+        if (vertex_id == EmptySlot)
+        {
+          const auto new_vertex_id = static_cast<uint32_t>(vertices_positions.size());
+          vertices_positions.push_back(position);
+          vertices_normals.push_back(normal);
+          vertices_texture_coordinates.push_back(texture_coordinates);
+          slots[slot] = new_vertex_id;
+          corners_vertices_ids[corner_id] = new_vertex_id;
+          break;
+        }
+
+        if (vertices_positions[vertex_id] == position && vertices_normals[vertex_id] == normal
+            && vertices_texture_coordinates[vertex_id] == texture_coordinates)
+        {
+          corners_vertices_ids[corner_id] = vertex_id;
+          break;
+        }
+      }
+    }
+  }
+
+  // Keep the vertex of every mesh corner, for Update. corners_vertices_ids becomes the EBO, in drawing order.
+  mCornersVerticesIds = corners_vertices_ids;
+
+  // Reorder the triangles for the post-transform vertex cache and overdraw, and then the vertices by first use
+  mOptimizationStatistics.reset();
+  if (inOptimize)
+  {
+    OptimizationStatistics optimization_statistics;
+    optimization_statistics.mBefore
+        = VertexCacheOptimizer::Analyze(MakeSpan(corners_vertices_ids), vertices_positions.size());
+
+    VertexCacheOptimizer::OptimizeVertexCache(corners_vertices_ids, vertices_positions.size());
+    VertexCacheOptimizer::OptimizeOverdraw(corners_vertices_ids, MakeSpan(vertices_positions));
+    const auto vertices_remap
+        = VertexCacheOptimizer::OptimizeVertexFetch(corners_vertices_ids, vertices_positions.size());
+    VertexCacheOptimizer::RemapVertices(vertices_positions, vertices_remap);
+    VertexCacheOptimizer::RemapVertices(vertices_normals, vertices_remap);
+    VertexCacheOptimizer::RemapVertices(vertices_texture_coordinates, vertices_remap);
+    for (auto& vertex_id : mCornersVerticesIds) { vertex_id = vertices_remap[vertex_id]; }
+
+    optimization_statistics.mAfter
+        = VertexCacheOptimizer::Analyze(MakeSpan(corners_vertices_ids), vertices_positions.size());
+    mOptimizationStatistics = optimization_statistics;
+  }
+  const auto number_of_vertices = vertices_positions.size();
+
+  // Group the triangles by meshlets, keeping the order inside every meshlet
+  mMeshlets.clear();
+  mMeshletsIndices.clear();
+  if (inBuildMeshlets)
+  {
+    mMeshlets = MeshletBuilder::Build(corners_vertices_ids, MakeSpan(vertices_positions));
+    mMeshletsIndices = corners_vertices_ids;
+  }
+
+  // Vertex->corners index (compressed sparse row), for Update
+  mVerticesCornersOffsets.assign(number_of_vertices + 1, 0);
+  for (const auto vertex_id : mCornersVerticesIds) { ++mVerticesCornersOffsets[vertex_id + 1]; }
+  std::partial_sum(mVerticesCornersOffsets.cbegin(), mVerticesCornersOffsets.cend(), mVerticesCornersOffsets.begin());
+  {
+    auto vertices_fill_offsets = mVerticesCornersOffsets;
+    mVerticesCornersIds.resize(number_of_corners);
+    for (Mesh::CornerId corner_id = 0; corner_id < number_of_corners; ++corner_id)
+      mVerticesCornersIds[vertices_fill_offsets[mCornersVerticesIds[corner_id]]++] = corner_id;
+  }
+
+  // Create vertices ids EBO, with 16 bit ids when there are few enough vertices. Reuse it if the size is the same.
+  {
+    const auto indices_data_type
+        = (number_of_vertices <= (static_cast<std::size_t>(std::numeric_limits<uint16_t>::max()) + 1))
+        ? GLTypeTraits<uint16_t>::GLType
+        : GLTypeTraits<uint32_t>::GLType;
+    const auto reuse_ebo
+        = (mVAO->GetEBO() && indices_data_type == mIndicesDataType && number_of_corners == mNumberOfElements);
+    const auto vertices_ids_ebo = (reuse_ebo ? mVAO->GetEBO() : std::make_shared<EBO>());
+    if (indices_data_type == GLTypeTraits<uint16_t>::GLType)
+    {
+      const auto corners_vertices_ids_16 = std::vector<uint16_t>(corners_vertices_ids.cbegin(),
+          corners_vertices_ids.cend());
+      if (reuse_ebo)
+        vertices_ids_ebo->BufferSubData(MakeSpan(corners_vertices_ids_16));
+      else
+        vertices_ids_ebo->BufferData(MakeSpan(corners_vertices_ids_16));
+    }
+    else
     {
-      face_vertices_ids.resize(inMesh.GetNumberOfCorners());
-      std::iota(face_vertices_ids.begin(), face_vertices_ids.end(), 0); // 0, 1, 2, 3, 4, ...
+      if (reuse_ebo)
+        vertices_ids_ebo->BufferSubData(MakeSpan(corners_vertices_ids));
+      else
+        vertices_ids_ebo->BufferData(MakeSpan(corners_vertices_ids));
     }
-    vertices_ids_ebo = std::make_shared<EBO>(MakeSpan(face_vertices_ids));
+    mIndicesDataType = indices_data_type;
     mVAO->SetEBO(vertices_ids_ebo);
   }
 
-  // Create corners positions VBO
+  // Positions are quantized inside the bounding box, the dequantization matrix maps them back
+  mPositionsQuantizationMin = Zero<Vec3f>();
+  mPositionsQuantizationExtent = Zero<Vec3f>();
+  mPositionsDequantizationMatrix = Identity<Mat4f>();
+  if (inVertexLayout == EVertexLayout::QUANTIZED)
   {
-    std::shared_ptr<VBO> corners_positions_pool_vbo;
+    auto min_position = (number_of_vertices > 0 ? vertices_positions.front() : Zero<Vec3f>());
+    auto max_position = min_position;
+    for (const auto& position : vertices_positions)
     {
-      std::vector<Vec3f> corners_positions_pool;
+      for (std::size_t i = 0; i < 3; ++i)
       {
-        corners_positions_pool.reserve(inMesh.GetNumberOfCorners());
-        for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
-        {
-          const auto face_id = (corner_id / 3);
-          const auto internal_corner_id = (corner_id % 3);
-          const auto vertex_id = inMesh.GetFacesData().at(face_id).mVerticesIds[internal_corner_id];
-          const auto& vertex_position = inMesh.GetVerticesData().at(vertex_id).mPosition;
-          corners_positions_pool.push_back(vertex_position);
-        }
+        min_position[i] = std::min(min_position[i], position[i]);
+        max_position[i] = std::max(max_position[i], position[i]);
       }
-      corners_positions_pool_vbo = std::make_shared<VBO>(MakeSpan(corners_positions_pool));
     }
-    mVAO->AddVBO(corners_positions_pool_vbo, MeshDrawData::PositionAttribLocation(), VAOVertexAttribT<Vec3f>());
+    mPositionsQuantizationMin = min_position;
+    mPositionsQuantizationExtent = (max_position - min_position);
+    mPositionsDequantizationMatrix = TranslationMat(mPositionsQuantizationMin) * ScaleMat(mPositionsQuantizationExtent);
+  }
+
+  // Create the vertices VBOs in the requested layout (or reuse them if they have the same size), and fill them
+  const auto reuse_vbos
+      = (!mVAO->GetVBOs().empty() && inVertexLayout == mVertexLayout && number_of_vertices == mNumberOfVertices);
+  mVertexLayout = inVertexLayout;
+  if (!reuse_vbos)
+    CreateVertexBuffers(number_of_vertices);
+  UploadVertices(0,
+      MakeSpan(vertices_positions),
+      MakeSpan(vertices_normals),
+      MakeSpan(vertices_texture_coordinates));
+
+  const auto index_size_in_bytes
+      = (mIndicesDataType == GLTypeTraits<uint16_t>::GLType) ? sizeof(uint16_t) : sizeof(uint32_t);
+  mNumberOfElements = number_of_corners;
+  mNumberOfVertices = number_of_vertices;
+  mSizeInBytes = mNumberOfElements * index_size_in_bytes + mNumberOfVertices * GetVertexSizeInBytes(mVertexLayout);
+  mLastUploadSizeInBytes = mSizeInBytes;
+
+  mOptimize = inOptimize;
+  mBuildMeshlets = inBuildMeshlets;
+  mMesh = &inMesh;
+  mMeshGeneration = inMesh.GetGeneration();
+}
+
+void MeshDrawData::Update(const Mesh& inMesh)
+{
+  if (&inMesh == mMesh && inMesh.GetGeneration() == mMeshGeneration)
+  {
+    mLastUploadSizeInBytes = 0;
+    return;
   }
 
-  // Create corners normals VBO
+  // Partial update, if the mesh dirty ranges cover all the changes since the last sync and the topology is the same
+  const auto can_update_dirty_vertices = (&inMesh == mMesh
+      && mMeshGeneration >= inMesh.GetDirtyRanges().mBeginGeneration
+      && inMesh.GetNumberOfCorners() == mCornersVerticesIds.size());
+  if (can_update_dirty_vertices && UpdateDirtyVertices(inMesh))
   {
-    std::shared_ptr<VBO> corners_normals_pool_vbo;
+    if (!mMeshlets.empty())
+      RefitMeshlets(inMesh);
+    mMeshGeneration = inMesh.GetGeneration();
+    return;
+  }
+
+  ComputeFromMesh(inMesh, mOptimize, mVertexLayout, mBuildMeshlets);
+}
+
+bool MeshDrawData::UpdateDirtyVertices(const Mesh& inMesh)
+{
+  const auto& dirty_ranges = inMesh.GetDirtyRanges();
+
+  // Gather the vertices of the dirty corners: the ones modified, the ones of the modified faces (their normal might
+  // be the face one), and the ones of the modified mesh vertices
+  std::vector<uint32_t> dirty_vertices_ids;
+  for (auto corner_id = dirty_ranges.mCorners.mBegin; corner_id < dirty_ranges.mCorners.mEnd; ++corner_id)
+    dirty_vertices_ids.push_back(mCornersVerticesIds[corner_id]);
+
+  for (auto face_id = dirty_ranges.mFaces.mBegin; face_id < dirty_ranges.mFaces.mEnd; ++face_id)
+  {
+    for (std::size_t i = 0; i < 3; ++i) { dirty_vertices_ids.push_back(mCornersVerticesIds[face_id * 3 + i]); }
+  }
+
+  const auto& dirty_mesh_vertices = dirty_ranges.mVertices;
+  if (!dirty_mesh_vertices.IsEmpty())
+  {
+    if (inMesh.HasVertexCornersIndex())
     {
-      std::vector<Vec3f> corners_normals_pool;
+      for (auto mesh_vertex_id = dirty_mesh_vertices.mBegin; mesh_vertex_id < dirty_mesh_vertices.mEnd;
+           ++mesh_vertex_id)
       {
-        corners_normals_pool.reserve(inMesh.GetNumberOfCorners());
-        for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
-        {
-          auto normal = inMesh.GetCornerNormal(corner_id);
-          if (normal == Zero<Vec3f>())
-            normal = inMesh.GetFaceNormal(inMesh.GetFaceIdFromCornerId(corner_id));
-          corners_normals_pool.push_back(normal);
-        }
+        const auto mesh_vertex_corners_ids
+            = inMesh.GetVertexCornersIdsSpan(static_cast<Mesh::VertexId>(mesh_vertex_id));
+        for (std::size_t i = 0; i < mesh_vertex_corners_ids.GetNumberOfElements(); ++i)
+          dirty_vertices_ids.push_back(mCornersVerticesIds[mesh_vertex_corners_ids.GetData()[i]]);
+      }
+    }
+    else
+    {
+      const auto* mesh_faces_vertices_ids = inMesh.GetFacesVerticesIds().GetData();
+      for (Mesh::CornerId corner_id = 0; corner_id < mCornersVerticesIds.size(); ++corner_id)
+      {
+        const auto mesh_vertex_id = mesh_faces_vertices_ids[corner_id / 3][corner_id % 3];
+        if (mesh_vertex_id >= dirty_mesh_vertices.mBegin && mesh_vertex_id < dirty_mesh_vertices.mEnd)
+          dirty_vertices_ids.push_back(mCornersVerticesIds[corner_id]);
       }
-      corners_normals_pool_vbo = std::make_shared<VBO>(MakeSpan(corners_normals_pool));
     }
-    mVAO->AddVBO(corners_normals_pool_vbo, MeshDrawData::NormalAttribLocation(), VAOVertexAttribT<Vec3f>());
   }
 
-  // Create corners texture coordinates VBO
+  std::sort(dirty_vertices_ids.begin(), dirty_vertices_ids.end());
+  dirty_vertices_ids.erase(std::unique(dirty_vertices_ids.begin(), dirty_vertices_ids.end()), dirty_vertices_ids.end());
+
+  // Upload runs of dirty vertices. Every vertex is recomputed from its corners, which must still agree (be welded).
+  const MeshCornersDrawAttributes mesh_corners_draw_attributes(inMesh);
+  std::vector<Vec3f> vertices_positions;
+  std::vector<Vec3f> vertices_normals;
+  std::vector<Vec2f> vertices_texture_coordinates;
+  mLastUploadSizeInBytes = 0;
+  for (std::size_t run_begin = 0; run_begin < dirty_vertices_ids.size();)
   {
-    std::shared_ptr<VBO> corners_texture_coordinates_pool_vbo;
+    auto run_end = (run_begin + 1);
+    while (run_end < dirty_vertices_ids.size()
+        && dirty_vertices_ids[run_end] - dirty_vertices_ids[run_end - 1] <= MaxDirtyVerticesGap)
+    {
+      ++run_end;
+    }
+
+    const auto begin_vertex_id = dirty_vertices_ids[run_begin];
+    const auto end_vertex_id = (dirty_vertices_ids[run_end - 1] + 1);
+    vertices_positions.clear();
+    vertices_normals.clear();
+    vertices_texture_coordinates.clear();
+    for (auto vertex_id = begin_vertex_id; vertex_id < end_vertex_id; ++vertex_id)
     {
-      std::vector<Vec2f> corners_texture_coordinates_pool;
+      const auto* vertex_corners_ids_begin = (mVerticesCornersIds.data() + mVerticesCornersOffsets[vertex_id]);
+      const auto* vertex_corners_ids_end = (mVerticesCornersIds.data() + mVerticesCornersOffsets[vertex_id + 1]);
+      const auto vertex_draw_attributes = mesh_corners_draw_attributes.Get(*vertex_corners_ids_begin);
+      for (auto corner_id_it = vertex_corners_ids_begin + 1; corner_id_it < vertex_corners_ids_end; ++corner_id_it)
       {
-        corners_texture_coordinates_pool.reserve(inMesh.GetNumberOfCorners());
-        for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
+        if (!(mesh_corners_draw_attributes.Get(*corner_id_it) == vertex_draw_attributes))
+          return false;
+      }
+
+      if (mVertexLayout == EVertexLayout::QUANTIZED)
+      {
+        for (std::size_t i = 0; i < 3; ++i)
         {
-          const auto& corner_texture_coordinates = inMesh.GetCornerTextureCoordinates(corner_id);
-          corners_texture_coordinates_pool.push_back(corner_texture_coordinates);
+          const auto quantization_offset = (vertex_draw_attributes.mPosition[i] - mPositionsQuantizationMin[i]);
+          if (quantization_offset < 0.0f || quantization_offset > mPositionsQuantizationExtent[i])
+            return false;
         }
       }
-      corners_texture_coordinates_pool_vbo = std::make_shared<VBO>(MakeSpan(corners_texture_coordinates_pool));
+
+      vertices_positions.push_back(vertex_draw_attributes.mPosition);
+      vertices_normals.push_back(vertex_draw_attributes.mNormal);
+      vertices_texture_coordinates.push_back(vertex_draw_attributes.mTextureCoordinates);
     }
-    mVAO->AddVBO(corners_texture_coordinates_pool_vbo,
+
+    UploadVertices(begin_vertex_id,
+        MakeSpan(vertices_positions),
+        MakeSpan(vertices_normals),
+        MakeSpan(vertices_texture_coordinates));
+    mLastUploadSizeInBytes += (end_vertex_id - begin_vertex_id) * GetVertexSizeInBytes(mVertexLayout);
+    run_begin = run_end;
+  }
+  return true;
+}
+
+void MeshDrawData::RefitMeshlets(const Mesh& inMesh)
+{
+  const MeshCornersDrawAttributes mesh_corners_draw_attributes(inMesh);
+  std::vector<Vec3f> vertices_positions(mNumberOfVertices);
+  for (std::size_t vertex_id = 0; vertex_id < mNumberOfVertices; ++vertex_id)
+  {
+    const auto vertex_corner_id = mVerticesCornersIds[mVerticesCornersOffsets[vertex_id]];
+    vertices_positions[vertex_id] = mesh_corners_draw_attributes.Get(vertex_corner_id).mPosition;
+  }
+
+  for (auto& meshlet : mMeshlets)
+    MeshletBuilder::ComputeBounds(meshlet, MakeSpan(mMeshletsIndices), MakeSpan(vertices_positions));
+}
+
+void MeshDrawData::CreateVertexBuffers(const std::size_t inNumberOfVertices)
+{
+  const auto create_vbo = [&](const std::size_t inVertexSizeInBytes)
+  {
+    const auto vbo = std::make_shared<VBO>();
+    vbo->BufferDataEmpty(inNumberOfVertices * inVertexSizeInBytes);
+    return vbo;
+  };
+
+  // AddVBO only replaces buffers by attribute location, so a previous layout could leave stale VBOs behind
+  mVAO->ClearVBOs();
+
+  switch (mVertexLayout)
+  {
+  case EVertexLayout::SEPARATE:
+    mVAO->AddVBO(create_vbo(sizeof(Vec3f)), MeshDrawData::PositionAttribLocation(), VAOVertexAttribT<Vec3f>());
+    mVAO->AddVBO(create_vbo(sizeof(Vec3f)), MeshDrawData::NormalAttribLocation(), VAOVertexAttribT<Vec3f>());
+    mVAO->AddVBO(create_vbo(sizeof(Vec2f)),
         MeshDrawData::TextureCoordinateAttribLocation(),
         VAOVertexAttribT<Vec2f>());
+    break;
+  case EVertexLayout::INTERLEAVED:
+    InterleavedVertexLayout::AddVBO(*mVAO, create_vbo(InterleavedVertexLayout::VertexSize));
+    break;
+  case EVertexLayout::PACKED:
+    PackedVertexLayout::AddVBO(*mVAO, create_vbo(PackedVertexLayout::VertexSize));
+    break;
+  case EVertexLayout::QUANTIZED:
+    QuantizedVertexLayout::AddVBO(*mVAO, create_vbo(QuantizedVertexLayout::VertexSize));
+    break;
   }
+}
+
+void MeshDrawData::UploadVertices(const std::size_t inBeginVertexId,
+    const Span<Vec3f>& inVerticesPositions,
+    const Span<Vec3f>& inVerticesNormals,
+    const Span<Vec2f>& inVerticesTextureCoordinates)
+{
+  const auto number_of_vertices = inVerticesPositions.GetNumberOfElements();
+  if (number_of_vertices == 0)
+    return;
 
-  mNumberOfElements = inMesh.GetNumberOfCorners();
+  const auto* positions = inVerticesPositions.GetData();
+  const auto* normals = inVerticesNormals.GetData();
+  const auto* texture_coordinates = inVerticesTextureCoordinates.GetData();
+  const auto& vbos = mVAO->GetVBOs();
+  switch (mVertexLayout)
+  {
+  case EVertexLayout::SEPARATE:
+    vbos[MeshDrawData::PositionAttribLocation()]->BufferSubData(inVerticesPositions, inBeginVertexId * sizeof(Vec3f));
+    vbos[MeshDrawData::NormalAttribLocation()]->BufferSubData(inVerticesNormals, inBeginVertexId * sizeof(Vec3f));
+    vbos[MeshDrawData::TextureCoordinateAttribLocation()]->BufferSubData(inVerticesTextureCoordinates,
+        inBeginVertexId * sizeof(Vec2f));
+    break;
+
+  case EVertexLayout::INTERLEAVED:
+    UploadInterleavedVertices<InterleavedVertexLayout>(*vbos[MeshDrawData::PositionAttribLocation()],
+        inBeginVertexId,
+        number_of_vertices,
+        [&](const std::size_t i) { return InterleavedVertex { positions[i], normals[i], texture_coordinates[i] }; });
+    break;
+
+  case EVertexLayout::PACKED:
+    UploadInterleavedVertices<PackedVertexLayout>(*vbos[MeshDrawData::PositionAttribLocation()],
+        inBeginVertexId,
+        number_of_vertices,
+        [&](const std::size_t i)
+        {
+          return PackedVertex { positions[i],
+            EncodeOctahedralSnorm16(normals[i]),
+            EncodeHalf2(texture_coordinates[i]) };
+        });
+    break;
+
+  case EVertexLayout::QUANTIZED:
+    UploadInterleavedVertices<QuantizedVertexLayout>(*vbos[MeshDrawData::PositionAttribLocation()],
+        inBeginVertexId,
+        number_of_vertices,
+        [&](const std::size_t i)
+        {
+          QuantizedVertex quantized_vertex;
+          for (std::size_t c = 0; c < 3; ++c)
+          {
+            const auto extent = mPositionsQuantizationExtent[c];
+            const auto offset = (positions[i][c] - mPositionsQuantizationMin[c]);
+            quantized_vertex.mPosition[c] = (extent > 0.0f ? EncodeUnorm16(offset / extent) : uint16_t(0));
+          }
+          quantized_vertex.mNormal = EncodeOctahedralSnorm16(normals[i]);
+          quantized_vertex.mTextureCoordinates = EncodeHalf2(texture_coordinates[i]);
+          return quantized_vertex;
+        });
+    break;
+  }
+}
 }
-}
\ No newline at end of file
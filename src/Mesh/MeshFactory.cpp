@@ -2,36 +2,71 @@
 #include <ez/Math.h>
 #include <ez/Mesh.h>
 #include <ez/Quat.h>
+#include <utility>
+#include <vector>
 
 namespace ez
 {
+namespace
+{
+// Streams of a mesh being generated, moved into it at once (see Mesh::SetStreams)
+class MeshStreams final
+{
+public:
+  MeshStreams(const std::size_t inNumberOfVertices, const std::size_t inNumberOfFaces)
+  {
+    mVerticesPositions.reserve(inNumberOfVertices);
+    mFacesVerticesIds.reserve(inNumberOfFaces);
+  }
+
+  void AddVertex(const Vec3f& inPosition) { mVerticesPositions.push_back(inPosition); }
+  void AddFace(const std::size_t inFaceVertexId0, const std::size_t inFaceVertexId1, const std::size_t inFaceVertexId2)
+  {
+    mFacesVerticesIds.push_back({ static_cast<Mesh::VertexId>(inFaceVertexId0),
+        static_cast<Mesh::VertexId>(inFaceVertexId1),
+        static_cast<Mesh::VertexId>(inFaceVertexId2) });
+  }
+
+  Mesh ToMesh()
+  {
+    Mesh mesh;
+    mesh.SetStreams(std::move(mVerticesPositions), std::move(mFacesVerticesIds));
+    return mesh;
+  }
+
+private:
+  std::vector<Vec3f> mVerticesPositions;
+  std::vector<Mesh::FaceVerticesIds> mFacesVerticesIds;
+};
+}
 
 Mesh MeshFactory::GetBox()
 {
-  Mesh box;
-
-  box.AddVertex(Vec3f { -1.0f, -1.0f, -1.0f }); // 0
-  box.AddVertex(Vec3f { -1.0f, -1.0f, 1.0f });  // 1
-  box.AddVertex(Vec3f { -1.0f, 1.0f, -1.0f });  // 2
-  box.AddVertex(Vec3f { -1.0f, 1.0f, 1.0f });   // 3
-  box.AddVertex(Vec3f { 1.0f, -1.0f, -1.0f });  // 4
-  box.AddVertex(Vec3f { 1.0f, -1.0f, 1.0f });   // 5
-  box.AddVertex(Vec3f { 1.0f, 1.0f, -1.0f });   // 6
-  box.AddVertex(Vec3f { 1.0f, 1.0f, 1.0f });    // 7
-
-  box.AddFace(1, 3, 2); // 0 X-
-  box.AddFace(0, 1, 2); // 1 X-
-  box.AddFace(0, 4, 1); // 2 Y-
-  box.AddFace(1, 4, 5); // 3 Y-
-  box.AddFace(0, 6, 4); // 4 Z-
-  box.AddFace(0, 2, 6); // 5 Z-
-  box.AddFace(4, 6, 5); // 6 X+
-  box.AddFace(5, 6, 7); // 7 X+
-  box.AddFace(3, 7, 2); // 8 Y+
-  box.AddFace(7, 6, 2); // 9 Y+
-  box.AddFace(1, 5, 3); // 10 Z+
-  box.AddFace(3, 5, 7); // 11 Z+
-
+  MeshStreams box_streams(8, 12);
+
+  box_streams.AddVertex(Vec3f { -1.0f, -1.0f, -1.0f }); // 0
+  box_streams.AddVertex(Vec3f { -1.0f, -1.0f, 1.0f });  // 1
+  box_streams.AddVertex(Vec3f { -1.0f, 1.0f, -1.0f });  // 2
+  box_streams.AddVertex(Vec3f { -1.0f, 1.0f, 1.0f });   // 3
+  box_streams.AddVertex(Vec3f { 1.0f, -1.0f, -1.0f });  // 4
+  box_streams.AddVertex(Vec3f { 1.0f, -1.0f, 1.0f });   // 5
+  box_streams.AddVertex(Vec3f { 1.0f, 1.0f, -1.0f });   // 6
+  box_streams.AddVertex(Vec3f { 1.0f, 1.0f, 1.0f });    // 7
+
+  box_streams.AddFace(1, 3, 2); // 0 X-
+  box_streams.AddFace(0, 1, 2); // 1 X-
+  box_streams.AddFace(0, 4, 1); // 2 Y-
+  box_streams.AddFace(1, 4, 5); // 3 Y-
+  box_streams.AddFace(0, 6, 4); // 4 Z-
+  box_streams.AddFace(0, 2, 6); // 5 Z-
+  box_streams.AddFace(4, 6, 5); // 6 X+
+  box_streams.AddFace(5, 6, 7); // 7 X+
+  box_streams.AddFace(3, 7, 2); // 8 Y+
+  box_streams.AddFace(7, 6, 2); // 9 Y+
+  box_streams.AddFace(1, 5, 3); // 10 Z+
+  box_streams.AddFace(3, 5, 7); // 11 Z+
+
+  auto box = box_streams.ToMesh();
   ConsolidateMesh(box);
   return box;
 }
@@ -61,7 +96,7 @@ Mesh MeshFactory::GetSphere(const std::size_t inNumLatitudes,
   EXPECTS(inNumLatitudes >= 3);
   EXPECTS(inNumLongitudes >= 3);
 
-  Mesh sphere;
+  MeshStreams sphere_streams(inNumLatitudes * inNumLongitudes, inNumLatitudes * inNumLongitudes * 2);
 
   // Add vertices
   const auto angle_z_increment
@@ -72,7 +107,7 @@ Mesh MeshFactory::GetSphere(const std::size_t inNumLatitudes,
   {
     if (z == 0 || z == (inNumLatitudes - 1)) // South or north pole, single vertex
     {
-      sphere.AddVertex(Vec3f { 0.0f, 0.0f, std::sin(angle_z) });
+      sphere_streams.AddVertex(Vec3f { 0.0f, 0.0f, std::sin(angle_z) });
       if (inIsHemisphere)
         continue;
     }
@@ -87,7 +122,7 @@ Mesh MeshFactory::GetSphere(const std::size_t inNumLatitudes,
         const auto position_x = cos_z * std::cos(angle_y);
         const auto position_y = cos_z * std::sin(angle_y);
         const auto point = Vec3f { position_x, position_y, position_z };
-        sphere.AddVertex(point);
+        sphere_streams.AddVertex(point);
 
         angle_y += angle_y_increment;
       }
@@ -108,7 +143,7 @@ Mesh MeshFactory::GetSphere(const std::size_t inNumLatitudes,
         const auto south_pole_vertex_index = 0;
         const auto up_vertex_index = 1 + y;
         const auto up_right_vertex_index = 1 + ((y + 1) % inNumLongitudes);
-        sphere.AddFace(south_pole_vertex_index, up_right_vertex_index, up_vertex_index);
+        sphere_streams.AddFace(south_pole_vertex_index, up_right_vertex_index, up_vertex_index);
       }
       else if (!is_up_north_pole) // Middle vertices
       {
@@ -116,19 +151,20 @@ Mesh MeshFactory::GetSphere(const std::size_t inNumLatitudes,
         const auto right_vertex_index = (1 + (z - 1) * inNumLongitudes) + ((y + 1) % inNumLongitudes);
         const auto up_vertex_index = (1 + z * inNumLongitudes) + y;
         const auto up_right_vertex_index = (1 + z * inNumLongitudes) + ((y + 1) % inNumLongitudes);
-        sphere.AddFace(current_vertex_index, right_vertex_index, up_right_vertex_index);
-        sphere.AddFace(current_vertex_index, up_right_vertex_index, up_vertex_index);
+        sphere_streams.AddFace(current_vertex_index, right_vertex_index, up_right_vertex_index);
+        sphere_streams.AddFace(current_vertex_index, up_right_vertex_index, up_vertex_index);
       }
       else // Next row above is the north pole point
       {
         const auto current_vertex_index = (1 + (z - 1) * inNumLongitudes) + y;
         const auto right_vertex_index = (1 + (z - 1) * inNumLongitudes) + ((y + 1) % inNumLongitudes);
         const auto north_pole_vertex_index = (1 + ((inNumLatitudes - 2) * inNumLongitudes));
-        sphere.AddFace(north_pole_vertex_index, current_vertex_index, right_vertex_index);
+        sphere_streams.AddFace(north_pole_vertex_index, current_vertex_index, right_vertex_index);
       }
     }
   }
 
+  auto sphere = sphere_streams.ToMesh();
   ConsolidateMesh(sphere);
   return sphere;
 }
@@ -137,7 +173,7 @@ Mesh MeshFactory::GetCylinder(const std::size_t inNumLongitudes)
 {
   EXPECTS(inNumLongitudes >= 3);
 
-  Mesh cylinder;
+  MeshStreams cylinder_streams(inNumLongitudes * 2 + 2, inNumLongitudes * 4);
 
   // Forward and back circle vertices
   for (const auto forward : { true, false })
@@ -150,13 +186,13 @@ Mesh MeshFactory::GetCylinder(const std::size_t inNumLongitudes)
       const auto y = std::sin(angle) * 0.5f;
       const auto z = (forward ? -0.5f : 0.5f);
       const auto vertex_position = Vec3f(x, y, z);
-      cylinder.AddVertex(vertex_position);
+      cylinder_streams.AddVertex(vertex_position);
     }
   }
 
   // Forward and back central vertices
-  cylinder.AddVertex(Vec3f { 0.0f, 0.0f, -0.5f });
-  cylinder.AddVertex(Vec3f { 0.0f, 0.0f, 0.5f });
+  cylinder_streams.AddVertex(Vec3f { 0.0f, 0.0f, -0.5f });
+  cylinder_streams.AddVertex(Vec3f { 0.0f, 0.0f, 0.5f });
 
   // Pipe faces
   for (Mesh::VertexId forward_vertex_id = 0; forward_vertex_id < inNumLongitudes; ++forward_vertex_id)
@@ -164,8 +200,8 @@ Mesh MeshFactory::GetCylinder(const std::size_t inNumLongitudes)
     const auto next_forward_vertex_id = (forward_vertex_id + 1) % inNumLongitudes;
     const auto back_vertex_id = (forward_vertex_id + inNumLongitudes);
     const auto next_back_vertex_id = (next_forward_vertex_id + inNumLongitudes);
-    cylinder.AddFace(forward_vertex_id, next_forward_vertex_id, back_vertex_id);
-    cylinder.AddFace(back_vertex_id, next_forward_vertex_id, next_back_vertex_id);
+    cylinder_streams.AddFace(forward_vertex_id, next_forward_vertex_id, back_vertex_id);
+    cylinder_streams.AddFace(back_vertex_id, next_forward_vertex_id, next_back_vertex_id);
   }
 
   // Cap vertices
@@ -177,12 +213,13 @@ Mesh MeshFactory::GetCylinder(const std::size_t inNumLongitudes)
       const auto next_cap_vertex_id = (cap_vertex_id + 1) % inNumLongitudes + (forward ? 0 : inNumLongitudes);
       const auto cap_central_vertex_id = (forward ? (inNumLongitudes * 2) : (inNumLongitudes * 2 + 1));
       if (forward)
-        cylinder.AddFace(next_cap_vertex_id, cap_vertex_id, cap_central_vertex_id);
+        cylinder_streams.AddFace(next_cap_vertex_id, cap_vertex_id, cap_central_vertex_id);
       else
-        cylinder.AddFace(cap_vertex_id, next_cap_vertex_id, cap_central_vertex_id);
+        cylinder_streams.AddFace(cap_vertex_id, next_cap_vertex_id, cap_central_vertex_id);
     }
   }
 
+  auto cylinder = cylinder_streams.ToMesh();
   ConsolidateMesh(cylinder);
   return cylinder;
 }
@@ -196,10 +233,10 @@ Mesh MeshFactory::GetCapsule(const float inRadius,
   EXPECTS(inNumLongitudes >= 3);
   EXPECTS(inLength >= 0.0f);
 
-  Mesh capsule;
+  const auto num_total_latitudes = (inNumHemisphereLatitudes * 2 + 1);
+  MeshStreams capsule_streams(num_total_latitudes * inNumLongitudes, num_total_latitudes * inNumLongitudes * 2);
 
   // Add vertices
-  const auto num_total_latitudes = (inNumHemisphereLatitudes * 2 + 1);
   const auto angle_z_increment = -(HalfCircleRads<float>() / (num_total_latitudes - 1));
   const auto angle_y_increment = -FullCircleRads() / inNumLongitudes;
   const auto half_length = (inLength / 2);
@@ -211,7 +248,7 @@ Mesh MeshFactory::GetCapsule(const float inRadius,
 
     if (z == 0 || z == (num_total_latitudes - 1)) // South or north pole, single vertex
     {
-      capsule.AddVertex(Vec3f { 0.0f, 0.0f, std::sin(angle_z) * inRadius + z_length_offset });
+      capsule_streams.AddVertex(Vec3f { 0.0f, 0.0f, std::sin(angle_z) * inRadius + z_length_offset });
     }
     else // Middle vertices
     {
@@ -223,7 +260,7 @@ Mesh MeshFactory::GetCapsule(const float inRadius,
       {
         const auto position_x = cos_z * std::cos(angle_y) * inRadius;
         const auto position_y = cos_z * std::sin(angle_y) * inRadius;
-        capsule.AddVertex(Vec3f { position_x, position_y, position_z });
+        capsule_streams.AddVertex(Vec3f { position_x, position_y, position_z });
         angle_y += angle_y_increment;
       }
     }
@@ -244,7 +281,7 @@ Mesh MeshFactory::GetCapsule(const float inRadius,
         const auto south_pole_vertex_index = 0;
         const auto up_vertex_index = 1 + y;
         const auto up_right_vertex_index = 1 + ((y + 1) % inNumLongitudes);
-        capsule.AddFace(south_pole_vertex_index, up_right_vertex_index, up_vertex_index);
+        capsule_streams.AddFace(south_pole_vertex_index, up_right_vertex_index, up_vertex_index);
       }
       else if (!is_up_north_pole) // Middle vertices
       {
@@ -252,19 +289,20 @@ Mesh MeshFactory::GetCapsule(const float inRadius,
         const auto right_vertex_index = (1 + (z - 1) * inNumLongitudes) + ((y + 1) % inNumLongitudes);
         const auto up_vertex_index = (1 + z * inNumLongitudes) + y;
         const auto up_right_vertex_index = (1 + z * inNumLongitudes) + ((y + 1) % inNumLongitudes);
-        capsule.AddFace(current_vertex_index, right_vertex_index, up_right_vertex_index);
-        capsule.AddFace(current_vertex_index, up_right_vertex_index, up_vertex_index);
+        capsule_streams.AddFace(current_vertex_index, right_vertex_index, up_right_vertex_index);
+        capsule_streams.AddFace(current_vertex_index, up_right_vertex_index, up_vertex_index);
       }
       else // Next row above is the north pole point
       {
         const auto current_vertex_index = (1 + (z - 1) * inNumLongitudes) + y;
         const auto right_vertex_index = (1 + (z - 1) * inNumLongitudes) + ((y + 1) % inNumLongitudes);
         const auto north_pole_vertex_index = (1 + ((num_total_latitudes - 2) * inNumLongitudes));
-        capsule.AddFace(north_pole_vertex_index, current_vertex_index, right_vertex_index);
+        capsule_streams.AddFace(north_pole_vertex_index, current_vertex_index, right_vertex_index);
       }
     }
   }
 
+  auto capsule = capsule_streams.ToMesh();
   ConsolidateMesh(capsule);
   return capsule;
 }
@@ -280,7 +318,7 @@ Mesh MeshFactory::GetTorus(const std::size_t inNumLatitudes, const std::size_t i
   const auto angle_longitude_increment = (FullCircleRads() / inNumLongitudes);
   const auto angle_latitude_increment = (FullCircleRads() / inNumLatitudes);
 
-  Mesh torus;
+  MeshStreams torus_streams(inNumLatitudes * inNumLongitudes, inNumLatitudes * inNumLongitudes * 2);
 
   auto angle_longitude = 0.0f;
   for (Mesh::VertexId longitude = 0; longitude < inNumLongitudes; ++longitude)
@@ -293,7 +331,7 @@ Mesh MeshFactory::GetTorus(const std::size_t inNumLatitudes, const std::size_t i
       const auto latitude_circle_position_local = Vec3f { 0.0f, std::sin(angle_latitude), std::cos(angle_latitude) };
       const auto latitude_circle_position_global
           = longitude_center_offset + longitude_rotation * (torus_radius * latitude_circle_position_local);
-      torus.AddVertex(latitude_circle_position_global);
+      torus_streams.AddVertex(latitude_circle_position_global);
       angle_latitude += angle_latitude_increment;
     }
     angle_longitude += angle_longitude_increment;
@@ -310,15 +348,16 @@ Mesh MeshFactory::GetTorus(const std::size_t inNumLatitudes, const std::size_t i
           = (((longitude + 1) % inNumLongitudes) * inNumLatitudes + latitude);
       const auto next_longitude_next_latitude_vertex_id
           = (((longitude + 1) % inNumLongitudes) * inNumLatitudes + ((latitude + 1) % inNumLatitudes));
-      torus.AddFace(current_longitude_current_latitude_vertex_id,
+      torus_streams.AddFace(current_longitude_current_latitude_vertex_id,
           current_longitude_next_latitude_vertex_id,
           next_longitude_current_latitude_vertex_id);
-      torus.AddFace(next_longitude_current_latitude_vertex_id,
+      torus_streams.AddFace(next_longitude_current_latitude_vertex_id,
           current_longitude_next_latitude_vertex_id,
           next_longitude_next_latitude_vertex_id);
     }
   }
 
+  auto torus = torus_streams.ToMesh();
   ConsolidateMesh(torus);
 
   return torus;
@@ -329,7 +368,7 @@ Mesh MeshFactory::GetPlane(const std::size_t inNumLatitudes, const std::size_t i
   EXPECTS(inNumLatitudes >= 2);
   EXPECTS(inNumLongitudes >= 2);
 
-  Mesh plane;
+  MeshStreams plane_streams(inNumLatitudes * inNumLongitudes, (inNumLatitudes - 1) * (inNumLongitudes - 1) * 2);
 
   const auto stride_x = (inNumLatitudes - 1);
   const auto stride_y = (inNumLongitudes - 1);
@@ -343,7 +382,7 @@ Mesh MeshFactory::GetPlane(const std::size_t inNumLatitudes, const std::size_t i
       const auto position_y = Map(progression_y, 0.0f, 1.0f, -0.5f, 0.5f);
       const auto position_z = 0.0f;
       const auto vertex_position = Vec3f { position_x, position_y, position_z };
-      plane.AddVertex(vertex_position);
+      plane_streams.AddVertex(vertex_position);
     }
   }
 
@@ -355,19 +394,21 @@ Mesh MeshFactory::GetPlane(const std::size_t inNumLatitudes, const std::size_t i
       const auto next_x_current_y_vertex_id = (y * inNumLatitudes + (x + 1));
       const auto current_x_next_y_vertex_id = ((y + 1) * inNumLatitudes + x);
       const auto next_x_next_y_vertex_id = ((y + 1) * inNumLatitudes + (x + 1));
-      plane.AddFace(current_x_current_y_vertex_id, next_x_current_y_vertex_id, next_x_next_y_vertex_id);
-      plane.AddFace(current_x_current_y_vertex_id, next_x_next_y_vertex_id, current_x_next_y_vertex_id);
+      plane_streams.AddFace(current_x_current_y_vertex_id, next_x_current_y_vertex_id, next_x_next_y_vertex_id);
+      plane_streams.AddFace(current_x_current_y_vertex_id, next_x_next_y_vertex_id, current_x_next_y_vertex_id);
     }
   }
 
+  auto plane = plane_streams.ToMesh();
+  std::vector<Vec2f> corners_texture_coordinates(plane.GetNumberOfCorners());
   for (Mesh::CornerId corner_id = 0; corner_id < plane.GetNumberOfCorners(); ++corner_id)
   {
     const auto vertex_id = plane.GetVertexIdFromCornerId(corner_id);
     const auto vertex_position = plane.GetVertexPosition(vertex_id);
-    const auto corner_texture_coordinates
+    corners_texture_coordinates[corner_id]
         = Map(XY(vertex_position), All<Vec2f>(-0.5f), All<Vec2f>(0.5f), All<Vec2f>(0.0f), All<Vec2f>(1.0f));
-    plane.SetCornerTextureCoordinates(corner_id, corner_texture_coordinates);
   }
+  plane.SetCornersTextureCoordinates(MakeSpan(corners_texture_coordinates));
 
   ConsolidateMesh(plane);
   return plane;
@@ -380,10 +421,10 @@ Mesh MeshFactory::GetCircleSection(const std::size_t inNumVertices, const float
 
   bool isFullCircle = (inSectionAngleRads == FullCircleRads());
 
-  Mesh circle_section;
+  MeshStreams circle_section_streams(inNumVertices + 1, inNumVertices);
   {
     const auto center_vertex = Zero<Vec3f>();
-    circle_section.AddVertex(center_vertex);
+    circle_section_streams.AddVertex(center_vertex);
   }
 
   for (Mesh::VertexId i = 0; i < inNumVertices; ++i)
@@ -391,16 +432,17 @@ Mesh MeshFactory::GetCircleSection(const std::size_t inNumVertices, const float
     const auto progress = (static_cast<float>(i) / (isFullCircle ? inNumVertices : (inNumVertices - 1)));
     const auto angle = Map(progress, 0.0f, 1.0f, 0.0f, inSectionAngleRads);
     const auto circle_position = Vec3f { std::cos(angle), std::sin(angle), 0.0f };
-    circle_section.AddVertex(circle_position);
+    circle_section_streams.AddVertex(circle_position);
   }
 
   for (Mesh::VertexId i = 0; i < (isFullCircle ? inNumVertices : (inNumVertices - 1)); ++i)
   {
     const auto current_i = (i + 1);
     const auto next_i = ((i + 1) % inNumVertices) + 1;
-    circle_section.AddFace(0, current_i, next_i);
+    circle_section_streams.AddFace(0, current_i, next_i);
   }
 
+  auto circle_section = circle_section_streams.ToMesh();
   ConsolidateMesh(circle_section);
   return circle_section;
 }
@@ -412,8 +454,8 @@ Mesh MeshFactory::GetCircle(const std::size_t inNumVertices)
 
 void MeshFactory::ConsolidateMesh(Mesh& ioMesh)
 {
-  ioMesh.ComputeCornerTable();
+  // Normals and corner table computed when first needed, meshes only drawn never compute the corner table
   constexpr auto max_smooth_angle = DegreeToRad(45.0f);
-  ioMesh.ComputeNormals(max_smooth_angle);
+  ioMesh.SetAutoNormals(max_smooth_angle);
 }
 }
\ No newline at end of file
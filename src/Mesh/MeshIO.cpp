@@ -4,6 +4,15 @@
 #include <ez/Macros.h>
 #include <ez/Math.h>
 #include <ez/Mesh.h>
+#include <ez/MeshBinaryIO.h>
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <assimp/Exporter.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
@@ -11,65 +20,261 @@
 
 namespace ez
 {
-void MeshIO::Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh)
+namespace
 {
-  Assimp::Importer importer;
-  const auto* scene_ptr
-      = importer.ReadFile(inMeshPath.string(), aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+constexpr auto SkippedMeshId = static_cast<std::size_t>(-1);
+
+Vec3f AiVector3DToVec3f(const aiVector3D& inAiVector3D)
+{
+  return Vec3f(inAiVector3D.x, inAiVector3D.y, inAiVector3D.z);
+}
+
+Mat4f AiMatrix4x4ToMat4f(const aiMatrix4x4& inAiMatrix4x4)
+{
+  Mat4f matrix;
+  for (unsigned int row = 0; row < 4; ++row)
+  {
+    for (unsigned int col = 0; col < 4; ++col) { matrix[row][col] = inAiMatrix4x4[row][col]; }
+  }
+  return matrix;
+}
+
+const aiScene& ReadAiScene(Assimp::Importer& ioImporter,
+    const std::filesystem::path& inPath,
+    const unsigned int inPostProcessFlags)
+{
+  const auto* scene_ptr = ioImporter.ReadFile(inPath.string(), inPostProcessFlags);
 
   if (!scene_ptr)
-    THROW_EXCEPTION("Error loading mesh from '" << inMeshPath.string() << "': " << importer.GetErrorString());
+    THROW_EXCEPTION("Error loading mesh from '" << inPath.string() << "': " << ioImporter.GetErrorString());
+
+  if (scene_ptr->mNumMeshes == 0)
+    THROW_EXCEPTION("Error loading mesh from '" << inPath.string() << "': the file contains no mesh.");
+
+  return *scene_ptr;
+}
+
+// The faces of an aiMesh are not contiguous, its other streams are
+struct AiMeshContents
+{
+  const aiMesh* mAiMesh = nullptr;
+  std::vector<Mesh::FaceVerticesIds> mFacesVerticesIds;
+  uint64_t mHash = 0;
+};
 
-  const auto& scene = *scene_ptr;
+AiMeshContents GetAiMeshContents(const aiMesh& inAiMesh)
+{
+  AiMeshContents ai_mesh_contents;
+  ai_mesh_contents.mAiMesh = &inAiMesh;
+  ai_mesh_contents.mFacesVerticesIds.resize(inAiMesh.mNumFaces);
+  for (std::size_t face_id = 0; face_id < inAiMesh.mNumFaces; ++face_id)
+  {
+    const auto& ai_face = inAiMesh.mFaces[face_id];
+    EXPECTS(ai_face.mNumIndices == 3);
+    std::copy_n(ai_face.mIndices, 3, ai_mesh_contents.mFacesVerticesIds[face_id].begin());
+  }
+  return ai_mesh_contents;
+}
 
-  if (scene.mNumMeshes == 0)
-    THROW_EXCEPTION("Error loading mesh from '" << inMeshPath.string() << "': the file contains no mesh.");
+template <typename T>
+std::size_t GetSizeInBytes(const T* inData, const std::size_t inNumberOfElements)
+{
+  return (inData ? (inNumberOfElements * sizeof(T)) : 0);
+}
 
-  const auto AiVector3DToVec3f
-      = [](const aiVector3D& inAiVector3D) { return Vec3f(inAiVector3D.x, inAiVector3D.y, inAiVector3D.z); };
+uint64_t ComputeAiMeshContentsHash(const AiMeshContents& inAiMeshContents)
+{
+  const auto& ai_mesh = *inAiMeshContents.mAiMesh;
+  const auto hash_bytes = [](const auto* inData, const std::size_t inSize, const uint64_t inSeed)
+  { return MeshBinaryIO::ComputeChecksum(reinterpret_cast<const std::byte*>(inData), inSize, inSeed); };
 
-  const auto& ai_mesh = *(scene.mMeshes[0]);
-  ioMesh.Clear();
+  const auto& faces_vertices_ids = inAiMeshContents.mFacesVerticesIds;
+  auto hash = hash_bytes(faces_vertices_ids.data(),
+      GetSizeInBytes(faces_vertices_ids.data(), faces_vertices_ids.size()),
+      0);
+  hash = hash_bytes(ai_mesh.mVertices, GetSizeInBytes(ai_mesh.mVertices, ai_mesh.mNumVertices), hash);
+  hash = hash_bytes(ai_mesh.mNormals, GetSizeInBytes(ai_mesh.mNormals, ai_mesh.mNumVertices), hash);
+  hash = hash_bytes(ai_mesh.mTextureCoords[0], GetSizeInBytes(ai_mesh.mTextureCoords[0], ai_mesh.mNumVertices), hash);
+  return hash;
+}
 
-  // Create vertices
-  for (Mesh::VertexId vertex_id = 0; vertex_id < ai_mesh.mNumVertices; ++vertex_id)
+bool HaveSameContents(const AiMeshContents& inLHS, const AiMeshContents& inRHS)
+{
+  const auto& lhs = *inLHS.mAiMesh;
+  const auto& rhs = *inRHS.mAiMesh;
+  const auto are_same_streams = [&](const aiVector3D* inLHSStream, const aiVector3D* inRHSStream)
   {
-    const auto ai_vertex_position = ai_mesh.mVertices[vertex_id];
-    const auto vertex_position = AiVector3DToVec3f(ai_vertex_position);
-    ioMesh.AddVertex(vertex_position);
+    return ((inLHSStream == nullptr) == (inRHSStream == nullptr))
+        && (inLHSStream == nullptr
+            || std::memcmp(inLHSStream, inRHSStream, GetSizeInBytes(inLHSStream, lhs.mNumVertices)) == 0);
+  };
+
+  return (inLHS.mHash == inRHS.mHash) && (lhs.mNumVertices == rhs.mNumVertices)
+      && (inLHS.mFacesVerticesIds == inRHS.mFacesVerticesIds) && are_same_streams(lhs.mVertices, rhs.mVertices)
+      && are_same_streams(lhs.mNormals, rhs.mNormals) && are_same_streams(lhs.mTextureCoords[0], rhs.mTextureCoords[0]);
+}
+
+// Corner normals and texture coordinates from the ones of their vertices. Moves the faces out of ioAiMeshContents.
+void SetMeshFromAiMesh(AiMeshContents& ioAiMeshContents, Mesh& ioMesh)
+{
+  const auto& ai_mesh = *ioAiMeshContents.mAiMesh;
+  const auto& faces_vertices_ids = ioAiMeshContents.mFacesVerticesIds;
+
+  std::vector<Vec3f> vertices_positions(ai_mesh.mNumVertices);
+  for (std::size_t vertex_id = 0; vertex_id < ai_mesh.mNumVertices; ++vertex_id)
+    vertices_positions[vertex_id] = AiVector3DToVec3f(ai_mesh.mVertices[vertex_id]);
+
+  const auto number_of_corners = (faces_vertices_ids.size() * 3);
+  const auto get_corner_vertex_id = [&](const std::size_t inCornerId)
+  { return faces_vertices_ids[inCornerId / 3][inCornerId % 3]; };
+
+  std::vector<Vec3f> corners_normals;
+  if (ai_mesh.mNormals != nullptr)
+  {
+    corners_normals.resize(number_of_corners);
+    for (std::size_t corner_id = 0; corner_id < number_of_corners; ++corner_id)
+    {
+      const auto ai_corner_normal = ai_mesh.mNormals[get_corner_vertex_id(corner_id)];
+      corners_normals[corner_id] = NormalizedSafe(AiVector3DToVec3f(ai_corner_normal));
+    }
   }
 
-  // Create faces
-  for (Mesh::FaceId face_id = 0; face_id < ai_mesh.mNumFaces; ++face_id)
+  std::vector<Vec2f> corners_texture_coordinates;
+  if (ai_mesh.mTextureCoords[0] != nullptr)
   {
-    const auto ai_face = ai_mesh.mFaces[face_id];
-    EXPECTS(ai_face.mNumIndices == 3);
-    ioMesh.AddFace(ai_face.mIndices[0], ai_face.mIndices[1], ai_face.mIndices[2]);
+    corners_texture_coordinates.resize(number_of_corners);
+    for (std::size_t corner_id = 0; corner_id < number_of_corners; ++corner_id)
+    {
+      const auto ai_corner_texture_coordinates = ai_mesh.mTextureCoords[0][get_corner_vertex_id(corner_id)];
+      corners_texture_coordinates[corner_id] = XY(AiVector3DToVec3f(ai_corner_texture_coordinates));
+    }
   }
 
-  // Assign corner properties
-  for (Mesh::CornerId corner_id = 0; corner_id < ioMesh.GetNumberOfCorners(); ++corner_id)
+  ioMesh.SetStreams(std::move(vertices_positions),
+      std::move(ioAiMeshContents.mFacesVerticesIds),
+      {},
+      std::move(corners_normals),
+      std::move(corners_texture_coordinates));
+}
+}
+
+void MeshIO::Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh)
+{
+  Assimp::Importer importer;
+  const auto& scene = ReadAiScene(importer, inMeshPath, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+  auto ai_mesh_contents = GetAiMeshContents(*(scene.mMeshes[0]));
+  SetMeshFromAiMesh(ai_mesh_contents, ioMesh);
+}
+
+MeshIO::Scene MeshIO::ReadScene(const std::filesystem::path& inScenePath, const float inMinEdgeAngleToSmooth)
+{
+  // Sorted by primitive type, so that the meshes are either all triangles or have no triangles at all
+  Assimp::Importer importer;
+  const auto& scene = ReadAiScene(importer,
+      inScenePath,
+      aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+
+  std::vector<AiMeshContents> ai_meshes_contents(scene.mNumMeshes);
+  ParallelFor(
+      scene.mNumMeshes,
+      [&](const std::size_t, const std::size_t inBeginAiMeshId, const std::size_t inEndAiMeshId)
+      {
+        for (auto ai_mesh_id = inBeginAiMeshId; ai_mesh_id < inEndAiMeshId; ++ai_mesh_id)
+        {
+          const auto& ai_mesh = *(scene.mMeshes[ai_mesh_id]);
+          if ((ai_mesh.mPrimitiveTypes & aiPrimitiveType_TRIANGLE) == 0)
+            continue;
+
+          auto& ai_mesh_contents = ai_meshes_contents[ai_mesh_id];
+          ai_mesh_contents = GetAiMeshContents(ai_mesh);
+          ai_mesh_contents.mHash = ComputeAiMeshContentsHash(ai_mesh_contents);
+        }
+      },
+      1);
+
+  // Every group of meshes with the same contents becomes one mesh (the ones shared by several nodes already are one)
+  std::vector<std::size_t> ai_meshes_ids_to_meshes_ids(scene.mNumMeshes, SkippedMeshId);
+  std::vector<std::size_t> meshes_ai_meshes_ids;
+  std::unordered_multimap<uint64_t, std::size_t> hashes_to_meshes_ids;
+  for (std::size_t ai_mesh_id = 0; ai_mesh_id < scene.mNumMeshes; ++ai_mesh_id)
   {
-    const auto face_id = (corner_id / 3);
-    const auto internal_corner_id = (corner_id % 3);
-    const auto vertex_id = ioMesh.GetFacesData().at(face_id).mVerticesIds.at(internal_corner_id);
+    const auto& ai_mesh_contents = ai_meshes_contents[ai_mesh_id];
+    if (!ai_mesh_contents.mAiMesh)
+      continue;
 
-    // Normal
-    if (ai_mesh.mNormals != nullptr)
+    auto& mesh_id = ai_meshes_ids_to_meshes_ids[ai_mesh_id];
+    const auto [same_hash_begin, same_hash_end] = hashes_to_meshes_ids.equal_range(ai_mesh_contents.mHash);
+    for (auto it = same_hash_begin; it != same_hash_end && mesh_id == SkippedMeshId; ++it)
     {
-      const auto ai_corner_normal = ai_mesh.mNormals[vertex_id];
-      const auto corner_normal = NormalizedSafe(AiVector3DToVec3f(ai_corner_normal));
-      ioMesh.SetCornerNormal(corner_id, corner_normal);
+      if (HaveSameContents(ai_mesh_contents, ai_meshes_contents[meshes_ai_meshes_ids[it->second]]))
+        mesh_id = it->second;
     }
 
-    // Texture coordinate
-    if (ai_mesh.mTextureCoords[0] != nullptr)
+    if (mesh_id == SkippedMeshId)
+    {
+      mesh_id = meshes_ai_meshes_ids.size();
+      meshes_ai_meshes_ids.push_back(ai_mesh_id);
+      hashes_to_meshes_ids.emplace(ai_mesh_contents.mHash, mesh_id);
+    }
+  }
+
+  // Every thread takes the largest mesh not taken yet, so that a few large meshes do not end up in the same thread
+  MeshIO::Scene result_scene;
+  result_scene.mMeshes.resize(meshes_ai_meshes_ids.size());
+  std::vector<std::size_t> meshes_ids_by_size(meshes_ai_meshes_ids.size());
+  std::iota(meshes_ids_by_size.begin(), meshes_ids_by_size.end(), 0);
+  std::sort(meshes_ids_by_size.begin(),
+      meshes_ids_by_size.end(),
+      [&](const std::size_t inLHSMeshId, const std::size_t inRHSMeshId)
+      {
+        return ai_meshes_contents[meshes_ai_meshes_ids[inLHSMeshId]].mFacesVerticesIds.size()
+            > ai_meshes_contents[meshes_ai_meshes_ids[inRHSMeshId]].mFacesVerticesIds.size();
+      });
+
+  // The threads are all busy with meshes already, the derived data of each one is computed in its thread alone
+  std::atomic<std::size_t> next_meshes_ids_by_size_index = 0;
+  ParallelFor(
+      std::min(GetNumberOfParallelThreads(), meshes_ids_by_size.size()),
+      [&](const std::size_t, const std::size_t, const std::size_t)
+      {
+        const ParallelSerialGuard parallel_serial_guard;
+        for (auto i = next_meshes_ids_by_size_index++; i < meshes_ids_by_size.size();
+             i = next_meshes_ids_by_size_index++)
+        {
+          const auto mesh_id = meshes_ids_by_size[i];
+          auto& ai_mesh_contents = ai_meshes_contents[meshes_ai_meshes_ids[mesh_id]];
+          auto& mesh = result_scene.mMeshes[mesh_id];
+          SetMeshFromAiMesh(ai_mesh_contents, mesh);
+          mesh.ComputeCornerTable();
+          mesh.ComputeFaceNormals();
+          if (ai_mesh_contents.mAiMesh->mNormals == nullptr)
+            mesh.ComputeCornerNormals(inMinEdgeAngleToSmooth);
+        }
+      },
+      1);
+
+  // Instances, from the node hierarchy
+  std::vector<std::pair<const aiNode*, aiMatrix4x4>> nodes_to_visit;
+  if (scene.mRootNode)
+    nodes_to_visit.emplace_back(scene.mRootNode, aiMatrix4x4());
+  while (!nodes_to_visit.empty())
+  {
+    const auto [node, parent_transform] = nodes_to_visit.back();
+    nodes_to_visit.pop_back();
+
+    const auto transform = (parent_transform * node->mTransformation);
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i)
     {
-      const auto ai_corner_texture_coordinates = ai_mesh.mTextureCoords[0][vertex_id];
-      const auto corner_texture_coordinates = XY(AiVector3DToVec3f(ai_corner_texture_coordinates));
-      ioMesh.SetCornerTextureCoordinates(corner_id, corner_texture_coordinates);
+      const auto mesh_id = ai_meshes_ids_to_meshes_ids[node->mMeshes[i]];
+      if (mesh_id != SkippedMeshId)
+        result_scene.mInstances.push_back({ mesh_id, AiMatrix4x4ToMat4f(transform), node->mName.C_Str() });
     }
+
+    for (unsigned int i = 0; i < node->mNumChildren; ++i)
+      nodes_to_visit.emplace_back(node->mChildren[i], transform);
   }
+
+  return result_scene;
 }
 
 void MeshIO::Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath, const bool inPreserveVerticesIds)
@@ -101,12 +306,12 @@ void MeshIO::Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath,
       ai_face.mNumIndices = 3;
       ai_face.mIndices = new unsigned int[ai_face.mNumIndices];
 
-      const auto& face_data = inMesh.GetFacesData().at(face_id);
+      const auto face_vertices_ids = inMesh.GetFaceVerticesIds(face_id);
       if (inPreserveVerticesIds)
       {
-        ai_face.mIndices[0] = face_data.mVerticesIds[0];
-        ai_face.mIndices[1] = face_data.mVerticesIds[1];
-        ai_face.mIndices[2] = face_data.mVerticesIds[2];
+        ai_face.mIndices[0] = face_vertices_ids[0];
+        ai_face.mIndices[1] = face_vertices_ids[1];
+        ai_face.mIndices[2] = face_vertices_ids[2];
       }
       else
       {
@@ -121,7 +326,7 @@ void MeshIO::Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath,
       ai_mesh.mNumVertices = inMesh.GetNumberOfVertices();
       ai_mesh.mVertices = new aiVector3D[inMesh.GetNumberOfVertices()];
       for (Mesh::VertexId vertex_id = 0; vertex_id < inMesh.GetNumberOfVertices(); ++vertex_id)
-      { ai_mesh.mVertices[vertex_id] = Vec3fToAiVector3D(inMesh.GetVerticesData().at(vertex_id).mPosition); }
+      { ai_mesh.mVertices[vertex_id] = Vec3fToAiVector3D(inMesh.GetVertexPosition(vertex_id)); }
     }
     else
     {
@@ -135,10 +340,9 @@ void MeshIO::Write(const Mesh& inMesh, const std::filesystem::path& inMeshPath,
       for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
       {
         const auto vertex_id = inMesh.GetVertexIdFromCornerId(corner_id);
-        ai_mesh.mVertices[corner_id] = Vec3fToAiVector3D(inMesh.GetVerticesData().at(vertex_id).mPosition);
-        ai_mesh.mNormals[corner_id] = Vec3fToAiVector3D(inMesh.GetCornersData().at(corner_id).mNormal);
-        ai_mesh.mTextureCoords[0][corner_id]
-            = Vec2fToAiVector3D(inMesh.GetCornersData().at(corner_id).mTextureCoordinates);
+        ai_mesh.mVertices[corner_id] = Vec3fToAiVector3D(inMesh.GetVertexPosition(vertex_id));
+        ai_mesh.mNormals[corner_id] = Vec3fToAiVector3D(inMesh.GetCornerNormal(corner_id));
+        ai_mesh.mTextureCoords[0][corner_id] = Vec2fToAiVector3D(inMesh.GetCornerTextureCoordinates(corner_id));
       }
     }
   }
@@ -0,0 +1,74 @@
+#include <ez/MeshLODChain.h>
+#include <ez/MeshSimplifier.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ez
+{
+MeshLODChain::MeshLODChain(const Mesh& inMesh,
+    const std::size_t inNumberOfLevels,
+    const float inFacesRatio,
+    const bool inOptimize,
+    const MeshDrawData::EVertexLayout inVertexLayout)
+{
+  EXPECTS(inNumberOfLevels >= 1);
+  EXPECTS(inFacesRatio > 0.0f && inFacesRatio < 1.0f);
+
+  mBoundingSphere = inMesh.GetBoundingSphere();
+
+  AddLevel(std::make_shared<MeshDrawData>(inMesh, inOptimize, inVertexLayout), 0.0f);
+  if (inNumberOfLevels == 1)
+    return;
+
+  // Every level is simplified from the original mesh, so that its error is measured against it
+  auto number_of_faces = inMesh.GetNumberOfFaces();
+  for (std::size_t level_id = 1; level_id < inNumberOfLevels; ++level_id)
+  {
+    MeshSimplifier::Parameters simplifier_parameters;
+    simplifier_parameters.mTargetNumberOfFaces = static_cast<std::size_t>(number_of_faces * inFacesRatio);
+    auto simplifier_result = MeshSimplifier::Simplify(inMesh, simplifier_parameters);
+
+    // Locked vertices (seams and boundaries ends) can stop the simplification early
+    const auto level_number_of_faces = simplifier_result.mMesh.GetNumberOfFaces();
+    if (level_number_of_faces == 0 || level_number_of_faces >= number_of_faces)
+      break;
+
+    AddLevel(std::make_shared<MeshDrawData>(simplifier_result.mMesh, inOptimize, inVertexLayout),
+        std::max(simplifier_result.mError, mLevels.back().mError));
+    number_of_faces = level_number_of_faces;
+  }
+}
+
+void MeshLODChain::AddLevel(const std::shared_ptr<const MeshDrawData>& inMeshDrawData, const float inError)
+{
+  EXPECTS(inMeshDrawData);
+  EXPECTS(inError >= 0.0f);
+  EXPECTS(mLevels.empty() || inError >= mLevels.back().mError);
+
+  mLevels.push_back(MeshLODChain::Level { inMeshDrawData, inError });
+}
+
+const MeshLODChain::Level& MeshLODChain::GetLevel(const std::size_t inLevelId) const
+{
+  EXPECTS(inLevelId < mLevels.size());
+  return mLevels[inLevelId];
+}
+
+std::size_t MeshLODChain::SelectLevel(const float inPixelsPerUnit, const float inMaxScreenError) const
+{
+  EXPECTS(!mLevels.empty());
+  EXPECTS(inPixelsPerUnit >= 0.0f);
+
+  const auto get_screen_error = [&](const std::size_t inLevelId)
+  { return mLevels[inLevelId].mError * inPixelsPerUnit; };
+
+  // Finer right away while the level is too coarse, coarser only once well below the max
+  auto level_id = std::min(mLastSelectedLevelId, mLevels.size() - 1);
+  while (level_id > 0 && get_screen_error(level_id) > inMaxScreenError) --level_id;
+  while (level_id + 1 < mLevels.size() && get_screen_error(level_id + 1) <= inMaxScreenError * (1.0f - Hysteresis))
+    ++level_id;
+
+  mLastSelectedLevelId = level_id;
+  return level_id;
+}
+}
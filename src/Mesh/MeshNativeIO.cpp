@@ -0,0 +1,1218 @@
+#include <ez/MeshNativeIO.h>
+#include <ez/Macros.h>
+#include <ez/MappedFile.h>
+#include <ez/Math.h>
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ez
+{
+namespace
+{
+constexpr std::size_t MinParallelChunkSizeInBytes = (1u << 20);
+
+// Parsed streams, with the corner ones possibly empty
+struct ParsedMesh
+{
+  std::vector<Vec3f> mVerticesPositions;
+  std::vector<Mesh::FaceVerticesIds> mFacesVerticesIds;
+  std::vector<Vec3f> mFacesNormals;
+  std::vector<Vec3f> mCornersNormals;
+  std::vector<Vec2f> mCornersTextureCoordinates;
+};
+
+std::string GetLowerCaseExtension(const std::filesystem::path& inMeshPath)
+{
+  auto extension = inMeshPath.extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  return extension;
+}
+
+// Text ========================================================================================================
+
+bool IsSpace(const char inCharacter) { return (inCharacter == ' ' || inCharacter == '\t' || inCharacter == '\r'); }
+
+const char* SkipSpaces(const char* inCursor, const char* inEnd)
+{
+  while (inCursor < inEnd && IsSpace(*inCursor)) ++inCursor;
+  return inCursor;
+}
+
+const char* SkipToken(const char* inCursor, const char* inEnd)
+{
+  inCursor = SkipSpaces(inCursor, inEnd);
+  while (inCursor < inEnd && !IsSpace(*inCursor)) ++inCursor;
+  return inCursor;
+}
+
+const char* GetLineEnd(const char* inCursor, const char* inEnd)
+{
+  const auto size = static_cast<std::size_t>(inEnd - inCursor);
+  const auto* line_end = static_cast<const char*>(std::memchr(inCursor, '\n', size));
+  return (line_end ? line_end : inEnd);
+}
+
+// Parses a number after optional spaces, advancing ioCursor past it
+template <typename T>
+bool ParseNumber(const char*& ioCursor, const char* inEnd, T& outValue)
+{
+  auto cursor = SkipSpaces(ioCursor, inEnd);
+  if (cursor < inEnd && *cursor == '+')
+    ++cursor;
+
+  const auto [number_end, error] = std::from_chars(cursor, inEnd, outValue);
+  if (error != std::errc())
+    return false;
+
+  ioCursor = number_end;
+  return true;
+}
+
+// Splits [inBegin, inEnd) into ranges of whole lines, one per parallel chunk: chunk i is [begins[i], begins[i + 1])
+std::vector<const char*> SplitIntoLinesChunks(const char* inBegin, const char* inEnd)
+{
+  const auto size = static_cast<std::size_t>(inEnd - inBegin);
+  const auto number_of_chunks = GetNumberOfParallelChunks(size, MinParallelChunkSizeInBytes);
+  std::vector<const char*> chunks_begins(number_of_chunks + 1, inEnd);
+  chunks_begins[0] = inBegin;
+  for (std::size_t chunk_id = 1; chunk_id < number_of_chunks; ++chunk_id)
+  {
+    const auto* chunk_begin = std::max(inBegin + (size * chunk_id) / number_of_chunks, chunks_begins[chunk_id - 1]);
+    const auto* line_end = GetLineEnd(chunk_begin, inEnd);
+    chunks_begins[chunk_id] = (line_end < inEnd ? line_end + 1 : inEnd);
+  }
+  return chunks_begins;
+}
+
+template <typename TFunction>
+void ParallelForEachChunk(const std::size_t inNumberOfChunks, const TFunction& inFunction)
+{
+  ParallelFor(
+      inNumberOfChunks,
+      [&](const std::size_t, const std::size_t inBeginChunkId, const std::size_t inEndChunkId)
+      {
+        for (auto chunk_id = inBeginChunkId; chunk_id < inEndChunkId; ++chunk_id) inFunction(chunk_id);
+      },
+      1);
+}
+
+// Exclusive prefix sum of the sizes, with the total at the end
+template <typename TChunk, typename TGetSize>
+std::vector<std::size_t> GetChunksOffsets(const std::vector<TChunk>& inChunks, const TGetSize& inGetSize)
+{
+  std::vector<std::size_t> chunks_offsets(inChunks.size() + 1, 0);
+  for (std::size_t chunk_id = 0; chunk_id < inChunks.size(); ++chunk_id)
+    chunks_offsets[chunk_id + 1] = chunks_offsets[chunk_id] + inGetSize(inChunks[chunk_id]);
+  return chunks_offsets;
+}
+
+void CheckFacesVerticesIds(const std::vector<Mesh::FaceVerticesIds>& inFacesVerticesIds,
+    const std::size_t inNumberOfVertices)
+{
+  ParallelFor(inFacesVerticesIds.size(),
+      [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          for (const auto vertex_id : inFacesVerticesIds[face_id])
+          {
+            if (vertex_id >= inNumberOfVertices)
+              THROW_EXCEPTION("Face " << face_id << " references vertex " << vertex_id << ", out of range");
+          }
+        }
+      });
+}
+
+// Corner attributes from per-vertex ones, as MeshIO does
+template <typename T>
+std::vector<T> GetCornersAttributesFromVertices(const std::vector<Mesh::FaceVerticesIds>& inFacesVerticesIds,
+    const std::vector<T>& inVerticesAttributes)
+{
+  std::vector<T> corners_attributes(inFacesVerticesIds.size() * 3);
+  ParallelFor(inFacesVerticesIds.size(),
+      [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          for (std::size_t i = 0; i < 3; ++i)
+            corners_attributes[face_id * 3 + i] = inVerticesAttributes[inFacesVerticesIds[face_id][i]];
+        }
+      });
+  return corners_attributes;
+}
+
+// OBJ =========================================================================================================
+
+// Attributes of an OBJ corner: position, texture coordinates and normal indices
+constexpr std::size_t ObjNumberOfAttributes = 3;
+using ObjCorner = std::array<Mesh::Id, ObjNumberOfAttributes>; // InvalidId if the attribute is not given
+
+// Negative OBJ indices are relative to the attributes read so far, so they are resolved once the number of
+// attributes of the previous chunks is known
+struct ObjRelativeIndex
+{
+  std::size_t mCornerId = 0; // In the chunk
+  std::size_t mAttributeId = 0;
+  int64_t mIndex = 0; // From the first attribute of the chunk (negative for the previous chunks)
+};
+
+struct ObjChunk
+{
+  std::array<std::size_t, ObjNumberOfAttributes> mNumbersOfAttributes {};
+  std::vector<Vec3f> mPositions;
+  std::vector<Vec2f> mTextureCoordinates;
+  std::vector<Vec3f> mNormals;
+  std::vector<ObjCorner> mCorners; // Of the triangulated faces, three per face
+  std::vector<ObjRelativeIndex> mRelativeIndices;
+};
+
+void ParseObjChunk(const char* inBegin, const char* inEnd, ObjChunk& outChunk)
+{
+  const auto throw_invalid_line = [](const char* inLineBegin, const char* inLineEnd)
+  {
+    const auto line = std::string_view(inLineBegin, static_cast<std::size_t>(inLineEnd - inLineBegin));
+    THROW_EXCEPTION("Invalid OBJ line '" << line << "'");
+  };
+
+  struct PolygonCorner
+  {
+    std::array<int64_t, ObjNumberOfAttributes> mIndices;
+  };
+  std::vector<PolygonCorner> polygon_corners;
+
+  const auto push_corner = [&](const PolygonCorner& inPolygonCorner)
+  {
+    ObjCorner corner;
+    for (std::size_t attribute_id = 0; attribute_id < ObjNumberOfAttributes; ++attribute_id)
+    {
+      const auto index = inPolygonCorner.mIndices[attribute_id];
+      if (index > 0)
+      {
+        if (index > static_cast<int64_t>(std::numeric_limits<Mesh::Id>::max() - 1))
+          THROW_EXCEPTION("OBJ index " << index << " out of range");
+        corner[attribute_id] = static_cast<Mesh::Id>(index - 1);
+      }
+      else if (index < 0)
+      {
+        const auto relative_index = static_cast<int64_t>(outChunk.mNumbersOfAttributes[attribute_id]) + index;
+        outChunk.mRelativeIndices.push_back(
+            ObjRelativeIndex { outChunk.mCorners.size(), attribute_id, relative_index });
+        corner[attribute_id] = Mesh::InvalidId;
+      }
+      else
+      {
+        corner[attribute_id] = Mesh::InvalidId;
+      }
+    }
+    outChunk.mCorners.push_back(corner);
+  };
+
+  for (const char* line_begin = inBegin; line_begin < inEnd;)
+  {
+    const auto* line_end = GetLineEnd(line_begin, inEnd);
+    const auto* cursor = SkipSpaces(line_begin, line_end);
+
+    if (cursor + 1 < line_end && cursor[0] == 'v')
+    {
+      if (IsSpace(cursor[1]))
+      {
+        ++cursor;
+        Vec3f position;
+        if (!ParseNumber(cursor, line_end, position[0]) || !ParseNumber(cursor, line_end, position[1])
+            || !ParseNumber(cursor, line_end, position[2]))
+          throw_invalid_line(line_begin, line_end);
+        outChunk.mPositions.push_back(position);
+        ++outChunk.mNumbersOfAttributes[0];
+      }
+      else if (cursor[1] == 't' && cursor + 2 < line_end && IsSpace(cursor[2]))
+      {
+        cursor += 2;
+        Vec2f texture_coordinates = Zero<Vec2f>();
+        if (!ParseNumber(cursor, line_end, texture_coordinates[0]))
+          throw_invalid_line(line_begin, line_end);
+        ParseNumber(cursor, line_end, texture_coordinates[1]); // Optional
+        outChunk.mTextureCoordinates.push_back(texture_coordinates);
+        ++outChunk.mNumbersOfAttributes[1];
+      }
+      else if (cursor[1] == 'n' && cursor + 2 < line_end && IsSpace(cursor[2]))
+      {
+        cursor += 2;
+        Vec3f normal;
+        if (!ParseNumber(cursor, line_end, normal[0]) || !ParseNumber(cursor, line_end, normal[1])
+            || !ParseNumber(cursor, line_end, normal[2]))
+          throw_invalid_line(line_begin, line_end);
+        outChunk.mNormals.push_back(normal);
+        ++outChunk.mNumbersOfAttributes[2];
+      }
+    }
+    else if (cursor + 1 < line_end && cursor[0] == 'f' && IsSpace(cursor[1]))
+    {
+      // Corners as "p", "p/t", "p//n" or "p/t/n"
+      ++cursor;
+      polygon_corners.clear();
+      while (SkipSpaces(cursor, line_end) < line_end)
+      {
+        PolygonCorner polygon_corner { { 0, 0, 0 } };
+        if (!ParseNumber(cursor, line_end, polygon_corner.mIndices[0]) || polygon_corner.mIndices[0] == 0)
+          throw_invalid_line(line_begin, line_end);
+        for (std::size_t attribute_id = 1; attribute_id < ObjNumberOfAttributes; ++attribute_id)
+        {
+          if (cursor >= line_end || *cursor != '/')
+            break;
+          ++cursor;
+          if (cursor < line_end && *cursor != '/' && !IsSpace(*cursor))
+          {
+            if (!ParseNumber(cursor, line_end, polygon_corner.mIndices[attribute_id]))
+              throw_invalid_line(line_begin, line_end);
+          }
+        }
+        polygon_corners.push_back(polygon_corner);
+      }
+
+      if (polygon_corners.size() < 3)
+        throw_invalid_line(line_begin, line_end);
+      for (std::size_t i = 1; i + 1 < polygon_corners.size(); ++i)
+      {
+        push_corner(polygon_corners[0]);
+        push_corner(polygon_corners[i]);
+        push_corner(polygon_corners[i + 1]);
+      }
+    }
+    // Anything else (comments, groups, materials, lines...) is skipped
+
+    line_begin = line_end + 1;
+  }
+}
+
+ParsedMesh ParseObj(const char* inBegin, const char* inEnd)
+{
+  const auto chunks_begins = SplitIntoLinesChunks(inBegin, inEnd);
+  const auto number_of_chunks = chunks_begins.size() - 1;
+  std::vector<ObjChunk> chunks(number_of_chunks);
+  ParallelForEachChunk(number_of_chunks,
+      [&](const std::size_t inChunkId)
+      { ParseObjChunk(chunks_begins[inChunkId], chunks_begins[inChunkId + 1], chunks[inChunkId]); });
+
+  // Merge the chunks, each in place at its offsets
+  std::array<std::vector<std::size_t>, ObjNumberOfAttributes> attributes_chunks_offsets;
+  for (std::size_t attribute_id = 0; attribute_id < ObjNumberOfAttributes; ++attribute_id)
+  {
+    attributes_chunks_offsets[attribute_id] = GetChunksOffsets(chunks,
+        [&](const ObjChunk& inChunk) { return inChunk.mNumbersOfAttributes[attribute_id]; });
+  }
+  const auto corners_chunks_offsets
+      = GetChunksOffsets(chunks, [](const ObjChunk& inChunk) { return inChunk.mCorners.size(); });
+  const auto number_of_positions = attributes_chunks_offsets[0].back();
+  const auto number_of_texture_coordinates = attributes_chunks_offsets[1].back();
+  const auto number_of_normals = attributes_chunks_offsets[2].back();
+  const auto number_of_corners = corners_chunks_offsets.back();
+
+  std::vector<Vec3f> positions(number_of_positions);
+  std::vector<Vec2f> texture_coordinates(number_of_texture_coordinates);
+  std::vector<Vec3f> normals(number_of_normals);
+  std::vector<ObjCorner> corners(number_of_corners);
+  ParallelForEachChunk(number_of_chunks,
+      [&](const std::size_t inChunkId)
+      {
+        auto& chunk = chunks[inChunkId];
+        std::copy(chunk.mPositions.cbegin(),
+            chunk.mPositions.cend(),
+            positions.begin() + attributes_chunks_offsets[0][inChunkId]);
+        std::copy(chunk.mTextureCoordinates.cbegin(),
+            chunk.mTextureCoordinates.cend(),
+            texture_coordinates.begin() + attributes_chunks_offsets[1][inChunkId]);
+        std::copy(chunk.mNormals.cbegin(),
+            chunk.mNormals.cend(),
+            normals.begin() + attributes_chunks_offsets[2][inChunkId]);
+
+        const auto corners_offset = corners_chunks_offsets[inChunkId];
+        std::copy(chunk.mCorners.cbegin(), chunk.mCorners.cend(), corners.begin() + corners_offset);
+        for (const auto& relative_index : chunk.mRelativeIndices)
+        {
+          const auto index = static_cast<int64_t>(attributes_chunks_offsets[relative_index.mAttributeId][inChunkId])
+              + relative_index.mIndex;
+          if (index < 0)
+            THROW_EXCEPTION("OBJ relative index out of range");
+          auto& corner = corners[corners_offset + relative_index.mCornerId];
+          corner[relative_index.mAttributeId] = static_cast<Mesh::Id>(index);
+        }
+        chunk = ObjChunk {}; // Release the chunk memory as soon as possible
+      });
+
+  ParsedMesh parsed_mesh;
+  const auto number_of_faces = number_of_corners / 3;
+  parsed_mesh.mFacesVerticesIds.resize(number_of_faces);
+  if (number_of_texture_coordinates > 0)
+    parsed_mesh.mCornersTextureCoordinates.resize(number_of_corners, Zero<Vec2f>());
+  if (number_of_normals > 0)
+    parsed_mesh.mCornersNormals.resize(number_of_corners, Zero<Vec3f>());
+
+  ParallelFor(number_of_faces,
+      [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          for (std::size_t i = 0; i < 3; ++i)
+          {
+            const auto corner_id = face_id * 3 + i;
+            const auto& corner = corners[corner_id];
+            if (corner[0] >= number_of_positions)
+              THROW_EXCEPTION("OBJ position index " << (corner[0] + 1) << " out of range");
+            parsed_mesh.mFacesVerticesIds[face_id][i] = corner[0];
+
+            if (corner[1] != Mesh::InvalidId)
+            {
+              if (corner[1] >= number_of_texture_coordinates)
+                THROW_EXCEPTION("OBJ texture coordinates index " << (corner[1] + 1) << " out of range");
+              parsed_mesh.mCornersTextureCoordinates[corner_id] = texture_coordinates[corner[1]];
+            }
+
+            if (corner[2] != Mesh::InvalidId)
+            {
+              if (corner[2] >= number_of_normals)
+                THROW_EXCEPTION("OBJ normal index " << (corner[2] + 1) << " out of range");
+              parsed_mesh.mCornersNormals[corner_id] = NormalizedSafe(normals[corner[2]]);
+            }
+          }
+        }
+      });
+
+  parsed_mesh.mVerticesPositions = std::move(positions);
+  return parsed_mesh;
+}
+
+// PLY =========================================================================================================
+
+enum class EPlyFormat
+{
+  ASCII,
+  BINARY_LITTLE_ENDIAN,
+  BINARY_BIG_ENDIAN
+};
+
+enum class EPlyType
+{
+  INT8,
+  UINT8,
+  INT16,
+  UINT16,
+  INT32,
+  UINT32,
+  FLOAT32,
+  FLOAT64
+};
+
+struct PlyProperty
+{
+  std::string mName;
+  EPlyType mType = EPlyType::FLOAT32; // Of the items, for lists
+  bool mIsList = false;
+  EPlyType mListCountType = EPlyType::UINT8;
+};
+
+struct PlyElement
+{
+  std::string mName;
+  std::size_t mCount = 0;
+  std::vector<PlyProperty> mProperties;
+};
+
+struct PlyHeader
+{
+  EPlyFormat mFormat = EPlyFormat::ASCII;
+  std::vector<PlyElement> mElements;
+  const char* mBodyBegin = nullptr;
+};
+
+// Vertex properties read, by their usual names
+enum class EPlyVertexAttribute
+{
+  X,
+  Y,
+  Z,
+  NX,
+  NY,
+  NZ,
+  U,
+  V
+};
+constexpr std::size_t PlyNumberOfVertexAttributes = 8;
+using PlyVertexAttributesPropertiesIds = std::array<std::optional<std::size_t>, PlyNumberOfVertexAttributes>;
+
+std::optional<EPlyType> GetPlyType(const std::string_view inTypeName)
+{
+  constexpr std::array<std::pair<std::string_view, EPlyType>, 16> types_names = { {
+      { "char", EPlyType::INT8 },
+      { "int8", EPlyType::INT8 },
+      { "uchar", EPlyType::UINT8 },
+      { "uint8", EPlyType::UINT8 },
+      { "short", EPlyType::INT16 },
+      { "int16", EPlyType::INT16 },
+      { "ushort", EPlyType::UINT16 },
+      { "uint16", EPlyType::UINT16 },
+      { "int", EPlyType::INT32 },
+      { "int32", EPlyType::INT32 },
+      { "uint", EPlyType::UINT32 },
+      { "uint32", EPlyType::UINT32 },
+      { "float", EPlyType::FLOAT32 },
+      { "float32", EPlyType::FLOAT32 },
+      { "double", EPlyType::FLOAT64 },
+      { "float64", EPlyType::FLOAT64 },
+  } };
+  for (const auto& [type_name, type] : types_names)
+  {
+    if (type_name == inTypeName)
+      return type;
+  }
+  return std::nullopt;
+}
+
+std::size_t GetPlyTypeSize(const EPlyType inType)
+{
+  switch (inType)
+  {
+  case EPlyType::INT8:
+  case EPlyType::UINT8: return 1;
+  case EPlyType::INT16:
+  case EPlyType::UINT16: return 2;
+  case EPlyType::INT32:
+  case EPlyType::UINT32:
+  case EPlyType::FLOAT32: return 4;
+  case EPlyType::FLOAT64: return 8;
+  }
+  return 0;
+}
+
+template <typename T>
+T LoadBinaryValue(const char* inData, const bool inIsBigEndian)
+{
+  std::array<char, sizeof(T)> bytes;
+  std::memcpy(bytes.data(), inData, sizeof(T));
+  if (inIsBigEndian)
+    std::reverse(bytes.begin(), bytes.end());
+  return std::bit_cast<T>(bytes);
+}
+
+double LoadPlyBinaryValue(const char* inData, const EPlyType inType, const bool inIsBigEndian)
+{
+  switch (inType)
+  {
+  case EPlyType::INT8: return LoadBinaryValue<int8_t>(inData, inIsBigEndian);
+  case EPlyType::UINT8: return LoadBinaryValue<uint8_t>(inData, inIsBigEndian);
+  case EPlyType::INT16: return LoadBinaryValue<int16_t>(inData, inIsBigEndian);
+  case EPlyType::UINT16: return LoadBinaryValue<uint16_t>(inData, inIsBigEndian);
+  case EPlyType::INT32: return LoadBinaryValue<int32_t>(inData, inIsBigEndian);
+  case EPlyType::UINT32: return LoadBinaryValue<uint32_t>(inData, inIsBigEndian);
+  case EPlyType::FLOAT32: return LoadBinaryValue<float>(inData, inIsBigEndian);
+  case EPlyType::FLOAT64: return LoadBinaryValue<double>(inData, inIsBigEndian);
+  }
+  return 0.0;
+}
+
+PlyHeader ParsePlyHeader(const char* inBegin, const char* inEnd)
+{
+  PlyHeader header;
+  bool is_first_line = true;
+  for (const char* line_begin = inBegin; line_begin < inEnd;)
+  {
+    const auto* line_end = GetLineEnd(line_begin, inEnd);
+    std::vector<std::string_view> tokens;
+    for (auto* cursor = SkipSpaces(line_begin, line_end); cursor < line_end;)
+    {
+      const auto* token_end = SkipToken(cursor, line_end);
+      tokens.emplace_back(cursor, static_cast<std::size_t>(token_end - cursor));
+      cursor = SkipSpaces(token_end, line_end);
+    }
+    const auto line = std::string_view(line_begin, static_cast<std::size_t>(line_end - line_begin));
+    line_begin = (line_end < inEnd ? line_end + 1 : inEnd);
+
+    if (is_first_line)
+    {
+      if (tokens.size() != 1 || tokens[0] != "ply")
+        THROW_EXCEPTION("Invalid PLY file: it does not begin with 'ply'");
+      is_first_line = false;
+    }
+    else if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info")
+    {
+      continue;
+    }
+    else if (tokens[0] == "format" && tokens.size() == 3)
+    {
+      if (tokens[1] == "ascii")
+        header.mFormat = EPlyFormat::ASCII;
+      else if (tokens[1] == "binary_little_endian")
+        header.mFormat = EPlyFormat::BINARY_LITTLE_ENDIAN;
+      else if (tokens[1] == "binary_big_endian")
+        header.mFormat = EPlyFormat::BINARY_BIG_ENDIAN;
+      else
+        THROW_EXCEPTION("Invalid PLY format '" << tokens[1] << "'");
+    }
+    else if (tokens[0] == "element" && tokens.size() == 3)
+    {
+      PlyElement element;
+      element.mName = tokens[1];
+      const auto* count_cursor = tokens[2].data();
+      if (!ParseNumber(count_cursor, tokens[2].data() + tokens[2].size(), element.mCount))
+        THROW_EXCEPTION("Invalid PLY header line '" << line << "'");
+      header.mElements.push_back(std::move(element));
+    }
+    else if (tokens[0] == "property" && !header.mElements.empty())
+    {
+      PlyProperty property;
+      std::optional<EPlyType> type;
+      if (tokens.size() == 5 && tokens[1] == "list")
+      {
+        const auto list_count_type = GetPlyType(tokens[2]);
+        type = GetPlyType(tokens[3]);
+        property.mIsList = true;
+        property.mListCountType = list_count_type.value_or(EPlyType::UINT8);
+        if (!list_count_type || list_count_type == EPlyType::FLOAT32 || list_count_type == EPlyType::FLOAT64)
+          type.reset();
+      }
+      else if (tokens.size() == 3)
+      {
+        type = GetPlyType(tokens[1]);
+      }
+
+      if (!type)
+        THROW_EXCEPTION("Invalid PLY header line '" << line << "'");
+      property.mType = *type;
+      property.mName = tokens.back();
+      header.mElements.back().mProperties.push_back(std::move(property));
+    }
+    else if (tokens[0] == "end_header")
+    {
+      header.mBodyBegin = line_begin;
+      return header;
+    }
+    else
+    {
+      THROW_EXCEPTION("Invalid PLY header line '" << line << "'");
+    }
+  }
+
+  THROW_EXCEPTION("Invalid PLY file: 'end_header' not found");
+}
+
+PlyVertexAttributesPropertiesIds GetPlyVertexAttributesPropertiesIds(const PlyElement& inVertexElement)
+{
+  constexpr std::array<std::pair<std::string_view, EPlyVertexAttribute>, 12> attributes_names = { {
+      { "x", EPlyVertexAttribute::X },
+      { "y", EPlyVertexAttribute::Y },
+      { "z", EPlyVertexAttribute::Z },
+      { "nx", EPlyVertexAttribute::NX },
+      { "ny", EPlyVertexAttribute::NY },
+      { "nz", EPlyVertexAttribute::NZ },
+      { "u", EPlyVertexAttribute::U },
+      { "v", EPlyVertexAttribute::V },
+      { "s", EPlyVertexAttribute::U },
+      { "t", EPlyVertexAttribute::V },
+      { "texture_u", EPlyVertexAttribute::U },
+      { "texture_v", EPlyVertexAttribute::V },
+  } };
+
+  PlyVertexAttributesPropertiesIds attributes_properties_ids;
+  for (std::size_t property_id = 0; property_id < inVertexElement.mProperties.size(); ++property_id)
+  {
+    for (const auto& [attribute_name, attribute] : attributes_names)
+    {
+      if (inVertexElement.mProperties[property_id].mName == attribute_name)
+        attributes_properties_ids[static_cast<std::size_t>(attribute)] = property_id;
+    }
+  }
+
+  const auto has_attribute = [&](const EPlyVertexAttribute inAttribute)
+  { return attributes_properties_ids[static_cast<std::size_t>(inAttribute)].has_value(); };
+  if (!has_attribute(EPlyVertexAttribute::X) || !has_attribute(EPlyVertexAttribute::Y)
+      || !has_attribute(EPlyVertexAttribute::Z))
+    THROW_EXCEPTION("Invalid PLY file: the vertices have no x, y, z properties");
+  return attributes_properties_ids;
+}
+
+std::optional<std::size_t> GetPlyFaceIndicesPropertyId(const PlyElement& inFaceElement)
+{
+  for (std::size_t property_id = 0; property_id < inFaceElement.mProperties.size(); ++property_id)
+  {
+    const auto& property = inFaceElement.mProperties[property_id];
+    if (property.mIsList && (property.mName == "vertex_indices" || property.mName == "vertex_index"))
+      return property_id;
+  }
+  return std::nullopt;
+}
+
+// Vertices attributes as read, before setting the corner ones
+struct PlyVertices
+{
+  std::vector<Vec3f> mPositions;
+  std::vector<Vec3f> mNormals;            // Empty if none
+  std::vector<Vec2f> mTextureCoordinates; // Empty if none
+};
+
+void ResizePlyVertices(PlyVertices& ioVertices,
+    const PlyVertexAttributesPropertiesIds& inAttributesPropertiesIds,
+    const std::size_t inNumberOfVertices)
+{
+  ioVertices.mPositions.resize(inNumberOfVertices);
+  if (inAttributesPropertiesIds[static_cast<std::size_t>(EPlyVertexAttribute::NX)])
+    ioVertices.mNormals.resize(inNumberOfVertices, Zero<Vec3f>());
+  if (inAttributesPropertiesIds[static_cast<std::size_t>(EPlyVertexAttribute::U)])
+    ioVertices.mTextureCoordinates.resize(inNumberOfVertices, Zero<Vec2f>());
+}
+
+void SetPlyVertexAttribute(PlyVertices& ioVertices,
+    const std::size_t inVertexId,
+    const EPlyVertexAttribute inAttribute,
+    const float inValue)
+{
+  switch (inAttribute)
+  {
+  case EPlyVertexAttribute::X:
+  case EPlyVertexAttribute::Y:
+  case EPlyVertexAttribute::Z:
+    ioVertices.mPositions[inVertexId][static_cast<std::size_t>(inAttribute)] = inValue;
+    break;
+  case EPlyVertexAttribute::NX:
+  case EPlyVertexAttribute::NY:
+  case EPlyVertexAttribute::NZ:
+    if (!ioVertices.mNormals.empty())
+      ioVertices.mNormals[inVertexId][static_cast<std::size_t>(inAttribute) - 3] = inValue;
+    break;
+  case EPlyVertexAttribute::U:
+  case EPlyVertexAttribute::V:
+    if (!ioVertices.mTextureCoordinates.empty())
+      ioVertices.mTextureCoordinates[inVertexId][static_cast<std::size_t>(inAttribute) - 6] = inValue;
+    break;
+  }
+}
+
+// Attribute read from each vertex property, if any
+std::vector<std::optional<EPlyVertexAttribute>> GetPlyPropertiesVertexAttributes(const PlyElement& inVertexElement,
+    const PlyVertexAttributesPropertiesIds& inAttributesPropertiesIds)
+{
+  std::vector<std::optional<EPlyVertexAttribute>> properties_attributes(inVertexElement.mProperties.size());
+  for (std::size_t attribute_id = 0; attribute_id < PlyNumberOfVertexAttributes; ++attribute_id)
+  {
+    if (const auto property_id = inAttributesPropertiesIds[attribute_id])
+      properties_attributes[*property_id] = static_cast<EPlyVertexAttribute>(attribute_id);
+  }
+  return properties_attributes;
+}
+
+void PushPlyFaceFan(const std::vector<int64_t>& inPolygonVerticesIds,
+    std::vector<Mesh::FaceVerticesIds>& ioFacesVerticesIds)
+{
+  if (inPolygonVerticesIds.size() < 3)
+    THROW_EXCEPTION("Invalid PLY face with " << inPolygonVerticesIds.size() << " vertices");
+  for (const auto vertex_id : inPolygonVerticesIds)
+  {
+    if (vertex_id < 0 || vertex_id >= static_cast<int64_t>(Mesh::InvalidId))
+      THROW_EXCEPTION("Invalid PLY vertex index " << vertex_id);
+  }
+  for (std::size_t i = 1; i + 1 < inPolygonVerticesIds.size(); ++i)
+  {
+    ioFacesVerticesIds.push_back({ static_cast<Mesh::VertexId>(inPolygonVerticesIds[0]),
+        static_cast<Mesh::VertexId>(inPolygonVerticesIds[i]),
+        static_cast<Mesh::VertexId>(inPolygonVerticesIds[i + 1]) });
+  }
+}
+
+// Every element instance in a line: elements are found by their line number, counted in parallel first
+void ParsePlyAsciiBody(const PlyHeader& inHeader,
+    const char* inEnd,
+    PlyVertices& outVertices,
+    std::vector<Mesh::FaceVerticesIds>& outFacesVerticesIds)
+{
+  const auto chunks_begins = SplitIntoLinesChunks(inHeader.mBodyBegin, inEnd);
+  const auto number_of_chunks = chunks_begins.size() - 1;
+  std::vector<std::size_t> chunks_numbers_of_lines(number_of_chunks);
+  ParallelForEachChunk(number_of_chunks,
+      [&](const std::size_t inChunkId)
+      {
+        chunks_numbers_of_lines[inChunkId]
+            = static_cast<std::size_t>(std::count(chunks_begins[inChunkId], chunks_begins[inChunkId + 1], '\n'));
+      });
+  std::vector<std::size_t> chunks_first_lines(number_of_chunks, 0);
+  std::exclusive_scan(chunks_numbers_of_lines.cbegin(),
+      chunks_numbers_of_lines.cend(),
+      chunks_first_lines.begin(),
+      std::size_t(0));
+
+  // Lines of each element: [elements_first_lines[e], elements_first_lines[e + 1])
+  std::vector<std::size_t> elements_first_lines(inHeader.mElements.size() + 1, 0);
+  for (std::size_t element_id = 0; element_id < inHeader.mElements.size(); ++element_id)
+    elements_first_lines[element_id + 1] = elements_first_lines[element_id] + inHeader.mElements[element_id].mCount;
+
+  const auto get_element_id = [&](const std::string_view inName) -> std::optional<std::size_t>
+  {
+    for (std::size_t element_id = 0; element_id < inHeader.mElements.size(); ++element_id)
+    {
+      if (inHeader.mElements[element_id].mName == inName)
+        return element_id;
+    }
+    return std::nullopt;
+  };
+  const auto vertex_element_id = *get_element_id("vertex");
+  const auto face_element_id = get_element_id("face");
+  const auto& vertex_element = inHeader.mElements[vertex_element_id];
+  const auto vertex_attributes_properties_ids = GetPlyVertexAttributesPropertiesIds(vertex_element);
+  const auto properties_vertex_attributes
+      = GetPlyPropertiesVertexAttributes(vertex_element, vertex_attributes_properties_ids);
+  const auto face_indices_property_id
+      = (face_element_id ? GetPlyFaceIndicesPropertyId(inHeader.mElements[*face_element_id]) : std::nullopt);
+  ResizePlyVertices(outVertices, vertex_attributes_properties_ids, vertex_element.mCount);
+
+  std::vector<std::vector<Mesh::FaceVerticesIds>> chunks_faces_vertices_ids(number_of_chunks);
+  ParallelForEachChunk(number_of_chunks,
+      [&](const std::size_t inChunkId)
+      {
+        auto& chunk_faces_vertices_ids = chunks_faces_vertices_ids[inChunkId];
+        std::vector<int64_t> polygon_vertices_ids;
+        auto line_id = chunks_first_lines[inChunkId];
+        const auto* chunk_end = chunks_begins[inChunkId + 1];
+        for (const char* line_begin = chunks_begins[inChunkId]; line_begin < chunk_end; ++line_id)
+        {
+          const auto* line_end = GetLineEnd(line_begin, chunk_end);
+          const auto* cursor = line_begin;
+          line_begin = line_end + 1;
+
+          if (line_id >= elements_first_lines[vertex_element_id]
+              && line_id < elements_first_lines[vertex_element_id + 1])
+          {
+            const auto vertex_id = line_id - elements_first_lines[vertex_element_id];
+            for (const auto& property_vertex_attribute : properties_vertex_attributes)
+            {
+              float value = 0.0f;
+              if (!ParseNumber(cursor, line_end, value))
+                THROW_EXCEPTION("Invalid PLY vertex line " << line_id);
+              if (property_vertex_attribute)
+                SetPlyVertexAttribute(outVertices, vertex_id, *property_vertex_attribute, value);
+            }
+          }
+          else if (face_indices_property_id && line_id >= elements_first_lines[*face_element_id]
+              && line_id < elements_first_lines[*face_element_id + 1])
+          {
+            const auto& face_properties = inHeader.mElements[*face_element_id].mProperties;
+            for (std::size_t property_id = 0; property_id < face_properties.size(); ++property_id)
+            {
+              if (!face_properties[property_id].mIsList)
+              {
+                cursor = SkipToken(cursor, line_end);
+                continue;
+              }
+
+              std::size_t list_count = 0;
+              if (!ParseNumber(cursor, line_end, list_count))
+                THROW_EXCEPTION("Invalid PLY face line " << line_id);
+              if (property_id != *face_indices_property_id)
+              {
+                for (std::size_t i = 0; i < list_count; ++i) cursor = SkipToken(cursor, line_end);
+                continue;
+              }
+
+              polygon_vertices_ids.resize(list_count);
+              for (auto& polygon_vertex_id : polygon_vertices_ids)
+              {
+                if (!ParseNumber(cursor, line_end, polygon_vertex_id))
+                  THROW_EXCEPTION("Invalid PLY face line " << line_id);
+              }
+              PushPlyFaceFan(polygon_vertices_ids, chunk_faces_vertices_ids);
+            }
+          }
+        }
+      });
+
+  const auto faces_chunks_offsets = GetChunksOffsets(chunks_faces_vertices_ids,
+      [](const std::vector<Mesh::FaceVerticesIds>& inChunkFaces) { return inChunkFaces.size(); });
+  outFacesVerticesIds.resize(faces_chunks_offsets.back());
+  ParallelForEachChunk(number_of_chunks,
+      [&](const std::size_t inChunkId)
+      {
+        std::copy(chunks_faces_vertices_ids[inChunkId].cbegin(),
+            chunks_faces_vertices_ids[inChunkId].cend(),
+            outFacesVerticesIds.begin() + faces_chunks_offsets[inChunkId]);
+      });
+}
+
+// Size in bytes of an element instance without lists
+std::optional<std::size_t> GetPlyFixedElementSize(const PlyElement& inElement)
+{
+  std::size_t element_size = 0;
+  for (const auto& property : inElement.mProperties)
+  {
+    if (property.mIsList)
+      return std::nullopt;
+    element_size += GetPlyTypeSize(property.mType);
+  }
+  return element_size;
+}
+
+// Reads the faces (triangulated from the inIndicesPropertyId lists) of a binary PLY element, returning its end. In
+// parallel if all of them are triangles. Without inIndicesPropertyId, just skips the element.
+const char* ParsePlyBinaryFaces(const PlyElement& inFaceElement,
+    const std::optional<std::size_t>& inIndicesPropertyId,
+    const char* inBegin,
+    const char* inEnd,
+    const bool inIsBigEndian,
+    std::vector<Mesh::FaceVerticesIds>& outFacesVerticesIds)
+{
+  const auto& indices_property_id = inIndicesPropertyId;
+  const auto throw_truncated = []() { THROW_EXCEPTION("Invalid PLY file: truncated face element"); };
+
+  // Triangles only, with no other lists: fixed size faces
+  std::size_t triangle_size = 0;
+  std::size_t triangle_indices_offset = 0;
+  bool has_other_lists = false;
+  for (std::size_t property_id = 0; property_id < inFaceElement.mProperties.size(); ++property_id)
+  {
+    const auto& property = inFaceElement.mProperties[property_id];
+    if (property_id == indices_property_id)
+    {
+      triangle_indices_offset = triangle_size;
+      triangle_size += GetPlyTypeSize(property.mListCountType) + 3 * GetPlyTypeSize(property.mType);
+    }
+    else
+    {
+      has_other_lists = has_other_lists || property.mIsList;
+      triangle_size += GetPlyTypeSize(property.mType);
+    }
+  }
+
+  if (indices_property_id && !has_other_lists
+      && inFaceElement.mCount <= static_cast<std::size_t>(inEnd - inBegin) / triangle_size)
+  {
+    const auto& indices_property = inFaceElement.mProperties[*indices_property_id];
+    const auto count_size = GetPlyTypeSize(indices_property.mListCountType);
+    const auto index_size = GetPlyTypeSize(indices_property.mType);
+    outFacesVerticesIds.resize(inFaceElement.mCount);
+    std::atomic<bool> all_triangles = true;
+
+    // Past a polygon the fixed stride reads misaligned faces, whose bytes can still look like triangles with invalid
+    // indices: those are only reported once all the faces are known to be triangles
+    std::atomic<bool> has_invalid_vertex_id = false;
+    std::atomic<double> invalid_vertex_id = 0.0;
+    ParallelFor(inFaceElement.mCount,
+        [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+        {
+          for (auto face_id = inBeginFaceId; face_id < inEndFaceId && all_triangles; ++face_id)
+          {
+            const auto* face_data = inBegin + face_id * triangle_size + triangle_indices_offset;
+            if (LoadPlyBinaryValue(face_data, indices_property.mListCountType, inIsBigEndian) != 3.0)
+            {
+              all_triangles = false;
+              break;
+            }
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+              const auto vertex_id
+                  = LoadPlyBinaryValue(face_data + count_size + i * index_size, indices_property.mType, inIsBigEndian);
+              if (vertex_id < 0.0 || vertex_id >= static_cast<double>(Mesh::InvalidId))
+              {
+                invalid_vertex_id = vertex_id;
+                has_invalid_vertex_id = true;
+                outFacesVerticesIds[face_id][i] = Mesh::InvalidId;
+                continue;
+              }
+              outFacesVerticesIds[face_id][i] = static_cast<Mesh::VertexId>(vertex_id);
+            }
+          }
+        });
+    if (all_triangles)
+    {
+      if (has_invalid_vertex_id)
+        THROW_EXCEPTION("Invalid PLY vertex index " << invalid_vertex_id.load());
+      return inBegin + inFaceElement.mCount * triangle_size;
+    }
+    outFacesVerticesIds.clear();
+  }
+
+  // Polygons, one after the other
+  const auto* cursor = inBegin;
+  std::vector<int64_t> polygon_vertices_ids;
+  for (std::size_t face_id = 0; face_id < inFaceElement.mCount; ++face_id)
+  {
+    for (std::size_t property_id = 0; property_id < inFaceElement.mProperties.size(); ++property_id)
+    {
+      const auto& property = inFaceElement.mProperties[property_id];
+      const auto item_size = GetPlyTypeSize(property.mType);
+      if (!property.mIsList)
+      {
+        cursor += item_size;
+        continue;
+      }
+
+      const auto count_size = GetPlyTypeSize(property.mListCountType);
+      if (cursor + count_size > inEnd)
+        throw_truncated();
+      const auto list_count
+          = static_cast<std::size_t>(LoadPlyBinaryValue(cursor, property.mListCountType, inIsBigEndian));
+      cursor += count_size;
+      if (list_count > static_cast<std::size_t>(inEnd - cursor) / std::max(item_size, std::size_t(1)))
+        throw_truncated();
+      if (property_id == indices_property_id)
+      {
+        polygon_vertices_ids.resize(list_count);
+        for (std::size_t i = 0; i < list_count; ++i)
+        {
+          const auto vertex_id = LoadPlyBinaryValue(cursor + i * item_size, property.mType, inIsBigEndian);
+          polygon_vertices_ids[i] = static_cast<int64_t>(vertex_id);
+        }
+        PushPlyFaceFan(polygon_vertices_ids, outFacesVerticesIds);
+      }
+      cursor += list_count * item_size;
+    }
+    if (cursor > inEnd)
+      throw_truncated();
+  }
+  return cursor;
+}
+
+// Elements one after the other. Returns false if not supported natively (vertices with lists).
+bool ParsePlyBinaryBody(const PlyHeader& inHeader,
+    const char* inEnd,
+    PlyVertices& outVertices,
+    std::vector<Mesh::FaceVerticesIds>& outFacesVerticesIds)
+{
+  const auto is_big_endian = (inHeader.mFormat == EPlyFormat::BINARY_BIG_ENDIAN);
+  const auto* cursor = inHeader.mBodyBegin;
+  for (const auto& element : inHeader.mElements)
+  {
+    const auto fixed_element_size = GetPlyFixedElementSize(element);
+    if (element.mName == "vertex")
+    {
+      if (!fixed_element_size)
+        return false;
+      if (element.mCount > static_cast<std::size_t>(inEnd - cursor) / std::max(*fixed_element_size, std::size_t(1)))
+        THROW_EXCEPTION("Invalid PLY file: truncated vertex element");
+
+      const auto attributes_properties_ids = GetPlyVertexAttributesPropertiesIds(element);
+      const auto properties_attributes = GetPlyPropertiesVertexAttributes(element, attributes_properties_ids);
+      std::vector<std::size_t> properties_offsets(element.mProperties.size(), 0);
+      for (std::size_t property_id = 1; property_id < element.mProperties.size(); ++property_id)
+        properties_offsets[property_id]
+            = properties_offsets[property_id - 1] + GetPlyTypeSize(element.mProperties[property_id - 1].mType);
+
+      ResizePlyVertices(outVertices, attributes_properties_ids, element.mCount);
+      ParallelFor(element.mCount,
+          [&](const std::size_t, const std::size_t inBeginVertexId, const std::size_t inEndVertexId)
+          {
+            for (auto vertex_id = inBeginVertexId; vertex_id < inEndVertexId; ++vertex_id)
+            {
+              const auto* vertex_data = cursor + vertex_id * (*fixed_element_size);
+              for (std::size_t property_id = 0; property_id < element.mProperties.size(); ++property_id)
+              {
+                if (!properties_attributes[property_id])
+                  continue;
+                const auto value = LoadPlyBinaryValue(vertex_data + properties_offsets[property_id],
+                    element.mProperties[property_id].mType,
+                    is_big_endian);
+                SetPlyVertexAttribute(outVertices,
+                    vertex_id,
+                    *properties_attributes[property_id],
+                    static_cast<float>(value));
+              }
+            }
+          });
+      cursor += element.mCount * (*fixed_element_size);
+    }
+    else if (element.mName == "face")
+    {
+      const auto indices_property_id = GetPlyFaceIndicesPropertyId(element);
+      cursor = ParsePlyBinaryFaces(element, indices_property_id, cursor, inEnd, is_big_endian, outFacesVerticesIds);
+    }
+    else if (fixed_element_size)
+    {
+      cursor += element.mCount * (*fixed_element_size);
+    }
+    else
+    {
+      cursor = ParsePlyBinaryFaces(element, std::nullopt, cursor, inEnd, is_big_endian, outFacesVerticesIds);
+    }
+
+    if (cursor > inEnd)
+      THROW_EXCEPTION("Invalid PLY file: truncated '" << element.mName << "' element");
+  }
+  return true;
+}
+
+std::optional<ParsedMesh> ParsePly(const char* inBegin, const char* inEnd)
+{
+  const auto header = ParsePlyHeader(inBegin, inEnd);
+  const auto has_vertex_element = std::any_of(header.mElements.cbegin(),
+      header.mElements.cend(),
+      [](const PlyElement& inElement) { return inElement.mName == "vertex"; });
+  if (!has_vertex_element)
+    THROW_EXCEPTION("Invalid PLY file: no vertex element");
+
+  PlyVertices vertices;
+  ParsedMesh parsed_mesh;
+  if (header.mFormat == EPlyFormat::ASCII)
+  {
+    const auto& vertex_element = *std::find_if(header.mElements.cbegin(),
+        header.mElements.cend(),
+        [](const PlyElement& inElement) { return inElement.mName == "vertex"; });
+    if (!GetPlyFixedElementSize(vertex_element))
+      return std::nullopt;
+    ParsePlyAsciiBody(header, inEnd, vertices, parsed_mesh.mFacesVerticesIds);
+  }
+  else if (!ParsePlyBinaryBody(header, inEnd, vertices, parsed_mesh.mFacesVerticesIds))
+  {
+    return std::nullopt;
+  }
+
+  CheckFacesVerticesIds(parsed_mesh.mFacesVerticesIds, vertices.mPositions.size());
+  if (!vertices.mNormals.empty())
+  {
+    for (auto& normal : vertices.mNormals) normal = NormalizedSafe(normal);
+    parsed_mesh.mCornersNormals = GetCornersAttributesFromVertices(parsed_mesh.mFacesVerticesIds, vertices.mNormals);
+  }
+  if (!vertices.mTextureCoordinates.empty())
+  {
+    parsed_mesh.mCornersTextureCoordinates
+        = GetCornersAttributesFromVertices(parsed_mesh.mFacesVerticesIds, vertices.mTextureCoordinates);
+  }
+  parsed_mesh.mVerticesPositions = std::move(vertices.mPositions);
+  return parsed_mesh;
+}
+
+// STL =========================================================================================================
+
+constexpr std::size_t StlHeaderSize = 84; // 80 bytes of comment and the number of triangles
+constexpr std::size_t StlTriangleSize = 50; // Normal, 3 positions and 2 bytes of attributes
+
+// Binary STL only. Returns nullopt for ASCII STL.
+std::optional<ParsedMesh> ParseStl(const char* inBegin, const char* inEnd)
+{
+  const auto file_size = static_cast<std::size_t>(inEnd - inBegin);
+  const auto number_of_triangles
+      = (file_size >= StlHeaderSize ? LoadBinaryValue<uint32_t>(inBegin + 80, false) : std::size_t(0));
+  if (file_size < StlHeaderSize || number_of_triangles > (file_size - StlHeaderSize) / StlTriangleSize)
+  {
+    if (file_size >= 5 && std::string_view(inBegin, 5) == "solid")
+      return std::nullopt;
+    THROW_EXCEPTION("Invalid binary STL file: truncated");
+  }
+
+  // Every triangle has its own corners...
+  const auto number_of_corners = number_of_triangles * 3;
+  std::vector<Vec3f> corners_positions(number_of_corners);
+  ParsedMesh parsed_mesh;
+  parsed_mesh.mFacesNormals.resize(number_of_triangles);
+  ParallelFor(number_of_triangles,
+      [&](const std::size_t, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          const auto* triangle_data = inBegin + StlHeaderSize + face_id * StlTriangleSize;
+          std::array<Vec3f, 4> vectors; // Normal and positions
+          for (std::size_t i = 0; i < 4; ++i)
+          {
+            for (std::size_t j = 0; j < 3; ++j)
+              vectors[i][j] = LoadBinaryValue<float>(triangle_data + (i * 3 + j) * sizeof(float), false);
+          }
+          for (std::size_t i = 0; i < 3; ++i) corners_positions[face_id * 3 + i] = vectors[i + 1];
+
+          // Many writers leave the normal zero
+          auto face_normal = NormalizedSafe(vectors[0]);
+          if (face_normal == Zero<Vec3f>())
+            face_normal = NormalizedSafe(Cross(vectors[2] - vectors[1], vectors[3] - vectors[1]));
+          parsed_mesh.mFacesNormals[face_id] = face_normal;
+        }
+      });
+
+  // ...welded by equal positions (bitwise), in an open addressing hash table of the vertices. The vertices are
+  // numbered in the order they first appear.
+  const auto get_position_bits
+      = [](const Vec3f& inPosition) { return std::bit_cast<std::array<uint32_t, 3>>(inPosition); };
+  const auto table_size = std::bit_ceil(std::max(number_of_corners * 2, std::size_t(16)));
+  const auto table_shift = 64 - std::countr_zero(table_size);
+  std::vector<Mesh::VertexId> table_vertices_ids(table_size, Mesh::InvalidId);
+  std::vector<Mesh::VertexId> corners_vertices_ids(number_of_corners);
+  for (std::size_t corner_id = 0; corner_id < number_of_corners; ++corner_id)
+  {
+    const auto& position = corners_positions[corner_id];
+    const auto position_bits = get_position_bits(position);
+    const auto hash = ((static_cast<uint64_t>(position_bits[0]) << 32) | position_bits[1]) * 0x9E3779B97F4A7C15ull
+        + position_bits[2] * 0xC2B2AE3D27D4EB4Full;
+    auto slot = static_cast<std::size_t>((hash * 0x9E3779B97F4A7C15ull) >> table_shift);
+    while (table_vertices_ids[slot] != Mesh::InvalidId
+        && get_position_bits(parsed_mesh.mVerticesPositions[table_vertices_ids[slot]]) != position_bits)
+      slot = (slot + 1) & (table_size - 1);
+
+    if (table_vertices_ids[slot] == Mesh::InvalidId)
+    {
+      table_vertices_ids[slot] = static_cast<Mesh::VertexId>(parsed_mesh.mVerticesPositions.size());
+      parsed_mesh.mVerticesPositions.push_back(position);
+    }
+    corners_vertices_ids[corner_id] = table_vertices_ids[slot];
+  }
+
+  parsed_mesh.mFacesVerticesIds.resize(number_of_triangles);
+  parsed_mesh.mCornersNormals.resize(number_of_corners);
+  for (std::size_t face_id = 0; face_id < number_of_triangles; ++face_id)
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      parsed_mesh.mFacesVerticesIds[face_id][i] = corners_vertices_ids[face_id * 3 + i];
+      parsed_mesh.mCornersNormals[face_id * 3 + i] = parsed_mesh.mFacesNormals[face_id];
+    }
+  }
+  return parsed_mesh;
+}
+}
+
+bool MeshNativeIO::IsSupported(const std::filesystem::path& inMeshPath)
+{
+  const auto extension = GetLowerCaseExtension(inMeshPath);
+  return (extension == ".obj" || extension == ".ply" || extension == ".stl");
+}
+
+bool MeshNativeIO::Read(const std::filesystem::path& inMeshPath, Mesh& ioMesh)
+{
+  if (!MeshNativeIO::IsSupported(inMeshPath))
+    return false;
+
+  const auto mapped_file = MappedFile(inMeshPath);
+  const auto* begin = reinterpret_cast<const char*>(mapped_file.GetData());
+  const auto* end = begin + mapped_file.GetSize();
+
+  std::optional<ParsedMesh> parsed_mesh;
+  try
+  {
+    const auto extension = GetLowerCaseExtension(inMeshPath);
+    if (extension == ".obj")
+      parsed_mesh = ParseObj(begin, end);
+    else if (extension == ".ply")
+      parsed_mesh = ParsePly(begin, end);
+    else
+      parsed_mesh = ParseStl(begin, end);
+  }
+  catch (const std::exception& inException)
+  {
+    THROW_EXCEPTION("Error loading mesh from " << inMeshPath << ": " << inException.what());
+  }
+
+  if (!parsed_mesh)
+    return false;
+
+  ioMesh.SetStreams(std::move(parsed_mesh->mVerticesPositions),
+      std::move(parsed_mesh->mFacesVerticesIds),
+      std::move(parsed_mesh->mFacesNormals),
+      std::move(parsed_mesh->mCornersNormals),
+      std::move(parsed_mesh->mCornersTextureCoordinates));
+  return true;
+}
+}
@@ -0,0 +1,953 @@
+#include <ez/MeshSimplifier.h>
+#include <ez/MathInitializers.h>
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+namespace ez
+{
+namespace
+{
+enum class EVertexKind : uint8_t
+{
+  MANIFOLD, // Interior vertex with a single wedge: collapses onto any neighbor
+  BORDER,   // On a single boundary: collapses along it, onto border or locked vertices
+  SEAM,     // On a single attribute seam (two wedges): collapses along it, onto seam or locked vertices
+  LOCKED    // Anything else (boundary or seam ends, non-manifold, ...): never collapses
+};
+
+// Faces are assigned to regions, and vertices to the region of all their faces (or to none, if they are shared)
+constexpr uint32_t SharedRegionId = static_cast<uint32_t>(-1);
+constexpr uint32_t AllRegionsId = static_cast<uint32_t>(-2);
+constexpr std::size_t MinNumberOfFacesPerRegion = 16384;
+constexpr std::size_t GlobalPassFacesFraction = 8; // Of the faces to remove, left to the global pass
+
+// Faces whose normal rotates more than this (cosine) in a collapse are considered flipped
+constexpr float MinFaceNormalCosine = 0.25f;
+
+// Symmetric 4x4 quadric of a set of weighted planes, evaluated as sum(weight * (normal . point + d)^2)
+struct Quadric
+{
+  double mA00 = 0.0, mA01 = 0.0, mA02 = 0.0, mA11 = 0.0, mA12 = 0.0, mA22 = 0.0;
+  double mB0 = 0.0, mB1 = 0.0, mB2 = 0.0;
+  double mC = 0.0;
+  double mWeight = 0.0;
+
+  static Quadric FromPlane(const Vec3f& inUnitNormal, const Vec3f& inPoint, const double inWeight)
+  {
+    const double a = inUnitNormal[0], b = inUnitNormal[1], c = inUnitNormal[2];
+    const double d = -(a * inPoint[0] + b * inPoint[1] + c * inPoint[2]);
+
+    Quadric quadric;
+    quadric.mA00 = inWeight * a * a;
+    quadric.mA01 = inWeight * a * b;
+    quadric.mA02 = inWeight * a * c;
+    quadric.mA11 = inWeight * b * b;
+    quadric.mA12 = inWeight * b * c;
+    quadric.mA22 = inWeight * c * c;
+    quadric.mB0 = inWeight * a * d;
+    quadric.mB1 = inWeight * b * d;
+    quadric.mB2 = inWeight * c * d;
+    quadric.mC = inWeight * d * d;
+    quadric.mWeight = inWeight;
+    return quadric;
+  }
+
+  Quadric& operator+=(const Quadric& inRHS)
+  {
+    mA00 += inRHS.mA00;
+    mA01 += inRHS.mA01;
+    mA02 += inRHS.mA02;
+    mA11 += inRHS.mA11;
+    mA12 += inRHS.mA12;
+    mA22 += inRHS.mA22;
+    mB0 += inRHS.mB0;
+    mB1 += inRHS.mB1;
+    mB2 += inRHS.mB2;
+    mC += inRHS.mC;
+    mWeight += inRHS.mWeight;
+    return *this;
+  }
+
+  // Weighted sum of the squared distances from inPoint to the planes
+  double Evaluate(const Vec3f& inPoint) const
+  {
+    const double x = inPoint[0], y = inPoint[1], z = inPoint[2];
+    const auto error = (mA00 * x * x + mA11 * y * y + mA22 * z * z)
+        + 2.0 * (mA01 * x * y + mA02 * x * z + mA12 * y * z + mB0 * x + mB1 * y + mB2 * z) + mC;
+    return std::max(error, 0.0);
+  }
+};
+
+// Plane through the edge (inPoint0, inPoint1), perpendicular to its face, that keeps the edge from moving sideways
+Quadric EdgeQuadric(const Vec3f& inPoint0, const Vec3f& inPoint1, const Vec3f& inFaceNormal)
+{
+  const auto edge = (inPoint1 - inPoint0);
+  const auto edge_plane_normal = Cross(edge, inFaceNormal);
+  const auto edge_plane_normal_length = Length(edge_plane_normal);
+  if (edge_plane_normal_length <= 0.0f)
+    return Quadric {};
+  return Quadric::FromPlane(edge_plane_normal * (1.0f / edge_plane_normal_length),
+      inPoint0,
+      Dot(edge, edge) * MeshSimplifier::BoundaryQuadricWeight);
+}
+
+// Half edge collapse of vertex mVertexId onto mTargetVertexId, queued by error
+struct Candidate
+{
+  double mError = 0.0;
+  Mesh::VertexId mVertexId = Mesh::InvalidId;
+  Mesh::VertexId mTargetVertexId = Mesh::InvalidId;
+
+  bool operator==(const Candidate& inRHS) const = default;
+  bool operator>(const Candidate& inRHS) const { return mError > inRHS.mError; }
+};
+
+// Min-heap of candidates (std::push_heap / std::pop_heap with std::greater). Updates are lazy: queued candidates stay
+// until popped, and are stale if they are not the current candidate of their vertex anymore.
+using CandidatesHeap = std::vector<Candidate>;
+constexpr std::size_t MinNumberOfCandidatesToCompact = 1024;
+
+// A neighbor of a vertex, and the wedge of the vertex in one of the faces they share
+struct NeighborWedge
+{
+  Mesh::VertexId mNeighborId = Mesh::InvalidId;
+  uint32_t mWedgeId = 0;
+
+  static bool CompareNeighborIds(const NeighborWedge& inLHS, const NeighborWedge& inRHS)
+  {
+    return inLHS.mNeighborId < inRHS.mNeighborId;
+  }
+};
+
+// Per thread buffers, to not allocate per candidate
+struct Scratch
+{
+  std::vector<NeighborWedge> mNeighborsWedges;
+  std::vector<NeighborWedge> mTargetNeighborsWedges;
+  std::vector<std::pair<double, Mesh::VertexId>> mTargets;
+  std::vector<Mesh::VertexId> mUpdatedVerticesIds;
+};
+
+// Faces are stored as wedges (a vertex and the attributes of its corners, shared by all the corners of the vertex with
+// the same attributes), so that collapses keep attributes without interpolating them.
+class EdgeCollapser final
+{
+public:
+  EdgeCollapser(const Mesh& inMesh, const bool inLockBoundaries)
+  {
+    const auto number_of_vertices = inMesh.GetNumberOfVertices();
+    const auto number_of_faces = inMesh.GetNumberOfFaces();
+    const auto* corners_normals = inMesh.GetCornersNormals().GetData();
+    const auto* corners_texture_coordinates = inMesh.GetCornersTextureCoordinates().GetData();
+    mVerticesPositions.assign(inMesh.GetVerticesPositions().GetData(),
+        inMesh.GetVerticesPositions().GetData() + number_of_vertices);
+
+    // Wedges: corners of the same vertex with the same attributes
+    std::vector<uint32_t> corners_wedges_ids(inMesh.GetNumberOfCorners());
+    mVerticesFacesIds.resize(number_of_vertices);
+    for (Mesh::VertexId vertex_id = 0; vertex_id < number_of_vertices; ++vertex_id)
+    {
+      const auto vertex_corners_ids = inMesh.GetVertexCornersIdsSpan(vertex_id);
+      const auto first_vertex_wedge_id = static_cast<uint32_t>(mWedgesVerticesIds.size());
+      mVerticesFacesIds[vertex_id].reserve(vertex_corners_ids.GetNumberOfElements());
+      for (std::size_t i = 0; i < vertex_corners_ids.GetNumberOfElements(); ++i)
+      {
+        const auto corner_id = vertex_corners_ids.GetData()[i];
+        const auto& normal = corners_normals[corner_id];
+        const auto& texture_coordinates = corners_texture_coordinates[corner_id];
+
+        auto wedge_id = first_vertex_wedge_id;
+        while (wedge_id < mWedgesVerticesIds.size()
+            && (mWedgesNormals[wedge_id] != normal || mWedgesTextureCoordinates[wedge_id] != texture_coordinates))
+        {
+          ++wedge_id;
+        }
+        if (wedge_id == mWedgesVerticesIds.size())
+        {
+          mWedgesVerticesIds.push_back(vertex_id);
+          mWedgesNormals.push_back(normal);
+          mWedgesTextureCoordinates.push_back(texture_coordinates);
+        }
+        corners_wedges_ids[corner_id] = wedge_id;
+        mVerticesFacesIds[vertex_id].push_back(corner_id / 3);
+      }
+    }
+
+    mFacesWedgesIds.resize(number_of_faces);
+    for (Mesh::FaceId face_id = 0; face_id < number_of_faces; ++face_id)
+    {
+      for (std::size_t i = 0; i < 3; ++i) { mFacesWedgesIds[face_id][i] = corners_wedges_ids[face_id * 3 + i]; }
+    }
+    mFacesRemoved.assign(number_of_faces, 0);
+    mNumberOfFaces = number_of_faces;
+
+    std::vector<bool> non_manifold_vertices(number_of_vertices, false);
+    for (const auto& non_manifold_edge : inMesh.GetNonManifoldEdges())
+    {
+      non_manifold_vertices[non_manifold_edge[0]] = true;
+      non_manifold_vertices[non_manifold_edge[1]] = true;
+    }
+
+    // Classify the vertices from the corner table, and sum the quadrics of their faces, boundaries and seams
+    mVerticesKinds.resize(number_of_vertices);
+    mVerticesQuadrics.resize(number_of_vertices);
+    ParallelFor(number_of_vertices,
+        [&](const std::size_t, const std::size_t inBegin, const std::size_t inEnd)
+        {
+          for (auto vertex_id = static_cast<Mesh::VertexId>(inBegin); vertex_id < inEnd; ++vertex_id)
+          {
+            const auto vertex_corners_ids = inMesh.GetVertexCornersIdsSpan(vertex_id);
+            const auto number_of_vertex_corners = vertex_corners_ids.GetNumberOfElements();
+            if (number_of_vertex_corners == 0)
+            {
+              mVerticesKinds[vertex_id] = EVertexKind::LOCKED;
+              continue;
+            }
+
+            Quadric vertex_quadric;
+            std::size_t number_of_border_edges = 0;
+            std::size_t number_of_seam_edges = 0;
+            std::size_t number_of_wedges = 0; // Consecutive wedges, the first one at the first corner
+            const auto first_wedge_id = corners_wedges_ids[vertex_corners_ids.GetData()[0]];
+            for (std::size_t i = 0; i < number_of_vertex_corners; ++i)
+            {
+              const auto corner_id = vertex_corners_ids.GetData()[i];
+              const auto next_corner_id = inMesh.GetNextCornerId(corner_id);
+              const auto previous_corner_id = inMesh.GetPreviousCornerId(corner_id);
+              const auto& position = mVerticesPositions[vertex_id];
+              const auto& next_position = mVerticesPositions[inMesh.GetVertexIdFromCornerId(next_corner_id)];
+              const auto& previous_position = mVerticesPositions[inMesh.GetVertexIdFromCornerId(previous_corner_id)];
+
+              const auto face_normal = Cross(next_position - position, previous_position - position);
+              const auto face_normal_length = Length(face_normal);
+              if (face_normal_length > 0.0f)
+              {
+                vertex_quadric += Quadric::FromPlane(face_normal * (1.0f / face_normal_length),
+                    position,
+                    face_normal_length * 0.5f);
+              }
+              const auto unit_face_normal = (face_normal_length > 0.0f ? face_normal * (1.0f / face_normal_length)
+                                                                       : Zero<Vec3f>());
+
+              // Edge (vertex, next), facing the previous corner. Interior edges are counted here only, once.
+              const auto next_edge_opposite_corner_id = inMesh.GetOppositeCornerId(previous_corner_id);
+              if (next_edge_opposite_corner_id == Mesh::InvalidId)
+              {
+                ++number_of_border_edges;
+                vertex_quadric += EdgeQuadric(position, next_position, unit_face_normal);
+              }
+              else if (corners_wedges_ids[corner_id]
+                      != corners_wedges_ids[inMesh.GetPreviousCornerId(next_edge_opposite_corner_id)]
+                  || corners_wedges_ids[next_corner_id]
+                      != corners_wedges_ids[inMesh.GetNextCornerId(next_edge_opposite_corner_id)])
+              {
+                ++number_of_seam_edges;
+                vertex_quadric += EdgeQuadric(position, next_position, unit_face_normal);
+              }
+
+              // Edge (previous, vertex), facing the next corner. Only boundary edges, interior ones are counted above.
+              if (inMesh.GetOppositeCornerId(next_corner_id) == Mesh::InvalidId)
+              {
+                ++number_of_border_edges;
+                vertex_quadric += EdgeQuadric(previous_position, position, unit_face_normal);
+              }
+
+              number_of_wedges = std::max<std::size_t>(number_of_wedges,
+                  corners_wedges_ids[corner_id] - first_wedge_id + 1);
+            }
+            mVerticesQuadrics[vertex_id] = vertex_quadric;
+
+            auto vertex_kind = EVertexKind::LOCKED;
+            if (!non_manifold_vertices[vertex_id] && IsSingleFan(inMesh, vertex_corners_ids))
+            {
+              if (number_of_border_edges == 0 && number_of_seam_edges == 0 && number_of_wedges == 1)
+                vertex_kind = EVertexKind::MANIFOLD;
+              else if (number_of_border_edges == 2 && number_of_seam_edges == 0 && number_of_wedges == 1)
+                vertex_kind = (inLockBoundaries ? EVertexKind::LOCKED : EVertexKind::BORDER);
+              else if (number_of_border_edges == 0 && number_of_seam_edges == 2 && number_of_wedges == 2)
+                vertex_kind = EVertexKind::SEAM;
+            }
+            mVerticesKinds[vertex_id] = vertex_kind;
+          }
+        });
+
+    mVerticesRemoved.assign(number_of_vertices, 0);
+    mVerticesCandidates.assign(number_of_vertices, Candidate {});
+    mVerticesRegionsIds.assign(number_of_vertices, SharedRegionId);
+  }
+
+  std::size_t GetNumberOfFaces() const { return mNumberOfFaces; }
+  std::size_t GetNumberOfCollapses() const { return mNumberOfCollapses; }
+  double GetError() const { return mError; }
+
+  // Splits the faces in slabs along the longest axis, and collapses the vertices inside each slab in parallel. The
+  // slabs advance in rounds under a common, growing, error threshold, so that they stay in order of error overall.
+  // They stop short of the target, and the last collapses are left to the global pass.
+  void CollapseRegions(const std::size_t inNumberOfRegions,
+      const std::size_t inTargetNumberOfFaces,
+      const double inMaxError)
+  {
+    const auto number_of_faces = mFacesWedgesIds.size();
+    if (inNumberOfRegions <= 1 || number_of_faces <= inTargetNumberOfFaces)
+      return;
+
+    // Faces centroids along the longest axis of the bounding box
+    auto min_position = mVerticesPositions.front();
+    auto max_position = min_position;
+    for (const auto& position : mVerticesPositions)
+    {
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        min_position[i] = std::min(min_position[i], position[i]);
+        max_position[i] = std::max(max_position[i], position[i]);
+      }
+    }
+    const auto extent = (max_position - min_position);
+    const auto axis = static_cast<std::size_t>(
+        (extent[0] >= extent[1] && extent[0] >= extent[2]) ? 0 : (extent[1] >= extent[2] ? 1 : 2));
+
+    std::vector<float> faces_centroids(number_of_faces);
+    for (std::size_t face_id = 0; face_id < number_of_faces; ++face_id)
+    {
+      faces_centroids[face_id] = 0.0f;
+      for (const auto wedge_id : mFacesWedgesIds[face_id])
+        faces_centroids[face_id] += mVerticesPositions[mWedgesVerticesIds[wedge_id]][axis];
+    }
+
+    // Slabs with the same number of faces
+    auto sorted_faces_centroids = faces_centroids;
+    std::vector<float> regions_ends(inNumberOfRegions);
+    for (std::size_t region_id = 0; region_id + 1 < inNumberOfRegions; ++region_id)
+    {
+      const auto nth = sorted_faces_centroids.begin() + (number_of_faces * (region_id + 1)) / inNumberOfRegions;
+      std::nth_element(sorted_faces_centroids.begin(), nth, sorted_faces_centroids.end());
+      regions_ends[region_id] = *nth;
+    }
+    regions_ends.back() = std::numeric_limits<float>::infinity();
+
+    std::vector<CollapseQueue> regions_queues(inNumberOfRegions);
+    std::vector<uint32_t> faces_regions_ids(number_of_faces);
+    for (std::size_t face_id = 0; face_id < number_of_faces; ++face_id)
+    {
+      const auto region_id = static_cast<uint32_t>(
+          std::upper_bound(regions_ends.cbegin(), regions_ends.cend() - 1, faces_centroids[face_id])
+          - regions_ends.cbegin());
+      faces_regions_ids[face_id] = region_id;
+      ++regions_queues[region_id].mNumberOfFaces;
+    }
+
+    // A vertex belongs to a region if all its faces do. Collapses only touch vertices of a single region.
+    std::vector<std::vector<Mesh::VertexId>> regions_vertices_ids(inNumberOfRegions);
+    for (Mesh::VertexId vertex_id = 0; vertex_id < mVerticesFacesIds.size(); ++vertex_id)
+    {
+      const auto& vertex_faces_ids = mVerticesFacesIds[vertex_id];
+      if (vertex_faces_ids.empty())
+        continue;
+
+      const auto region_id = faces_regions_ids[vertex_faces_ids.front()];
+      const auto is_in_region = std::all_of(vertex_faces_ids.cbegin(),
+          vertex_faces_ids.cend(),
+          [&](const Mesh::FaceId inFaceId) { return faces_regions_ids[inFaceId] == region_id; });
+      if (is_in_region)
+      {
+        mVerticesRegionsIds[vertex_id] = region_id;
+        regions_vertices_ids[region_id].push_back(vertex_id);
+      }
+    }
+
+    ParallelFor(
+        inNumberOfRegions,
+        [&](const std::size_t, const std::size_t inBegin, const std::size_t inEnd)
+        {
+          for (auto region_id = inBegin; region_id < inEnd; ++region_id)
+          {
+            auto& region_queue = regions_queues[region_id];
+            region_queue.mRegionId = static_cast<uint32_t>(region_id);
+            for (const auto vertex_id : regions_vertices_ids[region_id])
+            {
+              SetCandidate(region_queue,
+                  vertex_id,
+                  FindCandidate(vertex_id, region_queue.mRegionId, false, region_queue.mScratch));
+            }
+          }
+        },
+        1);
+
+    const auto regions_target_number_of_faces
+        = inTargetNumberOfFaces + (number_of_faces - inTargetNumberOfFaces) / GlobalPassFacesFraction;
+    auto number_of_remaining_faces = number_of_faces;
+    auto error_threshold = 0.0;
+    while (number_of_remaining_faces > regions_target_number_of_faces)
+    {
+      // Raise the threshold at least up to the cheapest candidate, so that every round collapses something
+      auto min_candidate_error = std::numeric_limits<double>::infinity();
+      for (const auto& region_queue : regions_queues)
+      {
+        if (!region_queue.mCandidates.empty())
+          min_candidate_error = std::min(min_candidate_error, region_queue.mCandidates.front().mError);
+      }
+      if (min_candidate_error > inMaxError)
+        break;
+      error_threshold = std::min(std::max(error_threshold * 2.0, min_candidate_error), inMaxError);
+
+      // Every region removes at most its share of the faces left to remove, and at least one face while it has
+      // candidates, so that small regions do not stall once the others are locked or used up
+      const auto number_of_faces_to_remove = (number_of_remaining_faces - regions_target_number_of_faces);
+      if (number_of_faces_to_remove < inNumberOfRegions * 2)
+        break;
+      ParallelFor(
+          inNumberOfRegions,
+          [&](const std::size_t, const std::size_t inBegin, const std::size_t inEnd)
+          {
+            for (auto region_id = inBegin; region_id < inEnd; ++region_id)
+            {
+              auto& region_queue = regions_queues[region_id];
+              const auto region_number_of_faces_to_remove = std::max(
+                  (number_of_faces_to_remove * region_queue.mNumberOfFaces) / number_of_remaining_faces,
+                  static_cast<std::size_t>(1));
+              RunQueue(region_queue,
+                  region_queue.mNumberOfFaces - std::min(region_number_of_faces_to_remove, region_queue.mNumberOfFaces),
+                  error_threshold);
+            }
+          },
+          1);
+
+      // Stalled (only invalid candidates under the threshold): the rest is left to the global pass
+      const auto previous_number_of_remaining_faces = number_of_remaining_faces;
+      number_of_remaining_faces = 0;
+      for (const auto& region_queue : regions_queues) { number_of_remaining_faces += region_queue.mNumberOfFaces; }
+      if (number_of_remaining_faces == previous_number_of_remaining_faces)
+        break;
+    }
+
+    for (const auto& region_queue : regions_queues)
+    {
+      mNumberOfCollapses += region_queue.mNumberOfCollapses;
+      mError = std::max(mError, region_queue.mError);
+    }
+    mNumberOfFaces = number_of_remaining_faces;
+    std::fill(mVerticesRegionsIds.begin(), mVerticesRegionsIds.end(), SharedRegionId);
+  }
+
+  // Collapses over the whole mesh, in order of error
+  void Collapse(const std::size_t inTargetNumberOfFaces, const double inMaxError)
+  {
+    const auto number_of_vertices = mVerticesPositions.size();
+    std::vector<std::optional<Candidate>> vertices_candidates(number_of_vertices);
+    ParallelFor(number_of_vertices,
+        [&](const std::size_t, const std::size_t inBegin, const std::size_t inEnd)
+        {
+          Scratch scratch;
+          for (auto vertex_id = static_cast<Mesh::VertexId>(inBegin); vertex_id < inEnd; ++vertex_id)
+            vertices_candidates[vertex_id] = FindCandidate(vertex_id, AllRegionsId, false, scratch);
+        });
+
+    CollapseQueue collapse_queue;
+    collapse_queue.mRegionId = AllRegionsId;
+    collapse_queue.mNumberOfFaces = mNumberOfFaces;
+    for (Mesh::VertexId vertex_id = 0; vertex_id < number_of_vertices; ++vertex_id)
+    {
+      mVerticesCandidates[vertex_id] = vertices_candidates[vertex_id].value_or(Candidate {});
+      if (vertices_candidates[vertex_id])
+        collapse_queue.mCandidates.push_back(*vertices_candidates[vertex_id]);
+    }
+    collapse_queue.mNumberOfCandidates = collapse_queue.mCandidates.size();
+    std::make_heap(collapse_queue.mCandidates.begin(), collapse_queue.mCandidates.end(), std::greater<Candidate> {});
+    RunQueue(collapse_queue, inTargetNumberOfFaces, inMaxError);
+
+    mNumberOfFaces = collapse_queue.mNumberOfFaces;
+    mNumberOfCollapses += collapse_queue.mNumberOfCollapses;
+    mError = std::max(mError, collapse_queue.mError);
+  }
+
+  // The remaining faces, with the unused vertices removed
+  Mesh Compact() const
+  {
+    Mesh mesh;
+    std::vector<Mesh::VertexId> new_vertices_ids(mVerticesPositions.size(), Mesh::InvalidId);
+    for (std::size_t face_id = 0; face_id < mFacesWedgesIds.size(); ++face_id)
+    {
+      if (mFacesRemoved[face_id])
+        continue;
+
+      std::array<Mesh::VertexId, 3> face_vertices_ids;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        const auto vertex_id = GetFaceVertexId(face_id, i);
+        auto& new_vertex_id = new_vertices_ids[vertex_id];
+        if (new_vertex_id == Mesh::InvalidId)
+          new_vertex_id = mesh.AddVertex(mVerticesPositions[vertex_id]);
+        face_vertices_ids[i] = new_vertex_id;
+      }
+      mesh.AddFace(face_vertices_ids[0], face_vertices_ids[1], face_vertices_ids[2]);
+    }
+
+    auto corners_normals = mesh.GetMutableCornersNormals();
+    auto corners_texture_coordinates = mesh.GetMutableCornersTextureCoordinates();
+    Mesh::CornerId corner_id = 0;
+    for (std::size_t face_id = 0; face_id < mFacesWedgesIds.size(); ++face_id)
+    {
+      if (mFacesRemoved[face_id])
+        continue;
+
+      for (const auto wedge_id : mFacesWedgesIds[face_id])
+      {
+        corners_normals.GetData()[corner_id] = mWedgesNormals[wedge_id];
+        corners_texture_coordinates.GetData()[corner_id] = mWedgesTextureCoordinates[wedge_id];
+        ++corner_id;
+      }
+    }
+
+    mesh.ComputeFaceNormals();
+    mesh.ComputeCornerTable();
+    return mesh;
+  }
+
+private:
+  // Candidates of the vertices of a region (or of all of them), and what their collapses did
+  struct CollapseQueue
+  {
+    uint32_t mRegionId = AllRegionsId;
+    CandidatesHeap mCandidates;
+    std::size_t mNumberOfCandidates = 0; // Not stale
+    Scratch mScratch;
+    std::size_t mNumberOfFaces = 0;
+    std::size_t mNumberOfCollapses = 0;
+    double mError = 0.0;
+  };
+
+  std::vector<Vec3f> mVerticesPositions;
+  std::vector<EVertexKind> mVerticesKinds;
+  std::vector<Quadric> mVerticesQuadrics;
+  std::vector<std::vector<Mesh::FaceId>> mVerticesFacesIds; // Only the faces not removed
+  std::vector<Candidate> mVerticesCandidates; // The queued one, with an invalid vertex id if none
+  std::vector<uint32_t> mVerticesRegionsIds;
+  std::vector<uint8_t> mVerticesRemoved; // Not vector<bool>, regions write them concurrently
+  std::vector<Mesh::VertexId> mWedgesVerticesIds;
+  std::vector<Vec3f> mWedgesNormals;
+  std::vector<Vec2f> mWedgesTextureCoordinates;
+  std::vector<std::array<uint32_t, 3>> mFacesWedgesIds;
+  std::vector<uint8_t> mFacesRemoved;
+  std::size_t mNumberOfFaces = 0;
+  std::size_t mNumberOfCollapses = 0;
+  double mError = 0.0; // Largest collapse error done (weighted mean of squared plane distances)
+
+  // Whether all the corners of the vertex are reachable walking across its faces (a single disk or half disk)
+  static bool IsSingleFan(const Mesh& inMesh, const Span<Mesh::CornerId>& inVertexCornersIds)
+  {
+    const auto first_corner_id = inVertexCornersIds.GetData()[0];
+    std::size_t number_of_fan_corners = 1;
+    auto corner_id = inMesh.GetNextAdjacentCornerId(first_corner_id);
+    while (corner_id != Mesh::InvalidId && corner_id != first_corner_id
+        && number_of_fan_corners <= inVertexCornersIds.GetNumberOfElements())
+    {
+      ++number_of_fan_corners;
+      corner_id = inMesh.GetNextAdjacentCornerId(corner_id);
+    }
+
+    if (corner_id == Mesh::InvalidId)
+    {
+      corner_id = inMesh.GetPreviousAdjacentCornerId(first_corner_id);
+      while (corner_id != Mesh::InvalidId && number_of_fan_corners <= inVertexCornersIds.GetNumberOfElements())
+      {
+        ++number_of_fan_corners;
+        corner_id = inMesh.GetPreviousAdjacentCornerId(corner_id);
+      }
+    }
+    return (number_of_fan_corners == inVertexCornersIds.GetNumberOfElements());
+  }
+
+  Mesh::VertexId GetFaceVertexId(const Mesh::FaceId inFaceId, const std::size_t inInternalCornerId) const
+  {
+    return mWedgesVerticesIds[mFacesWedgesIds[inFaceId][inInternalCornerId]];
+  }
+
+  bool IsInRegion(const Mesh::VertexId inVertexId, const uint32_t inRegionId) const
+  {
+    return (inRegionId == AllRegionsId || mVerticesRegionsIds[inVertexId] == inRegionId);
+  }
+
+  // The neighbors of the vertex, once per face they share with it, with the wedge of the vertex in that face. Sorted by
+  // neighbor. False if any neighbor is not in the region.
+  bool GetNeighborsWedges(const Mesh::VertexId inVertexId,
+      const uint32_t inRegionId,
+      std::vector<NeighborWedge>& outNeighborsWedges) const
+  {
+    outNeighborsWedges.clear();
+    for (const auto face_id : mVerticesFacesIds[inVertexId])
+    {
+      const auto& face_wedges_ids = mFacesWedgesIds[face_id];
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        if (mWedgesVerticesIds[face_wedges_ids[i]] != inVertexId)
+          continue;
+
+        for (const auto other_internal_corner_id : { (i + 1) % 3, (i + 2) % 3 })
+        {
+          const auto neighbor_id = mWedgesVerticesIds[face_wedges_ids[other_internal_corner_id]];
+          if (!IsInRegion(neighbor_id, inRegionId))
+            return false;
+          outNeighborsWedges.push_back(NeighborWedge { neighbor_id, face_wedges_ids[i] });
+        }
+        break;
+      }
+    }
+    std::sort(outNeighborsWedges.begin(), outNeighborsWedges.end(), NeighborWedge::CompareNeighborIds);
+    return true;
+  }
+
+  double GetCollapseError(const Mesh::VertexId inVertexId, const Mesh::VertexId inTargetVertexId) const
+  {
+    auto quadric = mVerticesQuadrics[inVertexId];
+    quadric += mVerticesQuadrics[inTargetVertexId];
+    return (quadric.mWeight > 0.0 ? quadric.Evaluate(mVerticesPositions[inTargetVertexId]) / quadric.mWeight : 0.0);
+  }
+
+  // Whether the vertex kinds allow the collapse, given the wedges of the vertex in the faces of the edge: 2 for
+  // interior edges (different ones in seams), 1 for boundary edges
+  bool IsAllowedCollapse(const Mesh::VertexId inVertexId,
+      const Mesh::VertexId inTargetVertexId,
+      const NeighborWedge* inEdgeFacesWedges,
+      const std::size_t inNumberOfEdgeFaces) const
+  {
+    const auto target_vertex_kind = mVerticesKinds[inTargetVertexId];
+    switch (mVerticesKinds[inVertexId])
+    {
+    case EVertexKind::MANIFOLD:
+      return (inNumberOfEdgeFaces == 2);
+    case EVertexKind::BORDER:
+      return (inNumberOfEdgeFaces == 1
+          && (target_vertex_kind == EVertexKind::BORDER || target_vertex_kind == EVertexKind::LOCKED));
+    case EVertexKind::SEAM:
+      return (inNumberOfEdgeFaces == 2 && inEdgeFacesWedges[0].mWedgeId != inEdgeFacesWedges[1].mWedgeId
+          && (target_vertex_kind == EVertexKind::SEAM || target_vertex_kind == EVertexKind::LOCKED));
+    case EVertexKind::LOCKED:
+      return false;
+    }
+    return false;
+  }
+
+  // Expects ioScratch.mNeighborsWedges to hold the ones of inVertexId
+  bool IsValidCollapse(const Mesh::VertexId inVertexId,
+      const Mesh::VertexId inTargetVertexId,
+      const uint32_t inRegionId,
+      Scratch& ioScratch) const
+  {
+    const auto& neighbors_wedges = ioScratch.mNeighborsWedges;
+    const auto edge_faces_wedges = std::equal_range(neighbors_wedges.cbegin(),
+        neighbors_wedges.cend(),
+        NeighborWedge { inTargetVertexId },
+        NeighborWedge::CompareNeighborIds);
+    const auto number_of_edge_faces = static_cast<std::size_t>(edge_faces_wedges.second - edge_faces_wedges.first);
+    if (!IsAllowedCollapse(inVertexId,
+            inTargetVertexId,
+            neighbors_wedges.data() + (edge_faces_wedges.first - neighbors_wedges.cbegin()),
+            number_of_edge_faces)
+        || !IsInRegion(inTargetVertexId, inRegionId)
+        || !GetNeighborsWedges(inTargetVertexId, inRegionId, ioScratch.mTargetNeighborsWedges))
+    {
+      return false;
+    }
+
+    // Link condition: the only common neighbors are the other vertices of the edge faces
+    const auto& target_neighbors_wedges = ioScratch.mTargetNeighborsWedges;
+    std::size_t number_of_common_neighbors = 0;
+    for (std::size_t i = 0, j = 0; i < neighbors_wedges.size() && j < target_neighbors_wedges.size();)
+    {
+      const auto neighbor_id = neighbors_wedges[i].mNeighborId;
+      const auto target_neighbor_id = target_neighbors_wedges[j].mNeighborId;
+      if (neighbor_id == target_neighbor_id)
+        ++number_of_common_neighbors;
+      if (neighbor_id <= target_neighbor_id)
+      {
+        while (i < neighbors_wedges.size() && neighbors_wedges[i].mNeighborId == neighbor_id) { ++i; }
+      }
+      if (target_neighbor_id <= neighbor_id)
+      {
+        while (j < target_neighbors_wedges.size() && target_neighbors_wedges[j].mNeighborId == target_neighbor_id)
+          ++j;
+      }
+    }
+    if (number_of_common_neighbors != number_of_edge_faces)
+      return false;
+
+    // No face may flip or degenerate when the vertex moves onto the target
+    const auto& target_position = mVerticesPositions[inTargetVertexId];
+    for (const auto face_id : mVerticesFacesIds[inVertexId])
+    {
+      std::array<Vec3f, 3> positions;
+      std::array<Vec3f, 3> moved_positions;
+      auto has_target_vertex = false;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        const auto vertex_id = GetFaceVertexId(face_id, i);
+        has_target_vertex |= (vertex_id == inTargetVertexId);
+        positions[i] = mVerticesPositions[vertex_id];
+        moved_positions[i] = (vertex_id == inVertexId ? target_position : positions[i]);
+      }
+      if (has_target_vertex)
+        continue;
+
+      const auto normal = Cross(positions[1] - positions[0], positions[2] - positions[0]);
+      const auto moved_normal
+          = Cross(moved_positions[1] - moved_positions[0], moved_positions[2] - moved_positions[0]);
+      const auto normals_dot = Dot(normal, moved_normal);
+      if (normals_dot <= 0.0f
+          || normals_dot < MinFaceNormalCosine * std::sqrt(Dot(normal, normal) * Dot(moved_normal, moved_normal)))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Cheapest collapse of the vertex onto one of its neighbors allowed by their kinds. The topological and geometric
+  // checks are costlier, so they are only done (inValidate) when the first candidate found turns out to be invalid.
+  std::optional<Candidate> FindCandidate(const Mesh::VertexId inVertexId,
+      const uint32_t inRegionId,
+      const bool inValidate,
+      Scratch& ioScratch) const
+  {
+    if (mVerticesRemoved[inVertexId] || mVerticesKinds[inVertexId] == EVertexKind::LOCKED
+        || !IsInRegion(inVertexId, inRegionId)
+        || !GetNeighborsWedges(inVertexId, inRegionId, ioScratch.mNeighborsWedges))
+    {
+      return std::nullopt;
+    }
+
+    const auto& neighbors_wedges = ioScratch.mNeighborsWedges;
+    ioScratch.mTargets.clear();
+    for (auto neighbor_wedge_it = neighbors_wedges.cbegin(); neighbor_wedge_it != neighbors_wedges.cend();)
+    {
+      const auto neighbor_id = neighbor_wedge_it->mNeighborId;
+      const auto edge_faces_wedges_end = std::find_if(neighbor_wedge_it,
+          neighbors_wedges.cend(),
+          [&](const NeighborWedge& inNeighborWedge) { return inNeighborWedge.mNeighborId != neighbor_id; });
+      const auto number_of_edge_faces = static_cast<std::size_t>(edge_faces_wedges_end - neighbor_wedge_it);
+      if (IsAllowedCollapse(inVertexId, neighbor_id, &*neighbor_wedge_it, number_of_edge_faces))
+        ioScratch.mTargets.emplace_back(GetCollapseError(inVertexId, neighbor_id), neighbor_id);
+      neighbor_wedge_it = edge_faces_wedges_end;
+    }
+
+    if (!inValidate)
+    {
+      const auto target_it = std::min_element(ioScratch.mTargets.cbegin(), ioScratch.mTargets.cend());
+      if (target_it == ioScratch.mTargets.cend())
+        return std::nullopt;
+      return Candidate { target_it->first, inVertexId, target_it->second };
+    }
+
+    std::sort(ioScratch.mTargets.begin(), ioScratch.mTargets.end());
+    for (const auto& [error, target_vertex_id] : ioScratch.mTargets)
+    {
+      if (IsValidCollapse(inVertexId, target_vertex_id, inRegionId, ioScratch))
+        return Candidate { error, inVertexId, target_vertex_id };
+    }
+    return std::nullopt;
+  }
+
+  // Moves the vertex onto the target: its faces around the edge are removed, and its wedges in the other faces are
+  // replaced by the target wedges on the same side of the edge.
+  void CollapseEdge(const Mesh::VertexId inVertexId,
+      const Mesh::VertexId inTargetVertexId,
+      std::size_t& ioNumberOfFaces)
+  {
+    std::array<std::pair<uint32_t, uint32_t>, 2> wedges_remap = {};
+    std::size_t number_of_wedges_remaps = 0;
+    auto& vertex_faces_ids = mVerticesFacesIds[inVertexId];
+    auto& target_vertex_faces_ids = mVerticesFacesIds[inTargetVertexId];
+    const auto remove_face_from_vertex = [&](const Mesh::VertexId inFaceVertexId, const Mesh::FaceId inFaceId)
+    {
+      auto& face_vertex_faces_ids = mVerticesFacesIds[inFaceVertexId];
+      const auto face_it = std::find(face_vertex_faces_ids.begin(), face_vertex_faces_ids.end(), inFaceId);
+      if (face_it != face_vertex_faces_ids.end())
+      {
+        *face_it = face_vertex_faces_ids.back();
+        face_vertex_faces_ids.pop_back();
+      }
+    };
+
+    for (const auto face_id : vertex_faces_ids)
+    {
+      const auto& face_wedges_ids = mFacesWedgesIds[face_id];
+      std::optional<uint32_t> wedge_id;
+      std::optional<uint32_t> target_wedge_id;
+      for (const auto face_wedge_id : face_wedges_ids)
+      {
+        const auto vertex_id = mWedgesVerticesIds[face_wedge_id];
+        if (vertex_id == inVertexId)
+          wedge_id = face_wedge_id;
+        else if (vertex_id == inTargetVertexId)
+          target_wedge_id = face_wedge_id;
+      }
+      if (!target_wedge_id)
+        continue;
+
+      if (number_of_wedges_remaps < wedges_remap.size())
+        wedges_remap[number_of_wedges_remaps++] = std::make_pair(*wedge_id, *target_wedge_id);
+
+      mFacesRemoved[face_id] = 1;
+      --ioNumberOfFaces;
+      for (const auto face_wedge_id : face_wedges_ids)
+      {
+        const auto face_vertex_id = mWedgesVerticesIds[face_wedge_id];
+        if (face_vertex_id != inVertexId)
+          remove_face_from_vertex(face_vertex_id, face_id);
+      }
+    }
+
+    for (const auto face_id : vertex_faces_ids)
+    {
+      if (mFacesRemoved[face_id])
+        continue;
+
+      for (auto& face_wedge_id : mFacesWedgesIds[face_id])
+      {
+        if (mWedgesVerticesIds[face_wedge_id] != inVertexId)
+          continue;
+
+        const auto wedges_remap_end = wedges_remap.cbegin() + number_of_wedges_remaps;
+        const auto wedge_remap_it = std::find_if(wedges_remap.cbegin(),
+            wedges_remap_end,
+            [&](const auto& inWedgeRemap) { return inWedgeRemap.first == face_wedge_id; });
+        if (wedge_remap_it != wedges_remap_end)
+          face_wedge_id = wedge_remap_it->second;
+        else
+          mWedgesVerticesIds[face_wedge_id] = inTargetVertexId; // Not on the edge sides, keeps its attributes
+      }
+      target_vertex_faces_ids.push_back(face_id);
+    }
+
+    vertex_faces_ids.clear();
+    vertex_faces_ids.shrink_to_fit();
+    mVerticesRemoved[inVertexId] = 1;
+    mVerticesQuadrics[inTargetVertexId] += mVerticesQuadrics[inVertexId];
+  }
+
+  // Makes the candidate the current one of its vertex, queueing it if it changed. The stale candidates are dropped from
+  // the queue once they outnumber the current ones.
+  void SetCandidate(CollapseQueue& ioCollapseQueue,
+      const Mesh::VertexId inVertexId,
+      const std::optional<Candidate>& inCandidate)
+  {
+    auto& vertex_candidate = mVerticesCandidates[inVertexId];
+    const auto candidate = inCandidate.value_or(Candidate {});
+    if (candidate == vertex_candidate)
+      return;
+
+    ioCollapseQueue.mNumberOfCandidates -= (vertex_candidate.mVertexId != Mesh::InvalidId ? 1 : 0);
+    vertex_candidate = candidate;
+    if (!inCandidate)
+      return;
+
+    auto& candidates = ioCollapseQueue.mCandidates;
+    ++ioCollapseQueue.mNumberOfCandidates;
+    candidates.push_back(candidate);
+    std::push_heap(candidates.begin(), candidates.end(), std::greater<Candidate> {});
+
+    if (candidates.size() > 2 * ioCollapseQueue.mNumberOfCandidates + MinNumberOfCandidatesToCompact)
+    {
+      std::erase_if(candidates,
+          [&](const Candidate& inQueuedCandidate)
+          { return inQueuedCandidate != mVerticesCandidates[inQueuedCandidate.mVertexId]; });
+      std::make_heap(candidates.begin(), candidates.end(), std::greater<Candidate> {});
+    }
+  }
+
+  // Collapses the cheapest candidates of the queue until it has the target number of faces, or the next candidate
+  // exceeds the max error
+  void RunQueue(CollapseQueue& ioCollapseQueue, const std::size_t inTargetNumberOfFaces, const double inMaxError)
+  {
+    const auto region_id = ioCollapseQueue.mRegionId;
+    auto& candidates = ioCollapseQueue.mCandidates;
+    auto& scratch = ioCollapseQueue.mScratch;
+    while (ioCollapseQueue.mNumberOfFaces > inTargetNumberOfFaces && !candidates.empty())
+    {
+      if (candidates.front().mError > inMaxError)
+        break;
+      std::pop_heap(candidates.begin(), candidates.end(), std::greater<Candidate> {});
+      const auto candidate = candidates.back();
+      candidates.pop_back();
+
+      const auto vertex_id = candidate.mVertexId;
+      const auto target_vertex_id = candidate.mTargetVertexId;
+      if (mVerticesRemoved[vertex_id] || candidate != mVerticesCandidates[vertex_id])
+        continue;
+
+      // The candidate was found without the topological and geometric checks
+      const auto is_valid = !mVerticesRemoved[target_vertex_id]
+          && GetNeighborsWedges(vertex_id, region_id, scratch.mNeighborsWedges)
+          && IsValidCollapse(vertex_id, target_vertex_id, region_id, scratch);
+      if (!is_valid)
+      {
+        SetCandidate(ioCollapseQueue, vertex_id, FindCandidate(vertex_id, region_id, true, scratch));
+        continue;
+      }
+
+      CollapseEdge(vertex_id, target_vertex_id, ioCollapseQueue.mNumberOfFaces);
+      SetCandidate(ioCollapseQueue, vertex_id, std::nullopt);
+      ++ioCollapseQueue.mNumberOfCollapses;
+      ioCollapseQueue.mError = std::max(ioCollapseQueue.mError, candidate.mError);
+
+      // The errors of the target and its neighbors changed. The ones outside the region are left to the global pass.
+      auto& updated_vertices_ids = scratch.mUpdatedVerticesIds;
+      GetNeighborsWedges(target_vertex_id, AllRegionsId, scratch.mTargetNeighborsWedges);
+      updated_vertices_ids.clear();
+      for (const auto& target_neighbor_wedge : scratch.mTargetNeighborsWedges)
+      {
+        if (updated_vertices_ids.empty() || updated_vertices_ids.back() != target_neighbor_wedge.mNeighborId)
+          updated_vertices_ids.push_back(target_neighbor_wedge.mNeighborId);
+      }
+      if (IsInRegion(target_vertex_id, region_id))
+        SetCandidate(ioCollapseQueue, target_vertex_id, FindCandidate(target_vertex_id, region_id, false, scratch));
+      for (const auto updated_vertex_id : updated_vertices_ids)
+      {
+        if (!IsInRegion(updated_vertex_id, region_id))
+          continue;
+
+        // Interior neighbors whose candidate is still there only have a new error onto the target
+        const auto& updated_vertex_candidate = mVerticesCandidates[updated_vertex_id];
+        if (mVerticesKinds[updated_vertex_id] == EVertexKind::MANIFOLD
+            && updated_vertex_candidate.mVertexId != Mesh::InvalidId
+            && updated_vertex_candidate.mTargetVertexId != vertex_id
+            && updated_vertex_candidate.mTargetVertexId != target_vertex_id)
+        {
+          const auto error = GetCollapseError(updated_vertex_id, target_vertex_id);
+          if (error < updated_vertex_candidate.mError)
+            SetCandidate(ioCollapseQueue, updated_vertex_id, Candidate { error, updated_vertex_id, target_vertex_id });
+          continue;
+        }
+        SetCandidate(ioCollapseQueue, updated_vertex_id, FindCandidate(updated_vertex_id, region_id, false, scratch));
+      }
+    }
+  }
+};
+}
+
+MeshSimplifier::Result MeshSimplifier::Simplify(const Mesh& inMesh, const MeshSimplifier::Parameters& inParameters)
+{
+  EXPECTS(inParameters.mMaxError >= 0.0f);
+
+  const auto max_error = static_cast<double>(inParameters.mMaxError) * inParameters.mMaxError; // Squared distance
+  EdgeCollapser edge_collapser(inMesh, inParameters.mLockBoundaries);
+
+  const auto number_of_regions = (inParameters.mNumberOfRegions > 0)
+      ? inParameters.mNumberOfRegions
+      : std::min(GetNumberOfParallelThreads(), inMesh.GetNumberOfFaces() / MinNumberOfFacesPerRegion);
+  edge_collapser.CollapseRegions(number_of_regions, inParameters.mTargetNumberOfFaces, max_error);
+  edge_collapser.Collapse(inParameters.mTargetNumberOfFaces, max_error);
+
+  Result result;
+  result.mMesh = edge_collapser.Compact();
+  result.mError = static_cast<float>(std::sqrt(edge_collapser.GetError()));
+  result.mNumberOfCollapses = edge_collapser.GetNumberOfCollapses();
+  return result;
+}
+}
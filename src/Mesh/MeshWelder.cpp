@@ -0,0 +1,352 @@
+#include <ez/MeshWelder.h>
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace ez
+{
+namespace
+{
+using Cell = std::array<int64_t, 3>;
+
+// Past this, cells coordinates are clamped (cells that far away are all the same)
+constexpr double MaxCellCoordinate = 4.0e18;
+
+// Position copied, so that the vertices of a cell are compared without jumping around the positions stream
+struct CellVertex
+{
+  uint64_t mCellKey = 0;
+  Mesh::VertexId mVertexId = Mesh::InvalidId;
+  Vec3f mPosition;
+
+  bool operator<(const CellVertex& inRHS) const
+  {
+    return (mCellKey < inRHS.mCellKey) || (mCellKey == inRHS.mCellKey && mVertexId < inRHS.mVertexId);
+  }
+};
+
+// Range of a cell key in the sorted cells vertices, in an open addressing table indexed by the key
+struct CellRun
+{
+  uint64_t mCellKey = 0;
+  uint32_t mBegin = 0;
+  uint32_t mEnd = 0; // Empty slot if 0
+};
+
+class CellRunsTable final
+{
+public:
+  explicit CellRunsTable(const std::vector<CellVertex>& inSortedCellsVertices)
+  {
+    std::size_t number_of_runs = 0;
+    for (std::size_t i = 0; i < inSortedCellsVertices.size(); ++i)
+    {
+      if (i == 0 || inSortedCellsVertices[i].mCellKey != inSortedCellsVertices[i - 1].mCellKey)
+        ++number_of_runs;
+    }
+
+    mRuns.resize(std::bit_ceil(std::max(number_of_runs * 2, static_cast<std::size_t>(1))));
+    for (std::size_t begin = 0; begin < inSortedCellsVertices.size();)
+    {
+      auto end = (begin + 1);
+      while (end < inSortedCellsVertices.size()
+          && inSortedCellsVertices[end].mCellKey == inSortedCellsVertices[begin].mCellKey)
+        ++end;
+
+      auto slot = GetSlot(inSortedCellsVertices[begin].mCellKey);
+      while (mRuns[slot].mEnd != 0) slot = (slot + 1) & (mRuns.size() - 1);
+      mRuns[slot] = CellRun { inSortedCellsVertices[begin].mCellKey,
+        static_cast<uint32_t>(begin),
+        static_cast<uint32_t>(end) };
+      begin = end;
+    }
+  }
+
+  // Empty run if there is no vertex with the key
+  std::pair<uint32_t, uint32_t> Find(const uint64_t inCellKey) const
+  {
+    for (auto slot = GetSlot(inCellKey); mRuns[slot].mEnd != 0; slot = (slot + 1) & (mRuns.size() - 1))
+    {
+      if (mRuns[slot].mCellKey == inCellKey)
+        return { mRuns[slot].mBegin, mRuns[slot].mEnd };
+    }
+    return { 0, 0 };
+  }
+
+private:
+  std::size_t GetSlot(const uint64_t inCellKey) const { return (inCellKey & (mRuns.size() - 1)); }
+
+  std::vector<CellRun> mRuns;
+};
+
+Cell GetCell(const Vec3f& inPosition, const float inEpsilon)
+{
+  Cell cell;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    // With no epsilon, the cell is the coordinate itself (+0 and -0 being the same)
+    if (inEpsilon == 0.0f)
+    {
+      cell[i] = static_cast<int64_t>(std::bit_cast<uint32_t>(inPosition[i] + 0.0f));
+      continue;
+    }
+
+    // NaN in cell 0, as casting it is undefined (it is never merged anyway, see the distance test)
+    const auto cell_coordinate = std::floor(static_cast<double>(inPosition[i]) / inEpsilon);
+    cell[i] = (std::isnan(cell_coordinate)
+            ? 0
+            : static_cast<int64_t>(std::clamp(cell_coordinate, -MaxCellCoordinate, MaxCellCoordinate)));
+  }
+  return cell;
+}
+
+uint64_t GetCellKey(const Cell& inCell)
+{
+  // Multiplicative mixing of the coordinates, and the 64-bit finalizer of MurmurHash3
+  auto key = (static_cast<uint64_t>(inCell[0]) * 0x9E3779B185EBCA87ull)
+      ^ (static_cast<uint64_t>(inCell[1]) * 0xC2B2AE3D27D4EB4Full)
+      ^ (static_cast<uint64_t>(inCell[2]) * 0x165667B19E3779F9ull);
+  key ^= (key >> 33u);
+  key *= 0xFF51AFD7ED558CCDull;
+  key ^= (key >> 33u);
+  key *= 0xC4CEB9FE1A85EC53ull;
+  key ^= (key >> 33u);
+  return key;
+}
+
+// Concurrent union-find where roots are only ever linked under lower ids, so that every set ends up rooted at its
+// lowest id, whatever the order of the unions
+Mesh::VertexId FindRoot(std::vector<std::atomic<Mesh::VertexId>>& ioParents, const Mesh::VertexId inVertexId)
+{
+  auto vertex_id = inVertexId;
+  while (true)
+  {
+    auto parent = ioParents[vertex_id].load();
+    if (parent == vertex_id)
+      return vertex_id;
+
+    // Path halving
+    const auto grandparent = ioParents[parent].load();
+    if (grandparent != parent)
+      ioParents[vertex_id].compare_exchange_weak(parent, grandparent);
+    vertex_id = grandparent;
+  }
+}
+
+void Unite(std::vector<std::atomic<Mesh::VertexId>>& ioParents,
+    const Mesh::VertexId inVertexId0,
+    const Mesh::VertexId inVertexId1)
+{
+  while (true)
+  {
+    auto root_0 = FindRoot(ioParents, inVertexId0);
+    auto root_1 = FindRoot(ioParents, inVertexId1);
+    if (root_0 == root_1)
+      return;
+
+    if (root_0 > root_1)
+      std::swap(root_0, root_1);
+
+    auto expected_parent = root_1;
+    if (ioParents[root_1].compare_exchange_strong(expected_parent, root_0))
+      return;
+  }
+}
+}
+
+MeshWelder::Result MeshWelder::Weld(Mesh& ioMesh, const MeshWelder::Parameters& inParameters)
+{
+  EXPECTS(inParameters.mEpsilon >= 0.0f);
+  EXPECTS(inParameters.mSeamEpsilon >= 0.0f);
+
+  const auto number_of_vertices = ioMesh.GetNumberOfVertices();
+  const auto number_of_faces = ioMesh.GetNumberOfFaces();
+  const auto* vertices_positions = ioMesh.GetVerticesPositions().GetData();
+  const auto* vertices_face_ids = ioMesh.GetVerticesFaceIds().GetData();
+  const auto* faces_vertices_ids = ioMesh.GetFacesVerticesIds().GetData();
+  const auto* corners_normals = ioMesh.GetCornersNormals().GetData();
+  const auto* corners_texture_coordinates = ioMesh.GetCornersTextureCoordinates().GetData();
+
+  // The vertices sorted by cell key
+  std::vector<CellVertex> cells_vertices(number_of_vertices);
+  ParallelFor(number_of_vertices,
+      [&](const std::size_t, const std::size_t inBeginVertexId, const std::size_t inEndVertexId)
+      {
+        for (auto vertex_id = inBeginVertexId; vertex_id < inEndVertexId; ++vertex_id)
+        {
+          const auto& vertex_position = vertices_positions[vertex_id];
+          cells_vertices[vertex_id] = CellVertex { GetCellKey(GetCell(vertex_position, inParameters.mEpsilon)),
+            static_cast<Mesh::VertexId>(vertex_id),
+            vertex_position };
+        }
+      });
+  ParallelSort(cells_vertices.begin(), cells_vertices.end());
+
+  // The corner of every vertex whose attributes are compared for seams (in the last face of the vertex, if any)
+  const auto get_vertex_corner_id = [&](const Mesh::VertexId inVertexId)
+  {
+    const auto face_id = vertices_face_ids[inVertexId];
+    if (face_id == Mesh::InvalidId)
+      return Mesh::InvalidId;
+
+    const auto& face_vertices_ids = faces_vertices_ids[face_id];
+    const auto internal_corner_id = static_cast<Mesh::Id>(
+        std::find(face_vertices_ids.cbegin(), face_vertices_ids.cend(), inVertexId) - face_vertices_ids.cbegin());
+    return static_cast<Mesh::CornerId>(face_id * 3 + internal_corner_id);
+  };
+
+  const auto sq_seam_epsilon = (inParameters.mSeamEpsilon * inParameters.mSeamEpsilon);
+  const auto have_same_attributes = [&](const Mesh::VertexId inVertexId0, const Mesh::VertexId inVertexId1)
+  {
+    const auto corner_id_0 = get_vertex_corner_id(inVertexId0);
+    const auto corner_id_1 = get_vertex_corner_id(inVertexId1);
+    if (corner_id_0 == Mesh::InvalidId || corner_id_1 == Mesh::InvalidId)
+      return true;
+
+    const auto normals_difference = (corners_normals[corner_id_0] - corners_normals[corner_id_1]);
+    const auto texture_coordinates_difference
+        = (corners_texture_coordinates[corner_id_0] - corners_texture_coordinates[corner_id_1]);
+    return (Dot(normals_difference, normals_difference) <= sq_seam_epsilon)
+        && (Dot(texture_coordinates_difference, texture_coordinates_difference) <= sq_seam_epsilon);
+  };
+
+  std::vector<std::atomic<Mesh::VertexId>> vertices_parents(number_of_vertices);
+  ParallelFor(number_of_vertices,
+      [&](const std::size_t, const std::size_t inBeginVertexId, const std::size_t inEndVertexId)
+      {
+        for (auto vertex_id = inBeginVertexId; vertex_id < inEndVertexId; ++vertex_id)
+          vertices_parents[vertex_id].store(static_cast<Mesh::VertexId>(vertex_id));
+      });
+
+  // Every vertex is united with the lower id vertices within epsilon, looking them up in its neighbor cells (cells
+  // with the same key are harmless, the distance is checked anyway). The vertices are visited in cell order, so that
+  // consecutive ones look up the same cells.
+  const CellRunsTable cell_runs_table(cells_vertices);
+  const auto neighbor_cell_range = (inParameters.mEpsilon == 0.0f ? 0 : 1);
+  const auto sq_epsilon = (inParameters.mEpsilon * inParameters.mEpsilon);
+  ParallelFor(number_of_vertices,
+      [&](const std::size_t, const std::size_t inBegin, const std::size_t inEnd)
+      {
+        for (auto i = inBegin; i < inEnd; ++i)
+        {
+          const auto vertex_id = cells_vertices[i].mVertexId;
+          const auto& vertex_position = cells_vertices[i].mPosition;
+          const auto vertex_cell = GetCell(vertex_position, inParameters.mEpsilon);
+          for (auto dx = -neighbor_cell_range; dx <= neighbor_cell_range; ++dx)
+          {
+            for (auto dy = -neighbor_cell_range; dy <= neighbor_cell_range; ++dy)
+            {
+              for (auto dz = -neighbor_cell_range; dz <= neighbor_cell_range; ++dz)
+              {
+                const auto neighbor_cell = Cell { vertex_cell[0] + dx, vertex_cell[1] + dy, vertex_cell[2] + dz };
+                const auto [run_begin, run_end] = cell_runs_table.Find(GetCellKey(neighbor_cell));
+
+                // Sorted by vertex id within the run
+                for (auto j = run_begin; j < run_end && cells_vertices[j].mVertexId < vertex_id; ++j)
+                {
+                  const auto neighbor_vertex_id = cells_vertices[j].mVertexId;
+                  // Written so that NaN positions are never within epsilon
+                  const auto to_neighbor = (cells_vertices[j].mPosition - vertex_position);
+                  if (!(Dot(to_neighbor, to_neighbor) <= sq_epsilon))
+                    continue;
+
+                  if (inParameters.mPreserveSeams && !have_same_attributes(neighbor_vertex_id, vertex_id))
+                    continue;
+
+                  Unite(vertices_parents, neighbor_vertex_id, vertex_id);
+                }
+              }
+            }
+          }
+        }
+      });
+
+  // New ids: the roots keep their order, and the other vertices take the new id of their root (a lower id)
+  std::vector<Mesh::VertexId> vertices_new_ids(number_of_vertices);
+  std::vector<Vec3f> new_vertices_positions;
+  for (Mesh::VertexId vertex_id = 0; vertex_id < number_of_vertices; ++vertex_id)
+  {
+    const auto root_vertex_id = FindRoot(vertices_parents, vertex_id);
+    if (root_vertex_id == vertex_id)
+    {
+      vertices_new_ids[vertex_id] = static_cast<Mesh::VertexId>(new_vertices_positions.size());
+      new_vertices_positions.push_back(vertices_positions[vertex_id]);
+    }
+    else
+    {
+      vertices_new_ids[vertex_id] = vertices_new_ids[root_vertex_id];
+    }
+  }
+
+  // Remapped faces, keeping the ones with three different vertices (chunks counted first, and then compacted)
+  const auto number_of_chunks = GetNumberOfParallelChunks(number_of_faces);
+  std::vector<Mesh::FaceVerticesIds> remapped_faces_vertices_ids(number_of_faces);
+  std::vector<std::size_t> chunks_number_of_kept_faces(number_of_chunks + 1, 0);
+  const auto is_degenerate = [](const Mesh::FaceVerticesIds& inFaceVerticesIds)
+  {
+    return (inFaceVerticesIds[0] == inFaceVerticesIds[1]) || (inFaceVerticesIds[1] == inFaceVerticesIds[2])
+        || (inFaceVerticesIds[2] == inFaceVerticesIds[0]);
+  };
+  ParallelFor(number_of_faces,
+      [&](const std::size_t inChunkId, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          auto& remapped_face_vertices_ids = remapped_faces_vertices_ids[face_id];
+          for (std::size_t i = 0; i < 3; ++i)
+            remapped_face_vertices_ids[i] = vertices_new_ids[faces_vertices_ids[face_id][i]];
+
+          if (!is_degenerate(remapped_face_vertices_ids))
+            ++chunks_number_of_kept_faces[inChunkId + 1];
+        }
+      });
+  std::partial_sum(chunks_number_of_kept_faces.cbegin(),
+      chunks_number_of_kept_faces.cend(),
+      chunks_number_of_kept_faces.begin());
+
+  MeshWelder::Result result;
+  const auto new_number_of_faces = chunks_number_of_kept_faces.back();
+  result.mNumberOfMergedVertices = (number_of_vertices - new_vertices_positions.size());
+  result.mNumberOfRemovedFaces = (number_of_faces - new_number_of_faces);
+  if (result.mNumberOfMergedVertices == 0 && result.mNumberOfRemovedFaces == 0)
+    return result; // Nothing to do, and the corner table is still valid
+
+  std::vector<Mesh::FaceVerticesIds> new_faces_vertices_ids(new_number_of_faces);
+  std::vector<Vec3f> new_faces_normals(new_number_of_faces);
+  std::vector<Vec3f> new_corners_normals(new_number_of_faces * 3);
+  std::vector<Vec2f> new_corners_texture_coordinates(new_number_of_faces * 3);
+  const auto* faces_normals = ioMesh.GetFacesNormals().GetData();
+  ParallelFor(number_of_faces,
+      [&](const std::size_t inChunkId, const std::size_t inBeginFaceId, const std::size_t inEndFaceId)
+      {
+        auto new_face_id = chunks_number_of_kept_faces[inChunkId];
+        for (auto face_id = inBeginFaceId; face_id < inEndFaceId; ++face_id)
+        {
+          if (is_degenerate(remapped_faces_vertices_ids[face_id]))
+            continue;
+
+          new_faces_vertices_ids[new_face_id] = remapped_faces_vertices_ids[face_id];
+          new_faces_normals[new_face_id] = faces_normals[face_id];
+          std::copy_n(corners_normals + face_id * 3, 3, new_corners_normals.begin() + new_face_id * 3);
+          std::copy_n(corners_texture_coordinates + face_id * 3,
+              3,
+              new_corners_texture_coordinates.begin() + new_face_id * 3);
+          ++new_face_id;
+        }
+      });
+
+  ioMesh.SetStreams(std::move(new_vertices_positions),
+      std::move(new_faces_vertices_ids),
+      std::move(new_faces_normals),
+      std::move(new_corners_normals),
+      std::move(new_corners_texture_coordinates));
+  return result;
+}
+}
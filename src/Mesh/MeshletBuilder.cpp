@@ -0,0 +1,260 @@
+#include <ez/MeshletBuilder.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace ez
+{
+namespace
+{
+constexpr uint32_t InvalidId = std::numeric_limits<uint32_t>::max();
+
+// Normal cones wider than this (min cosine between the axis and the triangles normals) are not worth testing
+constexpr float MinConeCosine = 0.1f;
+}
+
+std::vector<MeshletBuilder::Meshlet> MeshletBuilder::Build(std::vector<uint32_t>& ioIndices,
+    const Span<Vec3f>& inVerticesPositions,
+    const std::size_t inMaxNumberOfVertices,
+    const std::size_t inMaxNumberOfTriangles)
+{
+  EXPECTS(ioIndices.size() % 3 == 0);
+  EXPECTS(inMaxNumberOfVertices >= 3);
+  EXPECTS(inMaxNumberOfTriangles >= 1);
+
+  const auto number_of_triangles = ioIndices.size() / 3;
+  const auto number_of_vertices = inVerticesPositions.GetNumberOfElements();
+
+  // Vertex->triangles (compressed sparse row), and the number of triangles of every vertex not in a meshlet yet
+  std::vector<uint32_t> vertices_triangles_offsets(number_of_vertices + 1, 0);
+  for (const auto vertex_id : ioIndices)
+  {
+    EXPECTS(vertex_id < number_of_vertices);
+    ++vertices_triangles_offsets[vertex_id + 1];
+  }
+  std::partial_sum(vertices_triangles_offsets.cbegin(),
+      vertices_triangles_offsets.cend(),
+      vertices_triangles_offsets.begin());
+  std::vector<uint32_t> vertices_triangles_ids(ioIndices.size());
+  {
+    auto vertices_fill_offsets = vertices_triangles_offsets;
+    for (std::size_t i = 0; i < ioIndices.size(); ++i)
+      vertices_triangles_ids[vertices_fill_offsets[ioIndices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+  std::vector<uint32_t> vertices_number_of_free_triangles(number_of_vertices);
+  for (std::size_t vertex_id = 0; vertex_id < number_of_vertices; ++vertex_id)
+  {
+    vertices_number_of_free_triangles[vertex_id]
+        = (vertices_triangles_offsets[vertex_id + 1] - vertices_triangles_offsets[vertex_id]);
+  }
+
+  std::vector<uint8_t> triangles_in_meshlet(number_of_triangles, 0);
+  std::vector<uint32_t> vertices_meshlets_ids(number_of_vertices, InvalidId); // Last meshlet with the vertex
+  std::vector<uint32_t> meshlet_vertices_ids;
+  std::vector<uint32_t> meshlets_indices;
+  meshlets_indices.reserve(ioIndices.size());
+  std::vector<MeshletBuilder::Meshlet> meshlets;
+
+  const auto get_number_of_new_vertices = [&](const std::size_t inTriangleId, const uint32_t inMeshletId)
+  {
+    std::size_t number_of_new_vertices = 0;
+    for (std::size_t i = 0; i < 3; ++i)
+      number_of_new_vertices += (vertices_meshlets_ids[ioIndices[inTriangleId * 3 + i]] != inMeshletId ? 1 : 0);
+    return number_of_new_vertices;
+  };
+
+  // Free triangle around the meshlet that adds the fewest new vertices, and then whose vertices have the fewest free
+  // triangles left (so that the meshlets stay compact and do not leave isolated triangles behind)
+  const auto find_next_triangle = [&](const uint32_t inMeshletId)
+  {
+    auto best_triangle_id = InvalidId;
+    auto best_score = std::make_pair(std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max());
+    for (const auto vertex_id : meshlet_vertices_ids)
+    {
+      if (vertices_number_of_free_triangles[vertex_id] == 0)
+        continue;
+
+      for (auto i = vertices_triangles_offsets[vertex_id]; i < vertices_triangles_offsets[vertex_id + 1]; ++i)
+      {
+        const auto triangle_id = vertices_triangles_ids[i];
+        if (triangles_in_meshlet[triangle_id])
+          continue;
+
+        const auto number_of_new_vertices = get_number_of_new_vertices(triangle_id, inMeshletId);
+        if (meshlet_vertices_ids.size() + number_of_new_vertices > inMaxNumberOfVertices)
+          continue;
+
+        std::size_t number_of_free_triangles = 0;
+        for (std::size_t j = 0; j < 3; ++j)
+          number_of_free_triangles += vertices_number_of_free_triangles[ioIndices[triangle_id * 3 + j]];
+
+        const auto score = std::make_pair(number_of_new_vertices, number_of_free_triangles);
+        if (score < best_score)
+        {
+          best_score = score;
+          best_triangle_id = triangle_id;
+        }
+      }
+    }
+    return best_triangle_id;
+  };
+
+  std::size_t seed_triangle_id = 0;
+  std::size_t number_of_triangles_in_meshlets = 0;
+  while (number_of_triangles_in_meshlets < number_of_triangles)
+  {
+    const auto meshlet_id = static_cast<uint32_t>(meshlets.size());
+    MeshletBuilder::Meshlet meshlet;
+    meshlet.mBeginElement = static_cast<uint32_t>(meshlets_indices.size());
+    meshlet_vertices_ids.clear();
+
+    while (triangles_in_meshlet[seed_triangle_id]) ++seed_triangle_id;
+    auto triangle_id = static_cast<uint32_t>(seed_triangle_id);
+    std::size_t meshlet_number_of_triangles = 0;
+    while (triangle_id != InvalidId)
+    {
+      triangles_in_meshlet[triangle_id] = 1;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        const auto vertex_id = ioIndices[triangle_id * 3 + i];
+        meshlets_indices.push_back(vertex_id);
+        --vertices_number_of_free_triangles[vertex_id];
+        if (vertices_meshlets_ids[vertex_id] != meshlet_id)
+        {
+          vertices_meshlets_ids[vertex_id] = meshlet_id;
+          meshlet_vertices_ids.push_back(vertex_id);
+        }
+      }
+      ++meshlet_number_of_triangles;
+      ++number_of_triangles_in_meshlets;
+      if (meshlet_number_of_triangles == inMaxNumberOfTriangles)
+        break;
+
+      triangle_id = find_next_triangle(meshlet_id);
+    }
+
+    meshlet.mNumberOfElements = static_cast<uint32_t>(meshlets_indices.size() - meshlet.mBeginElement);
+    meshlet.mNumberOfVertices = static_cast<uint32_t>(meshlet_vertices_ids.size());
+    ComputeBounds(meshlet, MakeSpan(meshlets_indices), inVerticesPositions);
+    meshlets.push_back(meshlet);
+  }
+
+  ioIndices = std::move(meshlets_indices);
+  return meshlets;
+}
+
+void MeshletBuilder::ComputeBounds(MeshletBuilder::Meshlet& ioMeshlet,
+    const Span<uint32_t>& inIndices,
+    const Span<Vec3f>& inVerticesPositions)
+{
+  EXPECTS(ioMeshlet.mBeginElement + ioMeshlet.mNumberOfElements <= inIndices.GetNumberOfElements());
+
+  const auto* indices_begin = (inIndices.GetData() + ioMeshlet.mBeginElement);
+  const auto* indices_end = (indices_begin + ioMeshlet.mNumberOfElements);
+  const auto* positions = inVerticesPositions.GetData();
+  if (indices_begin == indices_end)
+  {
+    ioMeshlet.mBoundingSphere = Spheref { Zero<Vec3f>(), 0.0f };
+    ioMeshlet.mConeCutoff = 1.0f;
+    return;
+  }
+
+  // Bounding sphere around the bounding box center
+  auto min_position = positions[*indices_begin];
+  auto max_position = min_position;
+  for (auto index_it = indices_begin; index_it != indices_end; ++index_it)
+  {
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      min_position[i] = std::min(min_position[i], positions[*index_it][i]);
+      max_position[i] = std::max(max_position[i], positions[*index_it][i]);
+    }
+  }
+  const auto center = (min_position + max_position) * 0.5f;
+  auto radius = 0.0f;
+  for (auto index_it = indices_begin; index_it != indices_end; ++index_it)
+    radius = std::max(radius, Length(positions[*index_it] - center));
+  ioMeshlet.mBoundingSphere = Spheref { center, radius };
+
+  // Normal cone: the mean of the triangles normals, as wide as the farthest normal, with its apex behind all the
+  // triangles planes
+  std::vector<std::pair<Vec3f, Vec3f>> triangles_points_normals;
+  triangles_points_normals.reserve(ioMeshlet.mNumberOfElements / 3);
+  auto normals_sum = Zero<Vec3f>();
+  for (auto index_it = indices_begin; index_it + 2 < indices_end; index_it += 3)
+  {
+    const auto& position0 = positions[index_it[0]];
+    const auto normal = Cross(positions[index_it[1]] - position0, positions[index_it[2]] - position0);
+    const auto normal_length = Length(normal);
+    if (normal_length <= 0.0f)
+      continue;
+
+    triangles_points_normals.emplace_back(position0, normal / normal_length);
+    normals_sum += triangles_points_normals.back().second;
+  }
+
+  ioMeshlet.mConeApex = center;
+  ioMeshlet.mConeAxis = NormalizedSafe(normals_sum);
+  ioMeshlet.mConeCutoff = 1.0f;
+  if (triangles_points_normals.empty() || ioMeshlet.mConeAxis == Zero<Vec3f>())
+    return;
+
+  auto min_axis_cosine = 1.0f;
+  for (const auto& [triangle_point, triangle_normal] : triangles_points_normals)
+    min_axis_cosine = std::min(min_axis_cosine, Dot(triangle_normal, ioMeshlet.mConeAxis));
+  if (min_axis_cosine <= MinConeCosine)
+    return;
+
+  auto max_apex_distance = 0.0f;
+  for (const auto& [triangle_point, triangle_normal] : triangles_points_normals)
+  {
+    const auto apex_distance
+        = Dot(center - triangle_point, triangle_normal) / Dot(ioMeshlet.mConeAxis, triangle_normal);
+    max_apex_distance = std::max(max_apex_distance, apex_distance);
+  }
+  ioMeshlet.mConeApex = center - ioMeshlet.mConeAxis * max_apex_distance;
+  ioMeshlet.mConeCutoff = std::sqrt(1.0f - min_axis_cosine * min_axis_cosine);
+}
+
+void MeshletBuilder::Cull(const Span<MeshletBuilder::Meshlet>& inMeshlets,
+    const MeshletBuilder::CullingView& inCullingView,
+    const Mat4f& inTransformMatrix,
+    const bool inCullBackFacing,
+    std::vector<uint32_t>& outVisibleMeshletsIds)
+{
+  outVisibleMeshletsIds.clear();
+
+  const auto scales = Vec3f { Length(XYZ(inTransformMatrix * XYZ0(Right<Vec3f>()))),
+    Length(XYZ(inTransformMatrix * XYZ0(Up<Vec3f>()))),
+    Length(XYZ(inTransformMatrix * XYZ0(Back<Vec3f>()))) };
+  const auto max_scale = std::max({ scales[0], scales[1], scales[2] });
+  const auto min_scale = std::min({ scales[0], scales[1], scales[2] });
+  const auto use_normal_cones
+      = (inCullBackFacing && max_scale > 0.0f && (max_scale - min_scale) <= max_scale * 1e-3f);
+
+  const auto* meshlets = inMeshlets.GetData();
+  for (std::size_t meshlet_id = 0; meshlet_id < inMeshlets.GetNumberOfElements(); ++meshlet_id)
+  {
+    const auto& meshlet = meshlets[meshlet_id];
+    const auto center = XYZ(inTransformMatrix * XYZ1(meshlet.mBoundingSphere.GetCenter()));
+    const auto radius = (meshlet.mBoundingSphere.GetRadius() * max_scale);
+    const auto is_outside_frustum = std::any_of(inCullingView.mFrustumPlanes.cbegin(),
+        inCullingView.mFrustumPlanes.cend(),
+        [&](const Vec4f& inPlane) { return (Dot(XYZ(inPlane), center) + inPlane[3] < -radius); });
+    if (is_outside_frustum)
+      continue;
+
+    if (use_normal_cones && meshlet.mConeCutoff < 1.0f)
+    {
+      const auto cone_apex = XYZ(inTransformMatrix * XYZ1(meshlet.mConeApex));
+      const auto cone_axis = NormalizedSafe(XYZ(inTransformMatrix * XYZ0(meshlet.mConeAxis)));
+      if (Dot(NormalizedSafe(cone_apex - inCullingView.mCameraPosition), cone_axis) >= meshlet.mConeCutoff)
+        continue;
+    }
+
+    outVisibleMeshletsIds.push_back(static_cast<uint32_t>(meshlet_id));
+  }
+}
+}
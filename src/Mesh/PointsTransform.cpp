@@ -0,0 +1,194 @@
+#include <ez/PointsTransform.h>
+#include <ez/Parallel.h>
+#include <cmath>
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EZ_POINTS_TRANSFORM_AVX2
+#include <immintrin.h>
+#endif
+
+namespace ez
+{
+namespace
+{
+static_assert(sizeof(Vec3f) == 3 * sizeof(float), "The kernels read Vec3f streams as packed floats");
+
+constexpr std::size_t ParallelTransformMinChunkSize = (1u << 16u);
+
+enum class ETransformKind
+{
+  AFFINE_POINT,
+  PROJECTIVE_POINT,
+  NORMAL
+};
+
+// inMatrix is row-major, as Mat4f::Data()
+template <ETransformKind TKind>
+void TransformScalar(const float* inMatrix, float* ioXYZ, const std::size_t inNumberOfPoints)
+{
+  for (std::size_t i = 0; i < inNumberOfPoints; ++i)
+  {
+    auto* xyz = (ioXYZ + i * 3);
+    const auto x = xyz[0];
+    const auto y = xyz[1];
+    const auto z = xyz[2];
+    auto tx = (inMatrix[0] * x + inMatrix[1] * y + inMatrix[2] * z);
+    auto ty = (inMatrix[4] * x + inMatrix[5] * y + inMatrix[6] * z);
+    auto tz = (inMatrix[8] * x + inMatrix[9] * y + inMatrix[10] * z);
+
+    if constexpr (TKind != ETransformKind::NORMAL)
+    {
+      tx += inMatrix[3];
+      ty += inMatrix[7];
+      tz += inMatrix[11];
+    }
+
+    if constexpr (TKind == ETransformKind::PROJECTIVE_POINT)
+    {
+      const auto w = (inMatrix[12] * x + inMatrix[13] * y + inMatrix[14] * z + inMatrix[15]);
+      tx /= w;
+      ty /= w;
+      tz /= w;
+    }
+
+    if constexpr (TKind == ETransformKind::NORMAL)
+    {
+      const auto sq_length = (tx * tx + ty * ty + tz * tz);
+      if (sq_length > 0.0f)
+      {
+        const auto inverse_length = (1.0f / std::sqrt(sq_length));
+        tx *= inverse_length;
+        ty *= inverse_length;
+        tz *= inverse_length;
+      }
+    }
+
+    xyz[0] = tx;
+    xyz[1] = ty;
+    xyz[2] = tz;
+  }
+}
+
+#ifdef EZ_POINTS_TRANSFORM_AVX2
+// Transforms 8 points per iteration: the 24 interleaved floats are deinterleaved into x, y and z registers with
+// blends and permutes, transformed, and interleaved back.
+template <ETransformKind TKind>
+__attribute__((target("avx2,fma"))) void TransformAVX2(const float* inMatrix,
+    float* ioXYZ,
+    const std::size_t inNumberOfPoints)
+{
+  __m256 m[16];
+  for (std::size_t i = 0; i < 16; ++i) { m[i] = _mm256_set1_ps(inMatrix[i]); }
+  if constexpr (TKind == ETransformKind::NORMAL)
+  {
+    m[3] = _mm256_setzero_ps();
+    m[7] = _mm256_setzero_ps();
+    m[11] = _mm256_setzero_ps();
+  }
+
+  const auto deinterleave_x_permutation = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+  const auto deinterleave_y_permutation = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6);
+  const auto deinterleave_z_permutation = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+  const auto interleave_x_permutation = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+  const auto interleave_y_permutation = _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2);
+  const auto interleave_z_permutation = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+
+  std::size_t i = 0;
+  for (; i + 8 <= inNumberOfPoints; i += 8)
+  {
+    auto* xyz = (ioXYZ + i * 3);
+    const auto a = _mm256_loadu_ps(xyz + 0);  // x0 y0 z0 x1 y1 z1 x2 y2
+    const auto b = _mm256_loadu_ps(xyz + 8);  // z2 x3 y3 z3 x4 y4 z4 x5
+    const auto c = _mm256_loadu_ps(xyz + 16); // y5 z5 x6 y6 z6 x7 y7 z7
+
+    const auto x = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24),
+        deinterleave_x_permutation);
+    const auto y = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49),
+        deinterleave_y_permutation);
+    const auto z = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92),
+        deinterleave_z_permutation);
+
+    // No translation for normals: the fourth column is zeroed above
+    auto tx = _mm256_fmadd_ps(m[2], z, _mm256_fmadd_ps(m[1], y, _mm256_fmadd_ps(m[0], x, m[3])));
+    auto ty = _mm256_fmadd_ps(m[6], z, _mm256_fmadd_ps(m[5], y, _mm256_fmadd_ps(m[4], x, m[7])));
+    auto tz = _mm256_fmadd_ps(m[10], z, _mm256_fmadd_ps(m[9], y, _mm256_fmadd_ps(m[8], x, m[11])));
+
+    if constexpr (TKind == ETransformKind::PROJECTIVE_POINT)
+    {
+      const auto w = _mm256_fmadd_ps(m[14], z, _mm256_fmadd_ps(m[13], y, _mm256_fmadd_ps(m[12], x, m[15])));
+      const auto inverse_w = _mm256_div_ps(_mm256_set1_ps(1.0f), w);
+      tx = _mm256_mul_ps(tx, inverse_w);
+      ty = _mm256_mul_ps(ty, inverse_w);
+      tz = _mm256_mul_ps(tz, inverse_w);
+    }
+
+    if constexpr (TKind == ETransformKind::NORMAL)
+    {
+      const auto sq_length = _mm256_fmadd_ps(tz, tz, _mm256_fmadd_ps(ty, ty, _mm256_mul_ps(tx, tx)));
+      const auto one = _mm256_set1_ps(1.0f);
+      const auto non_zero = _mm256_cmp_ps(sq_length, _mm256_setzero_ps(), _CMP_GT_OQ);
+      const auto inverse_length = _mm256_blendv_ps(one, _mm256_div_ps(one, _mm256_sqrt_ps(sq_length)), non_zero);
+      tx = _mm256_mul_ps(tx, inverse_length);
+      ty = _mm256_mul_ps(ty, inverse_length);
+      tz = _mm256_mul_ps(tz, inverse_length);
+    }
+
+    const auto tx_interleaved = _mm256_permutevar8x32_ps(tx, interleave_x_permutation);
+    const auto ty_interleaved = _mm256_permutevar8x32_ps(ty, interleave_y_permutation);
+    const auto tz_interleaved = _mm256_permutevar8x32_ps(tz, interleave_z_permutation);
+    _mm256_storeu_ps(xyz + 0,
+        _mm256_blend_ps(_mm256_blend_ps(tx_interleaved, ty_interleaved, 0x92), tz_interleaved, 0x24));
+    _mm256_storeu_ps(xyz + 8,
+        _mm256_blend_ps(_mm256_blend_ps(tx_interleaved, ty_interleaved, 0x24), tz_interleaved, 0x49));
+    _mm256_storeu_ps(xyz + 16,
+        _mm256_blend_ps(_mm256_blend_ps(tx_interleaved, ty_interleaved, 0x49), tz_interleaved, 0x92));
+  }
+
+  TransformScalar<TKind>(inMatrix, ioXYZ + i * 3, inNumberOfPoints - i);
+}
+
+bool IsAVX2Supported()
+{
+  static const auto sAVX2Supported = (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"));
+  return sAVX2Supported;
+}
+#endif
+
+template <ETransformKind TKind>
+void Transform(const MutableSpan<Vec3f>& ioPoints, const Mat4f& inMatrix)
+{
+  auto* xyz = reinterpret_cast<float*>(ioPoints.GetData());
+  const auto* matrix = inMatrix.Data();
+  ParallelFor(
+      ioPoints.GetNumberOfElements(),
+      [&](const std::size_t, const std::size_t inBegin, const std::size_t inEnd)
+      {
+#ifdef EZ_POINTS_TRANSFORM_AVX2
+        if (IsAVX2Supported())
+        {
+          TransformAVX2<TKind>(matrix, xyz + inBegin * 3, inEnd - inBegin);
+          return;
+        }
+#endif
+        TransformScalar<TKind>(matrix, xyz + inBegin * 3, inEnd - inBegin);
+      },
+      ParallelTransformMinChunkSize);
+}
+}
+
+void TransformPoints(const MutableSpan<Vec3f>& ioPoints, const Mat4f& inTransform)
+{
+  Transform<ETransformKind::AFFINE_POINT>(ioPoints, inTransform);
+}
+
+void TransformPointsProjective(const MutableSpan<Vec3f>& ioPoints, const Mat4f& inTransform)
+{
+  Transform<ETransformKind::PROJECTIVE_POINT>(ioPoints, inTransform);
+}
+
+void TransformNormals(const MutableSpan<Vec3f>& ioNormals, const Mat4f& inNormalMatrix)
+{
+  Transform<ETransformKind::NORMAL>(ioNormals, inNormalMatrix);
+}
+}
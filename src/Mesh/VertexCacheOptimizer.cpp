@@ -0,0 +1,328 @@
+#include <ez/VertexCacheOptimizer.h>
+#include <ez/MathInitializers.h>
+#include <algorithm>
+#include <numeric>
+
+namespace ez
+{
+namespace
+{
+// FIFO cache simulated with timestamps: a vertex is in the cache if it was (re)inserted less than inCacheSize
+// insertions ago. Resetting the cache is just advancing the time by the cache size.
+class FIFOCacheSimulator final
+{
+public:
+  FIFOCacheSimulator(const std::size_t inNumberOfVertices, const std::size_t inCacheSize)
+      : mVerticesTimestamps(inNumberOfVertices, 0), mCacheSize(inCacheSize), mTime(inCacheSize + 1)
+  {
+  }
+
+  // Returns the number of misses (0 to 3) of the given triangle
+  std::size_t AddTriangle(const uint32_t* inTriangleVerticesIds)
+  {
+    std::size_t number_of_misses = 0;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      auto& vertex_timestamp = mVerticesTimestamps[inTriangleVerticesIds[i]];
+      if (mTime - vertex_timestamp > mCacheSize)
+      {
+        vertex_timestamp = mTime++;
+        ++number_of_misses;
+      }
+    }
+    return number_of_misses;
+  }
+
+  void Reset() { mTime += mCacheSize + 1; }
+
+private:
+  std::vector<std::size_t> mVerticesTimestamps;
+  std::size_t mCacheSize = 0;
+  std::size_t mTime = 0;
+};
+
+// Vertex -> triangles adjacency, in compressed rows
+struct VerticesTriangles
+{
+  std::vector<uint32_t> mOffsets;
+  std::vector<uint32_t> mTrianglesIds;
+};
+
+VerticesTriangles ComputeVerticesTriangles(const std::vector<uint32_t>& inIndices,
+    const std::size_t inNumberOfVertices)
+{
+  VerticesTriangles vertices_triangles;
+  vertices_triangles.mOffsets.assign(inNumberOfVertices + 1, 0);
+  for (const auto vertex_id : inIndices) { ++vertices_triangles.mOffsets[vertex_id + 1]; }
+  std::partial_sum(vertices_triangles.mOffsets.cbegin(),
+      vertices_triangles.mOffsets.cend(),
+      vertices_triangles.mOffsets.begin());
+
+  auto vertices_fill_offsets = vertices_triangles.mOffsets;
+  vertices_triangles.mTrianglesIds.resize(inIndices.size());
+  for (std::size_t i = 0; i < inIndices.size(); ++i)
+    vertices_triangles.mTrianglesIds[vertices_fill_offsets[inIndices[i]]++] = static_cast<uint32_t>(i / 3);
+  return vertices_triangles;
+}
+}
+
+VertexCacheOptimizer::Statistics VertexCacheOptimizer::Analyze(const Span<uint32_t>& inIndices,
+    const std::size_t inNumberOfVertices,
+    const std::size_t inCacheSize)
+{
+  EXPECTS(inIndices.GetNumberOfElements() % 3 == 0);
+
+  const auto* indices = inIndices.GetData();
+  const auto number_of_triangles = (inIndices.GetNumberOfElements() / 3);
+
+  FIFOCacheSimulator cache(inNumberOfVertices, inCacheSize);
+  Statistics statistics;
+  for (std::size_t triangle_id = 0; triangle_id < number_of_triangles; ++triangle_id)
+    statistics.mNumberOfCacheMisses += cache.AddTriangle(indices + triangle_id * 3);
+
+  std::vector<bool> vertices_referenced(inNumberOfVertices, false);
+  for (std::size_t i = 0; i < inIndices.GetNumberOfElements(); ++i) { vertices_referenced[indices[i]] = true; }
+  const auto number_of_referenced_vertices = std::count(vertices_referenced.cbegin(), vertices_referenced.cend(), true);
+
+  if (number_of_triangles > 0)
+    statistics.mACMR = static_cast<float>(statistics.mNumberOfCacheMisses) / number_of_triangles;
+  if (number_of_referenced_vertices > 0)
+    statistics.mATVR = static_cast<float>(statistics.mNumberOfCacheMisses) / number_of_referenced_vertices;
+  return statistics;
+}
+
+// Tipsify (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007):
+// emits the fans of the vertices around the current one, moving to the adjacent vertex that will still be in the cache
+// after emitting its remaining triangles, or to the most recent vertex with remaining triangles otherwise.
+void VertexCacheOptimizer::OptimizeVertexCache(std::vector<uint32_t>& ioIndices,
+    const std::size_t inNumberOfVertices,
+    const std::size_t inCacheSize)
+{
+  EXPECTS(ioIndices.size() % 3 == 0);
+
+  const auto number_of_triangles = (ioIndices.size() / 3);
+  if (number_of_triangles == 0)
+    return;
+
+  const auto vertices_triangles = ComputeVerticesTriangles(ioIndices, inNumberOfVertices);
+  std::vector<uint32_t> vertices_live_triangles(inNumberOfVertices);
+  for (std::size_t vertex_id = 0; vertex_id < inNumberOfVertices; ++vertex_id)
+  {
+    vertices_live_triangles[vertex_id]
+        = (vertices_triangles.mOffsets[vertex_id + 1] - vertices_triangles.mOffsets[vertex_id]);
+  }
+
+  const auto cache_size = static_cast<int64_t>(inCacheSize);
+  std::vector<int64_t> vertices_timestamps(inNumberOfVertices, 0);
+  int64_t time = cache_size + 1;
+
+  std::vector<bool> triangles_emitted(number_of_triangles, false);
+  std::vector<uint32_t> dead_end_vertices_ids;
+  std::vector<uint32_t> candidate_vertices_ids;
+  std::vector<uint32_t> optimized_indices;
+  optimized_indices.reserve(ioIndices.size());
+
+  const auto skip_dead_end = [&](std::size_t& ioCursor) -> int64_t
+  {
+    while (!dead_end_vertices_ids.empty())
+    {
+      const auto vertex_id = dead_end_vertices_ids.back();
+      dead_end_vertices_ids.pop_back();
+      if (vertices_live_triangles[vertex_id] > 0)
+        return vertex_id;
+    }
+
+    for (; ioCursor < inNumberOfVertices; ++ioCursor)
+    {
+      if (vertices_live_triangles[ioCursor] > 0)
+        return static_cast<int64_t>(ioCursor);
+    }
+    return -1;
+  };
+
+  std::size_t cursor = 0;
+  auto fanning_vertex_id = skip_dead_end(cursor);
+  while (fanning_vertex_id >= 0)
+  {
+    candidate_vertices_ids.clear();
+    for (auto triangle_it = vertices_triangles.mOffsets[fanning_vertex_id];
+         triangle_it < vertices_triangles.mOffsets[fanning_vertex_id + 1];
+         ++triangle_it)
+    {
+      const auto triangle_id = vertices_triangles.mTrianglesIds[triangle_it];
+      if (triangles_emitted[triangle_id])
+        continue;
+
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        const auto vertex_id = ioIndices[triangle_id * 3 + i];
+        optimized_indices.push_back(vertex_id);
+        dead_end_vertices_ids.push_back(vertex_id);
+        candidate_vertices_ids.push_back(vertex_id);
+        --vertices_live_triangles[vertex_id];
+        if (time - vertices_timestamps[vertex_id] > cache_size)
+          vertices_timestamps[vertex_id] = time++;
+      }
+      triangles_emitted[triangle_id] = true;
+    }
+
+    // Next fanning vertex: the oldest candidate that stays in the cache while fanning around it
+    int64_t next_vertex_id = -1;
+    int64_t best_priority = -1;
+    for (const auto vertex_id : candidate_vertices_ids)
+    {
+      const auto live_triangles = static_cast<int64_t>(vertices_live_triangles[vertex_id]);
+      if (live_triangles == 0)
+        continue;
+
+      int64_t priority = 0;
+      if (time - vertices_timestamps[vertex_id] + 2 * live_triangles <= cache_size)
+        priority = time - vertices_timestamps[vertex_id];
+      if (priority > best_priority)
+      {
+        best_priority = priority;
+        next_vertex_id = vertex_id;
+      }
+    }
+    fanning_vertex_id = (next_vertex_id >= 0 ? next_vertex_id : skip_dead_end(cursor));
+  }
+
+  ENSURES(optimized_indices.size() == ioIndices.size());
+  ioIndices = std::move(optimized_indices);
+}
+
+void VertexCacheOptimizer::OptimizeOverdraw(std::vector<uint32_t>& ioIndices,
+    const Span<Vec3f>& inVerticesPositions,
+    const float inThreshold,
+    const std::size_t inCacheSize)
+{
+  EXPECTS(ioIndices.size() % 3 == 0);
+  EXPECTS(inThreshold >= 1.0f);
+
+  const auto number_of_triangles = (ioIndices.size() / 3);
+  if (number_of_triangles == 0)
+    return;
+
+  const auto* vertices_positions = inVerticesPositions.GetData();
+  const auto number_of_vertices = inVerticesPositions.GetNumberOfElements();
+
+  // Hard boundaries: the triangles where the cache gets fully flushed (3 misses), so reordering there is free
+  std::vector<std::size_t> hard_clusters_begins;
+  {
+    FIFOCacheSimulator cache(number_of_vertices, inCacheSize);
+    for (std::size_t triangle_id = 0; triangle_id < number_of_triangles; ++triangle_id)
+    {
+      if (cache.AddTriangle(ioIndices.data() + triangle_id * 3) == 3 || triangle_id == 0)
+        hard_clusters_begins.push_back(triangle_id);
+    }
+    hard_clusters_begins.push_back(number_of_triangles);
+  }
+
+  // Soft boundaries: split each hard cluster wherever the ACMR since the last split (starting with an empty cache) is
+  // within the threshold of the cluster one
+  std::vector<std::size_t> clusters_begins;
+  {
+    FIFOCacheSimulator cache(number_of_vertices, inCacheSize);
+    for (std::size_t hard_cluster_id = 0; hard_cluster_id + 1 < hard_clusters_begins.size(); ++hard_cluster_id)
+    {
+      const auto hard_cluster_begin = hard_clusters_begins[hard_cluster_id];
+      const auto hard_cluster_end = hard_clusters_begins[hard_cluster_id + 1];
+
+      cache.Reset();
+      std::size_t hard_cluster_misses = 0;
+      for (auto triangle_id = hard_cluster_begin; triangle_id < hard_cluster_end; ++triangle_id)
+        hard_cluster_misses += cache.AddTriangle(ioIndices.data() + triangle_id * 3);
+      const auto max_acmr
+          = inThreshold * static_cast<float>(hard_cluster_misses) / (hard_cluster_end - hard_cluster_begin);
+
+      cache.Reset();
+      clusters_begins.push_back(hard_cluster_begin);
+      std::size_t misses = 0;
+      std::size_t triangles = 0;
+      for (auto triangle_id = hard_cluster_begin; triangle_id < hard_cluster_end; ++triangle_id)
+      {
+        misses += cache.AddTriangle(ioIndices.data() + triangle_id * 3);
+        ++triangles;
+        if (static_cast<float>(misses) / triangles <= max_acmr && triangle_id + 1 < hard_cluster_end)
+        {
+          clusters_begins.push_back(triangle_id + 1);
+          cache.Reset();
+          misses = 0;
+          triangles = 0;
+        }
+      }
+    }
+    clusters_begins.push_back(number_of_triangles);
+  }
+
+  const auto number_of_clusters = (clusters_begins.size() - 1);
+  if (number_of_clusters <= 1)
+    return;
+
+  // Sort the clusters by how much they face outwards from the mesh centroid, so that the outer ones are drawn first
+  // and occlude the rest
+  std::vector<Vec3f> clusters_centroids(number_of_clusters, Zero<Vec3f>());
+  std::vector<Vec3f> clusters_normals(number_of_clusters, Zero<Vec3f>());
+  auto mesh_centroid = Zero<Vec3f>();
+  float mesh_area = 0.0f;
+  for (std::size_t cluster_id = 0; cluster_id < number_of_clusters; ++cluster_id)
+  {
+    float cluster_area = 0.0f;
+    for (auto triangle_id = clusters_begins[cluster_id]; triangle_id < clusters_begins[cluster_id + 1]; ++triangle_id)
+    {
+      const auto& p0 = vertices_positions[ioIndices[triangle_id * 3 + 0]];
+      const auto& p1 = vertices_positions[ioIndices[triangle_id * 3 + 1]];
+      const auto& p2 = vertices_positions[ioIndices[triangle_id * 3 + 2]];
+      const auto area_weighted_normal = Cross(p1 - p0, p2 - p0); // Length is twice the area
+      const auto area = Length(area_weighted_normal);
+      clusters_centroids[cluster_id] += (p0 + p1 + p2) * area;
+      clusters_normals[cluster_id] += area_weighted_normal;
+      cluster_area += area;
+    }
+    mesh_centroid += clusters_centroids[cluster_id];
+    mesh_area += cluster_area;
+    if (cluster_area > 0.0f)
+      clusters_centroids[cluster_id] /= (cluster_area * 3.0f);
+  }
+  if (mesh_area > 0.0f)
+    mesh_centroid /= (mesh_area * 3.0f);
+
+  std::vector<float> clusters_sort_keys(number_of_clusters);
+  for (std::size_t cluster_id = 0; cluster_id < number_of_clusters; ++cluster_id)
+  {
+    clusters_sort_keys[cluster_id]
+        = Dot(clusters_centroids[cluster_id] - mesh_centroid, NormalizedSafe(clusters_normals[cluster_id]));
+  }
+
+  std::vector<std::size_t> sorted_clusters_ids(number_of_clusters);
+  std::iota(sorted_clusters_ids.begin(), sorted_clusters_ids.end(), 0);
+  std::stable_sort(sorted_clusters_ids.begin(),
+      sorted_clusters_ids.end(),
+      [&](const std::size_t inLHS, const std::size_t inRHS)
+      { return clusters_sort_keys[inLHS] > clusters_sort_keys[inRHS]; });
+
+  std::vector<uint32_t> sorted_indices;
+  sorted_indices.reserve(ioIndices.size());
+  for (const auto cluster_id : sorted_clusters_ids)
+  {
+    sorted_indices.insert(sorted_indices.end(),
+        ioIndices.cbegin() + clusters_begins[cluster_id] * 3,
+        ioIndices.cbegin() + clusters_begins[cluster_id + 1] * 3);
+  }
+  ioIndices = std::move(sorted_indices);
+}
+
+std::vector<uint32_t> VertexCacheOptimizer::OptimizeVertexFetch(std::vector<uint32_t>& ioIndices,
+    const std::size_t inNumberOfVertices)
+{
+  std::vector<uint32_t> remap(inNumberOfVertices, InvalidVertexId);
+  uint32_t next_vertex_id = 0;
+  for (auto& vertex_id : ioIndices)
+  {
+    if (remap[vertex_id] == InvalidVertexId)
+      remap[vertex_id] = next_vertex_id++;
+    vertex_id = remap[vertex_id];
+  }
+  return remap;
+}
+}
@@ -10,12 +10,15 @@ const std::shared_ptr<Texture2D> Material2D::GetTexture() const { return mTextur
 
 void Material2D::Bind(ShaderProgram& ioShaderProgram)
 {
+  static const auto MaterialTextureUniform = UniformHandle { "UMaterialTexture" };
+  static const auto MaterialColorUniform = UniformHandle { "UMaterialColor" };
+
   if (mTexture)
     mTexture->BindToTextureUnit(0);
   else
     TextureFactory::GetOneTexture()->BindToTextureUnit(0);
 
-  ioShaderProgram.SetUniformSafe("UMaterialTexture", 0);
-  ioShaderProgram.SetUniformSafe("UMaterialColor", mColor);
+  ioShaderProgram.SetUniformSafe(MaterialTextureUniform, 0);
+  ioShaderProgram.SetUniformSafe(MaterialColorUniform, mColor);
 }
 }
\ No newline at end of file
@@ -22,19 +22,25 @@ bool Material3D::IsLightingEnabled() const { return mLightingEnabled; }
 
 void Material3D::Bind(ShaderProgram& ioShaderProgram)
 {
+  static const auto MaterialTextureUniform = UniformHandle { "UMaterialTexture" };
+  static const auto MaterialLightingEnabledUniform = UniformHandle { "UMaterialLightingEnabled" };
+  static const auto MaterialDiffuseColorUniform = UniformHandle { "UMaterialDiffuseColor" };
+  static const auto MaterialSpecularIntensityUniform = UniformHandle { "UMaterialSpecularIntensity" };
+  static const auto MaterialSpecularExponentUniform = UniformHandle { "UMaterialSpecularExponent" };
+
   if (mTexture)
     mTexture->BindToTextureUnit(0);
   else
     TextureFactory::GetOneTexture()->BindToTextureUnit(0);
 
-  ioShaderProgram.SetUniformSafe("UMaterialTexture", 0);
+  ioShaderProgram.SetUniformSafe(MaterialTextureUniform, 0);
 
-  ioShaderProgram.SetUniformSafe("UMaterialLightingEnabled", mLightingEnabled);
-  ioShaderProgram.SetUniformSafe("UMaterialDiffuseColor", mDiffuseColor);
+  ioShaderProgram.SetUniformSafe(MaterialLightingEnabledUniform, mLightingEnabled);
+  ioShaderProgram.SetUniformSafe(MaterialDiffuseColorUniform, mDiffuseColor);
   if (mLightingEnabled)
   {
-    ioShaderProgram.SetUniformSafe("UMaterialSpecularIntensity", mSpecularIntensity);
-    ioShaderProgram.SetUniformSafe("UMaterialSpecularExponent", mSpecularExponent);
+    ioShaderProgram.SetUniformSafe(MaterialSpecularIntensityUniform, mSpecularIntensity);
+    ioShaderProgram.SetUniformSafe(MaterialSpecularExponentUniform, mSpecularExponent);
   }
 }
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <ez/MeshDrawDataCache.h>
+#include <iterator>
+
+namespace ez
+{
+MeshDrawDataCache::MeshDrawDataCache(const std::size_t inMaxNumberOfEntries, const std::size_t inMaxSizeInBytes)
+    : mMaxNumberOfEntries(inMaxNumberOfEntries), mMaxSizeInBytes(inMaxSizeInBytes)
+{
+}
+
+std::shared_ptr<const MeshDrawData> MeshDrawDataCache::Get(const Mesh& inMesh)
+{
+  auto entry_map_it = mEntriesMap.find(&inMesh);
+  if (entry_map_it == mEntriesMap.end())
+  {
+    Entry new_entry;
+    new_entry.mMesh = &inMesh;
+    new_entry.mGeneration = (inMesh.GetGeneration() - 1); // Forces the upload below
+    new_entry.mMeshDrawData = std::make_shared<MeshDrawData>();
+    mEntries.push_front(std::move(new_entry));
+    entry_map_it = mEntriesMap.emplace(&inMesh, mEntries.begin()).first;
+  }
+  else
+  {
+    mEntries.splice(mEntries.begin(), mEntries, entry_map_it->second); // Move to front (most recently used)
+  }
+
+  auto& entry = *entry_map_it->second;
+  if (entry.mGeneration == inMesh.GetGeneration())
+  {
+    ++mStats.mNumberOfHits;
+    return entry.mMeshDrawData;
+  }
+
+  // New or modified mesh, upload it (only its dirty ranges if possible)
+  ++mStats.mNumberOfUploads;
+  mSizeInBytes -= entry.mMeshDrawData->GetSizeInBytes();
+  entry.mMeshDrawData->Update(inMesh);
+  mStats.mUploadedSizeInBytes += entry.mMeshDrawData->GetLastUploadSizeInBytes();
+  entry.mGeneration = inMesh.GetGeneration();
+  mSizeInBytes += entry.mMeshDrawData->GetSizeInBytes();
+
+  const auto mesh_draw_data = entry.mMeshDrawData;
+  EvictIfNeeded();
+  return mesh_draw_data;
+}
+
+void MeshDrawDataCache::Evict(const Mesh& inMesh)
+{
+  const auto entry_map_it = mEntriesMap.find(&inMesh);
+  if (entry_map_it != mEntriesMap.end())
+    Evict(entry_map_it->second);
+}
+
+void MeshDrawDataCache::Clear()
+{
+  mEntries.clear();
+  mEntriesMap.clear();
+  mSizeInBytes = 0;
+}
+
+void MeshDrawDataCache::SetMaxNumberOfEntries(const std::size_t inMaxNumberOfEntries)
+{
+  mMaxNumberOfEntries = inMaxNumberOfEntries;
+  EvictIfNeeded();
+}
+
+void MeshDrawDataCache::SetMaxSizeInBytes(const std::size_t inMaxSizeInBytes)
+{
+  mMaxSizeInBytes = inMaxSizeInBytes;
+  EvictIfNeeded();
+}
+
+void MeshDrawDataCache::EvictIfNeeded()
+{
+  // Never evict the most recently used entry, it might be about to be drawn
+  while ((mEntries.size() > mMaxNumberOfEntries || mSizeInBytes > mMaxSizeInBytes) && mEntries.size() > 1)
+    Evict(std::prev(mEntries.end()));
+}
+
+void MeshDrawDataCache::Evict(const EntriesList::iterator inEntryIt)
+{
+  mSizeInBytes -= inEntryIt->mMeshDrawData->GetSizeInBytes();
+  mEntriesMap.erase(inEntryIt->mMesh);
+  mEntries.erase(inEntryIt);
+  ++mStats.mNumberOfEvictions;
+}
+}
@@ -0,0 +1,88 @@
+#include <ez/PrimitiveDrawDataCache.h>
+#include <ez/Macros.h>
+#include <ez/MeshFactory.h>
+#include <functional>
+
+namespace ez
+{
+std::size_t PrimitiveDrawDataCache::Key::Hash::operator()(const Key& inKey) const
+{
+  auto hash = std::hash<int>()(static_cast<int>(inKey.mPrimitive));
+  const auto combine = [&hash](const std::size_t inValueHash)
+  { hash ^= inValueHash + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+  combine(std::hash<std::size_t>()(inKey.mNumLatitudes));
+  combine(std::hash<std::size_t>()(inKey.mNumLongitudes));
+  combine(std::hash<float>()(inKey.mParameter));
+  return hash;
+}
+
+PrimitiveDrawDataCache::PrimitiveDrawDataCache(const std::size_t inMaxSizeInBytes) : mMaxSizeInBytes(inMaxSizeInBytes)
+{
+}
+
+std::shared_ptr<const MeshDrawData> PrimitiveDrawDataCache::Get(const Key& inKey)
+{
+  const auto entry_it = mEntriesMap.find(inKey);
+  if (entry_it != mEntriesMap.end())
+  {
+    ++mStats.mNumberOfHits;
+    mEntries.splice(mEntries.begin(), mEntries, entry_it->second); // Move to front (most recently used)
+    return entry_it->second->mMeshDrawData;
+  }
+
+  ++mStats.mNumberOfMisses;
+
+  // Primitives are built once and drawn many times, so they are worth optimizing
+  auto mesh_draw_data = std::make_shared<const MeshDrawData>(CreateMesh(inKey), true);
+  mSizeInBytes += mesh_draw_data->GetSizeInBytes();
+  mEntries.push_front(Entry { inKey, mesh_draw_data });
+  mEntriesMap.emplace(inKey, mEntries.begin());
+
+  EvictIfNeeded();
+  return mesh_draw_data;
+}
+
+void PrimitiveDrawDataCache::Clear()
+{
+  mEntries.clear();
+  mEntriesMap.clear();
+  mSizeInBytes = 0;
+}
+
+void PrimitiveDrawDataCache::SetMaxSizeInBytes(const std::size_t inMaxSizeInBytes)
+{
+  mMaxSizeInBytes = inMaxSizeInBytes;
+  EvictIfNeeded();
+}
+
+Mesh PrimitiveDrawDataCache::CreateMesh(const Key& inKey)
+{
+  switch (inKey.mPrimitive)
+  {
+  case EPrimitive::BOX: return MeshFactory::GetBox();
+  case EPrimitive::SPHERE: return MeshFactory::GetSphere(inKey.mNumLatitudes, inKey.mNumLongitudes);
+  case EPrimitive::HEMISPHERE: return MeshFactory::GetHemisphere(inKey.mNumLatitudes, inKey.mNumLongitudes);
+  case EPrimitive::CONE: return MeshFactory::GetCone(inKey.mNumLongitudes);
+  case EPrimitive::CYLINDER: return MeshFactory::GetCylinder(inKey.mNumLongitudes);
+  case EPrimitive::CAPSULE:
+    return MeshFactory::GetCapsule(1.0f, inKey.mParameter, inKey.mNumLatitudes, inKey.mNumLongitudes);
+  case EPrimitive::TORUS: return MeshFactory::GetTorus(inKey.mNumLatitudes, inKey.mNumLongitudes, inKey.mParameter);
+  case EPrimitive::PLANE: return MeshFactory::GetPlane(inKey.mNumLatitudes, inKey.mNumLongitudes);
+  case EPrimitive::CIRCLE: return MeshFactory::GetCircle(inKey.mNumLongitudes);
+  }
+  THROW_EXCEPTION("Unknown primitive");
+}
+
+void PrimitiveDrawDataCache::EvictIfNeeded()
+{
+  // Never evict the most recently used entry, it might be about to be drawn
+  while (mSizeInBytes > mMaxSizeInBytes && mEntries.size() > 1)
+  {
+    const auto& least_recently_used_entry = mEntries.back();
+    mSizeInBytes -= least_recently_used_entry.mMeshDrawData->GetSizeInBytes();
+    mEntriesMap.erase(least_recently_used_entry.mKey);
+    mEntries.pop_back();
+    ++mStats.mNumberOfEvictions;
+  }
+}
+}
@@ -9,7 +9,6 @@
 #include <ez/Math.h>
 #include <ez/Mesh.h>
 #include <ez/MeshDrawData.h>
-#include <ez/MeshFactory.h>
 #include <ez/PointLight.h>
 #include <ez/ShaderProgram.h>
 #include <ez/ShaderProgramFactory.h>
@@ -220,7 +219,16 @@ void Renderer2D::DrawCircleSectionBoundary(const AngleRads<float> inAngle, const
   DrawCircleSectionBoundaryGeneric<float, 2>(inAngle, inNumVertices);
 }
 
-void Renderer2D::DrawCircle(const std::size_t inNumVertices) { DrawCircleSection(FullCircleRads(), inNumVertices); }
+void Renderer2D::DrawCircle(const std::size_t inNumVertices)
+{
+  // As DrawCircleSection, the first and last of the vertices are the same point: inNumVertices - 1 segments
+  if (inNumVertices <= 3)
+  {
+    DrawCircleSection(FullCircleRads(), inNumVertices);
+    return;
+  }
+  DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::CIRCLE, 0, inNumVertices - 1));
+}
 
 void Renderer2D::DrawCircleBoundary(const std::size_t inNumVertices)
 {
@@ -263,7 +271,7 @@ void Renderer2D::DrawTriangleBoundary(const Triangle2f& inTriangle)
       Segment2f { inTriangle[2], inTriangle[0] } }));
 }
 
-void Renderer2D::DrawAARect() { DrawMesh(MeshFactory::GetPlane()); }
+void Renderer2D::DrawAARect() { DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::PLANE, 2, 2)); }
 
 void Renderer2D::DrawAARect(const AARectf& inAARect)
 {
@@ -350,10 +358,16 @@ void Renderer2D::PrepareForDraw(DrawSetup& ioDrawSetup)
 
   GetMaterial().Bind(shader_program);
 
-  shader_program.SetUniformSafe("UModel", model_matrix);
-  shader_program.SetUniformSafe("UNormal", normal_matrix);
-  shader_program.SetUniformSafe("UView", view_matrix);
-  shader_program.SetUniformSafe("UProjection", projection_matrix);
-  shader_program.SetUniformSafe("UProjectionViewModel", projection_view_model_matrix);
+  static const auto ModelUniform = UniformHandle { "UModel" };
+  static const auto NormalUniform = UniformHandle { "UNormal" };
+  static const auto ViewUniform = UniformHandle { "UView" };
+  static const auto ProjectionUniform = UniformHandle { "UProjection" };
+  static const auto ProjectionViewModelUniform = UniformHandle { "UProjectionViewModel" };
+
+  shader_program.SetUniformSafe(ModelUniform, model_matrix);
+  shader_program.SetUniformSafe(NormalUniform, normal_matrix);
+  shader_program.SetUniformSafe(ViewUniform, view_matrix);
+  shader_program.SetUniformSafe(ProjectionUniform, projection_matrix);
+  shader_program.SetUniformSafe(ProjectionViewModelUniform, projection_view_model_matrix);
 }
 }
\ No newline at end of file
@@ -9,13 +9,16 @@
 #include <ez/HyperSphere.h>
 #include <ez/Math.h>
 #include <ez/MeshDrawData.h>
-#include <ez/MeshFactory.h>
+#include <ez/MeshLODChain.h>
+#include <ez/MeshletBuilder.h>
 #include <ez/PointLight.h>
 #include <ez/ShaderProgram.h>
 #include <ez/ShaderProgramFactory.h>
 #include <ez/TextureFactory.h>
 #include <ez/UBO.h>
 #include <ez/Window.h>
+#include <algorithm>
+#include <cmath>
 
 namespace ez
 {
@@ -23,7 +26,6 @@ bool Renderer3D::sStaticResourcesInited = false;
 std::shared_ptr<ShaderProgram> Renderer3D::sOnlyColorShaderProgram;
 std::shared_ptr<ShaderProgram> Renderer3D::sMeshShaderProgram;
 std::shared_ptr<ShaderProgram> Renderer3D::sTextShaderProgram;
-std::shared_ptr<MeshDrawData> Renderer3D::sCone;
 
 Renderer3D::Renderer3D()
 {
@@ -34,8 +36,6 @@ Renderer3D::Renderer3D()
     sMeshShaderProgram = ShaderProgramFactory::GetMeshShaderProgram();
     sTextShaderProgram = ShaderProgramFactory::GetTextShaderProgram();
 
-    sCone = std::make_shared<MeshDrawData>(MeshFactory::GetCone(32));
-
     sStaticResourcesInited = true;
   }
 
@@ -121,6 +121,35 @@ void Renderer3D::AdaptCameraToWindow(const Window& inWindow)
     perspective_camera->SetAspectRatio(inWindow.GetFramebufferAspectRatio());
 }
 
+MeshletBuilder::CullingView Renderer3D::GetMeshletsCullingView() const
+{
+  const auto perspective_camera = GetPerspectiveCamera();
+  EXPECTS(perspective_camera);
+
+  // Planes through the camera position (the near and far ones aside), with normals pointing inwards
+  const auto position = perspective_camera->GetPosition();
+  const auto forward = perspective_camera->GetForward();
+  const auto right = perspective_camera->GetRight();
+  const auto up = perspective_camera->GetUp();
+  const auto tan_half_vertical_angle = Tan(perspective_camera->GetFullAngleOfView() * 0.5f);
+  const auto tan_half_horizontal_angle = tan_half_vertical_angle * perspective_camera->GetAspectRatio();
+  const auto plane_through_point = [](const Vec3f& inNormal, const Vec3f& inPoint)
+  {
+    const auto unit_normal = NormalizedSafe(inNormal);
+    return Vec4f { unit_normal[0], unit_normal[1], unit_normal[2], -Dot(unit_normal, inPoint) };
+  };
+
+  MeshletBuilder::CullingView culling_view;
+  culling_view.mCameraPosition = position;
+  culling_view.mFrustumPlanes = { plane_through_point(forward, position + forward * perspective_camera->GetZNear()),
+    plane_through_point(-forward, position + forward * perspective_camera->GetZFar()),
+    plane_through_point(forward * tan_half_horizontal_angle + right, position),
+    plane_through_point(forward * tan_half_horizontal_angle - right, position),
+    plane_through_point(forward * tan_half_vertical_angle + up, position),
+    plane_through_point(forward * tan_half_vertical_angle - up, position) };
+  return culling_view;
+}
+
 std::shared_ptr<PerspectiveCameraf> Renderer3D::GetPerspectiveCamera()
 {
   return std::dynamic_pointer_cast<PerspectiveCameraf>(mState.GetCurrent<Renderer3D::EStateId::CAMERA>());
@@ -180,15 +209,67 @@ void Renderer3D::DrawMesh(const Mesh& inMesh, const RendererGPU::EDrawType inDra
 void Renderer3D::DrawMesh(const MeshDrawData& inMeshDrawData, const RendererGPU::EDrawType inDrawType)
 {
   SetShaderProgram(sMeshShaderProgram);
-  RendererGPU::DrawMesh(inMeshDrawData, inDrawType);
+  mMeshDrawDataBeingDrawn = &inMeshDrawData;
+
+  const auto& meshlets = inMeshDrawData.GetMeshlets();
+  if (!meshlets.empty() && GetPerspectiveCamera())
+  {
+    // Back facing meshlets are only hidden when solid faces are culled, wireframes and points still show them
+    const auto cull_back_facing = (GetCullFaceEnabled() && inDrawType == RendererGPU::EDrawType::SOLID);
+    MeshletBuilder::Cull(MakeSpan(meshlets),
+        GetMeshletsCullingView(),
+        GetTransformMatrix(),
+        cull_back_facing,
+        mVisibleMeshletsIds);
+    if (mVisibleMeshletsIds.size() == meshlets.size())
+      RendererGPU::DrawMesh(inMeshDrawData, inDrawType);
+    else
+      RendererGPU::DrawMeshlets(inMeshDrawData, MakeSpan(mVisibleMeshletsIds), inDrawType);
+  }
+  else
+  {
+    RendererGPU::DrawMesh(inMeshDrawData, inDrawType);
+  }
+
+  mMeshDrawDataBeingDrawn = nullptr;
+}
+
+void Renderer3D::DrawMesh(const MeshLODChain& inMeshLODChain, const RendererGPU::EDrawType inDrawType)
+{
+  const auto perspective_camera = GetPerspectiveCamera();
+  if (!perspective_camera)
+  {
+    DrawMesh(*inMeshLODChain.GetLevel(0).mMeshDrawData, inDrawType);
+    return;
+  }
+
+  // Bounding sphere in world space, scaled by the largest scale of the transform
+  const auto& transform_matrix = GetTransformMatrix();
+  const auto& bounding_sphere = inMeshLODChain.GetBoundingSphere();
+  const auto transform_scale = std::max({ Length(XYZ(transform_matrix * XYZ0(Right<Vec3f>()))),
+      Length(XYZ(transform_matrix * XYZ0(Up<Vec3f>()))),
+      Length(XYZ(transform_matrix * XYZ0(Back<Vec3f>()))) });
+  const auto world_center = XYZ(transform_matrix * XYZ1(bounding_sphere.GetCenter()));
+  const auto world_radius = bounding_sphere.GetRadius() * transform_scale;
+
+  // Pixels per world unit at the closest point of the sphere (the finest level from inside it)
+  const auto distance = std::max(Length(world_center - perspective_camera->GetPosition()) - world_radius,
+      perspective_camera->GetZNear());
+  const auto viewport_height = static_cast<float>(GetViewport().GetSize()[1]);
+  const auto pixels_per_world_unit
+      = viewport_height / (2.0f * distance * Tan(perspective_camera->GetFullAngleOfView() * 0.5f));
+
+  const auto level_id = inMeshLODChain.SelectLevel(pixels_per_world_unit * transform_scale, std::exp2(mLODBias));
+  DrawMesh(*inMeshLODChain.GetLevel(level_id).mMeshDrawData, inDrawType);
 }
 
 void Renderer3D::DrawVAOElements(const VAO& inVAO,
     const GL::Size inNumberOfElementsToDraw,
-    const GL::EPrimitivesType inPrimitivesType)
+    const GL::EPrimitivesType inPrimitivesType,
+    const GL::EDataType inIndicesDataType)
 {
   SetShaderProgram(sMeshShaderProgram);
-  RendererGPU::DrawVAOElements(inVAO, inNumberOfElementsToDraw, inPrimitivesType);
+  RendererGPU::DrawVAOElements(inVAO, inNumberOfElementsToDraw, inPrimitivesType, inIndicesDataType);
 }
 
 void Renderer3D::DrawVAOArrays(const VAO& inVAO,
@@ -208,7 +289,7 @@ void Renderer3D::DrawArrow(const Segment3f& inArrowSegment)
   Translate(inArrowSegment.GetDestiny());
   Rotate(Orientation(inArrowSegment));
   Scale(Vec3f { 0.05f, 0.05f, 0.08f });
-  DrawMesh(*sCone);
+  DrawCone(32);
 }
 
 void Renderer3D::DrawAxes()
@@ -302,7 +383,7 @@ void Renderer3D::DrawAABoxBoundary(const AABoxf& inAABox)
   DrawAABoxBoundary();
 }
 
-void Renderer3D::DrawAABox() { DrawMesh(MeshFactory::GetBox()); }
+void Renderer3D::DrawAABox() { DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::BOX)); }
 
 void Renderer3D::DrawAABoxBoundary()
 {
@@ -320,13 +401,13 @@ void Renderer3D::DrawAABoxBoundary()
       Segment3f { Vec3f { 1.0f, -1.0f, -1.0f }, Vec3f { 1.0f, 1.0f, -1.0f } } }));
 }
 
-void Renderer3D::DrawAARect() { DrawMesh(MeshFactory::GetPlane()); }
+void Renderer3D::DrawAARect() { DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::PLANE, 2, 2)); }
 
 void Renderer3D::DrawAARect(const AARectf& inAARect)
 {
   Translate(XY0(Center(inAARect)));
   Scale(XY1(inAARect.GetSize()) * 0.5f);
-  DrawMesh(MeshFactory::GetPlane());
+  DrawAARect();
 }
 
 void Renderer3D::DrawAARectBoundary()
@@ -358,13 +439,25 @@ void Renderer3D::DrawCapsule(const Capsule3f& inCapsule,
     const std::size_t inNumHemisphereLatitudes,
     const std::size_t inNumLongitudes)
 {
+  if (IsVeryEqual(inCapsule.GetRadius(), 0.0f))
+    return;
+
+  // Capsules with the same length/radius ratio share the same mesh, scaled by the radius. The ratio is quantized, so
+  // that continuously animated capsules reuse a few meshes instead of filling the cache with a new one every frame
+  // (the drawn length is off by at most 1/128 of the radius).
+  constexpr auto length_radius_ratio_steps = 64.0f;
+  const auto length_radius_ratio
+      = std::round(Length(inCapsule.GetSegment()) / inCapsule.GetRadius() * length_radius_ratio_steps)
+      / length_radius_ratio_steps;
+
   const auto transform_guard = GetGuard<Renderer3D::EStateId::TRANSFORM_MATRIX>();
   Translate(Center(inCapsule));
   Rotate(Orientation(inCapsule));
-  DrawMesh(MeshFactory::GetCapsule(inCapsule.GetRadius(),
-      Length(inCapsule.GetSegment()),
+  Scale(inCapsule.GetRadius());
+  DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::CAPSULE,
       inNumHemisphereLatitudes,
-      inNumLongitudes));
+      inNumLongitudes,
+      length_radius_ratio));
 }
 
 void Renderer3D::DrawCylinder(const Cylinderf& inCylinder, const std::size_t inNumLongitudes)
@@ -377,23 +470,30 @@ void Renderer3D::DrawCylinder(const Cylinderf& inCylinder, const std::size_t inN
   DrawCylinder(inNumLongitudes);
 }
 
-void Renderer3D::DrawCylinder(std::size_t inNumLongitudes) { DrawMesh(MeshFactory::GetCylinder(inNumLongitudes)); }
+void Renderer3D::DrawCylinder(std::size_t inNumLongitudes)
+{
+  DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::CYLINDER, 0, inNumLongitudes));
+}
 
 void Renderer3D::DrawTorus(std::size_t inNumLatitudes, std::size_t inNumLongitudes, float inHoleSize)
 {
-  DrawMesh(MeshFactory::GetTorus(inNumLatitudes, inNumLongitudes, inHoleSize));
+  DrawMesh(
+      *GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::TORUS, inNumLatitudes, inNumLongitudes, inHoleSize));
 }
 
-void Renderer3D::DrawCone(std::size_t inNumLongitudes) { DrawMesh(MeshFactory::GetCone(inNumLongitudes)); }
+void Renderer3D::DrawCone(std::size_t inNumLongitudes)
+{
+  DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::CONE, 0, inNumLongitudes));
+}
 
 void Renderer3D::DrawHemisphere(std::size_t inNumLatitudes, std::size_t inNumLongitudes)
 {
-  DrawMesh(MeshFactory::GetHemisphere(inNumLatitudes, inNumLongitudes));
+  DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::HEMISPHERE, inNumLatitudes, inNumLongitudes));
 }
 
 void Renderer3D::DrawSphere(std::size_t inNumLatitudes, std::size_t inNumLongitudes)
 {
-  DrawMesh(MeshFactory::GetSphere(inNumLatitudes, inNumLongitudes));
+  DrawMesh(*GetPrimitiveDrawData(PrimitiveDrawDataCache::EPrimitive::SPHERE, inNumLatitudes, inNumLongitudes));
 }
 
 void Renderer3D::DrawSphere(const Spheref& inSphere, std::size_t inNumLatitudes, std::size_t inNumLongitudes)
@@ -482,42 +582,61 @@ void Renderer3D::PrepareForDraw(DrawSetup& ioDrawSetup)
 
   GetMaterial().Bind(shader_program);
 
-  const auto& model_matrix = GetTransformMatrix();
+  // Quantized positions are mapped to model space along with the model matrix. Normals are not quantized.
+  const auto* mesh_draw_data = mMeshDrawDataBeingDrawn;
+  const auto model_matrix = (mesh_draw_data ? GetTransformMatrix() * mesh_draw_data->GetPositionsDequantizationMatrix()
+                                            : GetTransformMatrix());
+  const auto octahedral_normals = (mesh_draw_data && mesh_draw_data->HasOctahedralNormals());
   const auto& current_camera = GetCamera();
   const auto view_matrix = current_camera->GetViewMatrix();
-  const auto normal_matrix = NormalMat(model_matrix);
+  const auto normal_matrix = NormalMat(GetTransformMatrix());
   const auto projection_matrix = current_camera->GetProjectionMatrix();
   const auto projection_view_model_matrix = projection_matrix * view_matrix * model_matrix;
 
-  shader_program.SetUniformSafe("UModel", model_matrix);
-  shader_program.SetUniformSafe("UNormal", normal_matrix);
-  shader_program.SetUniformSafe("UView", view_matrix);
-  shader_program.SetUniformSafe("UProjection", projection_matrix);
-  shader_program.SetUniformSafe("UProjectionViewModel", projection_view_model_matrix);
+  static const auto ModelUniform = UniformHandle { "UModel" };
+  static const auto NormalUniform = UniformHandle { "UNormal" };
+  static const auto OctahedralNormalsUniform = UniformHandle { "UOctahedralNormals" };
+  static const auto ViewUniform = UniformHandle { "UView" };
+  static const auto ProjectionUniform = UniformHandle { "UProjection" };
+  static const auto ProjectionViewModelUniform = UniformHandle { "UProjectionViewModel" };
+  static const auto CameraWorldPositionUniform = UniformHandle { "UCameraWorldPosition" };
+  static const auto CameraWorldDirectionUniform = UniformHandle { "UCameraWorldDirection" };
+  static const auto SceneAmbientColorUniform = UniformHandle { "USceneAmbientColor" };
+  static const auto NumberOfDirectionalLightsUniform = UniformHandle { "UNumberOfDirectionalLights" };
+  static const auto NumberOfPointLightsUniform = UniformHandle { "UNumberOfPointLights" };
+  static const auto DirectionalLightsUniformBlock = UniformBlockHandle { "UBlockDirectionalLights" };
+  static const auto PointLightsUniformBlock = UniformBlockHandle { "UBlockPointLights" };
+
+  shader_program.SetUniformSafe(ModelUniform, model_matrix);
+  shader_program.SetUniformSafe(NormalUniform, normal_matrix);
+  shader_program.SetUniformSafe(OctahedralNormalsUniform, octahedral_normals);
+  shader_program.SetUniformSafe(ViewUniform, view_matrix);
+  shader_program.SetUniformSafe(ProjectionUniform, projection_matrix);
+  shader_program.SetUniformSafe(ProjectionViewModelUniform, projection_view_model_matrix);
 
   const auto camera_world_position = current_camera->GetPosition();
   const auto camera_world_direction = Direction(current_camera->GetRotation());
-  shader_program.SetUniformSafe("UCameraWorldPosition", camera_world_position);
-  shader_program.SetUniformSafe("UCameraWorldDirection", camera_world_direction);
+  shader_program.SetUniformSafe(CameraWorldPositionUniform, camera_world_position);
+  shader_program.SetUniformSafe(CameraWorldDirectionUniform, camera_world_direction);
 
-  shader_program.SetUniformSafe("USceneAmbientColor", GetSceneAmbientColor());
+  shader_program.SetUniformSafe(SceneAmbientColorUniform, GetSceneAmbientColor());
 
   // Lights
   if (GetMaterial().IsLightingEnabled())
   {
     // Directional lights
-    shader_program.SetUniformBlockBindingSafe("UBlockDirectionalLights", 0);
+    shader_program.SetUniformBlockBindingSafe(DirectionalLightsUniformBlock, 0);
     const auto& directional_lights = mState.GetCurrent<Renderer3D::EStateId::DIRECTIONAL_LIGHTS>();
     mDirectionalLightsUBO.BufferSubData(MakeSpan(directional_lights));
     mDirectionalLightsUBO.BindToBindingPoint(0);
-    shader_program.SetUniformSafe("UNumberOfDirectionalLights", static_cast<int>(directional_lights.size()));
+    shader_program.SetUniformSafe(NumberOfDirectionalLightsUniform, static_cast<int>(directional_lights.size()));
 
     // Point lights
-    shader_program.SetUniformBlockBindingSafe("UBlockPointLights", 1);
+    shader_program.SetUniformBlockBindingSafe(PointLightsUniformBlock, 1);
     const auto& point_lights = mState.GetCurrent<Renderer3D::EStateId::POINT_LIGHTS>();
     mPointLightsUBO.BufferSubData(MakeSpan(point_lights));
     mPointLightsUBO.BindToBindingPoint(1);
-    shader_program.SetUniformSafe("UNumberOfPointLights", static_cast<int>(point_lights.size()));
+    shader_program.SetUniformSafe(NumberOfPointLightsUniform, static_cast<int>(point_lights.size()));
   }
 }
 }
\ No newline at end of file
@@ -14,11 +14,30 @@
 #include <ez/TextureOperations.h>
 #include <ez/UBO.h>
 #include <ez/Window.h>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 namespace ez
 {
+bool RendererGPU::sStaticResourcesInited = false;
+std::unique_ptr<StreamingVBO> RendererGPU::sStreamingVBO;
+std::unique_ptr<PrimitiveDrawDataCache> RendererGPU::sPrimitiveDrawDataCache;
+std::unique_ptr<MeshDrawDataCache> RendererGPU::sMeshDrawDataCache;
+
 RendererGPU::RendererGPU()
 {
+  // Init static resources
+  if (!sStaticResourcesInited)
+  {
+    sStreamingVBO = std::make_unique<StreamingVBO>();
+    sPrimitiveDrawDataCache = std::make_unique<PrimitiveDrawDataCache>();
+    sMeshDrawDataCache = std::make_unique<MeshDrawDataCache>();
+
+    sStaticResourcesInited = true;
+  }
+
   // Init default render target and default framebuffer
   mDefaultRenderTarget
       = std::make_shared<RenderTarget>(GL::ETextureFormat::RGBA8, GL::ETextureFormat::DEPTH24_STENCIL8);
@@ -148,8 +167,8 @@ void RendererGPU::DrawCustom(const std::function<void()>& inCustomDrawFunction)
 
 void RendererGPU::DrawMesh(const Mesh& inMesh, const RendererGPU::EDrawType inDrawType)
 {
-  const auto mesh_draw_data = MeshDrawData { inMesh };
-  DrawMesh(mesh_draw_data, inDrawType);
+  const auto mesh_draw_data = sMeshDrawDataCache->Get(inMesh);
+  DrawMesh(*mesh_draw_data, inDrawType);
 }
 void RendererGPU::DrawMesh(const MeshDrawData& inMeshDrawData, const RendererGPU::EDrawType inDrawType)
 {
@@ -159,11 +178,77 @@ void RendererGPU::DrawMesh(const MeshDrawData& inMeshDrawData, const RendererGPU
   const auto primitives_type
       = (inDrawType == EDrawType::POINTS) ? GL::EPrimitivesType::POINTS : GL::EPrimitivesType::TRIANGLES;
 
-  DrawVAOElements(inMeshDrawData.GetVAO(), inMeshDrawData.GetNumberOfElements(), primitives_type);
+  DrawVAOElements(inMeshDrawData.GetVAO(),
+      inMeshDrawData.GetNumberOfElements(),
+      primitives_type,
+      inMeshDrawData.GetIndicesDataType());
 
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); // TODO: Restore this properly
 }
 
+void RendererGPU::DrawMeshlets(const MeshDrawData& inMeshDrawData,
+    const Span<uint32_t>& inMeshletsIds,
+    const RendererGPU::EDrawType inDrawType)
+{
+  if (inMeshletsIds.GetNumberOfElements() == 0)
+    return;
+
+  // Element ranges of the meshlets, merging the consecutive ones
+  const auto& meshlets = inMeshDrawData.GetMeshlets();
+  const auto index_size_in_bytes
+      = (inMeshDrawData.GetIndicesDataType() == GLTypeTraits<uint16_t>::GLType) ? sizeof(uint16_t) : sizeof(uint32_t);
+  std::vector<GL::Size> ranges_numbers_of_elements;
+  std::vector<const void*> ranges_indices_offsets;
+  auto range_end_element = std::numeric_limits<std::size_t>::max();
+  for (const auto meshlet_id : inMeshletsIds)
+  {
+    EXPECTS(meshlet_id < meshlets.size());
+    const auto& meshlet = meshlets[meshlet_id];
+    if (meshlet.mBeginElement == range_end_element)
+    {
+      ranges_numbers_of_elements.back() += static_cast<GL::Size>(meshlet.mNumberOfElements);
+    }
+    else
+    {
+      ranges_numbers_of_elements.push_back(static_cast<GL::Size>(meshlet.mNumberOfElements));
+      ranges_indices_offsets.push_back(
+          reinterpret_cast<const void*>(static_cast<std::uintptr_t>(meshlet.mBeginElement * index_size_in_bytes)));
+    }
+    range_end_element = (meshlet.mBeginElement + meshlet.mNumberOfElements);
+  }
+
+  // Wireframe only for this draw: the polygon mode set before is restored afterwards
+  const auto is_wireframe = (inDrawType == EDrawType::WIREFRAME);
+  const auto previous_polygon_mode
+      = (is_wireframe ? GL::GetIntegers<2>(GL::EGetEnum::POLYGON_MODE) : std::array<GL::Int, 2> {});
+  if (is_wireframe)
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+  const auto primitives_type
+      = (inDrawType == EDrawType::POINTS) ? GL::EPrimitivesType::POINTS : GL::EPrimitivesType::TRIANGLES;
+  {
+    const auto draw_setup = PrepareForDraw();
+    const auto vao_bind_guard = inMeshDrawData.GetVAO().BindGuarded();
+    GL::MultiDrawElements(primitives_type,
+        MakeSpan(ranges_numbers_of_elements),
+        inMeshDrawData.GetIndicesDataType(),
+        MakeSpan(ranges_indices_offsets));
+  }
+
+  if (is_wireframe)
+    glPolygonMode(GL_FRONT_AND_BACK, static_cast<GLenum>(previous_polygon_mode[0]));
+}
+
+std::shared_ptr<const MeshDrawData> RendererGPU::GetPrimitiveDrawData(
+    const PrimitiveDrawDataCache::EPrimitive inPrimitive,
+    const std::size_t inNumLatitudes,
+    const std::size_t inNumLongitudes,
+    const float inParameter)
+{
+  return sPrimitiveDrawDataCache->Get(
+      PrimitiveDrawDataCache::Key { inPrimitive, inNumLatitudes, inNumLongitudes, inParameter });
+}
+
 void RendererGPU::AdaptToWindow(const Window& inWindow)
 {
   SetViewport(AARecti(Zero<Vec2i>(), inWindow.GetFramebufferSize()));
@@ -174,7 +259,8 @@ void RendererGPU::DrawVAOArraysOrElements(const VAO& inVAO,
     const GL::Size inNumberOfElementsToDraw,
     const GL::EPrimitivesType inPrimitivesType,
     const bool inDrawArrays,
-    const GL::Size inBeginArraysPrimitiveIndex)
+    const GL::Size inBeginArraysPrimitiveIndex,
+    const GL::EDataType inIndicesDataType)
 {
   const auto draw_setup = PrepareForDraw();
   const auto vao_bind_guard = inVAO.BindGuarded();
@@ -185,17 +271,17 @@ void RendererGPU::DrawVAOArraysOrElements(const VAO& inVAO,
   }
   else
   {
-    static constexpr auto ElementIdType = GLTypeTraits<Mesh::VertexId>::GLType;
-    GL::DrawElements(inPrimitivesType, inNumberOfElementsToDraw, ElementIdType);
+    GL::DrawElements(inPrimitivesType, inNumberOfElementsToDraw, inIndicesDataType);
   }
 }
 
 void RendererGPU::DrawVAOElements(const VAO& inVAO,
     const GL::Size inNumberOfElementsToDraw,
-    const GL::EPrimitivesType inPrimitivesType)
+    const GL::EPrimitivesType inPrimitivesType,
+    const GL::EDataType inIndicesDataType)
 {
   constexpr auto draw_arrays = false;
-  DrawVAOArraysOrElements(inVAO, inNumberOfElementsToDraw, inPrimitivesType, draw_arrays, 0);
+  DrawVAOArraysOrElements(inVAO, inNumberOfElementsToDraw, inPrimitivesType, draw_arrays, 0, inIndicesDataType);
 }
 
 void RendererGPU::DrawVAOArrays(const VAO& inVAO,
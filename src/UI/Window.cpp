@@ -46,6 +46,8 @@ Window::Window(const Window::CreateOptions& inCreateOptions)
   if (glew_init_error != GLEW_OK)
     THROW_EXCEPTION("Error initiating GLEW");
 
+  GL::InvalidateStateCache(); // New context, nothing known about its state yet
+
   if (inCreateOptions.mUseAntialiasing)
   {
     GL::Enable(GL::EEnablable::LINE_SMOOTH);
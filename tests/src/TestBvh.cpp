@@ -0,0 +1,199 @@
+#include <ez/Bvh.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+constexpr float DistanceTolerance = 1.0e-4f;
+
+// Moller-Trumbore, from both sides, as the BVH packets test
+std::optional<float> IntersectBruteForce(const Ray3f& inRay, const Triangle3f& inTriangle)
+{
+  const auto direction = Direction(inRay);
+  const auto edge_1 = (inTriangle[1] - inTriangle[0]);
+  const auto edge_2 = (inTriangle[2] - inTriangle[0]);
+  const auto p = Cross(direction, edge_2);
+  const auto determinant = Dot(edge_1, p);
+  if (determinant == 0.0f)
+    return std::nullopt;
+
+  const auto inverse_determinant = (1.0f / determinant);
+  const auto t = (inRay.GetOrigin() - inTriangle[0]);
+  const auto u = Dot(t, p) * inverse_determinant;
+  const auto q = Cross(t, edge_1);
+  const auto v = Dot(direction, q) * inverse_determinant;
+  const auto distance = Dot(edge_2, q) * inverse_determinant;
+  if (u < 0.0f || v < 0.0f || u + v > 1.0f || distance < 0.0f)
+    return std::nullopt;
+  return distance;
+}
+
+// Random triangles all around, and clusters of overlapping ones, so that leaves have to be split unevenly
+std::vector<Triangle3f> GetTriangles(std::mt19937& ioRandomEngine, const std::size_t inNumberOfTriangles)
+{
+  std::uniform_real_distribution<float> center_distribution(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> offset_distribution(-0.5f, 0.5f);
+  const auto get_random_vec = [&](auto& ioDistribution)
+  { return Vec3f { ioDistribution(ioRandomEngine), ioDistribution(ioRandomEngine), ioDistribution(ioRandomEngine) }; };
+
+  std::vector<Triangle3f> triangles;
+  for (std::size_t i = 0; i < inNumberOfTriangles; ++i)
+  {
+    const auto center = ((i % 8) == 0 ? Vec3f { 1.0f, 1.0f, 1.0f } : get_random_vec(center_distribution));
+    triangles.emplace_back(center + get_random_vec(offset_distribution),
+        center + get_random_vec(offset_distribution),
+        center + get_random_vec(offset_distribution));
+  }
+  return triangles;
+}
+
+// Every query against testing all the triangles, for single and batched rays
+bool TestAgainstBruteForce(const std::vector<Triangle3f>& inTriangles,
+    const std::vector<Ray3f>& inRays,
+    const Bvh<Triangle3f>::Parameters& inParameters)
+{
+  const Bvh<Triangle3f> bvh(MakeSpan(inTriangles), inParameters);
+  if (bvh.IsQuantized() != (inParameters.mQuantize && !inTriangles.empty())
+      || bvh.GetNumberOfTriangles() != inTriangles.size())
+  {
+    std::cerr << "BVH of " << inTriangles.size() << " triangles built wrong" << std::endl;
+    return false;
+  }
+
+  for (const auto max_distance : { Bvh<Triangle3f>::Infinity, 5.0f })
+  {
+    const auto batch_closest_intersections = bvh.IntersectClosest(MakeSpan(inRays), max_distance);
+    const auto batch_checks = bvh.IntersectCheck(MakeSpan(inRays), max_distance);
+    for (std::size_t ray_id = 0; ray_id < inRays.size(); ++ray_id)
+    {
+      const auto& ray = inRays[ray_id];
+      std::vector<float> distances(inTriangles.size(), Bvh<Triangle3f>::Infinity);
+      std::vector<std::size_t> hit_triangles_ids;
+      auto closest_distance = Bvh<Triangle3f>::Infinity;
+      for (std::size_t triangle_id = 0; triangle_id < inTriangles.size(); ++triangle_id)
+      {
+        const auto distance = IntersectBruteForce(ray, inTriangles[triangle_id]);
+        if (!distance || *distance > max_distance)
+          continue;
+
+        distances[triangle_id] = *distance;
+        hit_triangles_ids.push_back(triangle_id);
+        closest_distance = std::min(closest_distance, *distance);
+      }
+
+      // Closest: any triangle at the closest distance, as ties can go either way
+      const auto closest_intersection = bvh.IntersectClosest(ray, max_distance);
+      if (closest_intersection.has_value() != !hit_triangles_ids.empty()
+          || (closest_intersection
+              && (std::abs(closest_intersection->mDistance - closest_distance) > DistanceTolerance
+                  || std::abs(distances[closest_intersection->mPrimitiveIndex] - closest_distance)
+                      > DistanceTolerance)))
+      {
+        std::cerr << "IntersectClosest of ray " << ray_id << " differs from brute force" << std::endl;
+        return false;
+      }
+
+      auto all_intersections = bvh.IntersectAll(ray, max_distance);
+      std::sort(all_intersections.begin(),
+          all_intersections.end(),
+          [](const auto& inLHS, const auto& inRHS) { return inLHS.mPrimitiveIndex < inRHS.mPrimitiveIndex; });
+      auto all_intersections_match = (all_intersections.size() == hit_triangles_ids.size());
+      for (std::size_t i = 0; all_intersections_match && i < all_intersections.size(); ++i)
+      {
+        all_intersections_match = (all_intersections[i].mPrimitiveIndex == hit_triangles_ids[i])
+            && (std::abs(all_intersections[i].mDistance - distances[hit_triangles_ids[i]]) <= DistanceTolerance);
+      }
+      if (!all_intersections_match)
+      {
+        std::cerr << "IntersectAll of ray " << ray_id << " found " << all_intersections.size() << " triangles, "
+                  << hit_triangles_ids.size() << " by brute force" << std::endl;
+        return false;
+      }
+
+      if (bvh.IntersectCheck(ray, max_distance) != !hit_triangles_ids.empty())
+      {
+        std::cerr << "IntersectCheck of ray " << ray_id << " differs from brute force" << std::endl;
+        return false;
+      }
+
+      // Batched, the same as one by one
+      const auto& batch_closest_intersection = batch_closest_intersections[ray_id];
+      if (batch_closest_intersection.has_value() != closest_intersection.has_value()
+          || (batch_closest_intersection
+              && batch_closest_intersection->mPrimitiveIndex != closest_intersection->mPrimitiveIndex)
+          || (batch_checks[ray_id] != 0) != !hit_triangles_ids.empty())
+      {
+        std::cerr << "Batched queries of ray " << ray_id << " differ from the single ray ones" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+// Quantized and not, from leaves of one triangle to the largest ones quantized nodes can store
+int main(int argc, const char** argv)
+{
+  std::mt19937 random_engine(47);
+  std::uniform_real_distribution<float> position_distribution(-10.0f, 10.0f);
+  std::vector<Ray3f> rays;
+  for (std::size_t i = 0; i < 500; ++i)
+  {
+    const Vec3f origin { position_distribution(random_engine),
+      position_distribution(random_engine),
+      position_distribution(random_engine) };
+    const Vec3f random_direction { position_distribution(random_engine),
+      position_distribution(random_engine),
+      position_distribution(random_engine) };
+
+    // Half of them towards the cluster, to hit many overlapping triangles
+    const auto direction = ((i % 2) == 0 ? random_direction : (Vec3f { 1.0f, 1.0f, 1.0f } - origin));
+    rays.emplace_back(origin, NormalizedSafe(direction));
+  }
+
+  for (const auto number_of_triangles : { 0, 1, 7, 3000 })
+  {
+    const auto triangles = GetTriangles(random_engine, number_of_triangles);
+    for (const auto quantize : { false, true })
+    {
+      for (const auto max_leaf_size : { 1, 8, 60 })
+      {
+        Bvh<Triangle3f>::Parameters parameters;
+        parameters.mQuantize = quantize;
+        parameters.mMaxLeafSize = max_leaf_size;
+        if (!TestAgainstBruteForce(triangles, rays, parameters))
+        {
+          std::cerr << "With " << number_of_triangles << " triangles, quantized " << quantize << ", max leaf size "
+                    << max_leaf_size << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  // Large enough for the subtrees to be built and binned in parallel, against a sample of the rays only, as brute
+  // force gets slow at that size
+  const auto large_triangles = GetTriangles(random_engine, 70000);
+  const std::vector<Ray3f> sampled_rays(rays.cbegin(), rays.cbegin() + 50);
+  for (const auto quantize : { false, true })
+  {
+    Bvh<Triangle3f>::Parameters parameters;
+    parameters.mQuantize = quantize;
+    if (!TestAgainstBruteForce(large_triangles, sampled_rays, parameters))
+    {
+      std::cerr << "With " << large_triangles.size() << " triangles, quantized " << quantize << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Bvh tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -1,14 +1,13 @@
+#include <ez/Bvh.h>
 #include <ez/CameraControllerFly.h>
 #include <ez/HyperSphere.h>
 #include <ez/MeshFactory.h>
-#include <ez/Octree.h>
 #include <ez/PerspectiveCamera.h>
 #include <ez/Plane.h>
 #include "ez/Renderer3D.h"
 #include <ez/VAO.h>
 #include <ez/Window.h>
 #include <cstdlib>
-#include <stack>
 #include <vector>
 
 using namespace ez;
@@ -18,8 +17,8 @@ int main(int argc, const char** argv)
   // Create meshes
   const auto mesh = MeshFactory::GetTorus(30, 30, 0.5f);
 
-  // Create octree
-  const auto octree = Octree<Triangle3f>(MakeSpan(mesh.GetTriangles()), 8, 6);
+  // Create BVH
+  const auto bvh = Bvh<Triangle3f>(MakeSpan(mesh.GetTriangles()));
 
   // Create window
   Window::CreateOptions window_create_options;
@@ -57,8 +56,8 @@ int main(int argc, const char** argv)
 
       rays.push_back(mouse_ray);
 
-      const auto mesh_triangles = mesh.GetTriangles();
-      const auto mesh_intersections = IntersectAll(octree, mouse_ray);
+      const auto& mesh_triangles = mesh.GetTriangles();
+      const auto mesh_intersections = bvh.IntersectAll(mouse_ray);
       for (const auto& mesh_intersection : mesh_intersections)
       {
         hit_points.push_back(mouse_ray.GetPoint(mesh_intersection.mDistance));
@@ -122,22 +121,6 @@ int main(int argc, const char** argv)
       renderer.DrawPoint(hit_point);
     }
 
-    /*
-    renderer.GetMaterial().SetDiffuseColor(Red<Color4f>());
-    std::stack<const Octree<Triangle3f>*> octrees_stack;
-    octrees_stack.push(&octree);
-    while (!octrees_stack.empty())
-    {
-      const auto& child_octree = *(octrees_stack.top());
-      octrees_stack.pop();
-
-      if (child_octree.IsLeaf())
-        renderer.DrawAABoxBoundary(child_octree.GetAABox());
-
-      for (const auto& grandchild_octree : child_octree) { octrees_stack.push(&grandchild_octree); }
-    }
-    */
-
     // Add a light
     renderer.AddDirectionalLight(Normalized(Vec3f(-1.0f, -1.5f, 2.0f)), White<Color3f>());
 
@@ -0,0 +1,343 @@
+#include <ez/Mesh.h>
+#include <ez/MeshBinaryIO.h>
+#include <ez/MeshFactory.h>
+#include <ez/MeshNativeIO.h>
+#ifdef MESH_IO
+#include <ez/MeshIO.h>
+#endif
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+// Bitwise, element by element, since the streams are stored as they are in memory
+template <typename T>
+bool AreStreamsEqual(const std::string_view inStreamName, const Span<T>& inExpected, const Span<T>& inActual)
+{
+  if (inActual.GetNumberOfElements() != inExpected.GetNumberOfElements())
+  {
+    std::cerr << inStreamName << " has " << inActual.GetNumberOfElements() << " elements, expected "
+              << inExpected.GetNumberOfElements() << std::endl;
+    return false;
+  }
+
+  for (std::size_t i = 0; i < inExpected.GetNumberOfElements(); ++i)
+  {
+    if (std::memcmp(&inActual.GetData()[i], &inExpected.GetData()[i], sizeof(T)) != 0)
+    {
+      std::cerr << inStreamName << " differs at element " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AreVertexCornersIndicesEqual(const Mesh& inExpected, const Mesh& inActual)
+{
+  if (inActual.HasVertexCornersIndex() != inExpected.HasVertexCornersIndex())
+  {
+    std::cerr << "Vertex corners index presence differs" << std::endl;
+    return false;
+  }
+
+  for (Mesh::VertexId vertex_id = 0; vertex_id < inExpected.GetNumberOfVertices(); ++vertex_id)
+  {
+    if (!AreStreamsEqual("Vertex corners ids",
+            inExpected.GetVertexCornersIdsSpan(vertex_id),
+            inActual.GetVertexCornersIdsSpan(vertex_id)))
+      return false;
+  }
+  return true;
+}
+
+bool AreMeshesEqual(const Mesh& inExpected, const Mesh& inActual)
+{
+  return AreStreamsEqual("Vertices positions", inExpected.GetVerticesPositions(), inActual.GetVerticesPositions())
+      && AreStreamsEqual("Vertices face ids", inExpected.GetVerticesFaceIds(), inActual.GetVerticesFaceIds())
+      && AreStreamsEqual("Faces vertices ids", inExpected.GetFacesVerticesIds(), inActual.GetFacesVerticesIds())
+      && AreStreamsEqual("Faces normals", inExpected.GetFacesNormals(), inActual.GetFacesNormals())
+      && AreStreamsEqual("Corners normals", inExpected.GetCornersNormals(), inActual.GetCornersNormals())
+      && AreStreamsEqual("Corners texture coordinates",
+          inExpected.GetCornersTextureCoordinates(),
+          inActual.GetCornersTextureCoordinates())
+      && AreStreamsEqual("Corners opposite corners ids",
+          inExpected.GetCornersOppositeCornersIds(),
+          inActual.GetCornersOppositeCornersIds())
+      && AreStreamsEqual("Non-manifold edges",
+          MakeSpan(inExpected.GetNonManifoldEdges()),
+          MakeSpan(inActual.GetNonManifoldEdges()))
+      && AreVertexCornersIndicesEqual(inExpected, inActual);
+}
+
+bool AreMeshesEqual(const Mesh& inExpected, const MeshBinaryIO::MappedMesh& inActual)
+{
+  if (!inActual.IsCornerTableComputed() || !inActual.HasVertexCornersIndex())
+  {
+    std::cerr << "Mapped mesh is missing its corner table" << std::endl;
+    return false;
+  }
+
+  // Edges faced by the non-manifold corners, as Mesh::GetNonManifoldEdges
+  std::vector<Mesh::Edge> mapped_non_manifold_edges;
+  const auto* faces_vertices_ids = inActual.GetFacesVerticesIds().GetData();
+  const auto* non_manifold_corners_ids = inActual.GetNonManifoldCornersIds().GetData();
+  for (std::size_t i = 0; i < inActual.GetNonManifoldCornersIds().GetNumberOfElements(); ++i)
+  {
+    const auto& face_vertices_ids = faces_vertices_ids[non_manifold_corners_ids[i] / 3];
+    const auto internal_corner_id = (non_manifold_corners_ids[i] % 3);
+    mapped_non_manifold_edges.emplace_back(face_vertices_ids[(internal_corner_id + 1) % 3],
+        face_vertices_ids[(internal_corner_id + 2) % 3]);
+  }
+  if (!AreStreamsEqual("Mapped non-manifold edges",
+          MakeSpan(inExpected.GetNonManifoldEdges()),
+          MakeSpan(mapped_non_manifold_edges)))
+    return false;
+
+  const auto* vertex_corners_offsets = inActual.GetVertexCornersOffsets().GetData();
+  const auto* vertex_corners_ids = inActual.GetVertexCornersIds().GetData();
+  for (Mesh::VertexId vertex_id = 0; vertex_id < inExpected.GetNumberOfVertices(); ++vertex_id)
+  {
+    const auto mapped_vertex_corners_ids = MakeSpan(vertex_corners_ids + vertex_corners_offsets[vertex_id],
+        vertex_corners_offsets[vertex_id + 1] - vertex_corners_offsets[vertex_id]);
+    if (!AreStreamsEqual("Mapped vertex corners ids",
+            inExpected.GetVertexCornersIdsSpan(vertex_id),
+            mapped_vertex_corners_ids))
+      return false;
+  }
+
+  return AreStreamsEqual("Mapped vertices positions",
+             inExpected.GetVerticesPositions(),
+             inActual.GetVerticesPositions())
+      && AreStreamsEqual("Mapped vertices face ids", inExpected.GetVerticesFaceIds(), inActual.GetVerticesFaceIds())
+      && AreStreamsEqual("Mapped faces vertices ids", inExpected.GetFacesVerticesIds(), inActual.GetFacesVerticesIds())
+      && AreStreamsEqual("Mapped faces normals", inExpected.GetFacesNormals(), inActual.GetFacesNormals())
+      && AreStreamsEqual("Mapped corners normals", inExpected.GetCornersNormals(), inActual.GetCornersNormals())
+      && AreStreamsEqual("Mapped corners texture coordinates",
+          inExpected.GetCornersTextureCoordinates(),
+          inActual.GetCornersTextureCoordinates())
+      && AreStreamsEqual("Mapped corners opposite corners ids",
+          inExpected.GetCornersOppositeCornersIds(),
+          inActual.GetCornersOppositeCornersIds());
+}
+
+// Writes a mesh with all its streams and its corner table to .ezmesh, and checks that reading and mapping it back
+// gives the same streams, element by element
+bool TestReadAndMap()
+{
+  auto mesh = MeshFactory::GetSphere(64, 128);
+
+  // A fin on an edge of the sphere, so that there are non-manifold corners to store
+  const auto fin_face_vertices_ids = mesh.GetFaceVerticesIds(0);
+  const auto fin_vertex_id = mesh.AddVertex(Vec3f { 2.0f, 2.0f, 2.0f });
+  mesh.AddFace(fin_face_vertices_ids[1], fin_face_vertices_ids[0], fin_vertex_id);
+
+  // Every stream and the corner table, stored in the .ezmesh
+  mesh.ComputeNormals(0.5f);
+  for (Mesh::CornerId corner_id = 0; corner_id < mesh.GetNumberOfCorners(); ++corner_id)
+  {
+    const auto& vertex_position = mesh.GetVertexPosition(mesh.GetVertexIdFromCornerId(corner_id));
+    mesh.SetCornerTextureCoordinates(corner_id, Vec2f { vertex_position[0], vertex_position[1] });
+  }
+  mesh.ComputeCornerTable();
+
+  if (mesh.GetNonManifoldEdges().empty())
+  {
+    std::cerr << "The mesh to write has no non-manifold edges" << std::endl;
+    return false;
+  }
+
+  const auto ezmesh_path = std::filesystem::temp_directory_path() / "TestMeshBinaryIO.ezmesh";
+  mesh.Write(ezmesh_path);
+
+  Mesh read_mesh;
+  read_mesh.Read(ezmesh_path);
+  if (!AreMeshesEqual(mesh, read_mesh))
+  {
+    std::cerr << "The .ezmesh read mesh does not match the written one" << std::endl;
+    return false;
+  }
+
+  {
+    const auto mapped_mesh = MeshBinaryIO::Map(ezmesh_path);
+    if (!AreMeshesEqual(mesh, mapped_mesh))
+    {
+      std::cerr << "The .ezmesh mapped mesh does not match the written one" << std::endl;
+      return false;
+    }
+  }
+
+  std::filesystem::remove(ezmesh_path);
+  return true;
+}
+
+// Positions and triangles only, as the native readers get them from any exporter
+void WriteObj(const Mesh& inMesh, const std::filesystem::path& inPath)
+{
+  std::ofstream file(inPath);
+  for (const auto& vertex_position : inMesh.GetVerticesPositions())
+    file << "v " << vertex_position[0] << " " << vertex_position[1] << " " << vertex_position[2] << "\n";
+  for (const auto& face_vertices_ids : inMesh.GetFacesVerticesIds())
+    file << "f " << face_vertices_ids[0] + 1 << " " << face_vertices_ids[1] + 1 << " " << face_vertices_ids[2] + 1
+         << "\n";
+}
+
+// Binary little endian, with float positions and "list uchar int" faces
+void WritePly(const Mesh& inMesh, const std::filesystem::path& inPath)
+{
+  std::ofstream file(inPath, std::ios::binary);
+  file << "ply\n"
+       << "format binary_little_endian 1.0\n"
+       << "element vertex " << inMesh.GetNumberOfVertices() << "\n"
+       << "property float x\n"
+       << "property float y\n"
+       << "property float z\n"
+       << "element face " << inMesh.GetNumberOfFaces() << "\n"
+       << "property list uchar int vertex_indices\n"
+       << "end_header\n";
+
+  for (const auto& vertex_position : inMesh.GetVerticesPositions())
+  {
+    const std::array<float, 3> position = { vertex_position[0], vertex_position[1], vertex_position[2] };
+    file.write(reinterpret_cast<const char*>(position.data()), sizeof(position));
+  }
+
+  for (const auto& face_vertices_ids : inMesh.GetFacesVerticesIds())
+  {
+    constexpr uint8_t number_of_face_vertices = 3;
+    const std::array<int32_t, 3> face = { static_cast<int32_t>(face_vertices_ids[0]),
+      static_cast<int32_t>(face_vertices_ids[1]),
+      static_cast<int32_t>(face_vertices_ids[2]) };
+    file.write(reinterpret_cast<const char*>(&number_of_face_vertices), sizeof(number_of_face_vertices));
+    file.write(reinterpret_cast<const char*>(face.data()), sizeof(face));
+  }
+}
+
+// Binary, with the face normals, and the corners welded back by the reader
+void WriteStl(const Mesh& inMesh, const std::filesystem::path& inPath)
+{
+  std::ofstream file(inPath, std::ios::binary);
+  const std::array<char, 80> header {};
+  const auto number_of_triangles = static_cast<uint32_t>(inMesh.GetNumberOfFaces());
+  file.write(header.data(), header.size());
+  file.write(reinterpret_cast<const char*>(&number_of_triangles), sizeof(number_of_triangles));
+
+  for (Mesh::FaceId face_id = 0; face_id < inMesh.GetNumberOfFaces(); ++face_id)
+  {
+    std::array<float, 12> triangle {};
+    const auto& face_normal = inMesh.GetFaceNormal(face_id);
+    const auto& face_vertices_ids = inMesh.GetFaceVerticesIds(face_id);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      triangle[i] = face_normal[i];
+      for (std::size_t internal_corner_id = 0; internal_corner_id < 3; ++internal_corner_id)
+        triangle[3 + internal_corner_id * 3 + i] = inMesh.GetVertexPosition(face_vertices_ids[internal_corner_id])[i];
+    }
+    constexpr uint16_t attribute_byte_count = 0;
+    file.write(reinterpret_cast<const char*>(triangle.data()), sizeof(triangle));
+    file.write(reinterpret_cast<const char*>(&attribute_byte_count), sizeof(attribute_byte_count));
+  }
+}
+
+double TimeSeconds(const std::function<void()>& inFunction)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  inFunction();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Load times of a large mesh from .ezmesh (read and map), from OBJ, PLY and STL through MeshNativeIO and, if compiled
+// with MESH_IO, from OBJ through Assimp. As loaded for drawing: the .ezmesh already has the corner table, the other
+// formats need it computed.
+bool Benchmark(const std::size_t inNumberOfLatitudes)
+{
+  std::cout << "Creating sphere mesh..." << std::endl;
+  auto mesh = MeshFactory::GetSphere(inNumberOfLatitudes, inNumberOfLatitudes * 2);
+  mesh.ComputeCornerTable();
+  std::cout << mesh.GetNumberOfVertices() << " vertices, " << mesh.GetNumberOfFaces() << " faces" << std::endl;
+
+  const auto temporary_directory = std::filesystem::temp_directory_path();
+  const auto ezmesh_path = temporary_directory / "TestMeshBinaryIO.ezmesh";
+  const auto write_ezmesh_seconds = TimeSeconds([&]() { mesh.Write(ezmesh_path); });
+  std::cout << "Write .ezmesh: " << write_ezmesh_seconds << "s (" << std::filesystem::file_size(ezmesh_path)
+            << " bytes)" << std::endl;
+
+  Mesh ezmesh_read_mesh;
+  const auto read_ezmesh_seconds = TimeSeconds([&]() { ezmesh_read_mesh.Read(ezmesh_path); });
+  std::cout << "Read .ezmesh: " << read_ezmesh_seconds << "s" << std::endl;
+
+  const auto map_ezmesh_seconds = TimeSeconds([&]() { MeshBinaryIO::Map(ezmesh_path, false); });
+  std::cout << "Map .ezmesh (without checksum): " << map_ezmesh_seconds << "s" << std::endl;
+  std::filesystem::remove(ezmesh_path);
+
+  const auto print_read_seconds = [&](const std::string_view inReadName, const double inReadSeconds)
+  {
+    std::cout << "Read " << inReadName << " + ComputeCornerTable: " << inReadSeconds << "s ("
+              << (inReadSeconds / read_ezmesh_seconds) << "x the .ezmesh read)" << std::endl;
+  };
+
+  const auto obj_path = temporary_directory / "TestMeshBinaryIO.obj";
+  const auto ply_path = temporary_directory / "TestMeshBinaryIO.ply";
+  const auto stl_path = temporary_directory / "TestMeshBinaryIO.stl";
+  WriteObj(mesh, obj_path);
+  WritePly(mesh, ply_path);
+  WriteStl(mesh, stl_path);
+  for (const auto& native_path : { obj_path, ply_path, stl_path })
+  {
+    Mesh native_read_mesh;
+    auto is_supported = false;
+    const auto read_native_seconds = TimeSeconds([&]() {
+      is_supported = MeshNativeIO::Read(native_path, native_read_mesh);
+      native_read_mesh.ComputeCornerTable();
+    });
+    if (!is_supported || native_read_mesh.GetNumberOfFaces() != mesh.GetNumberOfFaces())
+    {
+      std::cerr << "MeshNativeIO did not read back the faces of " << native_path << std::endl;
+      return false;
+    }
+    print_read_seconds(native_path.extension().string() + " (MeshNativeIO)", read_native_seconds);
+  }
+
+#ifdef MESH_IO
+  Mesh assimp_read_mesh;
+  const auto read_assimp_seconds = TimeSeconds([&]() {
+    MeshIO::Read(obj_path, assimp_read_mesh);
+    assimp_read_mesh.ComputeCornerTable();
+  });
+  print_read_seconds(".obj (Assimp)", read_assimp_seconds);
+#endif
+
+  std::filesystem::remove(obj_path);
+  std::filesystem::remove(ply_path);
+  std::filesystem::remove(stl_path);
+  return true;
+}
+}
+
+// Checks that the .ezmesh streams read and mapped back are the same as the written ones. Usage: TestMeshBinaryIO.exe
+// [--benchmark [number of sphere latitudes, 1000 by default]] to also compare the load times of a large mesh.
+int main(int argc, const char** argv)
+{
+  if (!TestReadAndMap())
+    return EXIT_FAILURE;
+
+  if (argc >= 2 && std::string_view(argv[1]) == "--benchmark")
+  {
+    if (!Benchmark(argc >= 3 ? std::stoul(argv[2]) : 1000ul))
+      return EXIT_FAILURE;
+  }
+
+  std::cout << "MeshBinaryIO tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+#include <ez/Mesh.h>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+constexpr Mesh::VertexId GridSize = 8; // Vertices per side
+
+std::vector<Vec3f> GetGridVerticesPositions()
+{
+  std::vector<Vec3f> vertices_positions;
+  for (Mesh::VertexId y = 0; y < GridSize; ++y)
+  {
+    for (Mesh::VertexId x = 0; x < GridSize; ++x)
+      vertices_positions.push_back(Vec3f { static_cast<float>(x), static_cast<float>(y), 0.0f });
+  }
+  return vertices_positions;
+}
+
+std::vector<Mesh::FaceVerticesIds> GetGridFacesVerticesIds()
+{
+  std::vector<Mesh::FaceVerticesIds> faces_vertices_ids;
+  for (Mesh::VertexId y = 0; y + 1 < GridSize; ++y)
+  {
+    for (Mesh::VertexId x = 0; x + 1 < GridSize; ++x)
+    {
+      const auto vertex_id = (y * GridSize + x);
+      faces_vertices_ids.push_back({ vertex_id, vertex_id + 1, vertex_id + 1 + GridSize });
+      faces_vertices_ids.push_back({ vertex_id, vertex_id + 1 + GridSize, vertex_id + GridSize });
+    }
+  }
+  return faces_vertices_ids;
+}
+
+template <typename T>
+bool AreStreamsEqual(const std::string_view inStreamName, const Span<T>& inExpected, const Span<T>& inActual)
+{
+  if (inActual.GetNumberOfElements() != inExpected.GetNumberOfElements())
+  {
+    std::cerr << inStreamName << " has " << inActual.GetNumberOfElements() << " elements, expected "
+              << inExpected.GetNumberOfElements() << std::endl;
+    return false;
+  }
+
+  for (std::size_t i = 0; i < inExpected.GetNumberOfElements(); ++i)
+  {
+    if (!(inActual.GetData()[i] == inExpected.GetData()[i]))
+    {
+      std::cerr << inStreamName << " differs at element " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AreMeshesEqual(const Mesh& inExpected, const Mesh& inActual)
+{
+  return AreStreamsEqual("Vertices positions", inExpected.GetVerticesPositions(), inActual.GetVerticesPositions())
+      && AreStreamsEqual("Vertices face ids", inExpected.GetVerticesFaceIds(), inActual.GetVerticesFaceIds())
+      && AreStreamsEqual("Faces vertices ids", inExpected.GetFacesVerticesIds(), inActual.GetFacesVerticesIds())
+      && AreStreamsEqual("Faces normals", inExpected.GetFacesNormals(), inActual.GetFacesNormals())
+      && AreStreamsEqual("Corners normals", inExpected.GetCornersNormals(), inActual.GetCornersNormals())
+      && AreStreamsEqual("Corners texture coordinates",
+          inExpected.GetCornersTextureCoordinates(),
+          inActual.GetCornersTextureCoordinates())
+      && AreStreamsEqual("Corners opposite corners ids",
+          inExpected.GetCornersOppositeCornersIds(),
+          inActual.GetCornersOppositeCornersIds());
+}
+
+// AddVertices, AddFaces and SetStreams build the same mesh as AddVertex and AddFace
+bool TestSameAsOneByOne()
+{
+  const auto vertices_positions = GetGridVerticesPositions();
+  const auto faces_vertices_ids = GetGridFacesVerticesIds();
+
+  Mesh one_by_one_mesh;
+  for (const auto& vertex_position : vertices_positions) one_by_one_mesh.AddVertex(vertex_position);
+  for (const auto& face_vertices_ids : faces_vertices_ids)
+    one_by_one_mesh.AddFace(face_vertices_ids[0], face_vertices_ids[1], face_vertices_ids[2]);
+
+  // Twice the first half and then the second, so that the ids returned are not just 0
+  Mesh bulk_mesh;
+  const auto half_number_of_vertices = vertices_positions.size() / 2;
+  const auto half_number_of_faces = faces_vertices_ids.size() / 2;
+  const auto first_vertex_id = bulk_mesh.AddVertices(MakeSpan(vertices_positions.data(), half_number_of_vertices));
+  const auto second_vertex_id = bulk_mesh.AddVertices(MakeSpan(vertices_positions.data() + half_number_of_vertices,
+      vertices_positions.size() - half_number_of_vertices));
+  const auto first_face_id = bulk_mesh.AddFaces(MakeSpan(faces_vertices_ids.data(), half_number_of_faces));
+  const auto second_face_id = bulk_mesh.AddFaces(MakeSpan(faces_vertices_ids.data() + half_number_of_faces,
+      faces_vertices_ids.size() - half_number_of_faces));
+  if (first_vertex_id != 0 || second_vertex_id != half_number_of_vertices || first_face_id != 0
+      || second_face_id != half_number_of_faces)
+  {
+    std::cerr << "Bulk adds returned the first ids " << first_vertex_id << ", " << second_vertex_id << ", "
+              << first_face_id << " and " << second_face_id << ", expected 0, " << half_number_of_vertices
+              << ", 0 and " << half_number_of_faces << std::endl;
+    return false;
+  }
+
+  auto streams_vertices_positions = vertices_positions;
+  auto streams_faces_vertices_ids = faces_vertices_ids;
+  Mesh streams_mesh;
+  streams_mesh.SetStreams(std::move(streams_vertices_positions), std::move(streams_faces_vertices_ids));
+
+  if (!AreMeshesEqual(one_by_one_mesh, bulk_mesh) || !AreMeshesEqual(one_by_one_mesh, streams_mesh))
+  {
+    std::cerr << "Meshes built in bulk differ from the one built one element at a time" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// SetStreams keeps the given attributes, and replaces whatever the mesh had
+bool TestSetStreamsAttributes()
+{
+  const auto faces_vertices_ids = GetGridFacesVerticesIds();
+  const auto number_of_faces = faces_vertices_ids.size();
+  std::vector<Vec3f> faces_normals(number_of_faces, Vec3f { 0.0f, 0.0f, 1.0f });
+  std::vector<Vec3f> corners_normals(number_of_faces * 3, Vec3f { 0.0f, 1.0f, 0.0f });
+  std::vector<Vec2f> corners_texture_coordinates(number_of_faces * 3);
+  for (std::size_t corner_id = 0; corner_id < corners_texture_coordinates.size(); ++corner_id)
+    corners_texture_coordinates[corner_id] = Vec2f { static_cast<float>(corner_id), 0.0f };
+
+  Mesh mesh;
+  mesh.AddVertex(Vec3f { 1.0f, 2.0f, 3.0f });
+  mesh.SetStreams(GetGridVerticesPositions(),
+      std::vector<Mesh::FaceVerticesIds>(faces_vertices_ids),
+      std::vector<Vec3f>(faces_normals),
+      std::vector<Vec3f>(corners_normals),
+      std::vector<Vec2f>(corners_texture_coordinates));
+
+  const auto vertices_positions = GetGridVerticesPositions();
+  return AreStreamsEqual("Streams vertices positions", MakeSpan(vertices_positions), mesh.GetVerticesPositions())
+      && AreStreamsEqual("Streams faces vertices ids", MakeSpan(faces_vertices_ids), mesh.GetFacesVerticesIds())
+      && AreStreamsEqual("Streams faces normals", MakeSpan(faces_normals), mesh.GetFacesNormals())
+      && AreStreamsEqual("Streams corners normals", MakeSpan(corners_normals), mesh.GetCornersNormals())
+      && AreStreamsEqual("Streams corners texture coordinates",
+          MakeSpan(corners_texture_coordinates),
+          mesh.GetCornersTextureCoordinates());
+}
+
+// Bulk adds are topology changes: a new generation, dirty ranges started over past every generation synced before,
+// and derived data computed again
+bool TestGenerationAndDirtyRanges()
+{
+  const auto vertices_positions = GetGridVerticesPositions();
+  const auto faces_vertices_ids = GetGridFacesVerticesIds();
+
+  Mesh mesh;
+  mesh.AddVertices(MakeSpan(vertices_positions));
+  mesh.AddFaces(MakeSpan(faces_vertices_ids.data(), faces_vertices_ids.size() - 1));
+
+  // The last face is missing, so the diagonal of the last quad is on the boundary
+  const auto last_quad_face_id = static_cast<Mesh::FaceId>(mesh.GetNumberOfFaces() - 1);
+  const auto diagonal_corner_id = mesh.GetCornerIdFromFaceIdAndInternalCornerId(last_quad_face_id, 1);
+  if (mesh.GetOppositeCornerId(diagonal_corner_id) != Mesh::InvalidId)
+  {
+    std::cerr << "The diagonal of the half built last quad has an opposite corner" << std::endl;
+    return false;
+  }
+
+  // Synced, and then one vertex moved: only that vertex is dirty
+  mesh.ClearDirtyRanges();
+  const auto synced_generation = mesh.GetGeneration();
+  mesh.SetVertexPosition(3, Vec3f { 3.0f, 0.0f, 1.0f });
+  const auto& dirty_ranges = mesh.GetDirtyRanges();
+  if (dirty_ranges.mVertices.mBegin != 3 || dirty_ranges.mVertices.mEnd != 4 || !dirty_ranges.mCorners.IsEmpty()
+      || !dirty_ranges.mFaces.IsEmpty() || dirty_ranges.mBeginGeneration != synced_generation
+      || mesh.GetGeneration() == synced_generation)
+  {
+    std::cerr << "Moving a vertex left the dirty vertices [" << dirty_ranges.mVertices.mBegin << ", "
+              << dirty_ranges.mVertices.mEnd << "), expected [3, 4)" << std::endl;
+    return false;
+  }
+
+  for (const auto bulk_add : { 0, 1 })
+  {
+    const auto generation_before = mesh.GetGeneration();
+    if (bulk_add == 0)
+      mesh.AddVertices(MakeSpan(vertices_positions.data(), 1));
+    else
+      mesh.AddFaces(MakeSpan(faces_vertices_ids.data() + faces_vertices_ids.size() - 1, 1));
+
+    // Derived data synced at generation_before or earlier has to update fully
+    const auto& bulk_dirty_ranges = mesh.GetDirtyRanges();
+    if (mesh.GetGeneration() == generation_before || bulk_dirty_ranges.mBeginGeneration <= generation_before
+        || bulk_dirty_ranges.mBeginGeneration > mesh.GetGeneration() || !bulk_dirty_ranges.mVertices.IsEmpty()
+        || !bulk_dirty_ranges.mCorners.IsEmpty() || !bulk_dirty_ranges.mFaces.IsEmpty())
+    {
+      std::cerr << (bulk_add == 0 ? "AddVertices" : "AddFaces")
+                << " did not start a new generation with the dirty ranges started over" << std::endl;
+      return false;
+    }
+  }
+
+  // The corner table is computed again: the last face closes the diagonal, and the new vertex has no faces
+  if (mesh.GetNumberOfVertices() != vertices_positions.size() + 1
+      || mesh.GetOppositeCornerId(diagonal_corner_id) == Mesh::InvalidId
+      || mesh.GetVerticesFaceIds().GetData()[vertices_positions.size()] != Mesh::InvalidId)
+  {
+    std::cerr << "Derived data not updated after the bulk adds" << std::endl;
+    return false;
+  }
+
+  // Replacing the whole mesh is also a topology change
+  const auto generation_before_set_streams = mesh.GetGeneration();
+  mesh.SetStreams(GetGridVerticesPositions(), GetGridFacesVerticesIds());
+  if (mesh.GetGeneration() == generation_before_set_streams
+      || mesh.GetDirtyRanges().mBeginGeneration <= generation_before_set_streams
+      || !mesh.GetDirtyRanges().mVertices.IsEmpty())
+  {
+    std::cerr << "SetStreams did not start a new generation with the dirty ranges started over" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  if (!TestSameAsOneByOne() || !TestSetStreamsAttributes() || !TestGenerationAndDirtyRanges())
+    return EXIT_FAILURE;
+
+  std::cout << "Mesh bulk construction tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+#include <ez/Mesh.h>
+#include <cstdlib>
+#include <iostream>
+
+using namespace ez;
+
+namespace
+{
+// A tetrahedron without its last face, closed later
+Mesh GetOpenTetrahedron()
+{
+  Mesh mesh;
+  mesh.AddVertex(Vec3f { 0.0f, 0.0f, 0.0f });
+  mesh.AddVertex(Vec3f { 1.0f, 0.0f, 0.0f });
+  mesh.AddVertex(Vec3f { 0.0f, 1.0f, 0.0f });
+  mesh.AddVertex(Vec3f { 0.0f, 0.0f, 1.0f });
+  mesh.AddFace(0, 2, 1);
+  mesh.AddFace(0, 1, 3);
+  mesh.AddFace(0, 3, 2);
+  return mesh;
+}
+
+std::size_t GetNumberOfBoundaryCorners(const Mesh& inMesh)
+{
+  std::size_t number_of_boundary_corners = 0;
+  for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
+  {
+    if (inMesh.GetOppositeCornerId(corner_id) == Mesh::InvalidId)
+      ++number_of_boundary_corners;
+  }
+  return number_of_boundary_corners;
+}
+
+// Topology edits drop the corner table, the vertex->corners index, the edges, the triangles and the bounds, and the
+// queries compute them again from the new faces
+bool TestRecomputedAfterTopologyEdits()
+{
+  auto mesh = GetOpenTetrahedron();
+  mesh.ComputeCornerTable();
+  if (!mesh.HasVertexCornersIndex() || GetNumberOfBoundaryCorners(mesh) != 3 || mesh.GetNumberOfEdges() != 6
+      || mesh.GetTriangles().size() != 3 || mesh.GetVertexCornersIdsSpan(1).GetNumberOfElements() != 2)
+  {
+    std::cerr << "Open tetrahedron with the wrong derived data" << std::endl;
+    return false;
+  }
+
+  mesh.AddFace(1, 2, 3);
+  if (mesh.HasVertexCornersIndex())
+  {
+    std::cerr << "Vertex corners index kept after adding a face" << std::endl;
+    return false;
+  }
+
+  // Only what the queries need is computed: the opposite corners do not build the vertex->corners index
+  if (GetNumberOfBoundaryCorners(mesh) != 0 || mesh.HasVertexCornersIndex())
+  {
+    std::cerr << "Opposite corners not computed again after adding a face" << std::endl;
+    return false;
+  }
+
+  if (mesh.GetVertexCornersIdsSpan(1).GetNumberOfElements() != 3 || !mesh.HasVertexCornersIndex()
+      || mesh.GetNumberOfEdges() != 6 || mesh.GetTriangles().size() != 4)
+  {
+    std::cerr << "Derived data not computed again after adding a face" << std::endl;
+    return false;
+  }
+
+  // A vertex far away, without faces, grows the bounds
+  mesh.AddVertex(Vec3f { 0.0f, 0.0f, -4.0f });
+  if (mesh.HasVertexCornersIndex() || mesh.GetBoundingAABox().GetMin()[2] != -4.0f
+      || mesh.GetVertexCornersIdsSpan(4).GetNumberOfElements() != 0)
+  {
+    std::cerr << "Derived data not computed again after adding a vertex" << std::endl;
+    return false;
+  }
+
+  mesh.Clear();
+  if (mesh.GetNumberOfEdges() != 0 || !mesh.GetTriangles().empty())
+  {
+    std::cerr << "Derived data not computed again after clearing" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Position edits only drop the data derived from the positions, and attribute edits nothing: the topology stays
+// computed, and the cached triangles are only computed again once read
+bool TestKeptAfterOtherEdits()
+{
+  auto mesh = GetOpenTetrahedron();
+  mesh.ComputeCornerTable();
+  const auto& triangles = mesh.GetTriangles();
+  const auto& bounding_box = mesh.GetBoundingAABox();
+
+  mesh.SetCornerTextureCoordinates(0, Vec2f { 0.5f, 0.5f });
+  mesh.SetCornerNormal(0, Vec3f { 0.0f, 0.0f, 1.0f });
+  mesh.SetVertexPosition(3, Vec3f { 0.0f, 0.0f, 2.0f });
+  if (!mesh.HasVertexCornersIndex())
+  {
+    std::cerr << "Vertex corners index dropped by attribute and position edits" << std::endl;
+    return false;
+  }
+
+  // Lazy: the cached triangles still have the old position, until they are read again
+  if (triangles[1][2][2] != 1.0f || bounding_box.GetMax()[2] != 1.0f)
+  {
+    std::cerr << "Triangles or bounds computed right away on a position edit" << std::endl;
+    return false;
+  }
+
+  if (mesh.GetTriangles()[1][2][2] != 2.0f || mesh.GetBoundingAABox().GetMax()[2] != 2.0f
+      || !mesh.HasVertexCornersIndex())
+  {
+    std::cerr << "Triangles or bounds not computed again after a position edit" << std::endl;
+    return false;
+  }
+
+  // With auto normals, the normals are derived data too: they are dropped, marking every corner and face dirty, by
+  // position edits only
+  mesh.SetAutoNormals(0.5f);
+  const auto face_normal_z = mesh.GetFaceNormal(0)[2];
+  mesh.ClearDirtyRanges();
+  mesh.SetCornerTextureCoordinates(1, Vec2f { 0.25f, 0.25f });
+  if (!mesh.HasAutoNormals() || !mesh.GetDirtyRanges().mFaces.IsEmpty()
+      || mesh.GetDirtyRanges().mCorners.mEnd - mesh.GetDirtyRanges().mCorners.mBegin != 1)
+  {
+    std::cerr << "Auto normals dropped by a texture coordinates edit" << std::endl;
+    return false;
+  }
+
+  mesh.SetVertexPosition(1, Vec3f { 1.0f, 0.0f, 1.0f });
+  if (mesh.GetDirtyRanges().mFaces.mEnd != mesh.GetNumberOfFaces()
+      || mesh.GetDirtyRanges().mCorners.mEnd != mesh.GetNumberOfCorners() || mesh.GetFaceNormal(0)[2] == face_normal_z)
+  {
+    std::cerr << "Auto normals not computed again after a position edit" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  if (!TestRecomputedAfterTopologyEdits() || !TestKeptAfterOtherEdits())
+    return EXIT_FAILURE;
+
+  std::cout << "Mesh derived data tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+#include <ez/Mesh.h>
+#include <ez/MeshFactory.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+// The corners facing every edge, found by going through all the faces
+std::vector<std::vector<Mesh::CornerId>> GetEdgesFacingCornersIds(const Mesh& inMesh)
+{
+  std::vector<std::vector<Mesh::CornerId>> edges_facing_corners_ids(inMesh.GetNumberOfEdges());
+  for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
+  {
+    const auto face_vertices_ids = inMesh.GetFaceVerticesIds(inMesh.GetFaceIdFromCornerId(corner_id));
+    const auto internal_corner_id = (corner_id % 3);
+    const auto edge = Mesh::Edge { face_vertices_ids[(internal_corner_id + 1) % 3],
+      face_vertices_ids[(internal_corner_id + 2) % 3] };
+    const auto edge_id = inMesh.GetEdgeId(edge);
+    if (edge_id == Mesh::InvalidId)
+      return {};
+    edges_facing_corners_ids[edge_id].push_back(corner_id);
+  }
+  return edges_facing_corners_ids;
+}
+
+// Every edge is found back from its vertices (in both orders) and from its corners, and its corners are the ones
+// facing it: two for interior edges, and one with InvalidId as the second for boundary and non-manifold ones
+bool CheckEdges(const std::string_view inMeshName, const Mesh& inMesh)
+{
+  const auto edges_facing_corners_ids = GetEdgesFacingCornersIds(inMesh);
+  if (edges_facing_corners_ids.size() != inMesh.GetNumberOfEdges())
+  {
+    std::cerr << inMeshName << ": an edge of the faces is missing from the edge table" << std::endl;
+    return false;
+  }
+
+  for (Mesh::EdgeId edge_id = 0; edge_id < inMesh.GetNumberOfEdges(); ++edge_id)
+  {
+    const auto& edge = inMesh.GetEdge(edge_id);
+    if (inMesh.GetEdgeId(edge) != edge_id || inMesh.GetEdgeId(Mesh::Edge { edge[1], edge[0] }) != edge_id)
+    {
+      std::cerr << inMeshName << ": edge " << edge_id << " not found back from its vertices" << std::endl;
+      return false;
+    }
+
+    const auto& facing_corners_ids = edges_facing_corners_ids[edge_id];
+    const auto edge_corners_ids = inMesh.GetEdgeCornersIds(edge_id);
+    const auto is_interior = (facing_corners_ids.size() == 2);
+    const auto has_facing_corner = [&](const Mesh::CornerId inCornerId)
+    {
+      return std::find(facing_corners_ids.cbegin(), facing_corners_ids.cend(), inCornerId)
+          != facing_corners_ids.cend();
+    };
+    if (!has_facing_corner(edge_corners_ids[0])
+        || (is_interior ? !has_facing_corner(edge_corners_ids[1]) || edge_corners_ids[1] == edge_corners_ids[0]
+                        : edge_corners_ids[1] != Mesh::InvalidId))
+    {
+      std::cerr << inMeshName << ": edge " << edge_id << ", faced by " << facing_corners_ids.size()
+                << " corners, has the wrong corners" << std::endl;
+      return false;
+    }
+
+    for (const auto corner_id : facing_corners_ids)
+    {
+      if (inMesh.GetCornerEdgeId(corner_id) != edge_id)
+      {
+        std::cerr << inMeshName << ": corner " << corner_id << " does not face its edge " << edge_id << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Closed 2-manifolds: every edge has two faces, so E = 3F/2, and V - E + F is the Euler characteristic
+bool TestClosedMesh(const std::string_view inMeshName, const Mesh& inMesh, const int inEulerCharacteristic)
+{
+  if (inMesh.GetNumberOfEdges() * 2 != inMesh.GetNumberOfFaces() * 3
+      || static_cast<int>(inMesh.GetNumberOfVertices() + inMesh.GetNumberOfFaces() - inMesh.GetNumberOfEdges())
+          != inEulerCharacteristic)
+  {
+    std::cerr << inMeshName << ": " << inMesh.GetNumberOfEdges() << " edges for " << inMesh.GetNumberOfFaces()
+              << " faces and " << inMesh.GetNumberOfVertices() << " vertices" << std::endl;
+    return false;
+  }
+
+  if (!CheckEdges(inMeshName, inMesh))
+    return false;
+
+  for (Mesh::EdgeId edge_id = 0; edge_id < inMesh.GetNumberOfEdges(); ++edge_id)
+  {
+    if (inMesh.GetEdgeCornersIds(edge_id)[1] == Mesh::InvalidId)
+    {
+      std::cerr << inMeshName << ": closed mesh edge " << edge_id << " has a single corner" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// A plane, with its outline as the boundary, and then with a fin on one of its interior edges
+bool TestOpenMesh()
+{
+  constexpr std::size_t number_of_quads_per_side = 4;
+  auto plane = MeshFactory::GetPlane(number_of_quads_per_side + 1, number_of_quads_per_side + 1);
+  if (!CheckEdges("Plane", plane))
+    return false;
+
+  std::size_t number_of_boundary_edges = 0;
+  for (Mesh::EdgeId edge_id = 0; edge_id < plane.GetNumberOfEdges(); ++edge_id)
+  {
+    if (plane.GetEdgeCornersIds(edge_id)[1] == Mesh::InvalidId)
+      ++number_of_boundary_edges;
+  }
+
+  if (number_of_boundary_edges != number_of_quads_per_side * 4
+      || plane.GetNumberOfVertices() + plane.GetNumberOfFaces() - plane.GetNumberOfEdges() != 1)
+  {
+    std::cerr << "Plane with " << number_of_boundary_edges << " boundary edges of " << plane.GetNumberOfEdges()
+              << ", expected " << number_of_quads_per_side * 4 << " for a disk" << std::endl;
+    return false;
+  }
+
+  // An interior edge becomes non-manifold: no opposite corner for any of its three corners
+  Mesh::EdgeId fin_edge_id = 0;
+  while (plane.GetEdgeCornersIds(fin_edge_id)[1] == Mesh::InvalidId) ++fin_edge_id;
+  const auto fin_edge = plane.GetEdge(fin_edge_id);
+  const auto fin_vertex_id = plane.AddVertex(Vec3f { 0.0f, 0.0f, 1.0f });
+  plane.AddFace(fin_edge[0], fin_edge[1], fin_vertex_id);
+  if (!CheckEdges("Plane with a fin", plane))
+    return false;
+
+  const auto non_manifold_edge_id = plane.GetEdgeId(fin_edge);
+  if (plane.GetNonManifoldEdges().size() != 1 || !(plane.GetNonManifoldEdges().front() == fin_edge)
+      || plane.GetEdgeCornersIds(non_manifold_edge_id)[1] != Mesh::InvalidId)
+  {
+    std::cerr << "Non-manifold edge of the plane with a fin has a second corner" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  if (!TestClosedMesh("Sphere", MeshFactory::GetSphere(16, 32), 2)
+      || !TestClosedMesh("Torus", MeshFactory::GetTorus(16, 32), 0) || !TestOpenMesh())
+    return EXIT_FAILURE;
+
+  std::cout << "Mesh edges tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
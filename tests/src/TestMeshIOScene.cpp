@@ -0,0 +1,138 @@
+#include <ez/Mesh.h>
+#include <ez/MeshIO.h>
+#include <ez/Parallel.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+// Work nested in the chunks of a ParallelFor under a ParallelSerialGuard, as the meshes of MeshIO::ReadScene, stays in
+// the thread of its chunk
+bool TestParallelSerialGuard()
+{
+  constexpr std::size_t number_of_elements = DefaultParallelMinChunkSize * 64;
+  std::atomic<bool> nested_work_stayed_serial = true;
+  std::atomic<std::size_t> number_of_chunks = 0;
+  std::atomic<std::size_t> number_of_nested_elements = 0;
+  ParallelFor(
+      GetNumberOfParallelThreads(),
+      [&](const std::size_t, const std::size_t, const std::size_t)
+      {
+        const ParallelSerialGuard parallel_serial_guard;
+        ++number_of_chunks;
+        const auto chunk_thread_id = std::this_thread::get_id();
+        if (GetNumberOfParallelThreads() != 1 || GetNumberOfParallelChunks(number_of_elements) != 1)
+          nested_work_stayed_serial = false;
+
+        ParallelFor(number_of_elements,
+            [&](const std::size_t, const std::size_t inBeginElement, const std::size_t inEndElement)
+            {
+              if (std::this_thread::get_id() != chunk_thread_id)
+                nested_work_stayed_serial = false;
+              number_of_nested_elements += (inEndElement - inBeginElement);
+            });
+
+        std::vector<std::size_t> elements(number_of_elements);
+        for (std::size_t i = 0; i < elements.size(); ++i) elements[i] = (elements.size() - i);
+        ParallelSort(elements.begin(), elements.end());
+        if (!std::is_sorted(elements.cbegin(), elements.cend()))
+          nested_work_stayed_serial = false;
+      },
+      1);
+
+  if (!nested_work_stayed_serial || number_of_nested_elements != number_of_elements * number_of_chunks)
+  {
+    std::cerr << "Parallel work under a ParallelSerialGuard did not run serially in its thread" << std::endl;
+    return false;
+  }
+
+  if (GetNumberOfParallelChunks(number_of_elements) != std::min(GetNumberOfParallelThreads(), std::size_t(64)))
+  {
+    std::cerr << "ParallelSerialGuard still applies once destroyed" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+#ifdef MESH_IO
+// Three objects, two of them with the same contents: two meshes, three instances. Each of them with its corner table.
+bool TestReadScene()
+{
+  const auto obj_path = std::filesystem::temp_directory_path() / "TestMeshIOScene.obj";
+  {
+    // OBJ indices are global and 1-based: the tetrahedra vertices are 1-4 and 5-8, the box ones 9-16
+    std::ofstream obj_file(obj_path);
+    for (const auto first_vertex_id : { 1, 5 })
+    {
+      const auto v = [&](const int inVertexId) { return (first_vertex_id + inVertexId); };
+      obj_file << "o Tetrahedron" << first_vertex_id << "\n"
+               << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\n"
+               << "f " << v(0) << " " << v(2) << " " << v(1) << "\n"
+               << "f " << v(0) << " " << v(1) << " " << v(3) << "\n"
+               << "f " << v(0) << " " << v(3) << " " << v(2) << "\n"
+               << "f " << v(1) << " " << v(2) << " " << v(3) << "\n";
+    }
+    obj_file << "o Box\n"
+             << "v -1 -1 -1\nv 1 -1 -1\nv -1 1 -1\nv 1 1 -1\nv -1 -1 1\nv 1 -1 1\nv -1 1 1\nv 1 1 1\n"
+             << "f 9 11 12 10\nf 13 14 16 15\nf 9 10 14 13\nf 11 15 16 12\nf 9 13 15 11\nf 10 12 16 14\n";
+  }
+
+  const auto scene = MeshIO::ReadScene(obj_path, 0.5f);
+  std::filesystem::remove(obj_path);
+
+  if (scene.mMeshes.size() != 2 || scene.mInstances.size() != 3)
+  {
+    std::cerr << "Scene read with " << scene.mMeshes.size() << " meshes and " << scene.mInstances.size()
+              << " instances, expected 2 and 3" << std::endl;
+    return false;
+  }
+
+  for (const auto& mesh : scene.mMeshes)
+  {
+    if (mesh.GetNumberOfFaces() != 4 && mesh.GetNumberOfFaces() != 12)
+    {
+      std::cerr << "Scene mesh read with " << mesh.GetNumberOfFaces() << " faces, expected 4 or 12" << std::endl;
+      return false;
+    }
+
+    // Computed in the thread of the mesh, the same as from scratch
+    auto recomputed_mesh = mesh;
+    recomputed_mesh.ComputeCornerTable();
+    const auto corners_opposite_corners_ids = mesh.GetCornersOppositeCornersIds();
+    const auto recomputed_corners_opposite_corners_ids = recomputed_mesh.GetCornersOppositeCornersIds();
+    if (!mesh.HasVertexCornersIndex() || !mesh.GetNonManifoldEdges().empty()
+        || !std::equal(corners_opposite_corners_ids.GetData(),
+            corners_opposite_corners_ids.GetData() + corners_opposite_corners_ids.GetNumberOfElements(),
+            recomputed_corners_opposite_corners_ids.GetData()))
+    {
+      std::cerr << "Scene mesh read with a wrong corner table" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+}
+
+// MeshIO::ReadScene converts the meshes one per thread, and computes the derived data of each one in that thread
+int main(int argc, const char** argv)
+{
+  if (!TestParallelSerialGuard())
+    return EXIT_FAILURE;
+
+#ifdef MESH_IO
+  if (!TestReadScene())
+    return EXIT_FAILURE;
+#endif
+
+  std::cout << "MeshIO scene tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+#include <ez/MeshFactory.h>
+#include <ez/MeshLODChain.h>
+#include <ez/Window.h>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace ez;
+
+namespace
+{
+constexpr float ViewportHeight = 800.0f;
+constexpr float AngleOfView = 1.0f;
+constexpr float MaxScreenError = 1.0f;
+
+// Pixels per unit at inDistance from the camera, as in Renderer3D::DrawMesh(const MeshLODChain&)
+float GetPixelsPerUnit(const float inDistance)
+{
+  return ViewportHeight / (2.0f * inDistance * std::tan(AngleOfView * 0.5f));
+}
+
+// Distance from the camera at which an error of inError projects to inScreenError pixels
+float GetDistance(const float inError, const float inScreenError)
+{
+  return inError * ViewportHeight / (2.0f * inScreenError * std::tan(AngleOfView * 0.5f));
+}
+
+bool TestLevelsNumberOfFaces(const Mesh& inMesh, const MeshLODChain& inMeshLODChain, const float inFacesRatio)
+{
+  if (inMeshLODChain.GetNumberOfLevels() != 4)
+  {
+    std::cerr << "Sphere LOD chain has " << inMeshLODChain.GetNumberOfLevels() << " levels, expected 4" << std::endl;
+    return false;
+  }
+
+  if (inMeshLODChain.GetLevel(0).mMeshDrawData->GetNumberOfElements() != inMesh.GetNumberOfCorners()
+      || inMeshLODChain.GetLevel(0).mError != 0.0f)
+  {
+    std::cerr << "First LOD level is not the original mesh" << std::endl;
+    return false;
+  }
+
+  for (std::size_t level_id = 1; level_id < inMeshLODChain.GetNumberOfLevels(); ++level_id)
+  {
+    const auto& previous_level = inMeshLODChain.GetLevel(level_id - 1);
+    const auto& level = inMeshLODChain.GetLevel(level_id);
+    const auto previous_number_of_faces = previous_level.mMeshDrawData->GetNumberOfElements() / 3;
+    const auto number_of_faces = level.mMeshDrawData->GetNumberOfElements() / 3;
+
+    // Each level targets a ratio of the faces of the previous one, and collapses remove up to two faces at a time
+    const auto target_number_of_faces = static_cast<std::size_t>(previous_number_of_faces * inFacesRatio);
+    if (number_of_faces > target_number_of_faces || number_of_faces + 2 <= target_number_of_faces)
+    {
+      std::cerr << "LOD level " << level_id << " has " << number_of_faces << " faces, expected "
+                << target_number_of_faces << std::endl;
+      return false;
+    }
+
+    if (level.mError < previous_level.mError)
+    {
+      std::cerr << "LOD level " << level_id << " error " << level.mError << " is below the one of the previous level "
+                << previous_level.mError << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestDistanceSelection(const MeshLODChain& inMeshLODChain)
+{
+  // Same levels, with known errors
+  constexpr std::array levels_errors = { 0.0f, 0.001f, 0.01f, 0.1f };
+  MeshLODChain mesh_lod_chain;
+  for (std::size_t level_id = 0; level_id < levels_errors.size(); ++level_id)
+    mesh_lod_chain.AddLevel(inMeshLODChain.GetLevel(level_id).mMeshDrawData, levels_errors[level_id]);
+
+  // Coming from far away the coarsest level whose error projects to less than a pixel, never coarser than it
+  const auto select_level_at_distance = [&](const float inDistance)
+  { return mesh_lod_chain.SelectLevel(GetPixelsPerUnit(inDistance), MaxScreenError); };
+  auto previous_level_id = select_level_at_distance(1000.0f);
+  if (previous_level_id != levels_errors.size() - 1)
+  {
+    std::cerr << "Far away LOD level is " << previous_level_id << ", expected the coarsest" << std::endl;
+    return false;
+  }
+
+  for (auto distance = 1000.0f; distance > 0.001f; distance *= 0.9f)
+  {
+    const auto level_id = select_level_at_distance(distance);
+    if (level_id > previous_level_id || levels_errors[level_id] * GetPixelsPerUnit(distance) > MaxScreenError)
+    {
+      std::cerr << "Approaching at distance " << distance << " selected LOD level " << level_id << " after "
+                << previous_level_id << std::endl;
+      return false;
+    }
+    previous_level_id = level_id;
+  }
+
+  if (previous_level_id != 0)
+  {
+    std::cerr << "Close LOD level is " << previous_level_id << ", expected the finest" << std::endl;
+    return false;
+  }
+
+  // Moving away only switches to a coarser level once its error is below the hysteresis fraction
+  for (auto distance = 0.001f; distance < 1000.0f; distance *= 1.1f)
+  {
+    const auto level_id = select_level_at_distance(distance);
+    const auto max_coarser_screen_error = MaxScreenError * (1.0f - MeshLODChain::Hysteresis);
+    if (level_id < previous_level_id
+        || (level_id > previous_level_id
+            && levels_errors[level_id] * GetPixelsPerUnit(distance) > max_coarser_screen_error))
+    {
+      std::cerr << "Moving away at distance " << distance << " selected LOD level " << level_id << " after "
+                << previous_level_id << std::endl;
+      return false;
+    }
+    previous_level_id = level_id;
+  }
+
+  // In the hysteresis band of the second level, the level selected depends on where the camera comes from
+  const auto hysteresis_band_distance
+      = GetDistance(levels_errors[1], MaxScreenError * (1.0f - 0.5f * MeshLODChain::Hysteresis));
+  select_level_at_distance(0.001f);
+  const auto level_id_from_close = select_level_at_distance(hysteresis_band_distance);
+  select_level_at_distance(GetDistance(levels_errors[2], MaxScreenError) * 0.99f);
+  const auto level_id_from_far = select_level_at_distance(hysteresis_band_distance);
+  if (level_id_from_close != 0 || level_id_from_far != 1)
+  {
+    std::cerr << "In the hysteresis band selected LOD levels " << level_id_from_close << " from close and "
+              << level_id_from_far << " from far, expected 0 and 1" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  // The levels draw data needs a GL context
+  Window::CreateOptions window_create_options;
+  window_create_options.mTitle = "Test MeshLODChain";
+  const auto window = std::make_shared<Window>(window_create_options);
+
+  constexpr auto faces_ratio = 0.5f;
+  const auto sphere = MeshFactory::GetSphere(64, 128);
+  const MeshLODChain mesh_lod_chain(sphere, 4, faces_ratio);
+  if (!TestLevelsNumberOfFaces(sphere, mesh_lod_chain, faces_ratio) || !TestDistanceSelection(mesh_lod_chain))
+    return EXIT_FAILURE;
+
+  std::cout << "MeshLODChain tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#include <ez/Mesh.h>
+#include <ez/MeshNativeIO.h>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+constexpr std::size_t NumberOfVertices = 256;
+
+// Binary little endian PLY with float positions and "list uchar int" faces
+void WritePly(const std::filesystem::path& inPath, const std::vector<std::vector<int32_t>>& inFacesVerticesIds)
+{
+  std::ofstream file(inPath, std::ios::binary);
+  file << "ply\n"
+       << "format binary_little_endian 1.0\n"
+       << "element vertex " << NumberOfVertices << "\n"
+       << "property float x\n"
+       << "property float y\n"
+       << "property float z\n"
+       << "element face " << inFacesVerticesIds.size() << "\n"
+       << "property list uchar int vertex_indices\n"
+       << "end_header\n";
+
+  for (std::size_t vertex_id = 0; vertex_id < NumberOfVertices; ++vertex_id)
+  {
+    const std::array<float, 3> position = { static_cast<float>(vertex_id), static_cast<float>(vertex_id % 7), 0.0f };
+    file.write(reinterpret_cast<const char*>(position.data()), sizeof(position));
+  }
+
+  for (const auto& face_vertices_ids : inFacesVerticesIds)
+  {
+    const auto number_of_face_vertices = static_cast<uint8_t>(face_vertices_ids.size());
+    file.write(reinterpret_cast<const char*>(&number_of_face_vertices), sizeof(number_of_face_vertices));
+    file.write(reinterpret_cast<const char*>(face_vertices_ids.data()), face_vertices_ids.size() * sizeof(int32_t));
+  }
+}
+
+// Two quads first, then enough triangles to be split in several chunks. Read with the fixed triangle stride, the
+// triangles past the quads are 8 bytes off: their count byte is the low byte of the second index (3) and their first
+// index takes the low byte of the third one (>= 128) as its sign byte, so they look like triangles with negative
+// indices.
+bool TestMixedTrianglesAndQuads(const std::filesystem::path& inPath)
+{
+  std::vector<std::vector<int32_t>> faces_vertices_ids = { { 0, 1, 2, 4 }, { 4, 5, 6, 7 } };
+  for (int32_t triangle_id = 0; triangle_id < 20000; ++triangle_id)
+    faces_vertices_ids.push_back({ 8 + triangle_id % 100, 3, 128 + triangle_id % 128 });
+  WritePly(inPath, faces_vertices_ids);
+
+  Mesh mesh;
+  try
+  {
+    if (!MeshNativeIO::Read(inPath, mesh))
+    {
+      std::cerr << "Mixed triangles and quads PLY not read natively" << std::endl;
+      return false;
+    }
+  }
+  catch (const std::exception& inException)
+  {
+    std::cerr << "Mixed triangles and quads PLY failed to load: " << inException.what() << std::endl;
+    return false;
+  }
+
+  // Quads as fans of two triangles
+  std::vector<Mesh::FaceVerticesIds> expected_faces_vertices_ids;
+  for (const auto& face_vertices_ids : faces_vertices_ids)
+  {
+    for (std::size_t i = 1; i + 1 < face_vertices_ids.size(); ++i)
+    {
+      expected_faces_vertices_ids.push_back({ static_cast<Mesh::VertexId>(face_vertices_ids[0]),
+          static_cast<Mesh::VertexId>(face_vertices_ids[i]),
+          static_cast<Mesh::VertexId>(face_vertices_ids[i + 1]) });
+    }
+  }
+
+  if (mesh.GetNumberOfVertices() != NumberOfVertices || mesh.GetNumberOfFaces() != expected_faces_vertices_ids.size())
+  {
+    std::cerr << "Mixed triangles and quads PLY read with " << mesh.GetNumberOfVertices() << " vertices and "
+              << mesh.GetNumberOfFaces() << " faces, expected " << NumberOfVertices << " and "
+              << expected_faces_vertices_ids.size() << std::endl;
+    return false;
+  }
+
+  for (Mesh::FaceId face_id = 0; face_id < mesh.GetNumberOfFaces(); ++face_id)
+  {
+    if (mesh.GetFaceVerticesIds(face_id) != expected_faces_vertices_ids[face_id])
+    {
+      std::cerr << "Mixed triangles and quads PLY face " << face_id << " has the wrong vertices" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Triangles only, one of them with a negative index: the fixed stride read has to report it
+bool TestInvalidVertexIndex(const std::filesystem::path& inPath)
+{
+  std::vector<std::vector<int32_t>> faces_vertices_ids;
+  for (int32_t triangle_id = 0; triangle_id < 20000; ++triangle_id)
+    faces_vertices_ids.push_back({ triangle_id % 100, 100, 101 });
+  faces_vertices_ids[12345][1] = -1;
+  WritePly(inPath, faces_vertices_ids);
+
+  Mesh mesh;
+  try
+  {
+    MeshNativeIO::Read(inPath, mesh);
+  }
+  catch (const std::exception& inException)
+  {
+    if (std::string(inException.what()).find("Invalid PLY vertex index -1") != std::string::npos)
+      return true;
+    std::cerr << "Triangles PLY with a negative index failed with an unexpected error: " << inException.what()
+              << std::endl;
+    return false;
+  }
+
+  std::cerr << "Triangles PLY with a negative index loaded" << std::endl;
+  return false;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  const auto ply_path = std::filesystem::temp_directory_path() / "TestMeshNativeIO.ply";
+  const auto success = TestMixedTrianglesAndQuads(ply_path) && TestInvalidVertexIndex(ply_path);
+  std::filesystem::remove(ply_path);
+  if (!success)
+    return EXIT_FAILURE;
+
+  std::cout << "MeshNativeIO tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+#include <ez/Mesh.h>
+#include <ez/MeshFactory.h>
+#include <ez/MeshSimplifier.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+constexpr float PositionEpsilon = 1e-5f;
+
+// Every edge has exactly two faces, and V - E + F matches the Euler characteristic of the original mesh
+bool IsClosedManifold(const Mesh& inMesh, const int inEulerCharacteristic)
+{
+  if (!inMesh.GetNonManifoldEdges().empty())
+    return false;
+
+  for (Mesh::CornerId corner_id = 0; corner_id < inMesh.GetNumberOfCorners(); ++corner_id)
+  {
+    if (inMesh.GetOppositeCornerId(corner_id) == Mesh::InvalidId)
+      return false;
+  }
+
+  const auto euler_characteristic = static_cast<int>(inMesh.GetNumberOfVertices())
+      - static_cast<int>(inMesh.GetNumberOfEdges()) + static_cast<int>(inMesh.GetNumberOfFaces());
+  return (euler_characteristic == inEulerCharacteristic);
+}
+
+bool TestTargetNumberOfFaces()
+{
+  const auto sphere = MeshFactory::GetSphere(32, 64);
+
+  MeshSimplifier::Parameters parameters;
+  parameters.mTargetNumberOfFaces = sphere.GetNumberOfFaces() / 4;
+  parameters.mNumberOfRegions = 4; // Also through the parallel pass, which a mesh this small would skip
+  const auto result = MeshSimplifier::Simplify(sphere, parameters);
+
+  // Interior half edge collapses remove two faces at a time, so the target can be undershot by one
+  const auto number_of_faces = result.mMesh.GetNumberOfFaces();
+  if (number_of_faces > parameters.mTargetNumberOfFaces || number_of_faces + 2 <= parameters.mTargetNumberOfFaces)
+  {
+    std::cerr << "Simplified sphere has " << number_of_faces << " faces, expected "
+              << parameters.mTargetNumberOfFaces << std::endl;
+    return false;
+  }
+
+  if (result.mNumberOfCollapses != (sphere.GetNumberOfFaces() - number_of_faces) / 2)
+  {
+    std::cerr << "Simplified sphere reports " << result.mNumberOfCollapses << " collapses for "
+              << (sphere.GetNumberOfFaces() - number_of_faces) << " removed faces" << std::endl;
+    return false;
+  }
+
+  if (!IsClosedManifold(result.mMesh, 2))
+  {
+    std::cerr << "Simplified sphere is not a closed manifold with the topology of a sphere" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestMaxError()
+{
+  const auto torus = MeshFactory::GetTorus(32, 64);
+
+  MeshSimplifier::Parameters parameters;
+  parameters.mMaxError = 0.001f;
+  const auto result = MeshSimplifier::Simplify(torus, parameters);
+  if (result.mNumberOfCollapses == 0 || result.mError > parameters.mMaxError)
+  {
+    std::cerr << "Simplified torus with " << result.mNumberOfCollapses << " collapses and error " << result.mError
+              << ", expected some collapses within the max error " << parameters.mMaxError << std::endl;
+    return false;
+  }
+
+  if (!IsClosedManifold(result.mMesh, 0))
+  {
+    std::cerr << "Simplified torus is not a closed manifold with the topology of a torus" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Simplifies a flat plane as much as its error allows, with an attribute seam along x = 0 (texture coordinates shifted
+// on the right half), and checks that the outline and the seam are kept as they are
+bool TestBoundaryAndSeamPreservation()
+{
+  auto plane = MeshFactory::GetPlane(33, 33);
+
+  constexpr auto right_texture_coordinates_offset = 10.0f;
+  std::vector<Vec2f> corners_texture_coordinates(plane.GetNumberOfCorners());
+  for (Mesh::FaceId face_id = 0; face_id < plane.GetNumberOfFaces(); ++face_id)
+  {
+    const auto face_triangle = plane.GetFaceTriangle(face_id);
+    const auto face_is_right = (face_triangle[0][0] + face_triangle[1][0] + face_triangle[2][0] > 0.0f);
+    for (const auto corner_id : plane.GetFaceCornersIds(face_id))
+    {
+      const auto& position = plane.GetVertexPosition(plane.GetVertexIdFromCornerId(corner_id));
+      corners_texture_coordinates[corner_id]
+          = Vec2f { position[0] + (face_is_right ? right_texture_coordinates_offset : 0.0f), position[1] };
+    }
+  }
+  plane.SetCornersTextureCoordinates(MakeSpan(corners_texture_coordinates));
+
+  // Collapses that keep the plane flat and its outline and seam straight have no error
+  MeshSimplifier::Parameters parameters;
+  parameters.mMaxError = 1e-3f;
+  const auto result = MeshSimplifier::Simplify(plane, parameters);
+  const auto& simplified_plane = result.mMesh;
+  if (simplified_plane.GetNumberOfFaces() * 4 >= plane.GetNumberOfFaces())
+  {
+    std::cerr << "Plane was barely simplified, to " << simplified_plane.GetNumberOfFaces() << " faces" << std::endl;
+    return false;
+  }
+
+  if (!simplified_plane.GetNonManifoldEdges().empty())
+  {
+    std::cerr << "Simplified plane has non-manifold edges" << std::endl;
+    return false;
+  }
+
+  const auto is_right_corner = [&](const Mesh::CornerId inCornerId)
+  { return (simplified_plane.GetCornerTextureCoordinates(inCornerId)[0] > right_texture_coordinates_offset * 0.5f); };
+
+  auto boundary_length = 0.0f;
+  auto seam_length = 0.0f;
+  for (Mesh::CornerId corner_id = 0; corner_id < simplified_plane.GetNumberOfCorners(); ++corner_id)
+  {
+    const auto edge_vertices_ids = simplified_plane.GetFaceOtherVertexIds(
+        simplified_plane.GetFaceIdFromCornerId(corner_id),
+        simplified_plane.GetVertexIdFromCornerId(corner_id));
+    const auto& edge_position0 = simplified_plane.GetVertexPosition(edge_vertices_ids[0]);
+    const auto& edge_position1 = simplified_plane.GetVertexPosition(edge_vertices_ids[1]);
+    const auto edge_length = Length(edge_position1 - edge_position0);
+
+    // Corners keep the texture coordinates of their side of the seam
+    const auto& corner_position
+        = simplified_plane.GetVertexPosition(simplified_plane.GetVertexIdFromCornerId(corner_id));
+    const auto& corner_texture_coordinates = simplified_plane.GetCornerTextureCoordinates(corner_id);
+    const auto expected_texture_coordinate_x
+        = corner_position[0] + (is_right_corner(corner_id) ? right_texture_coordinates_offset : 0.0f);
+    if (std::abs(corner_texture_coordinates[0] - expected_texture_coordinate_x) > PositionEpsilon)
+    {
+      std::cerr << "Simplified plane corner " << corner_id << " moved away from its texture coordinates" << std::endl;
+      return false;
+    }
+
+    const auto opposite_corner_id = simplified_plane.GetOppositeCornerId(corner_id);
+    if (opposite_corner_id == Mesh::InvalidId)
+    {
+      const auto on_same_side = [&](const std::size_t inCoordinate)
+      {
+        return (std::abs(std::abs(edge_position0[inCoordinate]) - 0.5f) < PositionEpsilon
+            && std::abs(edge_position1[inCoordinate] - edge_position0[inCoordinate]) < PositionEpsilon);
+      };
+      if (!on_same_side(0) && !on_same_side(1))
+      {
+        std::cerr << "Simplified plane boundary edge of corner " << corner_id << " is not on the outline" << std::endl;
+        return false;
+      }
+      boundary_length += edge_length;
+    }
+    else if (is_right_corner(corner_id) != is_right_corner(opposite_corner_id))
+    {
+      if (std::abs(edge_position0[0]) > PositionEpsilon || std::abs(edge_position1[0]) > PositionEpsilon)
+      {
+        std::cerr << "Simplified plane seam edge of corner " << corner_id << " is not on the seam" << std::endl;
+        return false;
+      }
+      seam_length += edge_length * 0.5f; // Seen from both of its faces
+    }
+  }
+
+  if (std::abs(boundary_length - 4.0f) > PositionEpsilon || std::abs(seam_length - 1.0f) > PositionEpsilon)
+  {
+    std::cerr << "Simplified plane boundary length " << boundary_length << " and seam length " << seam_length
+              << ", expected 4 and 1" << std::endl;
+    return false;
+  }
+  return true;
+}
+// Four regions, three of them loose triangles that boundary locking keeps as they are, and the last one a sphere.
+// Close to the regions target, the share of the sphere region rounds down to no faces, and it has to go on anyway.
+bool TestLockedRegions()
+{
+  const auto sphere = MeshFactory::GetSphere(16, 32);
+  const auto sphere_number_of_faces = sphere.GetNumberOfFaces();
+
+  Mesh mesh;
+  for (std::size_t triangle_id = 0; triangle_id < sphere_number_of_faces * 3; ++triangle_id)
+  {
+    const auto x = static_cast<float>(triangle_id) * 30.0f / static_cast<float>(sphere_number_of_faces * 3);
+    const auto vertex_id = mesh.AddVertex(Vec3f { x, 0.0f, 0.0f });
+    mesh.AddVertex(Vec3f { x, 1.0f, 0.0f });
+    mesh.AddVertex(Vec3f { x, 0.0f, 1.0f });
+    mesh.AddFace(vertex_id, vertex_id + 1, vertex_id + 2);
+  }
+
+  const auto first_sphere_vertex_id = static_cast<Mesh::VertexId>(mesh.GetNumberOfVertices());
+  for (Mesh::VertexId vertex_id = 0; vertex_id < sphere.GetNumberOfVertices(); ++vertex_id)
+    mesh.AddVertex(sphere.GetVertexPosition(vertex_id) + Vec3f { 40.0f, 0.0f, 0.0f });
+  for (Mesh::FaceId face_id = 0; face_id < sphere_number_of_faces; ++face_id)
+  {
+    const auto face_vertices_ids = sphere.GetFaceVerticesIds(face_id);
+    mesh.AddFace(first_sphere_vertex_id + face_vertices_ids[0],
+        first_sphere_vertex_id + face_vertices_ids[1],
+        first_sphere_vertex_id + face_vertices_ids[2]);
+  }
+
+  // The regions pass aims at the loose triangles plus a few dozen faces of the sphere
+  MeshSimplifier::Parameters parameters;
+  parameters.mLockBoundaries = true;
+  parameters.mNumberOfRegions = 4;
+  parameters.mTargetNumberOfFaces = ((sphere_number_of_faces * 5 / 2 + 40) * 8) / 7;
+  const auto result = MeshSimplifier::Simplify(mesh, parameters);
+
+  const auto number_of_faces = result.mMesh.GetNumberOfFaces();
+  if (number_of_faces < sphere_number_of_faces * 3 || number_of_faces > sphere_number_of_faces * 3 + 4)
+  {
+    std::cerr << "Loose triangles and sphere simplified to " << number_of_faces << " faces, expected the "
+              << sphere_number_of_faces * 3 << " loose triangles and what is left of the sphere" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  if (!TestTargetNumberOfFaces() || !TestMaxError() || !TestBoundaryAndSeamPreservation()
+      || !TestLockedRegions())
+    return EXIT_FAILURE;
+
+  std::cout << "MeshSimplifier tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+#include <ez/Mesh.h>
+#include <ez/MeshWelder.h>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+struct WeldCase
+{
+  std::string_view mName;
+  std::vector<Vec3f> mVerticesPositions;
+  std::vector<Mesh::FaceVerticesIds> mFacesVerticesIds;
+  MeshWelder::Parameters mParameters;
+
+  // Expected after the weld
+  std::vector<Vec3f> mWeldedVerticesPositions;
+  std::vector<Mesh::FaceVerticesIds> mWeldedFacesVerticesIds;
+  std::size_t mNumberOfRemovedFaces = 0;
+};
+
+// Welds the mesh and checks the merged vertices (each one with the position of its lowest id vertex, in the order of
+// those) and the remapped faces, without the degenerate ones. The corner texture coordinates of every face are its
+// original face id, so that they show which face ended up where.
+bool TestWeld(const WeldCase& inCase)
+{
+  Mesh mesh;
+  for (const auto& vertex_position : inCase.mVerticesPositions) mesh.AddVertex(vertex_position);
+  for (Mesh::FaceId face_id = 0; face_id < inCase.mFacesVerticesIds.size(); ++face_id)
+  {
+    const auto& face_vertices_ids = inCase.mFacesVerticesIds[face_id];
+    mesh.AddFace(face_vertices_ids[0], face_vertices_ids[1], face_vertices_ids[2]);
+    for (Mesh::InternalCornerId internal_corner_id = 0; internal_corner_id < 3; ++internal_corner_id)
+    {
+      mesh.SetCornerTextureCoordinates(mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id, internal_corner_id),
+          Vec2f { static_cast<float>(face_id), 0.0f });
+    }
+  }
+
+  const auto result = MeshWelder::Weld(mesh, inCase.mParameters);
+  const auto expected_number_of_merged_vertices
+      = (inCase.mVerticesPositions.size() - inCase.mWeldedVerticesPositions.size());
+  if (result.mNumberOfMergedVertices != expected_number_of_merged_vertices
+      || result.mNumberOfRemovedFaces != inCase.mNumberOfRemovedFaces)
+  {
+    std::cerr << inCase.mName << ": " << result.mNumberOfMergedVertices << " vertices merged and "
+              << result.mNumberOfRemovedFaces << " faces removed, expected " << expected_number_of_merged_vertices
+              << " and " << inCase.mNumberOfRemovedFaces << std::endl;
+    return false;
+  }
+
+  if (mesh.GetNumberOfVertices() != inCase.mWeldedVerticesPositions.size()
+      || mesh.GetNumberOfFaces() != inCase.mWeldedFacesVerticesIds.size())
+  {
+    std::cerr << inCase.mName << ": welded into " << mesh.GetNumberOfVertices() << " vertices and "
+              << mesh.GetNumberOfFaces() << " faces, expected " << inCase.mWeldedVerticesPositions.size() << " and "
+              << inCase.mWeldedFacesVerticesIds.size() << std::endl;
+    return false;
+  }
+
+  for (Mesh::VertexId vertex_id = 0; vertex_id < mesh.GetNumberOfVertices(); ++vertex_id)
+  {
+    if (!(mesh.GetVertexPosition(vertex_id) == inCase.mWeldedVerticesPositions[vertex_id]))
+    {
+      std::cerr << inCase.mName << ": welded vertex " << vertex_id << " has the wrong position" << std::endl;
+      return false;
+    }
+  }
+
+  // The kept faces stay in order, with their corner attributes
+  std::vector<Mesh::FaceId> kept_faces_ids;
+  for (Mesh::FaceId face_id = 0; face_id < mesh.GetNumberOfFaces(); ++face_id)
+  {
+    if (mesh.GetFaceVerticesIds(face_id) != inCase.mWeldedFacesVerticesIds[face_id])
+    {
+      std::cerr << inCase.mName << ": welded face " << face_id << " has the wrong vertices" << std::endl;
+      return false;
+    }
+
+    const auto corner_id = mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id, 0);
+    const auto original_face_id = static_cast<Mesh::FaceId>(mesh.GetCornerTextureCoordinates(corner_id)[0]);
+    if (!kept_faces_ids.empty() && original_face_id <= kept_faces_ids.back())
+    {
+      std::cerr << inCase.mName << ": welded face " << face_id << " is out of order, or lost its attributes"
+                << std::endl;
+      return false;
+    }
+    kept_faces_ids.push_back(original_face_id);
+  }
+  return true;
+}
+
+// A tetrahedron as a triangle soup, three vertices per face, welded into a closed mesh of four vertices
+bool TestTriangleSoup()
+{
+  const std::array<Vec3f, 4> tetrahedron_positions = { Vec3f { 0.0f, 0.0f, 0.0f },
+    Vec3f { 1.0f, 0.0f, 0.0f },
+    Vec3f { 0.0f, 1.0f, 0.0f },
+    Vec3f { 0.0f, 0.0f, 1.0f } };
+  const std::vector<Mesh::FaceVerticesIds> tetrahedron_faces_vertices_ids
+      = { { 0, 2, 1 }, { 0, 1, 3 }, { 0, 3, 2 }, { 1, 2, 3 } };
+
+  WeldCase soup_case;
+  soup_case.mName = "Tetrahedron soup";
+  for (const auto& face_vertices_ids : tetrahedron_faces_vertices_ids)
+  {
+    const auto first_vertex_id = static_cast<Mesh::VertexId>(soup_case.mVerticesPositions.size());
+    soup_case.mFacesVerticesIds.push_back({ first_vertex_id, first_vertex_id + 1, first_vertex_id + 2 });
+    for (const auto vertex_id : face_vertices_ids)
+      soup_case.mVerticesPositions.push_back(tetrahedron_positions[vertex_id]);
+  }
+
+  // In the order of the first corner with each position: 0, 2, 1 and then 3
+  soup_case.mWeldedVerticesPositions
+      = { tetrahedron_positions[0], tetrahedron_positions[2], tetrahedron_positions[1], tetrahedron_positions[3] };
+  soup_case.mWeldedFacesVerticesIds = { { 0, 1, 2 }, { 0, 2, 3 }, { 0, 3, 1 }, { 2, 1, 3 } };
+  if (!TestWeld(soup_case))
+    return false;
+
+  // Welded, the corner table closes
+  Mesh mesh;
+  for (const auto& vertex_position : soup_case.mVerticesPositions) mesh.AddVertex(vertex_position);
+  for (const auto& face_vertices_ids : soup_case.mFacesVerticesIds)
+    mesh.AddFace(face_vertices_ids[0], face_vertices_ids[1], face_vertices_ids[2]);
+  MeshWelder::Weld(mesh, MeshWelder::Parameters {});
+  for (Mesh::CornerId corner_id = 0; corner_id < mesh.GetNumberOfCorners(); ++corner_id)
+  {
+    if (mesh.GetOppositeCornerId(corner_id) == Mesh::InvalidId)
+    {
+      std::cerr << "Welded tetrahedron soup has a boundary at corner " << corner_id << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Vertices exactly epsilon apart merge, and just past it they do not, in the same cell or in neighbor ones
+bool TestEpsilonBoundary()
+{
+  constexpr float epsilon = 0.5f; // Exact in binary, as the distances below
+  const auto past_epsilon = std::nextafter(epsilon, 1.0f);
+  const Vec3f far_position_0 { 10.0f, 10.0f, 10.0f };
+  const Vec3f far_position_1 { 20.0f, 20.0f, 20.0f };
+
+  MeshWelder::Parameters parameters;
+  parameters.mEpsilon = epsilon;
+
+  // The first two vertices of each face merge or not, the others are far away from everything
+  WeldCase at_epsilon_case { "At epsilon",
+    { Vec3f { 0.0f, 0.0f, 0.0f }, Vec3f { epsilon, 0.0f, 0.0f }, far_position_0, far_position_1 },
+    { { 0, 1, 2 }, { 1, 3, 2 } },
+    parameters,
+    { Vec3f { 0.0f, 0.0f, 0.0f }, far_position_0, far_position_1 },
+    { { 0, 2, 1 } },
+    1 };
+
+  WeldCase past_epsilon_case { "Past epsilon",
+    { Vec3f { 0.0f, 0.0f, 0.0f }, Vec3f { past_epsilon, 0.0f, 0.0f }, far_position_0 },
+    { { 0, 1, 2 } },
+    parameters,
+    { Vec3f { 0.0f, 0.0f, 0.0f }, Vec3f { past_epsilon, 0.0f, 0.0f }, far_position_0 },
+    { { 0, 1, 2 } },
+    0 };
+
+  // In neighbor cells (cell 0 and -1 on every axis), close
+  WeldCase across_cells_case { "Across cells",
+    { Vec3f { 0.01f, 0.01f, 0.01f }, Vec3f { -0.01f, -0.01f, -0.01f }, far_position_0 },
+    { { 0, 1, 2 } },
+    parameters,
+    { Vec3f { 0.01f, 0.01f, 0.01f }, far_position_0 },
+    {},
+    1 };
+
+  // In neighbor cells along the diagonal, within epsilon on every axis but not in distance
+  WeldCase diagonal_case { "Diagonal past epsilon",
+    { Vec3f { 0.4f, 0.4f, 0.4f }, Vec3f { 0.7f, 0.7f, 0.7f }, far_position_0 },
+    { { 0, 1, 2 } },
+    parameters,
+    { Vec3f { 0.4f, 0.4f, 0.4f }, Vec3f { 0.7f, 0.7f, 0.7f }, far_position_0 },
+    { { 0, 1, 2 } },
+    0 };
+
+  // Chained within epsilon, the ends 1 apart: all merged into the lowest id, keeping its position
+  WeldCase chain_case { "Chain",
+    { far_position_0, Vec3f { 1.0f, 0.0f, 0.0f }, Vec3f { 0.0f, 0.0f, 0.0f }, Vec3f { 0.5f, 0.0f, 0.0f } },
+    { { 0, 1, 2 }, { 2, 3, 0 }, { 3, 0, 1 } },
+    parameters,
+    { far_position_0, Vec3f { 1.0f, 0.0f, 0.0f } },
+    {},
+    3 };
+
+  // With no epsilon, only equal positions merge (+0 and -0 being equal)
+  WeldCase zero_epsilon_case { "Zero epsilon",
+    { Vec3f { 0.0f, 0.0f, 0.0f },
+      Vec3f { -0.0f, 0.0f, 0.0f },
+      Vec3f { std::nextafter(0.0f, 1.0f), 0.0f, 0.0f },
+      far_position_0 },
+    { { 0, 1, 3 }, { 1, 2, 3 } },
+    MeshWelder::Parameters {},
+    { Vec3f { 0.0f, 0.0f, 0.0f }, Vec3f { std::nextafter(0.0f, 1.0f), 0.0f, 0.0f }, far_position_0 },
+    { { 0, 1, 2 } },
+    1 };
+
+  return TestWeld(at_epsilon_case) && TestWeld(past_epsilon_case) && TestWeld(across_cells_case)
+      && TestWeld(diagonal_case) && TestWeld(chain_case) && TestWeld(zero_epsilon_case);
+}
+
+// Coincident vertices of a texture seam stay split when preserving seams, and merge otherwise
+bool TestPreserveSeams()
+{
+  for (const auto preserve_seams : { false, true })
+  {
+    Mesh mesh;
+    const auto vertex_id_0 = mesh.AddVertex(Vec3f { 0.0f, 0.0f, 0.0f });
+    const auto vertex_id_1 = mesh.AddVertex(Vec3f { 1.0f, 0.0f, 0.0f });
+    const auto vertex_id_2 = mesh.AddVertex(Vec3f { 0.0f, 1.0f, 0.0f });
+    const auto seam_vertex_id = mesh.AddVertex(Vec3f { 0.0f, 0.0f, 0.0f });
+    const auto vertex_id_3 = mesh.AddVertex(Vec3f { -1.0f, 0.0f, 0.0f });
+    const auto face_id_0 = mesh.AddFace(vertex_id_0, vertex_id_1, vertex_id_2);
+    const auto face_id_1 = mesh.AddFace(seam_vertex_id, vertex_id_2, vertex_id_3);
+    for (Mesh::InternalCornerId internal_corner_id = 0; internal_corner_id < 3; ++internal_corner_id)
+    {
+      mesh.SetCornerTextureCoordinates(mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_0, internal_corner_id),
+          Vec2f { 0.0f, 0.0f });
+      mesh.SetCornerTextureCoordinates(mesh.GetCornerIdFromFaceIdAndInternalCornerId(face_id_1, internal_corner_id),
+          Vec2f { 1.0f, 0.0f });
+    }
+
+    MeshWelder::Parameters parameters;
+    parameters.mPreserveSeams = preserve_seams;
+    const auto result = MeshWelder::Weld(mesh, parameters);
+    const auto expected_number_of_merged_vertices = (preserve_seams ? 0u : 1u);
+    if (result.mNumberOfMergedVertices != expected_number_of_merged_vertices
+        || mesh.GetFaceVerticesIds(1)[0] != (preserve_seams ? seam_vertex_id : vertex_id_0))
+    {
+      std::cerr << "Seam vertex " << (preserve_seams ? "merged while preserving seams" : "not merged") << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Vertices with a NaN coordinate are never merged, not even with each other, with or without epsilon
+bool TestNaNPositions()
+{
+  for (const auto epsilon : { 0.0f, 0.5f })
+  {
+    Mesh mesh;
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+      const auto nan_vertex_id = mesh.AddVertex(Vec3f { std::numeric_limits<float>::quiet_NaN(), 0.0f, 0.0f });
+      const auto vertex_id_1 = mesh.AddVertex(Vec3f { 1.0f, 0.0f, 0.0f });
+      const auto vertex_id_2 = mesh.AddVertex(Vec3f { 0.0f, 1.0f, 0.0f });
+      mesh.AddFace(nan_vertex_id, vertex_id_1, vertex_id_2);
+    }
+
+    MeshWelder::Parameters parameters;
+    parameters.mEpsilon = epsilon;
+    const auto result = MeshWelder::Weld(mesh, parameters);
+    if (result.mNumberOfMergedVertices != 2 || mesh.GetNumberOfFaces() != 2
+        || mesh.GetFaceVerticesIds(0)[0] == mesh.GetFaceVerticesIds(1)[0])
+    {
+      std::cerr << "NaN vertices merged with epsilon " << epsilon << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main(int argc, const char** argv)
+{
+  if (!TestTriangleSoup() || !TestEpsilonBoundary() || !TestPreserveSeams() || !TestNaNPositions())
+    return EXIT_FAILURE;
+
+  std::cout << "MeshWelder tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}
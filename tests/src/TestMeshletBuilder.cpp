@@ -0,0 +1,114 @@
+#include <ez/MeshFactory.h>
+#include <ez/MeshletBuilder.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace ez;
+
+namespace
+{
+// Whether all the triangles of the meshlet face away from the point
+bool IsMeshletBackFacing(const MeshletBuilder::Meshlet& inMeshlet,
+    const std::vector<uint32_t>& inIndices,
+    const Span<Vec3f>& inVerticesPositions,
+    const Vec3f& inPoint)
+{
+  const auto* vertices_positions = inVerticesPositions.GetData();
+  for (auto element = inMeshlet.mBeginElement; element < inMeshlet.mBeginElement + inMeshlet.mNumberOfElements;
+       element += 3)
+  {
+    const auto& position0 = vertices_positions[inIndices[element]];
+    const auto& position1 = vertices_positions[inIndices[element + 1]];
+    const auto& position2 = vertices_positions[inIndices[element + 2]];
+    const auto normal = Cross(position1 - position0, position2 - position0);
+    if (Dot(normal, inPoint - position0) > 0.0f)
+      return false;
+  }
+  return true;
+}
+}
+
+// Culls the meshlets of a sphere seen from outside, with its lower half out of the frustum, with and without the normal
+// cones test
+int main(int argc, const char** argv)
+{
+  const auto sphere = MeshFactory::GetSphere(32, 64);
+  const auto vertices_positions = sphere.GetVerticesPositions();
+  std::vector<uint32_t> indices;
+  indices.reserve(sphere.GetNumberOfCorners());
+  for (Mesh::FaceId face_id = 0; face_id < sphere.GetNumberOfFaces(); ++face_id)
+  {
+    const auto face_vertices_ids = sphere.GetFaceVerticesIds(face_id);
+    indices.insert(indices.end(), face_vertices_ids.cbegin(), face_vertices_ids.cend());
+  }
+
+  const auto meshlets = MeshletBuilder::Build(indices, vertices_positions);
+
+  // Far planes all around but one through z = 0, keeping z >= 0 only
+  MeshletBuilder::CullingView culling_view;
+  culling_view.mFrustumPlanes = { Vec4f { 1.0f, 0.0f, 0.0f, 100.0f },
+    Vec4f { -1.0f, 0.0f, 0.0f, 100.0f },
+    Vec4f { 0.0f, 1.0f, 0.0f, 100.0f },
+    Vec4f { 0.0f, -1.0f, 0.0f, 100.0f },
+    Vec4f { 0.0f, 0.0f, 1.0f, 0.0f },
+    Vec4f { 0.0f, 0.0f, -1.0f, 100.0f } };
+  culling_view.mCameraPosition = Vec3f { 10.0f, 0.0f, 0.0f };
+
+  std::vector<uint32_t> visible_meshlets_ids;
+  MeshletBuilder::Cull(MakeSpan(meshlets), culling_view, Identity<Mat4f>(), false, visible_meshlets_ids);
+  const auto frustum_visible_meshlets_ids = visible_meshlets_ids;
+  MeshletBuilder::Cull(MakeSpan(meshlets), culling_view, Identity<Mat4f>(), true, visible_meshlets_ids);
+  const auto front_visible_meshlets_ids = visible_meshlets_ids;
+
+  // Without the cone test, exactly the meshlets whose bounding sphere reaches z >= 0
+  for (uint32_t meshlet_id = 0; meshlet_id < meshlets.size(); ++meshlet_id)
+  {
+    const auto& bounding_sphere = meshlets[meshlet_id].mBoundingSphere;
+    const auto in_frustum = (bounding_sphere.GetCenter()[2] + bounding_sphere.GetRadius() >= 0.0f);
+    const auto is_visible = std::binary_search(frustum_visible_meshlets_ids.cbegin(),
+        frustum_visible_meshlets_ids.cend(),
+        meshlet_id);
+    if (in_frustum != is_visible)
+    {
+      std::cerr << "Meshlet " << meshlet_id << " visible " << is_visible << " without back facing culling, in frustum "
+                << in_frustum << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // With the cone test, a subset of those, only missing meshlets that fully face away from the camera
+  if (front_visible_meshlets_ids.size() >= frustum_visible_meshlets_ids.size())
+  {
+    std::cerr << "Back facing culling kept " << front_visible_meshlets_ids.size() << " meshlets of "
+              << frustum_visible_meshlets_ids.size() << ", expected fewer" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (const auto meshlet_id : frustum_visible_meshlets_ids)
+  {
+    const auto is_visible
+        = std::binary_search(front_visible_meshlets_ids.cbegin(), front_visible_meshlets_ids.cend(), meshlet_id);
+    if (!is_visible
+        && !IsMeshletBackFacing(meshlets[meshlet_id], indices, vertices_positions, culling_view.mCameraPosition))
+    {
+      std::cerr << "Meshlet " << meshlet_id << " culled as back facing, but it has triangles facing the camera"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (!std::includes(frustum_visible_meshlets_ids.cbegin(),
+          frustum_visible_meshlets_ids.cend(),
+          front_visible_meshlets_ids.cbegin(),
+          front_visible_meshlets_ids.cend()))
+  {
+    std::cerr << "Back facing culling shows meshlets outside the frustum" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "MeshletBuilder tests passed" << std::endl;
+  return EXIT_SUCCESS;
+}